@@ -10,6 +10,7 @@
 // Channel Access routines
 //===============================================================
 #include "ChannelAccess.h"
+#include "InternalData.h"
 
 using namespace std;
 
@@ -535,11 +536,11 @@ int ChannelAccess::getValuesRaw(void *dataBufOut, unsigned long pointNum)
 }
 
 //-----------------------------------------------
-// get a waveform with data type conversion, this is quite
-// slow process because the data copy has to be done one by one
+// get a waveform with data type conversion, the data are converted
+// with the vector kernels of InternalData (INTD_API_vecConvert)
 //-----------------------------------------------
-#define CA_WF_READ(dtp)                                                         \
-    {unsigned long   i, pno = pointNum;                                         \
+#define CA_WF_READ(intdType)                                                    \
+    {unsigned long   pno = pointNum;                                            \
     dbr_short_t     *pValueShort;                                               \
     dbr_float_t     *pValueFloat;                                               \
     dbr_enum_t      *pValueEnum;                                                \
@@ -560,8 +561,8 @@ int ChannelAccess::getValuesRaw(void *dataBufOut, unsigned long pointNum)
             var_alarmSeverity           = ptr_tShort -> severity;               \
                                                                                 \
             pValueShort                 = &ptr_tShort -> value;                 \
-            for(i = 0; i < pno; i ++)                                           \
-                dataBufOut[i] = (dtp)pValueShort[i];                            \
+            INTD_API_vecConvert(intdType, dataBufOut,                           \
+                                INTD_SHORT, pValueShort, pno);                  \
                                                                                 \
             break;                                                              \
                                                                                 \
@@ -572,8 +573,8 @@ int ChannelAccess::getValuesRaw(void *dataBufOut, unsigned long pointNum)
             var_alarmSeverity           = ptr_tFloat -> severity;               \
                                                                                 \
             pValueFloat                 = &ptr_tFloat -> value;                 \
-            for(i = 0; i < pno; i ++)                                           \
-                dataBufOut[i] = (dtp)pValueFloat[i];                            \
+            INTD_API_vecConvert(intdType, dataBufOut,                           \
+                                INTD_FLOAT, pValueFloat, pno);                  \
                                                                                 \
             break;                                                              \
                                                                                 \
@@ -584,8 +585,8 @@ int ChannelAccess::getValuesRaw(void *dataBufOut, unsigned long pointNum)
             var_alarmSeverity           = ptr_tEnum -> severity;                \
                                                                                 \
             pValueEnum                  = &ptr_tEnum -> value;                  \
-            for(i = 0; i < pno; i ++)                                           \
-                dataBufOut[i] = (dtp)pValueEnum[i];                             \
+            INTD_API_vecConvert(intdType, dataBufOut,                           \
+                                INTD_USHORT, pValueEnum, pno);                  \
                                                                                 \
             break;                                                              \
                                                                                 \
@@ -596,8 +597,8 @@ int ChannelAccess::getValuesRaw(void *dataBufOut, unsigned long pointNum)
             var_alarmSeverity           = ptr_tChar -> severity;                \
                                                                                 \
             pValueChar                  = &ptr_tChar -> value;                  \
-            for(i = 0; i < pno; i ++)                                           \
-                dataBufOut[i] = (dtp)pValueChar[i];                             \
+            INTD_API_vecConvert(intdType, dataBufOut,                           \
+                                INTD_UCHAR, pValueChar, pno);                   \
                                                                                 \
             break;                                                              \
                                                                                 \
@@ -608,8 +609,8 @@ int ChannelAccess::getValuesRaw(void *dataBufOut, unsigned long pointNum)
             var_alarmSeverity           = ptr_tLong -> severity;                \
                                                                                 \
             pValueLong                  = &ptr_tLong -> value;                  \
-            for(i = 0; i < pno; i ++)                                           \
-                dataBufOut[i] = (dtp)pValueLong[i];                             \
+            INTD_API_vecConvert(intdType, dataBufOut,                           \
+                                INTD_LONG, pValueLong, pno);                    \
                                                                                 \
             break;                                                              \
                                                                                 \
@@ -620,8 +621,8 @@ int ChannelAccess::getValuesRaw(void *dataBufOut, unsigned long pointNum)
             var_alarmSeverity           = ptr_tDouble -> severity;              \
                                                                                 \
             pValueDouble                = &ptr_tDouble -> value;                \
-            for(i = 0; i < pno; i ++)                                           \
-                dataBufOut[i] = (dtp)pValueDouble[i];                           \
+            INTD_API_vecConvert(intdType, dataBufOut,                           \
+                                INTD_DOUBLE, pValueDouble, pno);                \
                                                                                 \
             break;                                                              \
                                                                                 \
@@ -640,14 +641,14 @@ int ChannelAccess::getValuesRaw(void *dataBufOut, unsigned long pointNum)
                                                                                 \
     return pno;}
 
-int ChannelAccess::getValues(epicsInt8     *dataBufOut, unsigned long pointNum) {CA_WF_READ(epicsInt8)}
-int ChannelAccess::getValues(epicsUInt8    *dataBufOut, unsigned long pointNum) {CA_WF_READ(epicsUInt8)}
-int ChannelAccess::getValues(epicsInt16    *dataBufOut, unsigned long pointNum) {CA_WF_READ(epicsInt16)}
-int ChannelAccess::getValues(epicsUInt16   *dataBufOut, unsigned long pointNum) {CA_WF_READ(epicsUInt16)}
-int ChannelAccess::getValues(epicsInt32    *dataBufOut, unsigned long pointNum) {CA_WF_READ(epicsInt32)}
-int ChannelAccess::getValues(epicsUInt32   *dataBufOut, unsigned long pointNum) {CA_WF_READ(epicsUInt32)}
-int ChannelAccess::getValues(epicsFloat32  *dataBufOut, unsigned long pointNum) {CA_WF_READ(epicsFloat32)}
-int ChannelAccess::getValues(epicsFloat64  *dataBufOut, unsigned long pointNum) {CA_WF_READ(epicsFloat64)}
+int ChannelAccess::getValues(epicsInt8     *dataBufOut, unsigned long pointNum) {CA_WF_READ(INTD_CHAR)}
+int ChannelAccess::getValues(epicsUInt8    *dataBufOut, unsigned long pointNum) {CA_WF_READ(INTD_UCHAR)}
+int ChannelAccess::getValues(epicsInt16    *dataBufOut, unsigned long pointNum) {CA_WF_READ(INTD_SHORT)}
+int ChannelAccess::getValues(epicsUInt16   *dataBufOut, unsigned long pointNum) {CA_WF_READ(INTD_USHORT)}
+int ChannelAccess::getValues(epicsInt32    *dataBufOut, unsigned long pointNum) {CA_WF_READ(INTD_LONG)}
+int ChannelAccess::getValues(epicsUInt32   *dataBufOut, unsigned long pointNum) {CA_WF_READ(INTD_ULONG)}
+int ChannelAccess::getValues(epicsFloat32  *dataBufOut, unsigned long pointNum) {CA_WF_READ(INTD_FLOAT)}
+int ChannelAccess::getValues(epicsFloat64  *dataBufOut, unsigned long pointNum) {CA_WF_READ(INTD_DOUBLE)}
 
 //-----------------------------------------------
 // get status
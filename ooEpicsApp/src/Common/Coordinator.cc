@@ -9,6 +9,7 @@
 // Implementation of base class of Coordinator
 //===============================================================
 #include "Coordinator.h"
+#include "InternalData.h"
 
 using namespace std;
 
@@ -85,6 +86,20 @@ void Coordinator::waitEventWithTimeout   (double timeout)
 void Coordinator::waitEventWithTimeout   (int *eventCode, int *cmd, int *subCmd, double timeout)    {var_event.recvEventWithTimeout(eventCode, cmd, subCmd, timeout);}
 int  Coordinator::withPendingEvents      ()                                                         {return var_event.getUnsolvedMsgNum() > 0 ? 1 : 0;}
 
+//-----------------------------------------------
+// barrier for the record synchronization, the output records are processed by INTD_syncWithRecords after iocInit
+// and the jobs should not run on the default values. Timeout <= 0 waits forever. Return 0 when synchronized
+//-----------------------------------------------
+int Coordinator::waitRecordsSynced(double timeout)
+{
+    if(INTD_API_waitSyncDone(timeout) != 0) {
+        cout << "WARNING: Coordinator::waitRecordsSynced: " << crdName << " for module " << modName << " timed out waiting for the record synchronization!\n";
+        return -1;
+    }
+
+    return 0;
+}
+
 }
 //******************************************************
 // NAME SPACE OOEPICS
@@ -54,6 +54,8 @@ public:
     void waitEventWithTimeout   (int *eventCode, int *cmd, int *subCmd, double timeout);    
     int  withPendingEvents      ();
 
+    int  waitRecordsSynced      (double timeout);                   // wait until INTD_syncWithRecords finished before the main loop
+
 	char modName[CRD_STRING_LEN];
     char crdName[CRD_STRING_LEN];
 
@@ -45,6 +45,7 @@ LocalPV::LocalPV()
     var_dataType        = INTD_DOUBLE;  
 
     ptr_dataBuf         = NULL; 
+    var_sharedBuf       = 0;
 
     var_onceCreated     = 0;
 }
@@ -53,6 +54,7 @@ LocalPV::LocalPV()
 LocalPV::LocalPV(const char *moduleName, const char *dataName, const char *supStr, const char *unitStr, volatile epicsInt8 *dataPtr, unsigned int pointNum, void *privatePtr, INTD_CALLBACK callback, INTD_enum_recordType recordType, INTD_enum_scanType scanType, IOSCANPVT *ioIntScan, epicsMutexId mutexId, epicsEventId eventId)
 {
     ptr_dataBuf = NULL; 
+    var_sharedBuf = 0;
     fun_maniCallback(recordType, callback); 
     node = INTD_API_createDataNode(moduleName, dataName, supStr, unitStr, (void *)(dataPtr), privatePtr, pointNum, ioIntScan, INTD_CHAR, rCallback, wCallback, mutexId, eventId, recordType, scanType);  
 }
@@ -60,6 +62,7 @@ LocalPV::LocalPV(const char *moduleName, const char *dataName, const char *supSt
 LocalPV::LocalPV(const char *moduleName, const char *dataName, const char *supStr, const char *unitStr, volatile epicsUInt8 *dataPtr, unsigned int pointNum, void *privatePtr, INTD_CALLBACK callback, INTD_enum_recordType recordType, INTD_enum_scanType scanType, IOSCANPVT *ioIntScan, epicsMutexId mutexId, epicsEventId eventId)
 {
     ptr_dataBuf = NULL;
+    var_sharedBuf = 0;
     fun_maniCallback(recordType, callback);    
     node = INTD_API_createDataNode(moduleName, dataName, supStr, unitStr, (void *)(dataPtr), privatePtr, pointNum, ioIntScan, INTD_UCHAR, rCallback, wCallback, mutexId, eventId, recordType, scanType);  
 }
@@ -67,6 +70,7 @@ LocalPV::LocalPV(const char *moduleName, const char *dataName, const char *supSt
 LocalPV::LocalPV(const char *moduleName, const char *dataName, const char *supStr, const char *unitStr, volatile epicsInt16 *dataPtr, unsigned int pointNum, void *privatePtr, INTD_CALLBACK callback, INTD_enum_recordType recordType, INTD_enum_scanType scanType, IOSCANPVT *ioIntScan, epicsMutexId mutexId, epicsEventId eventId)
 {
     ptr_dataBuf = NULL;
+    var_sharedBuf = 0;
     fun_maniCallback(recordType, callback); 
     node = INTD_API_createDataNode(moduleName, dataName, supStr, unitStr, (void *)(dataPtr), privatePtr, pointNum, ioIntScan, INTD_SHORT, rCallback, wCallback, mutexId, eventId, recordType, scanType);  
 }
@@ -74,6 +78,7 @@ LocalPV::LocalPV(const char *moduleName, const char *dataName, const char *supSt
 LocalPV::LocalPV(const char *moduleName, const char *dataName, const char *supStr, const char *unitStr, volatile epicsUInt16 *dataPtr, unsigned int pointNum, void *privatePtr, INTD_CALLBACK callback, INTD_enum_recordType recordType, INTD_enum_scanType scanType, IOSCANPVT *ioIntScan, epicsMutexId mutexId, epicsEventId eventId)
 {
     ptr_dataBuf = NULL;
+    var_sharedBuf = 0;
     fun_maniCallback(recordType, callback); 
     node = INTD_API_createDataNode(moduleName, dataName, supStr, unitStr, (void *)(dataPtr), privatePtr, pointNum, ioIntScan, INTD_USHORT, rCallback, wCallback, mutexId, eventId, recordType, scanType);  
 }
@@ -81,6 +86,7 @@ LocalPV::LocalPV(const char *moduleName, const char *dataName, const char *supSt
 LocalPV::LocalPV(const char *moduleName, const char *dataName, const char *supStr, const char *unitStr, volatile epicsInt32 *dataPtr, unsigned int pointNum, void *privatePtr, INTD_CALLBACK callback, INTD_enum_recordType recordType, INTD_enum_scanType scanType, IOSCANPVT *ioIntScan, epicsMutexId mutexId, epicsEventId eventId)
 {
     ptr_dataBuf = NULL;
+    var_sharedBuf = 0;
     fun_maniCallback(recordType, callback); 
     node = INTD_API_createDataNode(moduleName, dataName, supStr, unitStr, (void *)(dataPtr), privatePtr, pointNum, ioIntScan, INTD_LONG, rCallback, wCallback, mutexId, eventId, recordType, scanType);  
 }
@@ -88,6 +94,7 @@ LocalPV::LocalPV(const char *moduleName, const char *dataName, const char *supSt
 LocalPV::LocalPV(const char *moduleName, const char *dataName, const char *supStr, const char *unitStr, volatile epicsUInt32 *dataPtr, unsigned int pointNum, void *privatePtr, INTD_CALLBACK callback, INTD_enum_recordType recordType, INTD_enum_scanType scanType, IOSCANPVT *ioIntScan, epicsMutexId mutexId, epicsEventId eventId)
 {
     ptr_dataBuf = NULL;
+    var_sharedBuf = 0;
     fun_maniCallback(recordType, callback); 
     node = INTD_API_createDataNode(moduleName, dataName, supStr, unitStr, (void *)(dataPtr), privatePtr, pointNum, ioIntScan, INTD_ULONG, rCallback, wCallback, mutexId, eventId, recordType, scanType);  
 }
@@ -95,6 +102,7 @@ LocalPV::LocalPV(const char *moduleName, const char *dataName, const char *supSt
 LocalPV::LocalPV(const char *moduleName, const char *dataName, const char *supStr, const char *unitStr, volatile epicsFloat32 *dataPtr, unsigned int pointNum, void *privatePtr, INTD_CALLBACK callback, INTD_enum_recordType recordType, INTD_enum_scanType scanType, IOSCANPVT *ioIntScan, epicsMutexId mutexId, epicsEventId eventId)
 {
     ptr_dataBuf = NULL;
+    var_sharedBuf = 0;
     fun_maniCallback(recordType, callback); 
     node = INTD_API_createDataNode(moduleName, dataName, supStr, unitStr, (void *)(dataPtr), privatePtr, pointNum, ioIntScan, INTD_FLOAT, rCallback, wCallback, mutexId, eventId, recordType, scanType);  
 }
@@ -102,6 +110,7 @@ LocalPV::LocalPV(const char *moduleName, const char *dataName, const char *supSt
 LocalPV::LocalPV(const char *moduleName, const char *dataName, const char *supStr, const char *unitStr, volatile epicsFloat64 *dataPtr, unsigned int pointNum, void *privatePtr, INTD_CALLBACK callback, INTD_enum_recordType recordType, INTD_enum_scanType scanType, IOSCANPVT *ioIntScan, epicsMutexId mutexId, epicsEventId eventId)
 {
     ptr_dataBuf = NULL;
+    var_sharedBuf = 0;
     fun_maniCallback(recordType, callback); 
     node = INTD_API_createDataNode(moduleName, dataName, supStr, unitStr, (void *)(dataPtr), privatePtr, pointNum, ioIntScan, INTD_DOUBLE, rCallback, wCallback, mutexId, eventId, recordType, scanType);  
 }
@@ -109,6 +118,7 @@ LocalPV::LocalPV(const char *moduleName, const char *dataName, const char *supSt
 LocalPV::LocalPV(const char *moduleName, const char *dataName, const char *supStr, const char *unitStr, volatile epicsOldString *dataPtr, unsigned int pointNum, void *privatePtr, INTD_CALLBACK callback, INTD_enum_recordType recordType, INTD_enum_scanType scanType, IOSCANPVT *ioIntScan, epicsMutexId mutexId, epicsEventId eventId)
 {
     ptr_dataBuf = NULL;
+    var_sharedBuf = 0;
     fun_maniCallback(recordType, callback);
     node = INTD_API_createDataNode(moduleName, dataName, supStr, unitStr, (void *)(dataPtr), privatePtr, pointNum, ioIntScan, INTD_OLDSTRING, rCallback, wCallback, mutexId, eventId, recordType, scanType);
 }
@@ -118,7 +128,7 @@ LocalPV::LocalPV(const char *moduleName, const char *dataName, const char *supSt
 //-----------------------------------------------
 LocalPV::~LocalPV() 
 {
-    if(ptr_dataBuf)
+    if(ptr_dataBuf && !var_sharedBuf)
         free(ptr_dataBuf);
 }
 
@@ -183,7 +193,8 @@ void LocalPV::init( string                  moduleName,
                     INTD_enum_scanType      scanType,
                     IOSCANPVT              *ioIntScan,
                     epicsMutexId            mutexId,
-                    epicsEventId            eventId)
+                    epicsEventId            eventId,
+                    string                  scanEvent)
 {
     unsigned int dataSize;
 
@@ -204,21 +215,7 @@ void LocalPV::init( string                  moduleName,
     fun_maniCallback(recordType, callback);
 
     // get data type from the record type
-    switch(recordType) {
-        case INTD_AO    :
-        case INTD_AI    : var_dataType = INTD_DOUBLE;   break;
-        case INTD_BO    :
-        case INTD_BI    : var_dataType = INTD_USHORT;   break;
-        case INTD_LO    :
-        case INTD_LI    : var_dataType = INTD_LONG;     break;
-        case INTD_MBBO  :
-        case INTD_MBBI  : var_dataType = INTD_USHORT;   break;
-        case INTD_WFO   :
-        case INTD_WFI   : var_dataType = var_wfDataType;break;
-        case INTD_SO    :
-        case INTD_SI    : var_dataType = INTD_CHAR;     break;
-        default         : var_dataType = INTD_DOUBLE;   break;
-    }
+    var_dataType = fun_getDataType(recordType, var_wfDataType);
 
     // get data size from the data type
     dataSize = fun_getDataSize(var_dataType);
@@ -234,25 +231,139 @@ void LocalPV::init( string                  moduleName,
         memset(ptr_dataBuf, 0, dataSize * pointNum);
 
         // create the data node
-        node = INTD_API_createDataNode( var_moduleName.c_str(), 
-                                        var_dataName.c_str(), 
-                                        var_supStr.c_str(), 
-                                        var_unitStr.c_str(), 
-                                        ptr_dataBuf, 
-                                        ptr_privatePtr, 
-                                        var_pointNum, 
-                                        ptr_ioIntScan, 
-                                        var_dataType, 
-                                        rCallback, 
-                                        wCallback, 
-                                        var_mutexId, 
-                                        var_eventId, 
-                                        var_recordType, 
-                                        var_scanType);  
-
-        // check the success of creation
-        if(node)
-            var_onceCreated = 1;
+        fun_createNode(scanEvent.c_str());
+    }
+}
+
+//-----------------------------------------------
+// init the local PVs of a table (LocalPVTable.h) in one pass. the buffers
+// of all PVs are allocated in one block, owned by the PV with the first
+// buffer. the names are built without temporary strings.
+// return:
+//      number of the PVs failed to be created
+//-----------------------------------------------
+#define LPV_TABLE_ALIGN     8                                           // alignment of the buffers in the block
+
+int LocalPV::initTable( const char             *moduleName,
+                        const char             *devName,
+                        void                   *privatePtr,
+                        epicsEventId            eventId,
+                        const LPV_struc_pvInit *items,
+                        unsigned int            num)
+{
+    unsigned int i, dataSize, failed = 0;
+    size_t       blockSize = 0, offset = 0;
+    char        *block;
+    char         dataName[256];
+    LocalPV     *pv;
+
+    if(!moduleName || !devName || !items || num == 0)
+        return num;
+
+    // the data types and the size of the block
+    for(i = 0; i < num; i ++) {
+        pv                  = items[i].pv;
+        pv -> var_dataType  = fun_getDataType(items[i].recordType, items[i].wfDataType);
+        dataSize            = pv -> fun_getDataSize(pv -> var_dataType) * items[i].pointNum;
+        blockSize          += (dataSize + LPV_TABLE_ALIGN - 1) & ~(size_t)(LPV_TABLE_ALIGN - 1);
+    }
+
+    if(blockSize == 0 || !(block = (char *)calloc(1, blockSize))) {
+        printf("LocalPV::initTable: Failed to allocate the buffers of %s.%s\n", moduleName, devName);
+        return num;
+    }
+
+    // init the PVs and create the nodes
+    for(i = 0; i < num; i ++) {
+        pv       = items[i].pv;
+        dataSize = pv -> fun_getDataSize(pv -> var_dataType) * items[i].pointNum;
+
+        if(dataSize == 0 || !items[i].valName) {
+            failed ++;
+            continue;
+        }
+
+        snprintf(dataName, sizeof(dataName), "%s|%s", devName, items[i].valName);
+
+        pv -> var_moduleName.assign (moduleName);
+        pv -> var_dataName.assign   (dataName);
+        pv -> var_supStr.assign     (items[i].supStr  ? items[i].supStr  : "");
+        pv -> var_unitStr.assign    (items[i].unitStr ? items[i].unitStr : "");
+
+        pv -> var_pointNum      = items[i].pointNum;
+        pv -> ptr_privatePtr    = privatePtr;
+        pv -> var_recordType    = items[i].recordType;
+        pv -> var_scanType      = items[i].scanType;
+        pv -> ptr_ioIntScan     = items[i].ioIntScan;
+        pv -> var_mutexId       = items[i].mutexId;
+        pv -> var_eventId       = eventId;
+        pv -> var_wfDataType    = items[i].wfDataType;
+
+        pv -> ptr_dataBuf       = block + offset;
+        pv -> var_sharedBuf     = offset != 0;                          // the first buffer frees the block
+        offset                 += (dataSize + LPV_TABLE_ALIGN - 1) & ~(size_t)(LPV_TABLE_ALIGN - 1);
+
+        pv -> fun_maniCallback(items[i].recordType, items[i].callback);
+        pv -> fun_createNode(items[i].scanEvent ? items[i].scanEvent : "");
+
+        if(!pv -> var_onceCreated)
+            failed ++;
+    }
+
+    return failed;
+}
+
+//-----------------------------------------------
+// create the data node with the buffer and the settings of the object
+//-----------------------------------------------
+void LocalPV::fun_createNode(const char *scanEvent)
+{
+    node = INTD_API_createDataNode( var_moduleName.c_str(), 
+                                    var_dataName.c_str(), 
+                                    var_supStr.c_str(), 
+                                    var_unitStr.c_str(), 
+                                    ptr_dataBuf, 
+                                    ptr_privatePtr, 
+                                    var_pointNum, 
+                                    ptr_ioIntScan, 
+                                    var_dataType, 
+                                    rCallback, 
+                                    wCallback, 
+                                    var_mutexId, 
+                                    var_eventId, 
+                                    var_recordType, 
+                                    var_scanType);  
+
+    // check the success of creation
+    if(node)
+        var_onceCreated = 1;
+
+    // event name of the event scan
+    if(node && var_scanType == INTD_EVENT)
+        INTD_API_setScanEvent(node, scanEvent);
+}
+
+//-----------------------------------------------
+// data type of the buffer from the record type
+//-----------------------------------------------
+INTD_enum_dataType LocalPV::fun_getDataType(INTD_enum_recordType recordType, INTD_enum_dataType wfDataType)
+{
+    switch(recordType) {
+        case INTD_AO    :
+        case INTD_AI    : return INTD_DOUBLE;
+        case INTD_BO    :
+        case INTD_BI    : return INTD_USHORT;
+        case INTD_LO    :
+        case INTD_LI    : return INTD_LONG;
+        case INTD_MBBO  :
+        case INTD_MBBI  : return INTD_USHORT;
+        case INTD_WFO   :
+        case INTD_WFI   : return wfDataType;
+        case INTD_SO    :
+        case INTD_SI    :
+        case INTD_LSO   :
+        case INTD_LSI   : return INTD_CHAR;
+        default         : return INTD_DOUBLE;
     }
 }
 
@@ -262,20 +373,21 @@ void LocalPV::init( string                  moduleName,
 //-----------------------------------------------
 #define LPV_VAL_READ(dtp)                                                               \
     {dtp val = 0;                                                                       \
+    unsigned int seq;                                                                   \
                                                                                         \
     if(!var_onceCreated ) return 0;                                                     \
                                                                                         \
-    if(var_mutexId) epicsMutexMustLock(var_mutexId);                                    \
+    do {                                                                                \
+        seq = INTD_API_readBegin(node);                                                 \
                                                                                         \
-    switch(var_recordType) {                                                            \
-        case INTD_AO    : val = (dtp)(*((epicsFloat64 *)ptr_dataBuf)); break;           \
-        case INTD_BO    : val = (dtp)(*((epicsUInt16  *)ptr_dataBuf)); break;           \
-        case INTD_LO    : val = (dtp)(*((epicsInt32   *)ptr_dataBuf)); break;           \
-        case INTD_MBBO  : val = (dtp)(*((epicsUInt16  *)ptr_dataBuf)); break;           \
-        default: break;                                                                 \
-    }                                                                                   \
-                                                                                        \
-    if(var_mutexId) epicsMutexUnlock(var_mutexId);                                      \
+        switch(var_recordType) {                                                        \
+            case INTD_AO    : val = (dtp)(*((epicsFloat64 *)ptr_dataBuf)); break;       \
+            case INTD_BO    : val = (dtp)(*((epicsUInt16  *)ptr_dataBuf)); break;       \
+            case INTD_LO    : val = (dtp)(*((epicsInt32   *)ptr_dataBuf)); break;       \
+            case INTD_MBBO  : val = (dtp)(*((epicsUInt16  *)ptr_dataBuf)); break;       \
+            default: break;                                                             \
+        }                                                                               \
+    } while(INTD_API_readRetry(node, seq));                                             \
                                                                                         \
     return val;}
 
@@ -290,6 +402,10 @@ epicsFloat64    LocalPV::getValueFloat64 () {LPV_VAL_READ(epicsFloat64)}
 
 int LocalPV::getValueString(char *strOut)                                       // return value is the number of char copied
 {
+    // the long string is copied with the size of the PV, the buffer must be large enough
+    if(var_onceCreated && var_recordType == INTD_LSO)
+        return getValueString(strOut, var_pointNum);
+
     // check the data buffer, record type and input
     if(!strOut || !var_onceCreated || var_recordType != INTD_SO)
         return 0;
@@ -300,48 +416,99 @@ int LocalPV::getValueString(char *strOut)
     return strlen(strOut);
 }
 
+int LocalPV::getValueString(char *strOut, unsigned int size)                    // size of the buffer with the terminating 0
+{
+    int len;
+
+    // check the data buffer, record type and input
+    if(!strOut || size == 0 || !var_onceCreated)
+        return 0;
+
+    if(var_recordType == INTD_SO) {
+        strncpy(strOut, (char *)ptr_dataBuf, size - 1);
+        strOut[size - 1] = '\0';
+        return strlen(strOut);
+    }
+
+    if(var_recordType != INTD_LSO)
+        return 0;
+
+    // copy the characters of the string only
+    len = INTD_API_getString(node, strOut, size);
+
+    return len > 0 ? len : 0;
+}
+
 string LocalPV::getValueString()
 {
     string strOut("");    
+    int    len;
 
     // check record type and input
-    if(!var_onceCreated || var_recordType != INTD_SO)
+    if(!var_onceCreated || (var_recordType != INTD_SO && var_recordType != INTD_LSO))
         return strOut;
 
     // copy the data
-    strOut.assign((char *)ptr_dataBuf);
+    if(var_recordType == INTD_LSO) {
+        strOut.resize(var_pointNum);
+        len = INTD_API_getString(node, &strOut[0], var_pointNum);
+        strOut.resize(len > 0 ? len : 0);
+    } else {
+        strOut.assign((char *)ptr_dataBuf);
+    }
 
     return strOut;
 }
 
 double LocalPV::getField(string fieldName)
 {
-    int status;
-    char data[128];
-
     // check 
     if(!node || fieldName.empty()) 
         return -1.0e12;
 
-    // get one value
-    status = INTD_API_getFieldData(node, fieldName.c_str(), (void *)data, 1);
+    // the field is resolved at the first call and then taken from the cache of the node
+    return getField(INTD_API_getFieldHandle(node, fieldName.c_str()));
+}
+
+int LocalPV::putField(string fieldName, double data)
+{
+    // check 
+    if(!node || fieldName.empty()) 
+        return 1;
 
-    if(status == 0)
-        return *((double *)data);
+    // put the field
+    return putField(INTD_API_getFieldHandle(node, fieldName.c_str()), data);
+}
+
+//-----------------------------------------------
+// access the fields with the handles resolved once, e.g. before a loop
+//-----------------------------------------------
+INTD_struc_fieldHandle *LocalPV::getFieldHandle(string fieldName)
+{
+    if(!node || fieldName.empty()) 
+        return NULL;
+
+    return INTD_API_getFieldHandle(node, fieldName.c_str());
+}
+
+double LocalPV::getField(INTD_struc_fieldHandle *handle)
+{
+    double data;
+
+    if(INTD_API_getFieldDouble(handle, &data) == 0)
+        return data;
     else
         return -1.0e13;
 }
 
-int LocalPV::putField(string fieldName, double data)
+int LocalPV::putField(INTD_struc_fieldHandle *handle, double data)
 {
     double localData = data;
 
-    // check 
-    if(!node || fieldName.empty()) 
+    if(!handle)
         return 1;
 
-    // put the field
-    return INTD_API_putFieldData(node, fieldName.c_str(), &localData, 1);
+    return INTD_API_putFieldByHandle(handle, &localData, 1);
 }
 
 //-----------------------------------------------
@@ -360,7 +527,7 @@ int LocalPV::setValue(epicsFloat64 dataIn)
         return 1;
 
     // set the data based on record type
-    if(var_mutexId) epicsMutexMustLock(var_mutexId);
+    INTD_API_writeBegin(node);
 
     switch(var_recordType) {
         case INTD_AI    : *((epicsFloat64 *)ptr_dataBuf) =              dataIn; break;
@@ -370,7 +537,11 @@ int LocalPV::setValue(epicsFloat64 dataIn)
         default: status = 1; break;            
     }
 
-    if(var_mutexId) epicsMutexUnlock(var_mutexId);
+    INTD_API_writeEnd(node);
+
+    // wait-free append to the history, unrolled when the history PVs are scanned
+    if(node -> history && status == 0)
+        INTD_API_historyAppend(node, dataIn, NULL);
 
     return status;
 }
@@ -403,14 +574,21 @@ int LocalPV::setValue(epicsFloat64 dataIn, LPV_enum_BIAlarm alarmSel)
 }
 
 //-----------------------------------------------
-// set value of a string input PV
+// set value of a string input PV (stringin or lsi). the long string is
+// truncated to the size of the PV
 // return:
 //      0 - success; 1 - failure (wrong buffer or PV type not supported)
 //-----------------------------------------------
 int LocalPV::setString(char *strIn)
 {
+    if(!strIn)
+        return 1;
+
+    if(var_onceCreated && var_recordType == INTD_LSI)
+        return setString(strIn, strlen(strIn));
+
     // check the data buffer, record type and input
-    if(!strIn || !var_onceCreated || var_recordType != INTD_SI)
+    if(!var_onceCreated || var_recordType != INTD_SI)
         return 1;
 
     // copy the data
@@ -421,6 +599,9 @@ int LocalPV::setString(char *strIn)
 
 int LocalPV::setString(string strIn)
 {
+    if(var_onceCreated && var_recordType == INTD_LSI)
+        return setString(strIn.data(), strIn.size());
+
     // check the data buffer, record type and input
     if(!var_onceCreated || var_recordType != INTD_SI)
         return 1;
@@ -431,6 +612,30 @@ int LocalPV::setString(string strIn)
     return 0;
 }
 
+int LocalPV::setString(const char *strIn, unsigned int len)                    // the length is known, no strlen
+{
+    // check the data buffer, record type and input
+    if(!strIn || !var_onceCreated)
+        return 1;
+
+    if(var_recordType == INTD_SI) {
+        if(len > MAX_STRING_SIZE - 1) len = MAX_STRING_SIZE - 1;
+
+        INTD_API_writeBegin(node);
+        memcpy(ptr_dataBuf, strIn, len);
+        ((char *)ptr_dataBuf)[len] = '\0';
+        INTD_API_writeEnd(node);
+
+        return 0;
+    }
+
+    if(var_recordType != INTD_LSI)
+        return 1;
+
+    // one bounded copy to the node, the length is kept for the lsi record
+    return INTD_API_putString(node, strIn, len) >= 0 ? 0 : 1;
+}
+
 //-----------------------------------------------
 // get data from a  waveform out PV without datatype conversion. 
 // the return value is the number of points that is actually read
@@ -439,6 +644,8 @@ int LocalPV::getValuesRaw(void *dataOut, unsigned int pointNum)
 {
     unsigned int pno = pointNum;
     unsigned int dataSize;
+    unsigned int seq;
+    void        *buf;
 
     // check the input, data buffer and record type
     if(!dataOut || pointNum == 0 || !var_onceCreated || var_recordType != INTD_WFO)
@@ -455,28 +662,38 @@ int LocalPV::getValuesRaw(void *dataOut, unsigned int pointNum)
         return 0;    
 
     // copy the data
-    if(var_mutexId) epicsMutexMustLock(var_mutexId);
-    memcpy(dataOut, ptr_dataBuf, pno * dataSize);
-    if(var_mutexId) epicsMutexUnlock(var_mutexId);
+    do {
+        seq = INTD_API_readBegin(node);
+        buf = INTD_API_readBuffer(node);
+        memcpy(dataOut, buf, pno * dataSize);
+    } while(INTD_API_readRetry(node, seq));
 
     return pno;
 }
 
+//-----------------------------------------------
+// get a slice of a waveform out PV without datatype conversion. 
+// the return value is the number of points that is actually read
+//-----------------------------------------------
+int LocalPV::getValuesRaw(void *dataOut, unsigned int offset, unsigned int pointNum)
+{
+    int pno;
+
+    // check the input, data buffer and record type
+    if(!dataOut || pointNum == 0 || !var_onceCreated || var_recordType != INTD_WFO)
+        return 0;
+
+    pno = INTD_API_getDataRange(node, offset, pointNum, dataOut);
+
+    return pno > 0 ? pno : 0;
+}
+
 //-----------------------------------------------
 // get a waveform out data with type conversion. 
 // the return value is the number of points that is actually read
 //-----------------------------------------------
-#define LPV_WF_READ(dtp)                                                        \
-    {unsigned int    i, pno = pointNum;                                         \
-                                                                                \
-    epicsInt8      *pValueChar;                                                 \
-    epicsUInt8     *pValueUChar;                                                \
-    epicsInt16     *pValueShort;                                                \
-    epicsUInt16    *pValueUShort;                                               \
-    epicsInt32     *pValueLong;                                                 \
-    epicsUInt32    *pValueULong;                                                \
-    epicsFloat32   *pValueFloat;                                                \
-    epicsFloat64   *pValueDouble;                                               \
+#define LPV_WF_READ(intdType)                                                   \
+    {unsigned int    pno = pointNum, seq;                                       \
                                                                                 \
     if(!dataOut || pointNum == 0 || !var_onceCreated                            \
         || var_recordType != INTD_WFO)                                          \
@@ -485,76 +702,23 @@ int LocalPV::getValuesRaw(void *dataOut, unsigned int pointNum)
     if(pno > var_pointNum)                                                      \
         pno = var_pointNum;                                                     \
                                                                                 \
-    if(var_mutexId) epicsMutexMustLock(var_mutexId);                            \
-                                                                                \
-    switch(var_dataType) {                                                      \
-        case INTD_CHAR      :                                                   \
-            pValueChar     = (epicsInt8 *)ptr_dataBuf;                          \
-            for(i = 0; i < pno; i ++)                                           \
-                dataOut[i] = (dtp)pValueChar[i];                                \
-            break;                                                              \
-                                                                                \
-        case INTD_UCHAR     :                                                   \
-            pValueUChar    = (epicsUInt8 *)ptr_dataBuf;                         \
-            for(i = 0; i < pno; i ++)                                           \
-                dataOut[i] = (dtp)pValueUChar[i];                               \
-            break;                                                              \
-                                                                                \
-        case INTD_SHORT     :                                                   \
-            pValueShort    = (epicsInt16 *)ptr_dataBuf;                         \
-            for(i = 0; i < pno; i ++)                                           \
-                dataOut[i] = (dtp)pValueShort[i];                               \
-            break;                                                              \
-                                                                                \
-        case INTD_USHORT    :                                                   \
-            pValueUShort   = (epicsUInt16 *)ptr_dataBuf;                        \
-            for(i = 0; i < pno; i ++)                                           \
-                dataOut[i] = (dtp)pValueUShort[i];                              \
-            break;                                                              \
-                                                                                \
-        case INTD_INT       :                                                   \
-        case INTD_LONG      :                                                   \
-            pValueLong     = (epicsInt32 *)ptr_dataBuf;                         \
-            for(i = 0; i < pno; i ++)                                           \
-                dataOut[i] = (dtp)pValueLong[i];                                \
-            break;                                                              \
-                                                                                \
-        case INTD_UINT      :                                                   \
-        case INTD_ULONG     :                                                   \
-            pValueULong    = (epicsUInt32 *)ptr_dataBuf;                        \
-            for(i = 0; i < pno; i ++)                                           \
-                dataOut[i] = (dtp)pValueULong[i];                               \
-            break;                                                              \
-                                                                                \
-        case INTD_FLOAT     :                                                   \
-            pValueFloat    = (epicsFloat32 *)ptr_dataBuf;                       \
-            for(i = 0; i < pno; i ++)                                           \
-                dataOut[i] = (dtp)pValueFloat[i];                               \
-            break;                                                              \
-                                                                                \
-        case INTD_DOUBLE    :                                                   \
-            pValueDouble   = (epicsFloat64 *)ptr_dataBuf;                       \
-            for(i = 0; i < pno; i ++)                                           \
-                dataOut[i] = (dtp)pValueDouble[i];                              \
-            break;                                                              \
-                                                                                \
-        default :                                                               \
-            pno = 0;                                                            \
-            break;                                                              \
-    }                                                                           \
-                                                                                \
-    if(var_mutexId) epicsMutexUnlock(var_mutexId);                              \
+    do {                                                                        \
+    seq = INTD_API_readBegin(node);                                             \
+    if(INTD_API_vecConvert(intdType, dataOut, var_dataType,                     \
+                           INTD_API_readBuffer(node), pno) != 0)                \
+        pno = 0;                                                                \
+    } while(INTD_API_readRetry(node, seq));                                     \
                                                                                 \
     return pno;}
 
-int LocalPV::getValues(epicsInt8     *dataOut, unsigned int pointNum) {LPV_WF_READ(epicsInt8)}
-int LocalPV::getValues(epicsUInt8    *dataOut, unsigned int pointNum) {LPV_WF_READ(epicsUInt8)}
-int LocalPV::getValues(epicsInt16    *dataOut, unsigned int pointNum) {LPV_WF_READ(epicsInt16)}
-int LocalPV::getValues(epicsUInt16   *dataOut, unsigned int pointNum) {LPV_WF_READ(epicsUInt16)}
-int LocalPV::getValues(epicsInt32    *dataOut, unsigned int pointNum) {LPV_WF_READ(epicsInt32)}
-int LocalPV::getValues(epicsUInt32   *dataOut, unsigned int pointNum) {LPV_WF_READ(epicsUInt32)}
-int LocalPV::getValues(epicsFloat32  *dataOut, unsigned int pointNum) {LPV_WF_READ(epicsFloat32)}
-int LocalPV::getValues(epicsFloat64  *dataOut, unsigned int pointNum) {LPV_WF_READ(epicsFloat64)}
+int LocalPV::getValues(epicsInt8     *dataOut, unsigned int pointNum) {LPV_WF_READ(INTD_CHAR)}
+int LocalPV::getValues(epicsUInt8    *dataOut, unsigned int pointNum) {LPV_WF_READ(INTD_UCHAR)}
+int LocalPV::getValues(epicsInt16    *dataOut, unsigned int pointNum) {LPV_WF_READ(INTD_SHORT)}
+int LocalPV::getValues(epicsUInt16   *dataOut, unsigned int pointNum) {LPV_WF_READ(INTD_USHORT)}
+int LocalPV::getValues(epicsInt32    *dataOut, unsigned int pointNum) {LPV_WF_READ(INTD_LONG)}
+int LocalPV::getValues(epicsUInt32   *dataOut, unsigned int pointNum) {LPV_WF_READ(INTD_ULONG)}
+int LocalPV::getValues(epicsFloat32  *dataOut, unsigned int pointNum) {LPV_WF_READ(INTD_FLOAT)}
+int LocalPV::getValues(epicsFloat64  *dataOut, unsigned int pointNum) {LPV_WF_READ(INTD_DOUBLE)}
 
 //-----------------------------------------------
 // set a waveform in data. the return value is the number of points that is actually writen
@@ -580,28 +744,38 @@ int LocalPV::setValuesRaw(void *dataIn, unsigned int pointNum)
         return 0;    
 
     // copy the data
-    if(var_mutexId) epicsMutexMustLock(var_mutexId);
-    memcpy(ptr_dataBuf, dataIn, pno * dataSize);
-    if(var_mutexId) epicsMutexUnlock(var_mutexId);
+    INTD_API_writeBegin(node);
+    memcpy(INTD_API_writeBuffer(node), dataIn, pno * dataSize);
+    INTD_API_writeEnd(node);
 
     return pno;
 }
 
+//-----------------------------------------------
+// set a slice of a waveform (e.g. one channel of a multiplexed buffer).
+// with setDirtyRange() only the changed points are copied to the record
+// and handled by publish(). the return value is the number of points that
+// is actually writen, there is no data conversion here
+//-----------------------------------------------
+int LocalPV::setValuesRaw(void *dataIn, unsigned int offset, unsigned int pointNum)
+{
+    int pno;
+
+    // check the input, data buffer and record type
+    if(!dataIn || pointNum == 0 || !var_onceCreated || var_recordType != INTD_WFI)
+        return 0;
+
+    pno = INTD_API_putDataRange(node, offset, pointNum, dataIn);
+
+    return pno > 0 ? pno : 0;
+}
+
 //-----------------------------------------------
 // set a waveform in data. the return value is the number of points that is actually writen
 // the data type will be converted
 //-----------------------------------------------
-#define LPV_WF_WRITE(dtp)                                                       \
-    {unsigned int    i, pno = pointNum;                                         \
-                                                                                \
-    epicsInt8      *pValueChar;                                                 \
-    epicsUInt8     *pValueUChar;                                                \
-    epicsInt16     *pValueShort;                                                \
-    epicsUInt16    *pValueUShort;                                               \
-    epicsInt32     *pValueLong;                                                 \
-    epicsUInt32    *pValueULong;                                                \
-    epicsFloat32   *pValueFloat;                                                \
-    epicsFloat64   *pValueDouble;                                               \
+#define LPV_WF_WRITE(intdType)                                                  \
+    {unsigned int    pno = pointNum;                                            \
                                                                                 \
     if(!dataIn || pointNum == 0 || !var_onceCreated                             \
        || var_recordType != INTD_WFI)                                           \
@@ -610,76 +784,23 @@ int LocalPV::setValuesRaw(void *dataIn, unsigned int pointNum)
     if(pno > var_pointNum)                                                      \
         pno = var_pointNum;                                                     \
                                                                                 \
-    if(var_mutexId) epicsMutexMustLock(var_mutexId);                            \
-                                                                                \
-    switch(var_dataType) {                                                      \
-        case INTD_CHAR      :                                                   \
-            pValueChar     = (epicsInt8 *)ptr_dataBuf;                          \
-            for(i = 0; i < pno; i ++)                                           \
-                pValueChar[i] = (dtp)dataIn[i];                                 \
-            break;                                                              \
-                                                                                \
-        case INTD_UCHAR     :                                                   \
-            pValueUChar    = (epicsUInt8 *)ptr_dataBuf;                         \
-            for(i = 0; i < pno; i ++)                                           \
-                pValueUChar[i] = (dtp)dataIn[i];                                \
-            break;                                                              \
-                                                                                \
-        case INTD_SHORT     :                                                   \
-            pValueShort    = (epicsInt16 *)ptr_dataBuf;                         \
-            for(i = 0; i < pno; i ++)                                           \
-                pValueShort[i] = (dtp)dataIn[i];                                \
-            break;                                                              \
-                                                                                \
-        case INTD_USHORT    :                                                   \
-            pValueUShort   = (epicsUInt16 *)ptr_dataBuf;                        \
-            for(i = 0; i < pno; i ++)                                           \
-                pValueUShort[i] = (dtp)dataIn[i];                               \
-            break;                                                              \
-                                                                                \
-        case INTD_INT       :                                                   \
-        case INTD_LONG      :                                                   \
-            pValueLong     = (epicsInt32 *)ptr_dataBuf;                         \
-            for(i = 0; i < pno; i ++)                                           \
-                pValueLong[i] = (dtp)dataIn[i];                                 \
-            break;                                                              \
-                                                                                \
-        case INTD_UINT      :                                                   \
-        case INTD_ULONG     :                                                   \
-            pValueULong    = (epicsUInt32 *)ptr_dataBuf;                        \
-            for(i = 0; i < pno; i ++)                                           \
-                pValueULong[i] = (dtp)dataIn[i];                                \
-            break;                                                              \
-                                                                                \
-        case INTD_FLOAT     :                                                   \
-            pValueFloat    = (epicsFloat32 *)ptr_dataBuf;                       \
-            for(i = 0; i < pno; i ++)                                           \
-                pValueFloat[i] = (dtp)dataIn[i];                                \
-            break;                                                              \
-                                                                                \
-        case INTD_DOUBLE    :                                                   \
-            pValueDouble   = (epicsFloat64 *)ptr_dataBuf;                       \
-            for(i = 0; i < pno; i ++)                                           \
-                pValueDouble[i] = (dtp)dataIn[i];                               \
-            break;                                                              \
-                                                                                \
-        default :                                                               \
-            pno = 0;                                                            \
-            break;                                                              \
-    }                                                                           \
-                                                                                \
-    if(var_mutexId) epicsMutexUnlock(var_mutexId);                              \
+    if(pno == var_pointNum) INTD_API_writeBeginFull(node);                      \
+    else                    INTD_API_writeBegin(node);                          \
+    if(INTD_API_vecConvert(var_dataType, INTD_API_writeBuffer(node),            \
+                           intdType, dataIn, pno) != 0)                         \
+        pno = 0;                                                                \
+    INTD_API_writeEnd(node);                                                    \
                                                                                 \
     return pno;}
 
-int LocalPV::setValues(epicsInt8     *dataIn, unsigned int pointNum) {LPV_WF_WRITE(epicsInt8)}
-int LocalPV::setValues(epicsUInt8    *dataIn, unsigned int pointNum) {LPV_WF_WRITE(epicsUInt8)}
-int LocalPV::setValues(epicsInt16    *dataIn, unsigned int pointNum) {LPV_WF_WRITE(epicsInt16)}
-int LocalPV::setValues(epicsUInt16   *dataIn, unsigned int pointNum) {LPV_WF_WRITE(epicsUInt16)}
-int LocalPV::setValues(epicsInt32    *dataIn, unsigned int pointNum) {LPV_WF_WRITE(epicsInt32)}
-int LocalPV::setValues(epicsUInt32   *dataIn, unsigned int pointNum) {LPV_WF_WRITE(epicsUInt32)}
-int LocalPV::setValues(epicsFloat32  *dataIn, unsigned int pointNum) {LPV_WF_WRITE(epicsFloat32)}
-int LocalPV::setValues(epicsFloat64  *dataIn, unsigned int pointNum) {LPV_WF_WRITE(epicsFloat64)}
+int LocalPV::setValues(epicsInt8     *dataIn, unsigned int pointNum) {LPV_WF_WRITE(INTD_CHAR)}
+int LocalPV::setValues(epicsUInt8    *dataIn, unsigned int pointNum) {LPV_WF_WRITE(INTD_UCHAR)}
+int LocalPV::setValues(epicsInt16    *dataIn, unsigned int pointNum) {LPV_WF_WRITE(INTD_SHORT)}
+int LocalPV::setValues(epicsUInt16   *dataIn, unsigned int pointNum) {LPV_WF_WRITE(INTD_USHORT)}
+int LocalPV::setValues(epicsInt32    *dataIn, unsigned int pointNum) {LPV_WF_WRITE(INTD_LONG)}
+int LocalPV::setValues(epicsUInt32   *dataIn, unsigned int pointNum) {LPV_WF_WRITE(INTD_ULONG)}
+int LocalPV::setValues(epicsFloat32  *dataIn, unsigned int pointNum) {LPV_WF_WRITE(INTD_FLOAT)}
+int LocalPV::setValues(epicsFloat64  *dataIn, unsigned int pointNum) {LPV_WF_WRITE(INTD_DOUBLE)}
 
 //-----------------------------------------------
 // manipulate the callback functions
@@ -693,6 +814,7 @@ void LocalPV::fun_maniCallback(INTD_enum_recordType recordType, INTD_CALLBACK ca
         case INTD_MBBO  :
         case INTD_WFO   :
         case INTD_SO    :
+        case INTD_LSO   :
             rCallback = NULL;
             wCallback = callback;
             break;
@@ -703,6 +825,7 @@ void LocalPV::fun_maniCallback(INTD_enum_recordType recordType, INTD_CALLBACK ca
         case INTD_MBBI  :
         case INTD_WFI   :
         case INTD_SI    :
+        case INTD_LSI   :
             rCallback = callback;
             wCallback = NULL;
             break;
@@ -779,6 +902,162 @@ int LocalPV::setAlias(const char *aliasStr)
     return INTD_API_setAlias(node, aliasStr);
 }
 
+//-----------------------------------------------
+// select the locking strategy of the data buffer. INTD_LOCK_SEQLOCK lets the
+// record processing read the value without blocking the writer, only for
+// scalars and small arrays. call it after init()
+//-----------------------------------------------
+int LocalPV::setLockMode(INTD_enum_lockMode lockMode)
+{
+    if(!node)
+        return 1;
+
+    return INTD_API_setLockMode(node, lockMode);
+}
+
+//-----------------------------------------------
+// track the range of a waveform PV changed by setValuesRaw(data, offset, num),
+// the record copies and publish() checks only the changed points. the other
+// writes mark the whole waveform. call it after init(), mutex mode only
+//-----------------------------------------------
+int LocalPV::setDirtyRange()
+{
+    if(!node)
+        return 1;
+
+    return INTD_API_enableDirtyRange(node);
+}
+
+//-----------------------------------------------
+// move the buffer of a waveform PV to a named shared memory segment, so a
+// process outside of the IOC writes (WFI) or reads (WFO) it in place with
+// InternalData_shm.h. a WFI PV is published when the producer updates it.
+// call it after init() and before iocInit, the local buffer is not used
+// any more
+//-----------------------------------------------
+int LocalPV::setSharedMemory(const char *segName)
+{
+    if(!node || !segName)
+        return 1;
+
+    return INTD_API_shmAttach(node, segName);
+}
+
+//-----------------------------------------------
+// request the I/O Intr scan of the PV through the rate limited publisher
+// of InternalData. requests within 1/maxRate are merged into one scan.
+// with change detection (setDeadband), the scan is only requested if
+// the value moved out of the deadband (returns 1 if suppressed)
+//-----------------------------------------------
+int LocalPV::publish()
+{
+    if(!node || !node -> ioIntScan)
+        return 1;
+
+    return INTD_API_publishNode(node);
+}
+
+int LocalPV::setPublishRate(double maxRate)
+{
+    if(!node || !node -> ioIntScan)
+        return 1;
+
+    return INTD_API_setPublishRate(node -> ioIntScan, maxRate);
+}
+
+//-----------------------------------------------
+// enable the change detection with the deadbands (only for scalars, arrays
+// are compared by hash)
+//-----------------------------------------------
+int LocalPV::setDeadband(double absDeadband, double relDeadband)
+{
+    if(!node)
+        return 1;
+
+    return INTD_API_setDeadband(node, absDeadband, relDeadband);
+}
+
+//-----------------------------------------------
+// execute the write callback of an output PV on the worker pool of
+// InternalData, the record stays active (PACT) until the callback is done
+//-----------------------------------------------
+int LocalPV::setAsyncWrite(int enable)
+{
+    if(!node)
+        return 1;
+
+    return INTD_API_setAsyncWrite(node, enable);
+}
+
+//-----------------------------------------------
+// execute the read callback of a periodically scanned input PV on the
+// worker pool of InternalData, the record reads the last result. budget
+// is the time (s) allowed to the callback, 0 for one scan period
+//-----------------------------------------------
+int LocalPV::setPrefetch(int enable, double budget)
+{
+    if(!node)
+        return 1;
+
+    return INTD_API_setPrefetch(node, enable, budget);
+}
+
+//-----------------------------------------------
+// declare the statistics of a waveform PV (min, max, mean, RMS, peak
+// position), created as AI PVs <name>-MIN etc. on the same scan. they are
+// computed by publish(), or by updateStats() for the periodic scans
+//-----------------------------------------------
+int LocalPV::addStats(unsigned int statMask)
+{
+    if(!node)
+        return 1;
+
+    return INTD_API_addWfStats(node, statMask);
+}
+
+int LocalPV::updateStats(unsigned int pno)
+{
+    if(!node)
+        return 1;
+
+    return INTD_API_updateWfStats(node, pno);
+}
+
+//-----------------------------------------------
+// attach a decimated view (stride, mean or min/max envelope) to a large
+// waveform PV, created as the WFI PV <name>-<suffix> on the same scan.
+// updated by publish(), or by updateViews() for the periodic scans
+//-----------------------------------------------
+int LocalPV::addView(const char *suffix, INTD_enum_wfViewType viewType, unsigned int points)
+{
+    if(!node)
+        return 1;
+
+    return INTD_API_addWfView(node, suffix, viewType, points) ? 0 : 1;
+}
+
+int LocalPV::updateViews()
+{
+    if(!node)
+        return 1;
+
+    return INTD_API_updateWfViews(node);
+}
+
+//-----------------------------------------------
+// keep the last values written by setValue (scalar PV) with their times.
+// the WFI PVs <name>-HIST and <name>-HIST-TS show them in the
+// chronological order, on the same scan as the PV. setValue must be
+// called by one thread only
+//-----------------------------------------------
+int LocalPV::addHistory(unsigned int depth)
+{
+    if(!node)
+        return 1;
+
+    return INTD_API_addHistory(node, depth);
+}
+
 int LocalPV::setAsg(const char *asgStr)
 {
     if(!asgStr || !node)
@@ -787,6 +1066,35 @@ int LocalPV::setAsg(const char *asgStr)
     return INTD_API_setAsg(node, asgStr);
 }
 
+//-----------------------------------------------
+// event scan (INTD_EVENT): set the event name of the PV before the
+// records are generated, and post the event to process all PVs of it
+//-----------------------------------------------
+int LocalPV::setScanEvent(const char *eventName)
+{
+    if(!eventName || !node)
+        return 1;
+
+    return INTD_API_setScanEvent(node, eventName);
+}
+
+//-----------------------------------------------
+// custom period scan (INTD_PERIOD): the PVs of the same period share
+// one timer, must be called before iocInit
+//-----------------------------------------------
+int LocalPV::setScanPeriod(double period)
+{
+    if(!node)
+        return 1;
+
+    return INTD_API_setScanPeriod(node, period);
+}
+
+int LocalPV::postEvent(const char *eventName)
+{
+    return INTD_API_postEvent(eventName);
+}
+
 } 
 //******************************************************
 // NAME SPACE OOEPICS
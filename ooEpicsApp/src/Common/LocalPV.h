@@ -33,6 +33,35 @@ typedef enum {
     LPV_BI_ALARM_INV        // BI value: 0 no alarm, 1 major alarm
 } LPV_enum_BIAlarm;
 
+//-----------------------------------------------
+// scoped views of the waveform buffer (LocalPVView.h)
+//-----------------------------------------------
+template<typename T> class LocalPVReadView;
+template<typename T> class LocalPVWriteView;
+
+class LocalPVGroup;                                                     // commit groups (LocalPVGroup.h)
+
+class LocalPV;
+
+//-----------------------------------------------
+// settings of a PV for the bulk creation, resolved from the static
+// table of the owner class (LocalPVTable.h)
+//-----------------------------------------------
+typedef struct {
+    LocalPV                *pv;
+    const char             *valName;
+    const char             *supStr;
+    const char             *unitStr;
+    unsigned int            pointNum;
+    INTD_CALLBACK           callback;
+    INTD_enum_recordType    recordType;
+    INTD_enum_scanType      scanType;
+    IOSCANPVT              *ioIntScan;
+    epicsMutexId            mutexId;
+    INTD_enum_dataType      wfDataType;                         // waveforms only
+    const char             *scanEvent;                          // INTD_EVENT only, NULL otherwise
+} LPV_struc_pvInit;
+
 //-----------------------------------------------
 // the class definition for local PV. It is an OO wrapper for the InternalData,
 // now only support a subset of the functions 
@@ -80,7 +109,15 @@ public:
                 INTD_enum_scanType      scanType,
                 IOSCANPVT              *ioIntScan, 
                 epicsMutexId            mutexId, 
-                epicsEventId            eventId);  
+                epicsEventId            eventId,
+                string                  scanEvent = "");                // event name (EVNT) for INTD_EVENT
+
+    static int initTable(const char             *moduleName,                // init many PVs in one pass with one buffer block,
+                         const char             *devName,                   // use LPV_initTable of LocalPVTable.h
+                         void                   *privatePtr,
+                         epicsEventId            eventId,
+                         const LPV_struc_pvInit *items,
+                         unsigned int            num);
 
     // get values and set values for the case with local data buffers
     epicsInt8       getValueInt8    ();                                 // get value of an output PV with data conversion
@@ -92,17 +129,25 @@ public:
     epicsFloat32    getValueFloat32 ();
     epicsFloat64    getValueFloat64 ();
     int             getValueString  (char *strOut);
+    int             getValueString  (char *strOut, unsigned int size);  // bounded by the size of the buffer
     string          getValueString  ();
 
     double          getField        (string fieldName);
     int             putField        (string fieldName, double data);
 
+    INTD_struc_fieldHandle *getFieldHandle(string fieldName);           // resolve a field once, use it in loops
+    double          getField        (INTD_struc_fieldHandle *handle);
+    int             putField        (INTD_struc_fieldHandle *handle, double data);
+
     int setValue (epicsFloat64 dataIn);                                 // set value of a input PV with data conversion
     int setValue (epicsFloat64 dataIn, LPV_enum_BIAlarm alarmSel);                   
-    int setString(char *strIn);                                         // set value of a stringin record
+    int setString(char *strIn);                                         // set value of a stringin or lsi record
     int setString(string strIn);
+    int setString(const char *strIn, unsigned int len);                 // the length is known, no strlen
 
     int getValuesRaw(void          *dataOut, unsigned int pointNum);    // get values of a waveform out PV without data conversion
+    int getValuesRaw(void          *dataOut, unsigned int offset,
+                     unsigned int pointNum);                            // get the points [offset, offset + pointNum) only
     int getValues   (epicsInt8     *dataOut, unsigned int pointNum);    // get values of a waveform out PV with data conversion
     int getValues   (epicsUInt8    *dataOut, unsigned int pointNum);
     int getValues   (epicsInt16    *dataOut, unsigned int pointNum);
@@ -113,6 +158,8 @@ public:
     int getValues   (epicsFloat64  *dataOut, unsigned int pointNum);
 
     int setValuesRaw(void          *dataIn, unsigned int pointNum);
+    int setValuesRaw(void          *dataIn, unsigned int offset,
+                     unsigned int pointNum);                            // set the points [offset, offset + pointNum) only, marked dirty
     int setValues   (epicsInt8     *dataIn, unsigned int pointNum);
     int setValues   (epicsUInt8    *dataIn, unsigned int pointNum);
     int setValues   (epicsInt16    *dataIn, unsigned int pointNum);
@@ -126,6 +173,34 @@ public:
     int setPrec     (unsigned int prec);
     int setAlias    (const char *aliasStr);
     int setAsg      (const char *asgStr);
+    int setScanEvent(const char *eventName);                            // event name (EVNT) for INTD_EVENT
+    int setScanPeriod(double period);                                   // period (s) for INTD_PERIOD, before iocInit
+
+    static int postEvent(const char *eventName);                        // process all records with SCAN=Event and this EVNT
+
+    int setLockMode (INTD_enum_lockMode lockMode);                      // select mutex (default) or sequence-lock protection
+    int setDirtyRange();                                                // track the changed range of a waveform PV
+    int setSharedMemory(const char *segName);                           // buffer of a waveform PV in a shared memory segment
+
+    int publish       ();                                               // request I/O Intr scan, merged by the rate limit
+    int setPublishRate(double maxRate);                                 // max scan rate (Hz) of the IOSCANPVT, 0 for no limit
+    int setDeadband   (double absDeadband, double relDeadband);         // publish/post only when the value really moved
+    int setAsyncWrite (int enable);                                     // run the write callback on the worker pool (output PVs)
+    int setPrefetch   (int enable, double budget = 0);                  // run the read callback on the worker pool ahead of the scan (input PVs)
+
+    int addStats    (unsigned int statMask);                            // derived AI PVs of a waveform (INTD_WFSTAT_xxx), computed by publish()
+    int updateStats (unsigned int pno = 0);                             // compute them without publish (periodic scans), over pno valid points
+    int addView     (const char *suffix, INTD_enum_wfViewType viewType,
+                     unsigned int points);                              // decimated WFI PV <name>-<suffix> of a waveform, updated by publish()
+    int updateViews ();                                                 // update them without publish (periodic scans)
+    int addHistory  (unsigned int depth);                               // WFI PVs <name>-HIST/-HIST-TS with the last values of setValue
+
+protected:
+    INTD_struc_node *getNode() const {return node;}                     // for the typed accessors (TypedLocalPV.h)
+
+    template<typename T> friend class LocalPVReadView;
+    template<typename T> friend class LocalPVWriteView;
+    friend class LocalPVGroup;
 
 private:
     INTD_CALLBACK rCallback;
@@ -150,6 +225,7 @@ private:
     INTD_enum_dataType      var_dataType;                       // datatype finally used
 
     void                   *ptr_dataBuf;
+    int                     var_sharedBuf;                      // 1 if the buffer is in the block of initTable owned by another PV
 
     // status
     int                     var_onceCreated;                    // 1 means successfully created
@@ -157,6 +233,8 @@ private:
     // private functions
     void fun_maniCallback(INTD_enum_recordType recordType, INTD_CALLBACK callback);
     unsigned int fun_getDataSize(INTD_enum_dataType dataType);
+    void fun_createNode(const char *scanEvent);
+    static INTD_enum_dataType fun_getDataType(INTD_enum_recordType recordType, INTD_enum_dataType wfDataType);
 };
 
 } 
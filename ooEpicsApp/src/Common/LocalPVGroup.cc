@@ -0,0 +1,251 @@
+//===============================================================
+//  Copyright (c) 2023 by Paul Scherrer Institute, Switzerland
+//  All rights reserved.
+//  Authors: Zheqiao Geng
+//===============================================================
+//===============================================================
+// LocalPVGroup.cc
+//
+// Class definition for the commit group of local PVs
+//===============================================================
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "LocalPVGroup.h"
+
+//******************************************************
+// NAME SPACE OOEPICS
+//******************************************************
+namespace OOEPICS {
+
+//-----------------------------------------------
+// construction and destruction
+//-----------------------------------------------
+LocalPVGroup::LocalPVGroup()
+{
+    var_itemNum = 0;
+}
+
+LocalPVGroup::~LocalPVGroup()
+{
+}
+
+//-----------------------------------------------
+// get the next item of the group, the items (and their buffers) are reused.
+// the PVs without mutex are refused, their writes could not be serialized
+// with the other writers during the commit
+//-----------------------------------------------
+LPV_struc_groupItem *LocalPVGroup::newItem(LocalPV &pv, LPV_enum_groupItem itemType)
+{
+    LPV_struc_groupItem *item;
+    INTD_struc_node     *dataNode = pv.getNode();
+
+    if(!dataNode)
+        return NULL;
+
+    if(!dataNode -> mutexId) {
+        printf("LocalPVGroup::stage: %s.%s has no mutex, it can not be written by a commit group\n", dataNode -> moduleName, dataNode -> dataName);
+        return NULL;
+    }
+
+    if(var_itemNum == var_items.size())
+        var_items.push_back(LPV_struc_groupItem());
+
+    item = &var_items[var_itemNum ++];
+
+    item -> pv       = &pv;
+    item -> itemType = itemType;
+    item -> value    = 0.0;
+    item -> dataType = INTD_DOUBLE;
+    item -> pointNum = 0;
+
+    return item;
+}
+
+//-----------------------------------------------
+// stage the values. return:
+//      0 - success; 1 - failure (PV not created or wrong input)
+//-----------------------------------------------
+int LocalPVGroup::stage(LocalPV &pv, epicsFloat64 dataIn)
+{
+    LPV_struc_groupItem *item = newItem(pv, LPV_GROUP_VALUE);
+
+    if(!item)
+        return 1;
+
+    item -> value = dataIn;
+    return 0;
+}
+
+int LocalPVGroup::stageString(LocalPV &pv, const char *strIn)
+{
+    LPV_struc_groupItem *item;
+
+    if(!strIn || !(item = newItem(pv, LPV_GROUP_STRING)))
+        return 1;
+
+    item -> data.assign(strIn, strIn + strlen(strIn) + 1);              // with the terminating 0
+    return 0;
+}
+
+int LocalPVGroup::stageString(LocalPV &pv, const string &strIn)
+{
+    return stageString(pv, strIn.c_str());
+}
+
+//-----------------------------------------------
+// order of the nodes in commit: by the mutex, then by the node
+//-----------------------------------------------
+static bool LPV_func_groupNodeLess(const INTD_struc_node *a, const INTD_struc_node *b)
+{
+    if(a -> mutexId != b -> mutexId)
+        return a -> mutexId < b -> mutexId;
+
+    return a < b;
+}
+
+//-----------------------------------------------
+// 1 if a staged waveform covers all the points of the node, the write
+// section then does not need to keep the old data (triple-buffer mode)
+//-----------------------------------------------
+int LocalPVGroup::isFullWrite(INTD_struc_node *dataNode)
+{
+    unsigned int i;
+
+    for(i = 0; i < var_itemNum; i ++)
+        if(var_items[i].pv -> getNode() == dataNode && var_items[i].itemType == LPV_GROUP_VALUES
+           && var_items[i].pointNum >= var_items[i].pv -> var_pointNum)
+            return 1;
+
+    return 0;
+}
+
+//-----------------------------------------------
+// write a staged item into the buffer of its node, the same conversions as
+// setValue/setValues/setString. the write section of the node is opened by
+// commit
+//-----------------------------------------------
+int LocalPVGroup::applyItem(LPV_struc_groupItem *item)
+{
+    LocalPV         *pv       = item -> pv;
+    INTD_struc_node *dataNode = pv -> getNode();
+    void            *buf      = INTD_API_writeBuffer(dataNode);
+    unsigned int     pno, size;
+
+    switch(item -> itemType) {
+        case LPV_GROUP_VALUE:
+            switch(pv -> var_recordType) {
+                case INTD_AI    : *((epicsFloat64 *)buf) =              item -> value; break;
+                case INTD_BI    : *((epicsUInt16  *)buf) = (epicsUInt16)item -> value; break;
+                case INTD_LI    : *((epicsInt32   *)buf) = (epicsInt32) item -> value; break;
+                case INTD_MBBI  : *((epicsUInt16  *)buf) = (epicsUInt16)item -> value; break;
+                default: return 1;
+            }
+            return 0;
+
+        case LPV_GROUP_STRING:                                          // the length of the lsi is searched by the readers
+            if(pv -> var_recordType == INTD_SI)         size = MAX_STRING_SIZE;
+            else if(pv -> var_recordType == INTD_LSI)   size = dataNode -> pno;
+            else return 1;
+
+            pno = (unsigned int)strlen(&item -> data[0]);
+            if(pno > size - 1) pno = size - 1;
+
+            memcpy(buf, &item -> data[0], pno);
+            ((char *)buf)[pno] = '\0';
+            return 0;
+
+        default:
+            if(pv -> var_recordType != INTD_WFI)
+                return 1;
+
+            pno = item -> pointNum < pv -> var_pointNum ? item -> pointNum : pv -> var_pointNum;
+
+            return INTD_API_vecConvert(pv -> var_dataType, buf, item -> dataType, &item -> data[0], pno) == 0 ? 0 : 1;
+    }
+}
+
+//-----------------------------------------------
+// write all staged values in one write section per node, then request one
+// I/O Intr scan for each IOSCANPVT with a changed node (change detection and
+// the rate limit of publish apply). the group is empty afterwards. return:
+//      0 - success; 1 - some of the values were not written
+//-----------------------------------------------
+int LocalPVGroup::commit(bool publish)
+{
+    int status = 0;
+    unsigned int i, j;
+    INTD_struc_node *dataNode;
+
+    if(var_itemNum == 0)
+        return 0;
+
+    // each node once, ordered by the mutex: the distinct mutexes are locked in the address order so that
+    // groups sharing nodes do not deadlock, the other nodes of the same mutex take it again recursively
+    var_nodes.clear();
+
+    for(i = 0; i < var_itemNum; i ++)
+        var_nodes.push_back(var_items[i].pv -> getNode());
+
+    sort(var_nodes.begin(), var_nodes.end(), LPV_func_groupNodeLess);
+    var_nodes.erase(unique(var_nodes.begin(), var_nodes.end()), var_nodes.end());
+
+    for(i = 0; i < var_nodes.size(); i ++) {
+        if(isFullWrite(var_nodes[i]))   INTD_API_writeBeginFull(var_nodes[i]);
+        else                            INTD_API_writeBegin(var_nodes[i]);
+    }
+
+    for(i = 0; i < var_itemNum; i ++)
+        if(applyItem(&var_items[i]) != 0)
+            status = 1;
+
+    for(i = var_nodes.size(); i > 0; i --)
+        INTD_API_writeEnd(var_nodes[i - 1]);
+
+    // wait-free append to the history of the scalars, as setValue
+    for(i = 0; i < var_itemNum; i ++) {
+        dataNode = var_items[i].pv -> getNode();
+
+        if(var_items[i].itemType == LPV_GROUP_VALUE && dataNode -> history)
+            INTD_API_historyAppend(dataNode, var_items[i].value, NULL);
+    }
+
+    // one scan per IOSCANPVT, the derived statistics and views are updated per node
+    if(publish) {
+        var_scans.clear();
+
+        for(i = 0; i < var_nodes.size(); i ++) {
+            dataNode = var_nodes[i];
+
+            if(!dataNode -> ioIntScan || INTD_API_publishPrepare(dataNode) != 1)
+                continue;
+
+            for(j = 0; j < var_scans.size(); j ++)
+                if(*var_scans[j] == *dataNode -> ioIntScan) break;
+
+            if(j == var_scans.size())
+                var_scans.push_back(dataNode -> ioIntScan);
+        }
+
+        for(j = 0; j < var_scans.size(); j ++)
+            INTD_API_publish(var_scans[j]);
+    }
+
+    var_itemNum = 0;
+    return status;
+}
+
+//-----------------------------------------------
+// drop the staged values without writing them
+//-----------------------------------------------
+void LocalPVGroup::clear()
+{
+    var_itemNum = 0;
+}
+
+}
+//******************************************************
+// NAME SPACE OOEPICS
+//******************************************************
+
@@ -0,0 +1,117 @@
+//===============================================================
+//  Copyright (c) 2023 by Paul Scherrer Institute, Switzerland
+//  All rights reserved.
+//  Authors: Zheqiao Geng
+//===============================================================
+//===============================================================
+// LocalPVGroup.h
+//
+// Commit group of local PVs. The new values of several input PVs
+// are staged first, commit() opens the write section of each node
+// once (the distinct mutexes in the address order), writes all the
+// values into the buffers, closes the sections and then requests
+// one I/O Intr scan per distinct IOSCANPVT. A record scanned by the
+// IOSCANPVT sees the complete result set, never a half-updated one.
+//
+//     resultGroup.stage(ampPV, amp);
+//     resultGroup.stage(phaPV, pha);
+//     resultGroup.stageValues(wfPV, wfData, pointNum);
+//     resultGroup.commit();                       // write, then publish
+//
+// The data of the waveforms and strings are copied when staged. The
+// buffers are kept after commit, so the group of a job reused in each
+// cycle does not allocate memory after the first one.
+// Only the PVs with a mutex (the module mutex given to LocalPV::init)
+// can be staged, the mutex serializes the commit with the other
+// writers. The readers follow the lock mode of the node: with the
+// mutex they wait for the commit, the sequence-lock readers retry
+// and the triple-buffer records get the buffers published at the end
+//===============================================================
+#ifndef LOCALPVGROUP_H
+#define LOCALPVGROUP_H
+
+#include <vector>
+
+#include "LocalPV.h"
+#include "TypedLocalPV.h"
+
+//******************************************************
+// NAME SPACE OOEPICS
+//******************************************************
+namespace OOEPICS {
+
+//-----------------------------------------------
+// staged update of a PV
+//-----------------------------------------------
+typedef enum {
+    LPV_GROUP_VALUE,                // scalar, as setValue
+    LPV_GROUP_VALUES,               // waveform, as setValues
+    LPV_GROUP_STRING                // stringin or lsi, as setString
+} LPV_enum_groupItem;
+
+typedef struct {
+    LocalPV                *pv;
+    LPV_enum_groupItem      itemType;
+    epicsFloat64            value;
+    INTD_enum_dataType      dataType;                           // element type of the staged waveform
+    unsigned int            pointNum;
+    vector<char>            data;                               // copy of the waveform or the string
+} LPV_struc_groupItem;
+
+//-----------------------------------------------
+// the commit group
+//-----------------------------------------------
+class LocalPVGroup
+{
+public:
+    LocalPVGroup();
+   ~LocalPVGroup();
+
+    // stage the new values, nothing is written before commit
+    int stage      (LocalPV &pv, epicsFloat64 dataIn);                  // scalar input PV
+    int stageString(LocalPV &pv, const char *strIn);                    // stringin or lsi PV
+    int stageString(LocalPV &pv, const string &strIn);
+
+    template<typename T>
+    int stageValues(LocalPV &pv, const T *dataIn, unsigned int pointNum)     // waveform input PV
+    {
+        LPV_struc_groupItem *item;
+
+        if(!dataIn || pointNum == 0 || !(item = newItem(pv, LPV_GROUP_VALUES)))
+            return 1;
+
+        item -> dataType = (INTD_enum_dataType)LPV_DataTraits<T>::dataType;
+        item -> pointNum = pointNum;
+        item -> data.assign((const char *)dataIn, (const char *)(dataIn + pointNum));
+
+        return 0;
+    }
+
+    int  commit(bool publish = true);                                   // write all staged values, then publish
+    void clear ();                                                      // drop the staged values
+
+    unsigned int size() const {return var_itemNum;}
+
+private:
+    vector<LPV_struc_groupItem>     var_items;                          // kept between the commits, only the first var_itemNum are staged
+    unsigned int                    var_itemNum;
+
+    vector<INTD_struc_node *>       var_nodes;                          // working buffers of commit
+    vector<IOSCANPVT *>             var_scans;
+
+    LPV_struc_groupItem *newItem(LocalPV &pv, LPV_enum_groupItem itemType);
+    int  isFullWrite(INTD_struc_node *dataNode);
+    int  applyItem(LPV_struc_groupItem *item);
+
+    // not copyable
+    LocalPVGroup(const LocalPVGroup &);
+    LocalPVGroup &operator=(const LocalPVGroup &);
+};
+
+}
+//******************************************************
+// NAME SPACE OOEPICS
+//******************************************************
+
+#endif
+
@@ -0,0 +1,117 @@
+//===============================================================
+//  Copyright (c) 2023 by Paul Scherrer Institute, Switzerland
+//  All rights reserved.
+//  Authors: Zheqiao Geng
+//===============================================================
+//===============================================================
+// LocalPVTable.h
+//
+// Table-driven creation of the local PVs of a class. The PVs are
+// described by a static table of LPV_PVDesc (constant data, no
+// constructor is run for it), which refers to the LocalPV members,
+// the IOSCANPVT and the mutex by the member pointers of the owner
+// class. LPV_initTable creates all PVs in one pass: the buffers are
+// allocated in one block and no temporary string is built, instead
+// of the string copies and the malloc of each LocalPV::init call.
+//
+//     const LPV_PVDesc<Job_X> Job_X::var_pvTable[] = {       // static member, to access the private members
+//     //   PV              name        sup unit  pno  callback record    scan        I/O scan             mutex
+//         {&Job_X::lpv_a,  "VAL-A",    "", "V",  1,   NULL,    INTD_AI,  INTD_IOINT, &Job_X::var_scan,    NULL},
+//         {&Job_X::lpv_wf, "WF-DATA",  "", "",   512, NULL,    INTD_WFI, INTD_IOINT, &Job_X::var_scan,    NULL, INTD_FLOAT},
+//         {&Job_X::lpv_b,  "SET-B",    "", "",   1,   NULL,    INTD_AO,  INTD_PASSIVE, NULL,              &Job_X::var_lock}
+//     };
+//
+//     LPV_initTable(this, modName, jobName, var_pvTable);
+//
+// The members must be of the type LocalPV (not TypedLocalPV). The
+// object is passed to the callbacks as the private pointer
+//===============================================================
+#ifndef LOCALPVTABLE_H
+#define LOCALPVTABLE_H
+
+#include <vector>
+
+#include "LocalPV.h"
+
+//******************************************************
+// NAME SPACE OOEPICS
+//******************************************************
+namespace OOEPICS {
+
+//-----------------------------------------------
+// descriptor of a PV of the owner class C. the fields after mutexId
+// can be omitted for the scalars, the waveforms must give the data type
+//-----------------------------------------------
+template<class C>
+struct LPV_PVDesc {
+    LocalPV C::*            pv;
+    const char             *valName;
+    const char             *supStr;
+    const char             *unitStr;
+    unsigned int            pointNum;
+    INTD_CALLBACK           callback;
+    INTD_enum_recordType    recordType;
+    INTD_enum_scanType      scanType;
+    IOSCANPVT C::*          ioIntScan;                          // NULL for none
+    epicsMutexId C::*       mutexId;                            // NULL for none
+    INTD_enum_dataType      wfDataType;                         // waveforms only (setWfDataType)
+    const char             *scanEvent;                          // INTD_EVENT only
+};
+
+//-----------------------------------------------
+// create the PVs of a table for the object. the IOSCANPVT and the mutex
+// must be initialized before. return:
+//      number of the PVs failed to be created
+//-----------------------------------------------
+template<class C>
+int LPV_initTable(  C                      *owner,
+                    const string           &moduleName,
+                    const string           &devName,
+                    const LPV_PVDesc<C>    *table,
+                    unsigned int            num,
+                    epicsEventId            eventId = NULL)
+{
+    unsigned int i;
+    vector<LPV_struc_pvInit> items(num);
+
+    if(!owner || !table || num == 0)
+        return num;
+
+    for(i = 0; i < num; i ++) {
+        const LPV_PVDesc<C> &desc = table[i];
+
+        items[i].pv         = &(owner ->* desc.pv);
+        items[i].valName    = desc.valName;
+        items[i].supStr     = desc.supStr;
+        items[i].unitStr    = desc.unitStr;
+        items[i].pointNum   = desc.pointNum;
+        items[i].callback   = desc.callback;
+        items[i].recordType = desc.recordType;
+        items[i].scanType   = desc.scanType;
+        items[i].ioIntScan  = desc.ioIntScan ? &(owner ->* desc.ioIntScan) : NULL;
+        items[i].mutexId    = desc.mutexId   ?  (owner ->* desc.mutexId)   : NULL;
+        items[i].wfDataType = desc.wfDataType;
+        items[i].scanEvent  = desc.scanEvent;
+    }
+
+    return LocalPV::initTable(moduleName.c_str(), devName.c_str(), (void *)owner, eventId, &items[0], num);
+}
+
+// the number of PVs taken from the array
+template<class C, unsigned int N>
+int LPV_initTable(  C                      *owner,
+                    const string           &moduleName,
+                    const string           &devName,
+                    const LPV_PVDesc<C>   (&table)[N],
+                    epicsEventId            eventId = NULL)
+{
+    return LPV_initTable(owner, moduleName, devName, table, N, eventId);
+}
+
+}
+//******************************************************
+// NAME SPACE OOEPICS
+//******************************************************
+
+#endif
+
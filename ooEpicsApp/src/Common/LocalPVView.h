@@ -0,0 +1,167 @@
+//===============================================================
+//  Copyright (c) 2023 by Paul Scherrer Institute, Switzerland
+//  All rights reserved.
+//  Authors: Zheqiao Geng
+//===============================================================
+//===============================================================
+// LocalPVView.h
+//
+// Scoped views of the data buffer of a waveform local PV. The view
+// holds the lock of the node while it lives and gives the pointer
+// and the number of points of the buffer, so a job can process the
+// data in place instead of copying it with getValues/setValues.
+// Keep the views short: the records and the other writers wait
+// for the lock meanwhile.
+//
+//     {
+//         LocalPVReadView<epicsFloat64>  in (rawPV);
+//         LocalPVWriteView<epicsFloat64> out(resultPV, true);
+//
+//         if(in.valid() && out.valid())
+//             process(out.data(), in.data(), in.size());
+//     }                                   // unlocked, resultPV published
+//
+// The element type must be the data type of the PV, no conversion
+// is done. Otherwise the view is not valid (data() is NULL)
+//===============================================================
+#ifndef LOCALPVVIEW_H
+#define LOCALPVVIEW_H
+
+#include "LocalPV.h"
+#include "TypedLocalPV.h"
+
+//******************************************************
+// NAME SPACE OOEPICS
+//******************************************************
+namespace OOEPICS {
+
+//-----------------------------------------------
+// check the element type against the node (INTD_INT/INTD_UINT are
+// the same as INTD_LONG/INTD_ULONG)
+//-----------------------------------------------
+template<typename T> inline bool LPV_viewTypeMatch(INTD_struc_node *dataNode)
+{
+    INTD_enum_dataType dataType;
+
+    if(!dataNode || dataNode -> pno == 0) return false;
+
+    dataType = dataNode -> dataType;
+    if(dataType == INTD_INT)  dataType = INTD_LONG;
+    if(dataType == INTD_UINT) dataType = INTD_ULONG;
+
+    return dataType == (INTD_enum_dataType)LPV_DataTraits<T>::dataType;
+}
+
+//-----------------------------------------------
+// read view, for the waveform PVs (WFO written by the IOC, or WFI)
+//-----------------------------------------------
+template<typename T>
+class LocalPVReadView
+{
+public:
+    explicit LocalPVReadView(LocalPV &pv) : dataNode(NULL), ptr_data(NULL), var_pno(0)
+    {
+        INTD_struc_node *nodeIn = pv.getNode();
+
+        if(!nodeIn || (nodeIn -> recordType != INTD_WFO && nodeIn -> recordType != INTD_WFI) ||
+           !LPV_viewTypeMatch<T>(nodeIn))
+            return;
+
+        dataNode = nodeIn;
+        ptr_data = (const T *)INTD_API_readLock(dataNode);
+        var_pno  = dataNode -> pno;
+    }
+
+   ~LocalPVReadView() {release();}
+
+    // unlock before the end of the scope, the view is not valid afterwards
+    void release()
+    {
+        if(dataNode) INTD_API_readUnlock(dataNode);
+
+        dataNode = NULL;
+        ptr_data = NULL;
+        var_pno  = 0;
+    }
+
+    bool            valid() const                       {return ptr_data != NULL;}
+    const T        *data()  const                       {return ptr_data;}
+    unsigned int    size()  const                       {return var_pno;}
+    const T        &operator[](unsigned int i) const    {return ptr_data[i];}
+
+private:
+    INTD_struc_node        *dataNode;                           // NULL if not locked
+    const T                *ptr_data;
+    unsigned int            var_pno;
+
+    // not copyable, the lock is held once
+    LocalPVReadView(const LocalPVReadView &);
+    LocalPVReadView &operator=(const LocalPVReadView &);
+};
+
+//-----------------------------------------------
+// write view, for the WFI PVs. without markDirty the whole array is
+// treated as changed. the buffer holds the latest data, also in the
+// triple-buffer mode
+//-----------------------------------------------
+template<typename T>
+class LocalPVWriteView
+{
+public:
+    LocalPVWriteView(LocalPV &pv, bool publishIn = false) : ptr_pv(&pv), dataNode(NULL), ptr_data(NULL), var_pno(0), var_publish(publishIn)
+    {
+        INTD_struc_node *nodeIn = pv.getNode();
+
+        if(!nodeIn || nodeIn -> recordType != INTD_WFI || !LPV_viewTypeMatch<T>(nodeIn))
+            return;
+
+        dataNode = nodeIn;
+
+        INTD_API_writeBegin(dataNode);
+        ptr_data = (T *)INTD_API_writeBuffer(dataNode);
+        var_pno  = dataNode -> pno;
+    }
+
+   ~LocalPVWriteView() {release();}
+
+    // finish the write before the end of the scope (and publish if requested when created)
+    void release()
+    {
+        if(dataNode) {
+            INTD_API_writeEnd(dataNode);
+            if(var_publish) ptr_pv -> publish();
+        }
+
+        dataNode = NULL;
+        ptr_data = NULL;
+        var_pno  = 0;
+    }
+
+    // only the points [first, first + num) were changed (dirty-range tracking, LocalPV::setDirtyRange)
+    void markDirty(unsigned int first, unsigned int num)
+    {
+        if(dataNode) INTD_API_markDirty(dataNode, first, num);
+    }
+
+    bool            valid() const                       {return ptr_data != NULL;}
+    T              *data()  const                       {return ptr_data;}
+    unsigned int    size()  const                       {return var_pno;}
+    T              &operator[](unsigned int i) const    {return ptr_data[i];}
+
+private:
+    LocalPV                *ptr_pv;
+    INTD_struc_node        *dataNode;                           // NULL if not locked
+    T                      *ptr_data;
+    unsigned int            var_pno;
+    bool                    var_publish;                        // publish the PV when released
+
+    LocalPVWriteView(const LocalPVWriteView &);
+    LocalPVWriteView &operator=(const LocalPVWriteView &);
+};
+
+}
+//******************************************************
+// NAME SPACE OOEPICS
+//******************************************************
+
+#endif
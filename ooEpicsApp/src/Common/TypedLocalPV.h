@@ -0,0 +1,196 @@
+//===============================================================
+//  Copyright (c) 2023 by Paul Scherrer Institute, Switzerland
+//  All rights reserved.
+//  Authors: Zheqiao Geng
+//===============================================================
+//===============================================================
+// TypedLocalPV.h
+//
+// Local PV with the value type and the record type fixed at
+// compile time, e.g. TypedLocalPV<epicsFloat64, INTD_AI>. The node
+// is created by LocalPV::init as before, so a module can migrate
+// PV by PV. The accessors are inlined: no check of the record
+// type, no switch on the data type and no conversion through
+// double, a wrong combination does not compile
+//===============================================================
+#ifndef TYPEDLOCALPV_H
+#define TYPEDLOCALPV_H
+
+#include <cstring>
+
+#include "LocalPV.h"
+
+//******************************************************
+// NAME SPACE OOEPICS
+//******************************************************
+namespace OOEPICS {
+
+//-----------------------------------------------
+// INTD data type of the waveform element types
+//-----------------------------------------------
+template<typename T> struct LPV_DataTraits;
+
+template<> struct LPV_DataTraits<epicsInt8>    {enum {dataType = INTD_CHAR};};
+template<> struct LPV_DataTraits<epicsUInt8>   {enum {dataType = INTD_UCHAR};};
+template<> struct LPV_DataTraits<epicsInt16>   {enum {dataType = INTD_SHORT};};
+template<> struct LPV_DataTraits<epicsUInt16>  {enum {dataType = INTD_USHORT};};
+template<> struct LPV_DataTraits<epicsInt32>   {enum {dataType = INTD_LONG};};
+template<> struct LPV_DataTraits<epicsUInt32>  {enum {dataType = INTD_ULONG};};
+template<> struct LPV_DataTraits<epicsFloat32> {enum {dataType = INTD_FLOAT};};
+template<> struct LPV_DataTraits<epicsFloat64> {enum {dataType = INTD_DOUBLE};};
+
+//-----------------------------------------------
+// storage type of the record types (same as LocalPV::init), input records
+// are written by the module, the waveforms store the value type itself.
+// the string records are not supported
+//-----------------------------------------------
+template<INTD_enum_recordType R, typename T> struct LPV_RecordTraits;
+
+#define LPV_RECORD_TRAITS(rec, stor, in, arr)                                           \
+    template<typename T> struct LPV_RecordTraits<rec, T> {                              \
+        typedef stor storage;                                                           \
+        enum {input = in, array = arr};                                                 \
+    };
+
+LPV_RECORD_TRAITS(INTD_AI,   epicsFloat64, 1, 0)
+LPV_RECORD_TRAITS(INTD_AO,   epicsFloat64, 0, 0)
+LPV_RECORD_TRAITS(INTD_BI,   epicsUInt16,  1, 0)
+LPV_RECORD_TRAITS(INTD_BO,   epicsUInt16,  0, 0)
+LPV_RECORD_TRAITS(INTD_LI,   epicsInt32,   1, 0)
+LPV_RECORD_TRAITS(INTD_LO,   epicsInt32,   0, 0)
+LPV_RECORD_TRAITS(INTD_MBBI, epicsUInt16,  1, 0)
+LPV_RECORD_TRAITS(INTD_MBBO, epicsUInt16,  0, 0)
+LPV_RECORD_TRAITS(INTD_WFI,  T,            1, 1)
+LPV_RECORD_TRAITS(INTD_WFO,  T,            0, 1)
+
+#undef LPV_RECORD_TRAITS
+
+// compile-time check, LPV_StaticCheck<false> is incomplete and does not compile
+template<bool> struct LPV_StaticCheck;
+template<> struct LPV_StaticCheck<true> {static void check() {}};
+
+//-----------------------------------------------
+// the typed local PV. get() is for all record types, set() only for the
+// input records, the output records are written by the IOC (use
+// forceOPVValue to change them). all other functions of LocalPV are
+// available (publish, setDesc, addStats, ...)
+//-----------------------------------------------
+template<typename T, INTD_enum_recordType R>
+class TypedLocalPV : public LocalPV
+{
+public:
+    typedef typename LPV_RecordTraits<R, T>::storage storage_type;
+
+    enum {isInput = LPV_RecordTraits<R, T>::input, isArray = LPV_RecordTraits<R, T>::array};
+
+    TypedLocalPV() : dataNode(NULL), dataBuf(NULL), var_pno(0) {}
+
+    // same as LocalPV::init, the record type is the template argument
+    void init(  string                  moduleName,
+                string                  devName,
+                string                  valName,
+                string                  supStr,
+                string                  unitStr,
+                unsigned int            pointNum,
+                void                   *privatePtr,
+                INTD_CALLBACK           callback,
+                INTD_enum_scanType      scanType,
+                IOSCANPVT              *ioIntScan,
+                epicsMutexId            mutexId,
+                epicsEventId            eventId,
+                string                  scanEvent = "")
+    {
+        if(isArray)
+            setWfDataType((INTD_enum_dataType)LPV_DataTraits<T>::dataType);
+
+        LocalPV::init(moduleName, devName, valName, supStr, unitStr, isArray ? pointNum : 1, privatePtr, callback,
+                      R, scanType, ioIntScan, mutexId, eventId, scanEvent);
+
+        dataNode       = getNode();
+        dataBuf        = dataNode ? (storage_type *)dataNode -> dataPtr : NULL;
+        var_pno        = dataNode ? dataNode -> pno : 0;
+    }
+
+    // scalars
+    T get()
+    {
+        LPV_StaticCheck<!isArray>::check();                                // waveforms: use get(dataOut, num)
+
+        T val = T();
+        unsigned int seq;
+
+        if(!dataBuf) return val;
+
+        do {
+            seq = INTD_API_readBegin(dataNode);
+            val = (T)*dataBuf;
+        } while(INTD_API_readRetry(dataNode, seq));
+
+        return val;
+    }
+
+    int set(T val)
+    {
+        LPV_StaticCheck<!isArray>::check();                                // waveforms: use set(dataIn, num)
+        LPV_StaticCheck<isInput>::check();                                 // output records are written by the IOC
+
+        if(!dataBuf) return 1;
+
+        INTD_API_writeBegin(dataNode);
+        *dataBuf = (storage_type)val;
+        INTD_API_writeEnd(dataNode);
+
+        if(dataNode -> history)
+            INTD_API_historyAppend(dataNode, (double)val, NULL);
+
+        return 0;
+    }
+
+    // waveforms, the return value is the number of points copied
+    unsigned int get(T *dataOut, unsigned int num)
+    {
+        LPV_StaticCheck<isArray>::check();                                 // scalars: use get()
+
+        unsigned int seq;
+
+        if(!dataBuf || !dataOut) return 0;
+        if(num > var_pno) num = var_pno;
+
+        do {
+            seq = INTD_API_readBegin(dataNode);
+            memcpy(dataOut, INTD_API_readBuffer(dataNode), num * sizeof(T));
+        } while(INTD_API_readRetry(dataNode, seq));
+
+        return num;
+    }
+
+    unsigned int set(const T *dataIn, unsigned int num)
+    {
+        LPV_StaticCheck<isArray>::check();                                 // scalars: use set(val)
+        LPV_StaticCheck<isInput>::check();                                 // output records are written by the IOC
+
+        if(!dataBuf || !dataIn) return 0;
+        if(num > var_pno) num = var_pno;
+
+        if(num == var_pno) INTD_API_writeBeginFull(dataNode);
+        else               INTD_API_writeBegin(dataNode);
+        memcpy(INTD_API_writeBuffer(dataNode), dataIn, num * sizeof(T));
+        INTD_API_writeEnd(dataNode);
+
+        return num;
+    }
+
+    unsigned int size() const {return var_pno;}
+
+private:
+    INTD_struc_node        *dataNode;                           // cached from LocalPV after init
+    storage_type           *dataBuf;                            // NULL if the node is not created
+    unsigned int            var_pno;
+};
+
+}
+//******************************************************
+// NAME SPACE OOEPICS
+//******************************************************
+
+#endif
@@ -9,7 +9,14 @@
  * Header file for the InternalData module
  * This module acts as the isolation layer between EPICS records and inernal code
  ***************************************************************************/
+#include <stddef.h>
+#include <math.h>
 #include <dbAccess.h>					/* there is conflicts in db_access.h (used by cadef.h) and dbFldTypes.h for the DBR_xxx definitions. So only use dbAccess.h locally */
+#include <epicsAtomic.h>
+#include <epicsThread.h>
+#include <epicsTime.h>
+#include <epicsVersion.h>
+#include <menuFtype.h>
 #include "InternalData.h"
 #include "recordGenerate.h"
 
@@ -19,6 +26,118 @@
 static ELLLIST INTD_gvar_dataList;                                  /* later we need a mutex to protect this list! */
 static int INTD_gvar_dataListInitialized = 0;
 
+#define INTD_HASH_INIT_BUCKETS 1024                                 /* initial number of buckets, must be power of 2 */
+
+#define INTD_STATS_HIST_BINS    16                                  /* bins of the callback duration histogram: <1us, <2us, ... >=16ms */
+
+typedef struct INTD_struc_nodeStats_tag {                           /* access statistics of a data node, the counters are atomic, */
+    struct INTD_struc_nodeStats_tag *next;                          /*   the bytes, times and last access are approximate when */
+    INTD_struc_node    *dataNode;                                   /*   several threads access the node at the same time */
+    size_t              getCnt;
+    size_t              putCnt;
+    double              bytesGet;
+    double              bytesPut;
+    epicsTimeStamp      lastAccess;
+    size_t              cbNum;                                      /* number of callbacks timed */
+    double              cbTotal;                                    /* total time in the callbacks (s) */
+    double              cbMax;                                      /* longest callback (s) */
+    size_t              cbHist[INTD_STATS_HIST_BINS];
+} INTD_struc_nodeStats;
+
+static INTD_struc_nodeStats *INTD_gvar_statsList    = NULL;
+static int                   INTD_gvar_statsEnabled = 0;            /* new nodes get the statistics */
+
+typedef struct INTD_struc_change_tag {                              /* change detection of a data node */
+    double              absDeadband;                                /* scalars: change must exceed the absolute deadband ... */
+    double              relDeadband;                                /* ... and the relative deadband (fraction of the last value) */
+    double              lastValue;                                  /* scalars: last value passed */
+    unsigned long long *blockHash;                                  /* arrays: hash of each block of the last data passed, */
+    unsigned int        blockNum;                                   /*   followed by the hashes of the check in progress */
+    unsigned int        hashFirst, hashEnd;                         /* blocks hashed by the check in progress */
+    int                 valid;                                      /* the last value/hash is valid */
+    unsigned long       checkCnt;                                   /* number of checks */
+    unsigned long       suppressCnt;                                /* number of checks found unchanged */
+} INTD_struc_change;
+
+#define INTD_CHANGE_BLOCK_SIZE  4096                                /* bytes per hash of the change detection */
+
+typedef struct INTD_struc_dirty_tag {                               /* dirty range tracking of an array node */
+    unsigned int        readFirst, readEnd;                         /* points changed since the last read of the record, empty if first >= end */
+    unsigned int        pubFirst, pubEnd;                           /* points changed since the last publish */
+    int                 marked;                                     /* a range was marked in the current write section */
+    unsigned int        readerPno;                                  /* points of the last read of the record, 0 before the first one */
+    unsigned long       rangeCnt;                                   /* writes with a range */
+    unsigned long       fullCnt;                                    /* writes without a range (whole array dirty) */
+    unsigned long       skipCnt;                                    /* range writes with unchanged data */
+    double              pointsRead;                                 /* points copied to the record */
+    double              pointsFull;                                 /* points the full copies would have taken */
+} INTD_struc_dirty;
+
+#define INTD_TBUF_FRESH         4                                   /* flag in the middle index: published but not yet read */
+
+typedef struct INTD_struc_tripleBuf_tag {                           /* buffers of the triple-buffer mode */
+    void               *buf[3];
+    int                 back;                                       /* buffer filled by the writer, owned by the writer */
+    int                 front;                                      /* buffer copied by the record, owned by the record */
+    int                 middle;                                     /* last published buffer (| INTD_TBUF_FRESH), swapped atomically */
+    int                 shared;                                     /* latest buffer read by the other readers, with the mutex held */
+} INTD_struc_tripleBuf;
+
+static INTD_struc_node **INTD_gvar_hashBuckets  = NULL;             /* hash index of the data nodes keyed on (moduleName, dataName) */
+static unsigned int      INTD_gvar_hashBucketNum = 0;               /* number of buckets (power of 2) */
+static unsigned int      INTD_gvar_hashNodeNum   = 0;               /* number of nodes in the hash index */
+static int               INTD_gvar_hashDegraded  = 0;               /* some nodes are not in the hash index, search the list on a miss */
+
+typedef struct INTD_struc_modIndex {                                /* nodes of one module instance, for the file generators */
+    struct INTD_struc_modIndex *next;
+    const char                 *moduleName;                         /* interned, compared by pointer */
+    INTD_struc_node            *first;                              /* chained by modNext in the creation order */
+    INTD_struc_node            *last;
+    unsigned int                nodeNum;
+} INTD_struc_modIndex;
+
+static INTD_struc_modIndex *INTD_gvar_modIndex   = NULL;
+
+#define INTD_NODE_SLAB_NUM      256                                 /* number of data nodes in one slab */
+#define INTD_NODE_ALIGN         64                                  /* nodes are aligned to cache lines */
+#define INTD_STRPOOL_CHUNK_SIZE 65536                               /* size of one chunk of the string pool */
+#define INTD_INTERN_BUCKETS     1024                                /* buckets of the interned string table, must be power of 2 */
+
+#define INTD_NAME_LEN           128                                 /* max size of the strings of a node (with the terminating 0), */
+#define INTD_SUPSTR_LEN         256                                 /*   the generators copy them into buffers of these sizes */
+#define INTD_UNITSTR_LEN        16
+
+#define INTD_NODE_STRIDE        ((sizeof(INTD_struc_node) + INTD_NODE_ALIGN - 1) & ~(size_t)(INTD_NODE_ALIGN - 1))
+#define INTD_NODE_OF(ellNode)   ((INTD_struc_node *)((char *)(ellNode) - offsetof(INTD_struc_node, node)))
+
+typedef struct INTD_struc_nodeSlab {                                /* slab of data nodes */
+    struct INTD_struc_nodeSlab *next;
+    void                       *mem;                                /* memory block as allocated */
+    char                       *nodes;                              /* first node, aligned */
+    unsigned int                used;                               /* number of nodes handed out */
+} INTD_struc_nodeSlab;
+
+typedef struct INTD_struc_strChunk {                                /* chunk of the string pool */
+    struct INTD_struc_strChunk *next;
+    size_t                      size;
+    size_t                      used;
+    char                        data[1];
+} INTD_struc_strChunk;
+
+typedef struct INTD_struc_internStr {                               /* entry of the interned string table */
+    struct INTD_struc_internStr *next;
+    unsigned int                 hash;
+    const char                  *str;
+} INTD_struc_internStr;
+
+static INTD_struc_nodeSlab  *INTD_gvar_nodeSlabs     = NULL;        /* slab currently used is the head of the list */
+static unsigned int          INTD_gvar_nodeSlabNum   = 0;
+static INTD_struc_strChunk  *INTD_gvar_strChunks     = NULL;        /* chunk currently used is the head of the list */
+static size_t                INTD_gvar_strPoolBytes  = 0;           /* bytes of strings stored in the pool */
+static INTD_struc_internStr *INTD_gvar_internStrs[INTD_INTERN_BUCKETS];
+static unsigned int          INTD_gvar_internStrNum  = 0;
+static unsigned int          INTD_gvar_internHitNum  = 0;           /* number of strings shared by interning */
+
 static char *INTD_gvar_scanStrs[] = {                               /* string for different scanning */
     "Passive",
     "I/O Intr",
@@ -28,9 +147,15 @@ static char *INTD_gvar_scanStrs[] = {                               /* string fo
     "1 second",
     ".5 second",
     ".2 second",
-    ".1 second"
+    ".1 second",
+    "I/O Intr",                                                     /* 50 Hz, scanned by the timer of InternalData_scan.c */
+    "I/O Intr",                                                     /* 100 Hz */
+    "Event",
+    "I/O Intr"                                                      /* custom period */
 };
 
+static int INTD_gvar_arrayRecords = 0;                              /* 1: generate aao/aai records for the waveform nodes */
+
 int INTD_gvar_iocInitDone = 0;										/* global variable to show iocInit is finished or not */
 
 /*======================================
@@ -80,6 +205,344 @@ static int INTD_func_getDataSize(INTD_enum_dataType dataType)
     return var_dataSize;
 }
 
+/**
+ * Walk the data nodes in the order that they were created
+ */
+static INTD_struc_node *INTD_func_firstNode()
+{
+    ELLNODE *ptr_ellNode = ellFirst(&INTD_gvar_dataList);
+    return ptr_ellNode ? INTD_NODE_OF(ptr_ellNode) : NULL;
+}
+
+static INTD_struc_node *INTD_func_nextNode(INTD_struc_node *dataNode)
+{
+    ELLNODE *ptr_ellNode = ellNext(&dataNode -> node);
+    return ptr_ellNode ? INTD_NODE_OF(ptr_ellNode) : NULL;
+}
+
+/**
+ * Iterate the data nodes in the creation order, for the reports of the other files of the module
+ */
+INTD_struc_node *INTD_API_firstNode()
+{
+    return INTD_gvar_dataListInitialized ? INTD_func_firstNode() : NULL;
+}
+
+INTD_struc_node *INTD_API_nextNode(INTD_struc_node *dataNode)
+{
+    return dataNode ? INTD_func_nextNode(dataNode) : NULL;
+}
+
+/**
+ * Allocate a cleared data node from the slabs
+ */
+static INTD_struc_node *INTD_func_allocNode()
+{
+    INTD_struc_nodeSlab *ptr_slab = INTD_gvar_nodeSlabs;
+
+    if(!ptr_slab || ptr_slab -> used >= INTD_NODE_SLAB_NUM) {
+        ptr_slab = (INTD_struc_nodeSlab *)calloc(1, sizeof(INTD_struc_nodeSlab));
+        if(!ptr_slab) return NULL;
+
+        ptr_slab -> mem = calloc(1, INTD_NODE_SLAB_NUM * INTD_NODE_STRIDE + INTD_NODE_ALIGN);
+        if(!ptr_slab -> mem) {
+            free(ptr_slab);
+            return NULL;
+        }
+
+        ptr_slab -> nodes   = (char *)(((size_t)ptr_slab -> mem + INTD_NODE_ALIGN - 1) & ~(size_t)(INTD_NODE_ALIGN - 1));
+        ptr_slab -> next    = INTD_gvar_nodeSlabs;
+        INTD_gvar_nodeSlabs = ptr_slab;
+        INTD_gvar_nodeSlabNum ++;
+    }
+
+    return (INTD_struc_node *)(ptr_slab -> nodes + INTD_NODE_STRIDE * (ptr_slab -> used ++));
+}
+
+/**
+ * Length of a string, at most maxLen (the string may not be terminated within maxLen characters)
+ */
+static size_t INTD_func_strLen(const char *str, size_t maxLen)
+{
+    size_t len = 0;
+
+    while(len < maxLen && str[len]) len ++;
+
+    return len;
+}
+
+/**
+ * Copy a string into the string pool, the memory is released when EPICS exits. The string is truncated to
+ *   maxSize - 1 characters
+ */
+static const char *INTD_func_storeString(const char *str, size_t maxSize)
+{
+    size_t len, chunkSize;
+    char *ptr_str;
+    INTD_struc_strChunk *ptr_chunk = INTD_gvar_strChunks;
+
+    if(!str || !str[0]) return "";
+
+    len = INTD_func_strLen(str, maxSize - 1);
+
+    if(str[len])
+        printf("INTD_func_storeString: String truncated to %u characters: %.*s\n", (unsigned int)len, (int)len, str);
+
+    len ++;
+
+    if(!ptr_chunk || ptr_chunk -> size - ptr_chunk -> used < len) {
+        chunkSize = len > INTD_STRPOOL_CHUNK_SIZE ? len : INTD_STRPOOL_CHUNK_SIZE;
+        ptr_chunk = (INTD_struc_strChunk *)malloc(sizeof(INTD_struc_strChunk) + chunkSize);
+        if(!ptr_chunk) return "";
+
+        ptr_chunk -> size   = chunkSize;
+        ptr_chunk -> used   = 0;
+        ptr_chunk -> next   = INTD_gvar_strChunks;
+        INTD_gvar_strChunks = ptr_chunk;
+    }
+
+    ptr_str = ptr_chunk -> data + ptr_chunk -> used;
+    memcpy(ptr_str, str, len - 1);
+    ptr_str[len - 1] = '\0';
+
+    ptr_chunk -> used      += len;
+    INTD_gvar_strPoolBytes += len;
+
+    return ptr_str;
+}
+
+/**
+ * Get the shared copy of a string which is used by many nodes (e.g. module name), truncated as INTD_func_storeString
+ */
+static const char *INTD_func_internString(const char *str, size_t maxSize)
+{
+    unsigned int hash = 2166136261u;
+    size_t i, len;
+    INTD_struc_internStr *ptr_entry;
+
+    if(!str || !str[0]) return "";
+
+    len = INTD_func_strLen(str, maxSize - 1);
+
+    for(i = 0; i < len; i ++) {
+        hash ^= (unsigned char)str[i];
+        hash *= 16777619u;
+    }
+
+    for(ptr_entry = INTD_gvar_internStrs[hash & (INTD_INTERN_BUCKETS - 1)]; ptr_entry; ptr_entry = ptr_entry -> next) {
+        if(ptr_entry -> hash == hash && strncmp(ptr_entry -> str, str, len) == 0 && ptr_entry -> str[len] == '\0') {
+            INTD_gvar_internHitNum ++;
+            return ptr_entry -> str;
+        }
+    }
+
+    ptr_entry = (INTD_struc_internStr *)malloc(sizeof(INTD_struc_internStr));
+    if(!ptr_entry) return INTD_func_storeString(str, maxSize);
+
+    ptr_entry -> hash = hash;
+    ptr_entry -> str  = INTD_func_storeString(str, maxSize);
+    ptr_entry -> next = INTD_gvar_internStrs[hash & (INTD_INTERN_BUCKETS - 1)];
+
+    INTD_gvar_internStrs[hash & (INTD_INTERN_BUCKETS - 1)] = ptr_entry;
+    INTD_gvar_internStrNum ++;
+
+    return ptr_entry -> str;
+}
+
+/**
+ * Change a string of a node stored by INTD_func_storeString (description, alias). A new copy is always
+ *   stored, the old one may be read by the file generators at the same time. Setting the same string
+ *   again keeps the old copy, so that repeated calls do not fill the pool
+ */
+static const char *INTD_func_replaceString(const char *oldStr, const char *str)
+{
+    if(!str || !str[0]) return "";
+
+    if(oldStr && strncmp(oldStr, str, INTD_NAME_LEN - 1) == 0 && oldStr[0]) return oldStr;
+
+    return INTD_func_storeString(str, INTD_NAME_LEN);
+}
+
+/**
+ * Create the statistics block of a data node
+ */
+static void INTD_func_statsNew(INTD_struc_node *dataNode)
+{
+    INTD_struc_nodeStats *ptr_stats = (INTD_struc_nodeStats *)calloc(1, sizeof(INTD_struc_nodeStats));
+
+    if(!ptr_stats) return;
+
+    ptr_stats -> dataNode = dataNode;
+    ptr_stats -> next     = INTD_gvar_statsList;
+    INTD_gvar_statsList   = ptr_stats;
+
+    dataNode -> stats = ptr_stats;
+    INTD_API_setFeature(dataNode, INTD_FEATURE_STATS, 1);
+}
+
+/**
+ * Hash value of the key (moduleName, dataName), FNV-1a
+ */
+static unsigned int INTD_func_hashKey(const char *moduleName, const char *dataName)
+{
+    unsigned int hash = 2166136261u;
+    const unsigned char *p;
+
+    for(p = (const unsigned char *)moduleName; *p; p ++) {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+
+    hash ^= '.';                                                    /* separator, so that ("ab","c") differs from ("a","bc") */
+    hash *= 16777619u;
+
+    for(p = (const unsigned char *)dataName; *p; p ++) {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/**
+ * Double the number of buckets of the hash index and redistribute the nodes. The nodes keep their
+ * order in the chains (creation order), so that the first node created is found for duplicated names
+ */
+static int INTD_func_hashGrow()
+{
+    unsigned int i, idx;
+    unsigned int newBucketNum;
+    INTD_struc_node **newBuckets, **newTails;
+    INTD_struc_node  *ptr_dataNode, *ptr_next;
+
+    newBucketNum = INTD_gvar_hashBucketNum ? INTD_gvar_hashBucketNum * 2 : INTD_HASH_INIT_BUCKETS;
+    newBuckets   = (INTD_struc_node **)calloc(newBucketNum, sizeof(INTD_struc_node *));
+    newTails     = (INTD_struc_node **)calloc(newBucketNum, sizeof(INTD_struc_node *));
+
+    if(!newBuckets || !newTails) {
+        if(newBuckets) free(newBuckets);
+        if(newTails)   free(newTails);
+        return -1;
+    }
+
+    for(i = 0; i < INTD_gvar_hashBucketNum; i ++) {
+        for(ptr_dataNode = INTD_gvar_hashBuckets[i]; ptr_dataNode; ptr_dataNode = ptr_next) {
+            ptr_next                 = ptr_dataNode -> hashNext;
+            idx                      = ptr_dataNode -> hashKey & (newBucketNum - 1);
+            ptr_dataNode -> hashNext = NULL;
+
+            if(newTails[idx]) newTails[idx] -> hashNext = ptr_dataNode;
+            else              newBuckets[idx]           = ptr_dataNode;
+
+            newTails[idx] = ptr_dataNode;
+        }
+    }
+
+    free(newTails);
+    if(INTD_gvar_hashBuckets) free(INTD_gvar_hashBuckets);
+
+    INTD_gvar_hashBuckets   = newBuckets;
+    INTD_gvar_hashBucketNum = newBucketNum;
+
+    return 0;
+}
+
+/**
+ * Add a data node to the tail of its chain in the hash index. The table grows when the load factor exceeds 1
+ */
+static void INTD_func_hashInsert(INTD_struc_node *dataNode)
+{
+    unsigned int idx;
+    INTD_struc_node **ptr_link;
+
+    if(INTD_gvar_hashNodeNum >= INTD_gvar_hashBucketNum)
+        INTD_func_hashGrow();
+
+    if(!INTD_gvar_hashBuckets) {
+        printf("INTD_func_hashInsert: Failed to allocate the hash index, %s will only be found by list search\n", dataNode -> dataName);
+        INTD_gvar_hashDegraded = 1;
+        return;
+    }
+
+    dataNode -> hashKey  = INTD_func_hashKey(dataNode -> moduleName, dataNode -> dataName);
+    dataNode -> hashNext = NULL;
+    idx                  = dataNode -> hashKey & (INTD_gvar_hashBucketNum - 1);
+
+    for(ptr_link = &INTD_gvar_hashBuckets[idx]; *ptr_link; ptr_link = &(*ptr_link) -> hashNext) ;
+
+    *ptr_link = dataNode;
+    INTD_gvar_hashNodeNum ++;
+}
+
+/**
+ * Look up a data node in the hash index
+ */
+static INTD_struc_node *INTD_func_hashFind(const char *moduleName, const char *dataName)
+{
+    unsigned int hashKey;
+    INTD_struc_node *ptr_dataNode;
+
+    if(!INTD_gvar_hashBuckets) return NULL;
+
+    hashKey = INTD_func_hashKey(moduleName, dataName);
+
+    for(ptr_dataNode = INTD_gvar_hashBuckets[hashKey & (INTD_gvar_hashBucketNum - 1)];
+        ptr_dataNode;
+        ptr_dataNode = ptr_dataNode -> hashNext) {
+
+        if(ptr_dataNode -> hashKey == hashKey &&
+           strcmp(ptr_dataNode -> moduleName, moduleName) == 0 && 
+           strcmp(ptr_dataNode -> dataName, dataName) == 0)
+            return ptr_dataNode;
+    }
+
+    return NULL;
+}
+
+/**
+ * Add a data node to the index of its module. The module name is interned, so the pointers are compared
+ */
+static void INTD_func_modIndexAdd(INTD_struc_node *dataNode)
+{
+    INTD_struc_modIndex *ptr_mod;
+
+    for(ptr_mod = INTD_gvar_modIndex; ptr_mod; ptr_mod = ptr_mod -> next)
+        if(ptr_mod -> moduleName == dataNode -> moduleName) break;
+
+    if(!ptr_mod) {
+        ptr_mod = (INTD_struc_modIndex *)calloc(1, sizeof(INTD_struc_modIndex));
+        if(!ptr_mod) {
+            printf("INTD_func_modIndexAdd: Failed to allocate the module index, %s will not be generated per module\n", dataNode -> dataName);
+            return;
+        }
+
+        ptr_mod -> moduleName = dataNode -> moduleName;
+        ptr_mod -> next       = INTD_gvar_modIndex;
+        INTD_gvar_modIndex    = ptr_mod;
+    }
+
+    dataNode -> modNext = NULL;
+
+    if(ptr_mod -> last) ptr_mod -> last -> modNext = dataNode;
+    else                ptr_mod -> first           = dataNode;
+
+    ptr_mod -> last = dataNode;
+    ptr_mod -> nodeNum ++;
+}
+
+/**
+ * Look up the index of a module, one string comparison per module
+ */
+static INTD_struc_modIndex *INTD_func_modIndexFind(const char *moduleName)
+{
+    INTD_struc_modIndex *ptr_mod;
+
+    for(ptr_mod = INTD_gvar_modIndex; ptr_mod; ptr_mod = ptr_mod -> next)
+        if(strcmp(ptr_mod -> moduleName, moduleName) == 0) return ptr_mod;
+
+    return NULL;
+}
+
 /**
  * Get system time
  */
@@ -95,12 +558,82 @@ static int INTD_func_getDataSize(INTD_enum_dataType dataType)
  */
 static void INTD_func_cleanDataMem()
 {
-    INTD_struc_node *ptr_dataNode = NULL;
+    unsigned int i;
+    INTD_struc_nodeSlab  *ptr_slab;
+    INTD_struc_strChunk  *ptr_chunk;
+    INTD_struc_internStr *ptr_entry;
+
+    /* clean the statistics */
+    while(INTD_gvar_statsList) {
+        INTD_struc_nodeStats *ptr_stats = INTD_gvar_statsList;
+        INTD_gvar_statsList = ptr_stats -> next;
+        free(ptr_stats);
+    }
+
+    /* clean the data nodes, they are released together with the slabs */
+    if(INTD_gvar_dataListInitialized) {
+        INTD_struc_node *ptr_dataNode;
+
+        for(ptr_dataNode = INTD_func_firstNode(); ptr_dataNode; ptr_dataNode = INTD_func_nextNode(ptr_dataNode)) {
+            INTD_API_setFeature(ptr_dataNode, INTD_FEATURE_CHANGE, 0);
+            if(ptr_dataNode -> change) free(ptr_dataNode -> change -> blockHash);
+            free(ptr_dataNode -> change);
+            ptr_dataNode -> change = NULL;
+
+            while(ptr_dataNode -> fieldHandles) {
+                INTD_struc_fieldHandle *ptr_handle = ptr_dataNode -> fieldHandles;
+                ptr_dataNode -> fieldHandles = ptr_handle -> next;
+                free(ptr_handle);
+            }
+            ptr_dataNode -> fieldLast = NULL;
+
+            if(ptr_dataNode -> tripleBuf) {
+                for(i = 0; i < 3; i ++) free(ptr_dataNode -> tripleBuf -> buf[i]);
+                free(ptr_dataNode -> tripleBuf);
+                ptr_dataNode -> tripleBuf = NULL;
+            }
+        }
+    }
+
+    ellInit(&INTD_gvar_dataList);
+
+    while((ptr_slab = INTD_gvar_nodeSlabs)) {
+        INTD_gvar_nodeSlabs = ptr_slab -> next;
+        free(ptr_slab -> mem);
+        free(ptr_slab);
+    }
+
+    /* clean the string pool */
+    for(i = 0; i < INTD_INTERN_BUCKETS; i ++) {
+        while((ptr_entry = INTD_gvar_internStrs[i])) {
+            INTD_gvar_internStrs[i] = ptr_entry -> next;
+            free(ptr_entry);
+        }
+    }
 
-    /* clean the data node in reverse order that they were added */
-    while((ptr_dataNode = (INTD_struc_node *)ellLast(&INTD_gvar_dataList))) {
-        ellDelete(&INTD_gvar_dataList, &ptr_dataNode -> node);
-        free(ptr_dataNode);
+    while((ptr_chunk = INTD_gvar_strChunks)) {
+        INTD_gvar_strChunks = ptr_chunk -> next;
+        free(ptr_chunk);
+    }
+
+    INTD_gvar_nodeSlabNum  = 0;
+    INTD_gvar_strPoolBytes = 0;
+    INTD_gvar_internStrNum = 0;
+    INTD_gvar_internHitNum = 0;
+
+    /* clean the hash index */
+    if(INTD_gvar_hashBuckets) free(INTD_gvar_hashBuckets);
+
+    INTD_gvar_hashBuckets   = NULL;
+    INTD_gvar_hashBucketNum = 0;
+    INTD_gvar_hashNodeNum   = 0;
+    INTD_gvar_hashDegraded  = 0;
+
+    /* clean the module index */
+    while(INTD_gvar_modIndex) {
+        INTD_struc_modIndex *ptr_mod = INTD_gvar_modIndex;
+        INTD_gvar_modIndex = ptr_mod -> next;
+        free(ptr_mod);
     }
 
     /* Print the message */
@@ -152,6 +685,11 @@ INTD_struc_node *INTD_API_createDataNode(const char *moduleName,
         return NULL;
     }
 
+    if(INTD_func_strLen(moduleName, INTD_NAME_LEN) >= INTD_NAME_LEN || INTD_func_strLen(dataName, INTD_NAME_LEN) >= INTD_NAME_LEN) {
+        printf("INTD_API_createDataNode: Module or data name longer than %d characters (%.40s...)\n", INTD_NAME_LEN - 1, dataName);
+        return NULL;
+    }
+
     if(!dataPtr) {
         printf("INTD_API_createDataNode: Illegal data assigned\n");
         return NULL;
@@ -172,7 +710,7 @@ INTD_struc_node *INTD_API_createDataNode(const char *moduleName,
     }
 
     /* Create a new data node */
-    ptr_dataNode = (INTD_struc_node *)calloc(1, sizeof(INTD_struc_node));
+    ptr_dataNode = INTD_func_allocNode();
 
     if(!ptr_dataNode) {
         printf("INTD_API_createDataNode: Failed to create the data node of %s for the module of %s\n", dataName, moduleName);
@@ -181,7 +719,7 @@ INTD_struc_node *INTD_API_createDataNode(const char *moduleName,
 
     /* get the sub-module name and the data name. The input dataName may contains of a '|' character to pass in the sub-module name which
        is only used to generate the record names. The '|' will be converted to '-' to get the final data name */
-    strcpy(dataName_convert, dataName);
+    snprintf(dataName_convert, sizeof(dataName_convert), "%s", dataName);
     
     posVertLine = strchr(dataName_convert, '|'); 
     posEnd      = strchr(dataName_convert, '\0');   
@@ -192,19 +730,20 @@ INTD_struc_node *INTD_API_createDataNode(const char *moduleName,
         strncpy(dataName_recPart,        posVertLine + 1,  posEnd - posVertLine - 1);
         *posVertLine = '-';
     } else {
-        strcpy(dataName_recPart, dataName_convert);
+        snprintf(dataName_recPart, sizeof(dataName_recPart), "%s", dataName_convert);
     }
 
     /* Initalize the data node */
-    strcpy(ptr_dataNode -> moduleName,      moduleName);
-    strcpy(ptr_dataNode -> dataName,        dataName_convert);
-    strcpy(ptr_dataNode -> subModuleName,   dataName_subModPart);
-    strcpy(ptr_dataNode -> recName,         dataName_recPart);    
-    strcpy(ptr_dataNode -> supStr,          supStr);
-    strcpy(ptr_dataNode -> unitStr,         unitStr);
-    strcpy(ptr_dataNode -> desc,            "");
-    strcpy(ptr_dataNode -> alias,           "");
-    strcpy(ptr_dataNode -> asg,             "");
+    ptr_dataNode -> moduleName      = INTD_func_internString(moduleName,          INTD_NAME_LEN);
+    ptr_dataNode -> dataName        = INTD_func_storeString (dataName_convert,    INTD_NAME_LEN);
+    ptr_dataNode -> subModuleName   = INTD_func_internString(dataName_subModPart, INTD_NAME_LEN);
+    ptr_dataNode -> recName         = INTD_func_storeString (dataName_recPart,    INTD_NAME_LEN);
+    ptr_dataNode -> supStr          = INTD_func_internString(supStr,              INTD_SUPSTR_LEN);
+    ptr_dataNode -> unitStr         = INTD_func_internString(unitStr,             INTD_UNITSTR_LEN);
+    ptr_dataNode -> desc            = "";
+    ptr_dataNode -> alias           = "";
+    ptr_dataNode -> asg             = "";
+    ptr_dataNode -> scanEvent       = "";
     
     ptr_dataNode -> dataPtr         = dataPtr;
     ptr_dataNode -> privateData     = privateData;
@@ -217,14 +756,26 @@ INTD_struc_node *INTD_API_createDataNode(const char *moduleName,
     ptr_dataNode -> epicsRecord     = NULL;
     ptr_dataNode -> mutexId         = mutexId;
     ptr_dataNode -> eventId         = eventId;
+    ptr_dataNode -> features        = eventId ? INTD_FEATURE_EVENT : 0;
     ptr_dataNode -> recordType      = recordType;
     ptr_dataNode -> scanType        = scanType;
     ptr_dataNode -> enableCallback  = 1;
+    ptr_dataNode -> lockMode        = INTD_LOCK_MUTEX;
+    ptr_dataNode -> seqCount        = 0;
     ptr_dataNode -> nsta            = UDF_ALARM;
     ptr_dataNode -> nsevr           = INVALID_ALARM;
 
-    /* Add the data node to the list */
+    /* Add the data node to the list (keep the creation order for the file generators), the hash index and the module index */
     ellAdd(&INTD_gvar_dataList, &ptr_dataNode -> node);
+    INTD_func_hashInsert(ptr_dataNode);
+    INTD_func_modIndexAdd(ptr_dataNode);
+
+    if(INTD_gvar_statsEnabled)
+        INTD_func_statsNew(ptr_dataNode);
+
+    /* Custom rates are I/O Intr scans on a shared IOSCANPVT (INTD_PERIOD when the period is set) */
+    if(scanType == INTD_50HZ || scanType == INTD_100HZ)
+        INTD_API_scanAttach(ptr_dataNode);
 
     return ptr_dataNode;
 }
@@ -236,7 +787,7 @@ INTD_struc_node *INTD_API_createDataNode(const char *moduleName,
 int INTD_API_setDescription(INTD_struc_node *dataNode, const char *descStr)
 {
     if(dataNode) 
-        strcpy(dataNode -> desc, descStr);
+        epicsAtomicSetPtrT((void **)&dataNode -> desc, (void *)INTD_func_replaceString(dataNode -> desc, descStr));
 
     return 0;
 }
@@ -252,7 +803,7 @@ int INTD_API_setPrecision(INTD_struc_node *dataNode, unsigned int precVal)
 int INTD_API_setAlias(INTD_struc_node *dataNode, const char *aliasStr)
 {
     if(dataNode) 
-        strcpy(dataNode -> alias, aliasStr);
+        epicsAtomicSetPtrT((void **)&dataNode -> alias, (void *)INTD_func_replaceString(dataNode -> alias, aliasStr));
 
     return 0;    
 }
@@ -260,11 +811,53 @@ int INTD_API_setAlias(INTD_struc_node *dataNode, const char *aliasStr)
 int INTD_API_setAsg(INTD_struc_node *dataNode, const char *asgStr)
 {
     if(dataNode) 
-        strcpy(dataNode -> asg, asgStr);
+        dataNode -> asg = INTD_func_internString(asgStr, INTD_NAME_LEN);
 
     return 0;    
 }
 
+/**
+ * Set the event name (EVNT) of a node with the INTD_EVENT scan, the records are processed by INTD_API_postEvent.
+ *   Refused if the user gave an IOSCANPVT, the records with SCAN=Event would not be scanned by it
+ */
+int INTD_API_setScanEvent(INTD_struc_node *dataNode, const char *eventName)
+{
+    if(!dataNode || !eventName) return -1;
+
+    if(dataNode -> scanType != INTD_EVENT) {
+        printf("INTD_API_setScanEvent: %s.%s is not scanned by event\n", dataNode -> moduleName, dataNode -> dataName);
+        return -1;
+    }
+
+    if(dataNode -> ioIntScan) {
+        printf("INTD_API_setScanEvent: %s.%s has its own IOSCANPVT, not scanned by event\n", dataNode -> moduleName, dataNode -> dataName);
+        return -1;
+    }
+
+    dataNode -> scanEvent = INTD_func_internString(eventName, INTD_NAME_LEN);
+    return 0;
+}
+
+/**
+ * Search a data node in the hash index, or in the list if the hash index is not available
+ */
+static INTD_struc_node *INTD_func_lookupNode(const char *moduleName, const char *dataName)
+{
+    INTD_struc_node *ptr_dataNode = INTD_func_hashFind(moduleName, dataName);
+
+    if(!ptr_dataNode && (INTD_gvar_hashDegraded || !INTD_gvar_hashBuckets) && INTD_gvar_dataListInitialized) {
+        for(ptr_dataNode = INTD_func_firstNode();
+            ptr_dataNode;
+            ptr_dataNode = INTD_func_nextNode(ptr_dataNode)) {
+            
+            if(strcmp(ptr_dataNode -> moduleName, moduleName) == 0 && strcmp(ptr_dataNode -> dataName, dataName) == 0)
+                break;
+        }
+    }
+
+    return ptr_dataNode;
+}
+
 /**
  * Find a data node based on the module name and the data name. This will be called by the record_init function and the
  *   pointer of the record will be also remembered here
@@ -278,7 +871,6 @@ int INTD_API_setAsg(INTD_struc_node *dataNode, const char *asgStr)
  */
 INTD_struc_node *INTD_API_findDataNode(const char *moduleName, const char *dataName, dbCommon *epicsRecord)
 {
-    int              var_nodeFound = 0;
     INTD_struc_node *ptr_dataNode  = NULL;
 
     /* check the input */
@@ -293,18 +885,9 @@ INTD_struc_node *INTD_API_findDataNode(const char *moduleName, const char *dataN
     }
 
     /* find the data node */
-    for(ptr_dataNode = (INTD_struc_node *)ellFirst(&INTD_gvar_dataList);
-        ptr_dataNode;
-        ptr_dataNode = (INTD_struc_node *)ellNext(&ptr_dataNode -> node)) {
-        
-        if(strcmp(ptr_dataNode -> moduleName, moduleName) == 0 && strcmp(ptr_dataNode -> dataName, dataName) == 0) {
-            var_nodeFound = 1;
-            break;
-        }
-
-    }
+    ptr_dataNode = INTD_func_lookupNode(moduleName, dataName);
 
-    if(var_nodeFound) {
+    if(ptr_dataNode) {
         ptr_dataNode -> epicsRecord = epicsRecord;
 
         return ptr_dataNode;
@@ -314,801 +897,2288 @@ INTD_struc_node *INTD_API_findDataNode(const char *moduleName, const char *dataN
 }
 
 /**
- * Get data from the data node. This will be called by the record processing routine for reading data
- * Input:
- *   dataNode       : Data node to get data from
- *   pno            : Number of points to get from the internal data node
- * Output:
- *   data           : The data read out from the node, the buffer should be already defined in the caller
+ * Set the maximum I/O Intr scan rate of the IOSCANPVT used by a data node (see INTD_API_publish)
+ * Input
+ *   moduleName     : Module name
+ *   dataName       : Data name
+ *   maxRate        : Maximum scan rate (Hz), 0 for no limit
  * Return:
  *   0              : Successful
- *  -1              : Failed
+ *   -1             : Failed
  */
-int INTD_API_getData(INTD_struc_node *dataNode, unsigned int pno, void *data)
+int INTD_API_setDataPublishRate(const char *moduleName, const char *dataName, double maxRate)
 {
-    int var_dataSize;
-
-    /* Check the input */
-    if(!dataNode || !data || !dataNode -> dataPtr || pno <= 0) 
-        return -1;
-
-    /* Execute the call back if defined */
-    if(dataNode -> readCallback && dataNode -> enableCallback) 
-        (*dataNode -> readCallback)(dataNode -> privateData);
-    
-    if(!dataNode -> enableCallback)
-        dataNode -> enableCallback = 1;
+    INTD_struc_node *ptr_dataNode = NULL;
 
-    /* Get the data size */
-    var_dataSize = INTD_func_getDataSize(dataNode -> dataType);
+    if(!moduleName || !dataName) return -1;
 
-    /* Get the data based on the size */
-    if(dataNode -> mutexId) epicsMutexMustLock(dataNode -> mutexId);
+    ptr_dataNode = INTD_func_lookupNode(moduleName, dataName);
 
-    if(pno > 1) {                                                   /* array */       
-        memcpy(data, dataNode -> dataPtr, pno * var_dataSize);
-    } else if(pno == 1) {                                           /* single value (these code to remove the overhead from memcpy) */
-        switch(dataNode -> dataType) {
-            case INTD_CHAR:     *((epicsInt8    *)data) = *((epicsInt8    *)dataNode -> dataPtr); break;
-            case INTD_UCHAR:    *((epicsUInt8   *)data) = *((epicsUInt8   *)dataNode -> dataPtr); break;
-            case INTD_SHORT:    *((epicsInt16   *)data) = *((epicsInt16   *)dataNode -> dataPtr); break;
-            case INTD_USHORT:   *((epicsUInt16  *)data) = *((epicsUInt16  *)dataNode -> dataPtr); break;
-            case INTD_INT:      *((epicsInt32   *)data) = *((epicsInt32   *)dataNode -> dataPtr); break;
-            case INTD_UINT:     *((epicsUInt32  *)data) = *((epicsUInt32  *)dataNode -> dataPtr); break;
-            case INTD_LONG:     *((epicsInt32   *)data) = *((epicsInt32   *)dataNode -> dataPtr); break;
-            case INTD_ULONG:    *((epicsUInt32  *)data) = *((epicsUInt32  *)dataNode -> dataPtr); break;
-            case INTD_FLOAT:    *((epicsFloat32 *)data) = *((epicsFloat32 *)dataNode -> dataPtr); break;
-            case INTD_DOUBLE:   *((epicsFloat64 *)data) = *((epicsFloat64 *)dataNode -> dataPtr); break;
-            case INTD_OLDSTRING: *((char        *)data) = *((char         *)dataNode -> dataPtr); break;
-            default: break;
-        }
+    if(!ptr_dataNode || !ptr_dataNode -> ioIntScan) {
+        printf("INTD_API_setDataPublishRate: Data node %s.%s not found or without I/O Intr scan\n", moduleName, dataName);
+        return -1;
     }
 
-    if(dataNode -> mutexId) epicsMutexUnlock(dataNode -> mutexId);
-
-    /* Signal the event if it is specified */
-    if(dataNode -> eventId) epicsEventSignal(dataNode -> eventId);
-
-    return 0;
+    return INTD_API_setPublishRate(ptr_dataNode -> ioIntScan, maxRate);
 }
 
 /**
- * Put data from the data node. This will be called by the record processing routine for writing data
- * Input:
- *   dataNode       : Data node to get data from
- *   pno            : Number of points to get from the internal data node
- *   data           : The data write to the node, the buffer should be already defined in the caller
- * Return:
- *   0              : Successful
- *  -1              : Failed
+ * Switch the data node to complete the writes of its record asynchronously
  */
-int INTD_API_putData(INTD_struc_node *dataNode, unsigned int pno, void *data)
+int INTD_API_setDataAsyncWrite(const char *moduleName, const char *dataName, int enable)
 {
-    int var_dataSize;
-
-    /* Check the input */
-    if(!dataNode || !data || !dataNode -> dataPtr || pno <= 0) 
-        return -1;
+    INTD_struc_node *ptr_dataNode = NULL;
 
-    /* Get the data size */
-    var_dataSize = INTD_func_getDataSize(dataNode -> dataType);
+    if(!moduleName || !dataName) return -1;
 
-    /* Put the data based on the size */
-    if(dataNode -> mutexId) epicsMutexMustLock(dataNode -> mutexId);
+    ptr_dataNode = INTD_func_lookupNode(moduleName, dataName);
 
-    if(pno > 1) {                                                   /* array */
-        memcpy(dataNode -> dataPtr, data, pno * var_dataSize);
+    if(!ptr_dataNode) {
+        printf("INTD_API_setDataAsyncWrite: Data node %s.%s not found\n", moduleName, dataName);
+        return -1;
+    }
+
+    return INTD_API_setAsyncWrite(ptr_dataNode, enable);
+}
+
+/**
+ * Execute the read callback of the data node on the worker pool, ahead of the periodic scan
+ */
+int INTD_API_setDataPrefetch(const char *moduleName, const char *dataName, int enable, double budget)
+{
+    INTD_struc_node *ptr_dataNode = NULL;
+
+    if(!moduleName || !dataName) return -1;
+
+    ptr_dataNode = INTD_func_lookupNode(moduleName, dataName);
+
+    if(!ptr_dataNode) {
+        printf("INTD_API_setDataPrefetch: Data node %s.%s not found\n", moduleName, dataName);
+        return -1;
+    }
+
+    return INTD_API_setPrefetch(ptr_dataNode, enable, budget);
+}
+
+/**
+ * Declare the derived statistics of a waveform node
+ */
+int INTD_API_setDataWfStats(const char *moduleName, const char *dataName, unsigned int statMask)
+{
+    INTD_struc_node *ptr_dataNode = NULL;
+
+    if(!moduleName || !dataName) return -1;
+
+    ptr_dataNode = INTD_func_lookupNode(moduleName, dataName);
+
+    if(!ptr_dataNode) {
+        printf("INTD_API_setDataWfStats: Data node %s.%s not found\n", moduleName, dataName);
+        return -1;
+    }
+
+    return INTD_API_addWfStats(ptr_dataNode, statMask);
+}
+
+/**
+ * Attach a decimated view to a waveform node
+ */
+int INTD_API_setDataWfView(const char *moduleName, const char *dataName, const char *suffix, INTD_enum_wfViewType viewType, unsigned int points)
+{
+    INTD_struc_node *ptr_dataNode = NULL;
+
+    if(!moduleName || !dataName) return -1;
+
+    ptr_dataNode = INTD_func_lookupNode(moduleName, dataName);
+
+    if(!ptr_dataNode) {
+        printf("INTD_API_setDataWfView: Data node %s.%s not found\n", moduleName, dataName);
+        return -1;
+    }
+
+    return INTD_API_addWfView(ptr_dataNode, suffix, viewType, points) ? 0 : -1;
+}
+
+/**
+ * Keep the history of a scalar node
+ */
+int INTD_API_setDataHistory(const char *moduleName, const char *dataName, unsigned int depth)
+{
+    INTD_struc_node *ptr_dataNode = NULL;
+
+    if(!moduleName || !dataName) return -1;
+
+    ptr_dataNode = INTD_func_lookupNode(moduleName, dataName);
+
+    if(!ptr_dataNode) {
+        printf("INTD_API_setDataHistory: Data node %s.%s not found\n", moduleName, dataName);
+        return -1;
+    }
+
+    return INTD_API_addHistory(ptr_dataNode, depth);
+}
+
+/**
+ * Move the buffer of a waveform node to a shared memory segment
+ */
+int INTD_API_setDataShm(const char *moduleName, const char *dataName, const char *segName)
+{
+    INTD_struc_node *ptr_dataNode = NULL;
+
+    if(!moduleName || !dataName) return -1;
+
+    ptr_dataNode = INTD_func_lookupNode(moduleName, dataName);
+
+    if(!ptr_dataNode) {
+        printf("INTD_API_setDataShm: Data node %s.%s not found\n", moduleName, dataName);
+        return -1;
+    }
+
+    return INTD_API_shmAttach(ptr_dataNode, segName);
+}
+
+/**
+ * Add the points [first, end) to the dirty ranges of the node
+ */
+static void INTD_func_dirtyExtend(INTD_struc_dirty *dirty, unsigned int first, unsigned int end)
+{
+    if(first >= end) return;
+
+    if(first < dirty -> readFirst) dirty -> readFirst = first;
+    if(end   > dirty -> readEnd)   dirty -> readEnd   = end;
+    if(first < dirty -> pubFirst)  dirty -> pubFirst  = first;
+    if(end   > dirty -> pubEnd)    dirty -> pubEnd    = end;
+}
+
+/**
+ * Copy an array with the dirty range tracked. The record bound to the node (passed by its device support) keeps
+ *   its buffer in sync and only copies the points changed since its last read, other readers get a full copy.
+ *   Called with the lock held
+ */
+static void INTD_func_readDirty(INTD_struc_node *dataNode, unsigned int pno, void *data, const void *buf, dbCommon *record)
+{
+    unsigned int first, end;
+    unsigned int size = INTD_func_getDataSize(dataNode -> dataType);
+    INTD_struc_dirty *dirty = dataNode -> dirty;
+
+    if(!record || record != dataNode -> epicsRecord) {
+        memcpy(data, buf, (size_t)pno * size);
+        return;
+    }
+
+    if(pno != dirty -> readerPno) {                                 /* first read, or the size read changed */
+        first = 0;
+        end   = pno;
+        dirty -> readerPno = pno;
+    } else {
+        first = dirty -> readFirst;
+        end   = dirty -> readEnd < pno ? dirty -> readEnd : pno;
+    }
+
+    if(first < end) {
+        memcpy((char *)data + (size_t)first * size, (const char *)buf + (size_t)first * size, (size_t)(end - first) * size);
+        dirty -> pointsRead += end - first;
+    }
+
+    dirty -> pointsFull += pno;
+    dirty -> readFirst   = dataNode -> pno;
+    dirty -> readEnd     = 0;
+}
+
+/**
+ * Exchange an integer atomically, return the old value
+ */
+static int INTD_func_atomicExchange(int *target, int newVal)
+{
+    int oldVal;
+
+    do {
+        oldVal = epicsAtomicGetIntT(target);
+    } while(epicsAtomicCmpAndSwapIntT(target, oldVal, newVal) != oldVal);
+
+    return oldVal;
+}
+
+/**
+ * Allocate the buffers of the triple-buffer mode, all initialized with the current data
+ */
+static int INTD_func_tripleBufInit(INTD_struc_node *dataNode)
+{
+    int i;
+    size_t size = (size_t)dataNode -> pno * INTD_func_getDataSize(dataNode -> dataType);
+    INTD_struc_tripleBuf *tbuf;
+
+    if(dataNode -> tripleBuf) return 0;
+
+    tbuf = (INTD_struc_tripleBuf *)calloc(1, sizeof(INTD_struc_tripleBuf));
+    if(!tbuf) return -1;
+
+    for(i = 0; i < 3; i ++) {
+        tbuf -> buf[i] = malloc(size);
+
+        if(!tbuf -> buf[i]) {
+            while(i --) free(tbuf -> buf[i]);
+            free(tbuf);
+            return -1;
+        }
+
+        memcpy(tbuf -> buf[i], dataNode -> dataPtr, size);
+    }
+
+    tbuf -> back   = 0;
+    tbuf -> middle = 1;
+    tbuf -> front  = 2;
+
+    epicsAtomicWriteMemoryBarrier();
+    dataNode -> tripleBuf = tbuf;
+    return 0;
+}
+
+/**
+ * Latest published buffer of the triple-buffer mode, called with the node mutex held (no writer can publish).
+ *   It is the middle buffer if the record did not take it yet, otherwise the front buffer of the record. The
+ *   front index is not read, the record may be between its swap and the update of the index
+ */
+static int INTD_func_tripleBufLatest(INTD_struc_tripleBuf *tbuf)
+{
+    int middle = epicsAtomicGetIntT(&tbuf -> middle);
+
+    if(middle & INTD_TBUF_FRESH) return middle & ~INTD_TBUF_FRESH;
+
+    return 3 - tbuf -> back - middle;                               /* the buffer that is neither back nor middle */
+}
+
+/**
+ * Take the latest published buffer as the front buffer of the record, without lock
+ */
+static void *INTD_func_tripleBufTake(INTD_struc_tripleBuf *tbuf)
+{
+    if(epicsAtomicGetIntT(&tbuf -> middle) & INTD_TBUF_FRESH)
+        tbuf -> front = INTD_func_atomicExchange(&tbuf -> middle, tbuf -> front) & ~INTD_TBUF_FRESH;
+
+    epicsAtomicReadMemoryBarrier();
+    return tbuf -> buf[tbuf -> front];
+}
+
+/**
+ * Protect a write access of the data buffer. The mutex (if defined) is always taken to serialize the writers,
+ *   in the sequence-lock mode the counter is odd during the write to invalidate the concurrent reads. In the
+ *   triple-buffer mode the back buffer holds the data of two writes ago, the latest data is copied into it
+ *   so that the points not written keep their values. INTD_API_writeBeginFull skips the copy for a write of
+ *   all the points
+ */
+static void INTD_func_writeBegin(INTD_struc_node *dataNode, int full)
+{
+    INTD_struc_tripleBuf *tbuf;
+
+    if(dataNode -> mutexId) epicsMutexMustLock(dataNode -> mutexId);
+
+    dataNode -> strLen = 0;                                         /* unknown until INTD_func_writeString sets it */
+
+    if(dataNode -> lockMode == INTD_LOCK_SEQLOCK) {
+        epicsAtomicIncrIntT(&dataNode -> seqCount);
+        epicsAtomicWriteMemoryBarrier();
+    } else if(dataNode -> lockMode == INTD_LOCK_SHARED) {
+        INTD_API_shmWriteBegin(dataNode);
+    } else if(dataNode -> lockMode == INTD_LOCK_TRIPLEBUF && !full) {
+        tbuf = dataNode -> tripleBuf;
+
+        epicsAtomicReadMemoryBarrier();
+        memcpy(tbuf -> buf[tbuf -> back], tbuf -> buf[INTD_func_tripleBufLatest(tbuf)],
+               (size_t)dataNode -> pno * INTD_func_getDataSize(dataNode -> dataType));
+    }
+}
+
+/**
+ * Long string nodes (lso/lsi records) only copy the characters of the string, not the whole buffer. The length
+ *   is kept by INTD_func_writeString, after the other writes (in place, LocalPV) it is searched in the buffer
+ */
+#define INTD_IS_LONG_STRING(dataNode) ((dataNode) -> recordType == INTD_LSO || (dataNode) -> recordType == INTD_LSI)
+
+static unsigned int INTD_func_readString(INTD_struc_node *dataNode, unsigned int size, char *str, const char *buf)
+{
+    unsigned int len = dataNode -> strLen;
+
+    if(!len) len = (unsigned int)INTD_func_strLen(buf, dataNode -> pno);
+    if(len > size - 1) len = size - 1;
+
+    memcpy(str, buf, len);
+    str[len] = '\0';
+
+    return len;
+}
+
+static unsigned int INTD_func_writeString(INTD_struc_node *dataNode, unsigned int len, const char *str, char *buf)
+{
+    if(len > dataNode -> pno - 1) len = dataNode -> pno - 1;
+    len = (unsigned int)INTD_func_strLen(str, len);
+
+    memcpy(buf, str, len);
+    buf[len] = '\0';
+
+    dataNode -> strLen = len;
+    return len;
+}
+
+/**
+ * Copy the data out of / into the data node, following the lock mode of the node. For the long strings,
+ *   pno is the size of the string with the terminating 0 (LEN of the lso/lsi records) and the read returns
+ *   the length of the string copied, otherwise pno. record is the record reading the data, NULL for the other
+ *   readers. In the triple-buffer mode, the record bound to the node takes the latest buffer without lock
+ */
+static int INTD_func_readData(INTD_struc_node *dataNode, unsigned int pno, void *data, dbCommon *record)
+{
+    unsigned int seq;
+    int len = (int)pno;
+    void *buf;
+
+    if(dataNode -> lockMode == INTD_LOCK_TRIPLEBUF && record && record == dataNode -> epicsRecord) {
+        buf = INTD_func_tripleBufTake(dataNode -> tripleBuf);
+        memcpy(data, buf, (size_t)pno * INTD_func_getDataSize(dataNode -> dataType));
+        return len;
+    }
+
+    /* Get the data based on the size (retried in the sequence-lock mode if a writer was active) */
+    do {
+        seq = INTD_API_readBegin(dataNode);
+        buf = INTD_API_readBuffer(dataNode);
+
+        if(INTD_IS_LONG_STRING(dataNode)) {                         /* long string */
+            len = (int)INTD_func_readString(dataNode, pno, (char *)data, (const char *)buf);
+        } else if(pno > 1) {                                        /* array */       
+            if(INTD_HAS_FEATURE(dataNode, INTD_FEATURE_DIRTY))
+                INTD_func_readDirty(dataNode, pno, data, buf, record);
+            else
+                memcpy(data, buf, pno * INTD_func_getDataSize(dataNode -> dataType));
+        } else if(pno == 1) {                                       /* single value (these code to remove the overhead from memcpy) */
+            switch(dataNode -> dataType) {
+                case INTD_CHAR:     *((epicsInt8    *)data) = *((epicsInt8    *)buf); break;
+                case INTD_UCHAR:    *((epicsUInt8   *)data) = *((epicsUInt8   *)buf); break;
+                case INTD_SHORT:    *((epicsInt16   *)data) = *((epicsInt16   *)buf); break;
+                case INTD_USHORT:   *((epicsUInt16  *)data) = *((epicsUInt16  *)buf); break;
+                case INTD_INT:      *((epicsInt32   *)data) = *((epicsInt32   *)buf); break;
+                case INTD_UINT:     *((epicsUInt32  *)data) = *((epicsUInt32  *)buf); break;
+                case INTD_LONG:     *((epicsInt32   *)data) = *((epicsInt32   *)buf); break;
+                case INTD_ULONG:    *((epicsUInt32  *)data) = *((epicsUInt32  *)buf); break;
+                case INTD_FLOAT:    *((epicsFloat32 *)data) = *((epicsFloat32 *)buf); break;
+                case INTD_DOUBLE:   *((epicsFloat64 *)data) = *((epicsFloat64 *)buf); break;
+                case INTD_OLDSTRING: *((char        *)data) = *((char         *)buf); break;
+                default: break;
+            }
+        }
+    } while(INTD_API_readRetry(dataNode, seq));
+
+    /* only the shared memory mode ends with an odd counter: the external writer stalled, the data may be torn */
+    if(seq & 1) return -1;
+
+    return len;
+}
+
+static void INTD_func_writeData(INTD_struc_node *dataNode, unsigned int pno, void *data)
+{
+    void *buf;
+
+    /* Put the data based on the size, the other points keep their values */
+    INTD_func_writeBegin(dataNode, pno >= dataNode -> pno);
+    buf = INTD_API_writeBuffer(dataNode);
+
+    if(INTD_IS_LONG_STRING(dataNode)) {                             /* long string, without the terminating 0 of the input */
+        INTD_func_writeString(dataNode, pno - 1, (const char *)data, (char *)buf);
+    } else if(pno > 1) {                                            /* array */
+        memcpy(buf, data, pno * INTD_func_getDataSize(dataNode -> dataType));
     } else if(pno == 1) {                                           /* single value (these code to remove the overhead from memcpy) */
         switch(dataNode -> dataType) {
-            case INTD_CHAR:     *((epicsInt8    *)dataNode -> dataPtr) = *((epicsInt8    *)data); break;
-            case INTD_UCHAR:    *((epicsUInt8   *)dataNode -> dataPtr) = *((epicsUInt8   *)data); break;
-            case INTD_SHORT:    *((epicsInt16   *)dataNode -> dataPtr) = *((epicsInt16   *)data); break;
-            case INTD_USHORT:   *((epicsUInt16  *)dataNode -> dataPtr) = *((epicsUInt16  *)data); break;
-            case INTD_INT:      *((epicsInt32   *)dataNode -> dataPtr) = *((epicsInt32   *)data); break;
-            case INTD_UINT:     *((epicsUInt32  *)dataNode -> dataPtr) = *((epicsUInt32  *)data); break;
-            case INTD_LONG:     *((epicsInt32   *)dataNode -> dataPtr) = *((epicsInt32   *)data); break;
-            case INTD_ULONG:    *((epicsUInt32  *)dataNode -> dataPtr) = *((epicsUInt32  *)data); break;
-            case INTD_FLOAT:    *((epicsFloat32 *)dataNode -> dataPtr) = *((epicsFloat32 *)data); break;
-            case INTD_DOUBLE:   *((epicsFloat64 *)dataNode -> dataPtr) = *((epicsFloat64 *)data); break;
-            case INTD_OLDSTRING: *((char        *)dataNode -> dataPtr) = *((char         *)data); break;
+            case INTD_CHAR:     *((epicsInt8    *)buf) = *((epicsInt8    *)data); break;
+            case INTD_UCHAR:    *((epicsUInt8   *)buf) = *((epicsUInt8   *)data); break;
+            case INTD_SHORT:    *((epicsInt16   *)buf) = *((epicsInt16   *)data); break;
+            case INTD_USHORT:   *((epicsUInt16  *)buf) = *((epicsUInt16  *)data); break;
+            case INTD_INT:      *((epicsInt32   *)buf) = *((epicsInt32   *)data); break;
+            case INTD_UINT:     *((epicsUInt32  *)buf) = *((epicsUInt32  *)data); break;
+            case INTD_LONG:     *((epicsInt32   *)buf) = *((epicsInt32   *)data); break;
+            case INTD_ULONG:    *((epicsUInt32  *)buf) = *((epicsUInt32  *)data); break;
+            case INTD_FLOAT:    *((epicsFloat32 *)buf) = *((epicsFloat32 *)data); break;
+            case INTD_DOUBLE:   *((epicsFloat64 *)buf) = *((epicsFloat64 *)data); break;
+            case INTD_OLDSTRING: *((char        *)buf) = *((char         *)data); break;
             default: break;
         }
     }
 
-    if(dataNode -> mutexId) epicsMutexUnlock(dataNode -> mutexId);
+    if(dataNode -> pno > 1 && !INTD_IS_LONG_STRING(dataNode))       /* valid points of the array, for the statistics */
+        dataNode -> validPno = pno < dataNode -> pno ? pno : 0;
+
+    INTD_API_writeEnd(dataNode);
+}
+
+/**
+ * Execute a callback and add its duration to the histogram. The bin i counts the durations below 2^i us,
+ *   the last bin counts all longer ones
+ */
+static void INTD_func_statsCallback(INTD_struc_nodeStats *stats, INTD_CALLBACK callback, void *privateData, epicsTimeStamp *now)
+{
+    epicsTimeStamp t0;
+    double dt;
+    unsigned int bin = 0;
+
+    epicsTimeGetCurrent(&t0);
+    (*callback)(privateData);
+    epicsTimeGetCurrent(now);
+
+    dt = epicsTimeDiffInSeconds(now, &t0);
+    if(dt < 0) dt = 0;
+
+    while(bin < INTD_STATS_HIST_BINS - 1 && dt * 1e6 >= (double)(1u << bin))
+        bin ++;
+
+    epicsAtomicIncrSizeT(&stats -> cbHist[bin]);
+    epicsAtomicIncrSizeT(&stats -> cbNum);
+    stats -> cbTotal += dt;
+    if(dt > stats -> cbMax) stats -> cbMax = dt;
+}
+
+/**
+ * getData/putData with the access statistics, only used when the statistics are enabled
+ */
+static int INTD_func_getDataStats(INTD_struc_node *dataNode, unsigned int pno, void *data, dbCommon *record, int prefetched)
+{
+    INTD_struc_nodeStats *stats = dataNode -> stats;
+    epicsTimeStamp now;
+    int len;
+
+    if(dataNode -> readCallback && dataNode -> enableCallback && !prefetched) 
+        INTD_func_statsCallback(stats, dataNode -> readCallback, dataNode -> privateData, &now);
+    else
+        epicsTimeGetCurrent(&now);
+    
+    if(!dataNode -> enableCallback)
+        dataNode -> enableCallback = 1;
+
+    len = INTD_func_readData(dataNode, pno, data, record);
+
+    epicsAtomicIncrSizeT(&stats -> getCnt);
+    stats -> bytesGet   += (double)pno * INTD_func_getDataSize(dataNode -> dataType);
+    stats -> lastAccess  = now;
+
+    if(INTD_HAS_FEATURE(dataNode, INTD_FEATURE_EVENT)) epicsEventSignal(dataNode -> eventId);
+
+    return (int)len;
+}
+
+static int INTD_func_putDataStats(INTD_struc_node *dataNode, unsigned int pno, void *data)
+{
+    INTD_struc_nodeStats *stats = dataNode -> stats;
+    epicsTimeStamp now;
+
+    INTD_func_writeData(dataNode, pno, data);
+
+    if(dataNode -> writeCallback && dataNode -> enableCallback) 
+        INTD_func_statsCallback(stats, dataNode -> writeCallback, dataNode -> privateData, &now);
+    else
+        epicsTimeGetCurrent(&now);
+
+    if(!dataNode -> enableCallback)
+        dataNode -> enableCallback = 1;
+
+    epicsAtomicIncrSizeT(&stats -> putCnt);
+    stats -> bytesPut   += (double)pno * INTD_func_getDataSize(dataNode -> dataType);
+    stats -> lastAccess  = now;
+
+    if(INTD_HAS_FEATURE(dataNode, INTD_FEATURE_EVENT)) epicsEventSignal(dataNode -> eventId);
+
+    return 0;
+}
+
+/**
+ * Size in bytes of one element of the data type
+ */
+int INTD_API_getDataSize(INTD_enum_dataType dataType)
+{
+    return INTD_func_getDataSize(dataType);
+}
+
+/**
+ * Get data from the data node. This will be called by the record processing routine for reading data
+ * Input:
+ *   dataNode       : Data node to get data from
+ *   pno            : Number of points to get from the internal data node
+ * Output:
+ *   data           : The data read out from the node, the buffer should be already defined in the caller
+ * Return:
+ *   0              : Successful
+ *  -1              : Failed
+ */
+int INTD_API_getData(INTD_struc_node *dataNode, unsigned int pno, void *data)
+{
+    return INTD_API_getRecordData(dataNode, pno, data, NULL);
+}
+
+/**
+ * Read the data for a record, return the number of points (length of the long string) or -1
+ */
+static int INTD_func_getRecordData(INTD_struc_node *dataNode, unsigned int pno, void *data, dbCommon *record)
+{
+    int prefetched = 0;
+    int len;
+
+    /* Check the input */
+    if(!dataNode || !data || !dataNode -> dataPtr || pno <= 0) 
+        return -1;
+
+    /* The read callback is executed ahead of the scan by the worker pool, only check the age of the data */
+    if(INTD_HAS_FEATURE(dataNode, INTD_FEATURE_PREFETCH))
+        prefetched = INTD_API_prefetchCheck(dataNode) >= 0;
+
+    /* Collect the access statistics if enabled */
+    if(INTD_HAS_FEATURE(dataNode, INTD_FEATURE_STATS))
+        return INTD_func_getDataStats(dataNode, pno, data, record, prefetched);
+
+    /* Execute the call back if defined */
+    if(dataNode -> readCallback && dataNode -> enableCallback && !prefetched) 
+        (*dataNode -> readCallback)(dataNode -> privateData);
+    
+    if(!dataNode -> enableCallback)
+        dataNode -> enableCallback = 1;
+
+    /* Get the data */
+    len = INTD_func_readData(dataNode, pno, data, record);
+
+    /* Signal the event if it is specified */
+    if(INTD_HAS_FEATURE(dataNode, INTD_FEATURE_EVENT)) epicsEventSignal(dataNode -> eventId);
+
+    return (int)len;
+}
+
+/**
+ * Get data from the data node for a record, same as INTD_API_getData. The array records pass themselves, so
+ *   that the record bound to the node (INTD_API_findDataNode) is told apart from the other readers: it takes
+ *   the latest buffer without lock in the triple-buffer mode and only copies the changed points when the
+ *   dirty range is tracked
+ * Input:
+ *   record         : The record reading the data
+ */
+int INTD_API_getRecordData(INTD_struc_node *dataNode, unsigned int pno, void *data, dbCommon *record)
+{
+    return INTD_func_getRecordData(dataNode, pno, data, record) < 0 ? -1 : 0;
+}
+
+/**
+ * Get the long string of the data node for the lsi record, same as INTD_API_getRecordData but returns the
+ *   length of the string (kept by the node, no search for the terminating 0)
+ * Input:
+ *   size           : Size of the string buffer including the terminating 0 (SIZV)
+ * Return:
+ *   >=0            : Length of the string
+ *  -1              : Failed
+ */
+int INTD_API_getRecordString(INTD_struc_node *dataNode, char *str, unsigned int size, dbCommon *record)
+{
+    if(!dataNode || !INTD_IS_LONG_STRING(dataNode)) return -1;
+
+    return INTD_func_getRecordData(dataNode, size, (void *)str, record);
+}
+
+/**
+ * Put data from the data node. This will be called by the record processing routine for writing data
+ * Input:
+ *   dataNode       : Data node to get data from
+ *   pno            : Number of points to get from the internal data node
+ *   data           : The data write to the node, the buffer should be already defined in the caller
+ * Return:
+ *   0              : Successful
+ *  -1              : Failed
+ */
+int INTD_API_putData(INTD_struc_node *dataNode, unsigned int pno, void *data)
+{
+    /* Check the input */
+    if(!dataNode || !data || !dataNode -> dataPtr || pno <= 0) 
+        return -1;
+
+    /* Collect the access statistics if enabled */
+    if(INTD_HAS_FEATURE(dataNode, INTD_FEATURE_STATS))
+        return INTD_func_putDataStats(dataNode, pno, data);
+
+    /* Put the data */
+    INTD_func_writeData(dataNode, pno, data);
+
+    /* Execute the call back if defined */    
+    if(dataNode -> writeCallback && dataNode -> enableCallback) 
+        (*dataNode -> writeCallback)(dataNode -> privateData);    
+
+    if(!dataNode -> enableCallback)
+        dataNode -> enableCallback = 1;
+
+    /* Signal the event if it is specified */
+    if(INTD_HAS_FEATURE(dataNode, INTD_FEATURE_EVENT)) epicsEventSignal(dataNode -> eventId);
+
+    return 0;
+}
+
+/**
+ * Put data to the data node from an output record, with the write callback executed by the worker pool
+ *   when the node is in the asynchronous mode. The record is processed twice: the first call writes the
+ *   data, queues the callback and sets PACT; the second call (PACT set, from the worker) completes it.
+ *   Without the asynchronous mode, or when the queue is full, it is the same as INTD_API_putData
+ * Input:
+ *   dataNode       : Data node to put data to
+ *   pno            : Number of points to put to the internal data node
+ *   data           : The data write to the node
+ *   epicsRecord    : The record being processed
+ * Return:
+ *   0              : Successful
+ *  -1              : Failed
+ */
+int INTD_API_putDataAsync(INTD_struc_node *dataNode, unsigned int pno, void *data, dbCommon *epicsRecord)
+{
+    if(!dataNode || !epicsRecord || !dataNode -> async)
+        return INTD_API_putData(dataNode, pno, data);
+
+    /* Completion, the data was written and the callback executed in the first phase */
+    if(epicsRecord -> pact)
+        return 0;
+
+    /* Nothing slow to move away from this thread */
+    if(!dataNode -> writeCallback || !dataNode -> enableCallback)
+        return INTD_API_putData(dataNode, pno, data);
+
+    if(!data || !dataNode -> dataPtr || pno <= 0) 
+        return -1;
+
+    INTD_func_writeData(dataNode, pno, data);
+
+    if(INTD_HAS_FEATURE(dataNode, INTD_FEATURE_STATS)) {
+        epicsAtomicIncrSizeT(&dataNode -> stats -> putCnt);
+        dataNode -> stats -> bytesPut += (double)pno * INTD_func_getDataSize(dataNode -> dataType);
+        epicsTimeGetCurrent(&dataNode -> stats -> lastAccess);
+    }
+
+    epicsRecord -> pact = TRUE;
+    if(INTD_API_asyncSubmit(dataNode, epicsRecord) == 0)
+        return 0;
+
+    /* Asynchronous mode disabled or queue full, execute the callback here */
+    epicsRecord -> pact = FALSE;
+
+    (*dataNode -> writeCallback)(dataNode -> privateData);
+
+    if(INTD_HAS_FEATURE(dataNode, INTD_FEATURE_EVENT)) epicsEventSignal(dataNode -> eventId);
+
+    return 0;
+}
+
+/**
+ * Write a string to a long string node (INTD_LSO/INTD_LSI) with one bounded copy. The length is kept in the
+ *   node, so the lsi record only copies the characters of the string. No callback is executed, as for the
+ *   other writes of the producer
+ * Input:
+ *   dataNode       : Long string node
+ *   str            : The string, need not be terminated
+ *   len            : Number of characters, truncated to the size of the node - 1
+ * Return:
+ *   Number of characters written, -1 if failed
+ */
+int INTD_API_putString(INTD_struc_node *dataNode, const char *str, unsigned int len)
+{
+    if(!dataNode || !str || !dataNode -> dataPtr || !INTD_IS_LONG_STRING(dataNode))
+        return -1;
+
+    INTD_API_writeBegin(dataNode);
+    len = INTD_func_writeString(dataNode, len, str, (char *)INTD_API_writeBuffer(dataNode));
+    INTD_API_writeEnd(dataNode);
+
+    return (int)len;
+}
+
+/**
+ * Read the string of a long string node (INTD_LSO/INTD_LSI), the output is always terminated
+ * Input:
+ *   size           : Size of the output buffer with the terminating 0
+ * Return:
+ *   Length of the string read, -1 if failed
+ */
+int INTD_API_getString(INTD_struc_node *dataNode, char *str, unsigned int size)
+{
+    unsigned int seq, len;
+
+    if(!dataNode || !str || size == 0 || !dataNode -> dataPtr || !INTD_IS_LONG_STRING(dataNode))
+        return -1;
+
+    do {
+        seq = INTD_API_readBegin(dataNode);
+        len = INTD_func_readString(dataNode, size, str, (const char *)INTD_API_readBuffer(dataNode));
+    } while(INTD_API_readRetry(dataNode, seq));
+
+    return (int)len;
+}
+
+/**
+ * Set or clear a INTD_FEATURE_* bit of the node. The bit is set after the block is published (the barrier makes
+ *   the pointer visible first) and must be cleared before the block is detached
+ * Input:
+ *   dataNode       : Data node
+ *   feature        : INTD_FEATURE_* bit
+ *   enable         : 1 to set, 0 to clear
+ */
+void INTD_API_setFeature(INTD_struc_node *dataNode, int feature, int enable)
+{
+    int oldVal, newVal;
+
+    epicsAtomicWriteMemoryBarrier();
+
+    do {
+        oldVal = epicsAtomicGetIntT(&dataNode -> features);
+        newVal = enable ? (oldVal | feature) : (oldVal & ~feature);
+    } while(epicsAtomicCmpAndSwapIntT(&dataNode -> features, oldVal, newVal) != oldVal);
+}
+
+/**
+ * Select the locking strategy of the data buffer. The sequence-lock mode lets the readers (record processing or
+ *   user code) copy the data without blocking the writer: a reader retries if a write happened meanwhile. It is
+ *   only allowed for scalars and small arrays (INTD_SEQLOCK_MAX_SIZE bytes), so that a retried copy stays cheap.
+ *   Writers still take the node mutex (if defined) to serialize among themselves.
+ * The triple-buffer mode is for large arrays: the writer fills a back buffer and publishes it by swapping it
+ *   with the middle buffer, the record bound to the node (INTD_API_getRecordData) takes the latest published
+ *   buffer by swapping its front buffer with the middle one. Neither side waits for the other and the record
+ *   copies without any lock. The other readers (LocalPV, statistics, views, change detection) copy the latest
+ *   published buffer with the node mutex held, without swapping, so the node must have a mutex. A write
+ *   section starts with a copy of the latest data in the back buffer, unless it is declared to write all the
+ *   points (INTD_API_writeBeginFull). The mode cannot be left once selected.
+ * The mode must be selected before iocInit, the readers do not expect it to change between readBegin and readRetry.
+ * Input:
+ *   dataNode       : Data node to be configured
+ *   lockMode       : INTD_LOCK_MUTEX, INTD_LOCK_SEQLOCK or INTD_LOCK_TRIPLEBUF
+ * Return:
+ *   0              : Successful
+ *  -1              : Failed
+ */
+int INTD_API_setLockMode(INTD_struc_node *dataNode, INTD_enum_lockMode lockMode)
+{
+    if(!dataNode) return -1;
+
+    if(lockMode == dataNode -> lockMode) return 0;
+
+    if(INTD_gvar_iocInitDone) {                                     /* a reader in readBegin/readRetry must see the same mode */
+        printf("INTD_API_setLockMode: Must be called before iocInit (%s.%s)\n", dataNode -> moduleName, dataNode -> dataName);
+        return -1;
+    }
+
+    if(dataNode -> lockMode == INTD_LOCK_TRIPLEBUF) {
+        printf("INTD_API_setLockMode: Data of %s can not leave the triple-buffer mode\n", dataNode -> dataName);
+        return -1;
+    }
+
+    if(dataNode -> lockMode == INTD_LOCK_SHARED || lockMode == INTD_LOCK_SHARED) {
+        printf("INTD_API_setLockMode: The shared memory mode of %s is only set by INTD_API_shmAttach\n", dataNode -> dataName);
+        return -1;
+    }
+
+    if(lockMode != INTD_LOCK_MUTEX && dataNode -> dirty) {
+        printf("INTD_API_setLockMode: Data of %s has the dirty range tracked, only the mutex mode is allowed\n", dataNode -> dataName);
+        return -1;
+    }
+
+    if(lockMode == INTD_LOCK_SEQLOCK && dataNode -> pno * INTD_func_getDataSize(dataNode -> dataType) > INTD_SEQLOCK_MAX_SIZE) {
+        printf("INTD_API_setLockMode: Data of %s is too large for the sequence-lock mode\n", dataNode -> dataName);
+        return -1;
+    }
+
+    if(lockMode == INTD_LOCK_TRIPLEBUF) {
+        if(dataNode -> pno <= 1 || INTD_IS_LONG_STRING(dataNode)) {
+            printf("INTD_API_setLockMode: Triple-buffer mode is only for arrays (%s)\n", dataNode -> dataName);
+            return -1;
+        }
+
+        if(!dataNode -> mutexId) {
+            printf("INTD_API_setLockMode: Triple-buffer mode needs the mutex of the node (%s)\n", dataNode -> dataName);
+            return -1;
+        }
+
+        epicsMutexMustLock(dataNode -> mutexId);
+        if(INTD_func_tripleBufInit(dataNode) != 0) {
+            epicsMutexUnlock(dataNode -> mutexId);
+            printf("INTD_API_setLockMode: Failed to allocate the buffers for %s\n", dataNode -> dataName);
+            return -1;
+        }
+
+        dataNode -> lockMode = lockMode;
+        epicsMutexUnlock(dataNode -> mutexId);
+        return 0;
+    }
+
+    dataNode -> lockMode = lockMode;
+    return 0;
+}
+
+/**
+ * Protect a read access of the data buffer. Usage:
+ *   do {
+ *       seq = INTD_API_readBegin(dataNode);
+ *       ... copy from INTD_API_readBuffer(dataNode) ...
+ *   } while(INTD_API_readRetry(dataNode, seq));
+ * In the mutex mode, the mutex is held between the two calls and the loop runs once. In the sequence-lock mode, 
+ *   the copy is repeated until no writer touched the buffer meanwhile. In the triple-buffer mode, the mutex is
+ *   held and the latest published buffer is read in place (only the record swaps buffers, see
+ *   INTD_API_getRecordData), so any number of readers can use the node. The shared memory mode is
+ *   the sequence-lock mode on the counter in the segment, which the external process also bumps. An odd
+ *   seq after the loop tells that the external writer stalled and the copy is not valid
+ */
+unsigned int INTD_API_readBegin(INTD_struc_node *dataNode)
+{
+    unsigned int seq;
+    unsigned int spin = 0;
+    INTD_struc_tripleBuf *tbuf;
+
+    if(dataNode -> lockMode == INTD_LOCK_TRIPLEBUF) {           /* read the latest published buffer, the writers wait */
+        tbuf = dataNode -> tripleBuf;
+
+        epicsMutexMustLock(dataNode -> mutexId);
+        tbuf -> shared = INTD_func_tripleBufLatest(tbuf);
+
+        epicsAtomicReadMemoryBarrier();
+        return 0;
+    }
+
+    if(dataNode -> lockMode == INTD_LOCK_SHARED)
+        return INTD_API_shmReadBegin(dataNode);
+
+    if(dataNode -> lockMode == INTD_LOCK_SEQLOCK) {
+        while((seq = (unsigned int)epicsAtomicGetIntT(&dataNode -> seqCount)) & 1) {
+            if(++ spin > 1000) {                                    /* writer preempted, give it the CPU */
+                epicsThreadSleep(0.0);
+                spin = 0;
+            }
+        }
+
+        epicsAtomicReadMemoryBarrier();
+        return seq;
+    }
+
+    if(dataNode -> mutexId) epicsMutexMustLock(dataNode -> mutexId);
+    return 0;
+}
+
+int INTD_API_readRetry(INTD_struc_node *dataNode, unsigned int seq)
+{
+    if(dataNode -> lockMode == INTD_LOCK_TRIPLEBUF) {
+        epicsMutexUnlock(dataNode -> mutexId);
+        return 0;
+    }
+
+    if(dataNode -> lockMode == INTD_LOCK_SHARED)
+        return INTD_API_shmReadRetry(dataNode, seq);
+
+    if(dataNode -> lockMode == INTD_LOCK_SEQLOCK) {
+        epicsAtomicReadMemoryBarrier();
+        return (unsigned int)epicsAtomicGetIntT(&dataNode -> seqCount) != seq;
+    }
+
+    if(dataNode -> mutexId) epicsMutexUnlock(dataNode -> mutexId);
+    return 0;
+}
+
+/**
+ * Start a write section, see INTD_func_writeBegin. INTD_API_writeBeginFull is for a write of all the points
+ */
+void INTD_API_writeBegin(INTD_struc_node *dataNode)
+{
+    INTD_func_writeBegin(dataNode, 0);
+}
+
+void INTD_API_writeBeginFull(INTD_struc_node *dataNode)
+{
+    INTD_func_writeBegin(dataNode, 1);
+    dataNode -> validPno = 0;
+}
+
+void INTD_API_writeEnd(INTD_struc_node *dataNode)
+{
+    INTD_struc_tripleBuf *tbuf;
+
+    if(dataNode -> lockMode == INTD_LOCK_SEQLOCK) {
+        epicsAtomicWriteMemoryBarrier();
+        epicsAtomicIncrIntT(&dataNode -> seqCount);
+    } else if(dataNode -> lockMode == INTD_LOCK_SHARED) {
+        INTD_API_shmWriteEnd(dataNode);
+    } else if(dataNode -> lockMode == INTD_LOCK_TRIPLEBUF) {    /* publish the back buffer */
+        tbuf = dataNode -> tripleBuf;
+
+        epicsAtomicWriteMemoryBarrier();
+        tbuf -> back = INTD_func_atomicExchange(&tbuf -> middle, tbuf -> back | INTD_TBUF_FRESH) & ~INTD_TBUF_FRESH;
+    }
+
+    /* a write section without INTD_API_markDirty may have changed any point */
+    if(INTD_HAS_FEATURE(dataNode, INTD_FEATURE_DIRTY)) {
+        if(!dataNode -> dirty -> marked) {
+            INTD_func_dirtyExtend(dataNode -> dirty, 0, dataNode -> pno);
+            dataNode -> dirty -> fullCnt ++;
+        }
+
+        dataNode -> dirty -> marked = 0;
+    }
+
+    if(dataNode -> mutexId) epicsMutexUnlock(dataNode -> mutexId);
+}
+
+/**
+ * Hold the data buffer for reading in place (without copy) until INTD_API_readUnlock. The node mutex is taken,
+ *   so the writers wait meanwhile. In the triple-buffer mode the buffer is the latest published one. Not possible
+ *   for a buffer in shared memory written by the external process (WFI), which does not take the mutex
+ * Return:
+ *   The buffer, NULL if the node is not defined
+ */
+const void *INTD_API_readLock(INTD_struc_node *dataNode)
+{
+    if(!dataNode || (dataNode -> lockMode == INTD_LOCK_SHARED && dataNode -> recordType == INTD_WFI)) return NULL;
+
+    if(dataNode -> lockMode == INTD_LOCK_TRIPLEBUF) {
+        INTD_API_readBegin(dataNode);
+        return INTD_API_readBuffer(dataNode);
+    }
+
+    if(dataNode -> mutexId) epicsMutexMustLock(dataNode -> mutexId);
+    return dataNode -> dataPtr;
+}
+
+void INTD_API_readUnlock(INTD_struc_node *dataNode)
+{
+    if(!dataNode || (dataNode -> lockMode == INTD_LOCK_SHARED && dataNode -> recordType == INTD_WFI)) return;
+
+    if(dataNode -> mutexId) epicsMutexUnlock(dataNode -> mutexId);
+}
+
+/**
+ * Buffer to be accessed between INTD_API_readBegin/INTD_API_readRetry or INTD_API_writeBegin/INTD_API_writeEnd.
+ *   It is the latest published (read) or back (write) buffer in the triple-buffer mode and the data pointer otherwise
+ */
+void *INTD_API_readBuffer(INTD_struc_node *dataNode)
+{
+    if(dataNode -> lockMode == INTD_LOCK_TRIPLEBUF)
+        return dataNode -> tripleBuf -> buf[dataNode -> tripleBuf -> shared];
+
+    return dataNode -> dataPtr;
+}
+
+void *INTD_API_writeBuffer(INTD_struc_node *dataNode)
+{
+    if(dataNode -> lockMode == INTD_LOCK_TRIPLEBUF)
+        return dataNode -> tripleBuf -> buf[dataNode -> tripleBuf -> back];
+
+    return dataNode -> dataPtr;
+}
+
+/**
+ * Contention benchmark of the mutex and the sequence-lock modes (INTD_API_lockBenchmark)
+ */
+#define INTD_LOCKBENCH_PNO      8                                   /* doubles copied per access, one cache line */
+
+typedef struct {
+    int                 stop;
+    int                 running;                                    /* threads not finished yet */
+    epicsEventId        doneEvent;
+} INTD_struc_lockBench;
+
+typedef struct {
+    INTD_struc_node    *dataNode;
+    unsigned long       count;                                      /* accesses done */
+    unsigned long       retries;                                    /* copies repeated by a reader */
+} INTD_struc_lockBenchThread;
+
+static INTD_struc_lockBench *INTD_gvar_lockBenchShared = NULL;
+
+static void INTD_func_lockBenchReader(void *arg)
+{
+    INTD_struc_lockBenchThread *ptr_thread = (INTD_struc_lockBenchThread *)arg;
+    INTD_struc_lockBench       *ptr_shared = INTD_gvar_lockBenchShared;
+    INTD_struc_node *dataNode = ptr_thread -> dataNode;
+    epicsFloat64 copy[INTD_LOCKBENCH_PNO];
+    unsigned int seq;
+    int loops;
+
+    while(!epicsAtomicGetIntT(&ptr_shared -> stop)) {
+        loops = 0;
+        do {
+            seq = INTD_API_readBegin(dataNode);
+            memcpy(copy, INTD_API_readBuffer(dataNode), sizeof(copy));
+            loops ++;
+        } while(INTD_API_readRetry(dataNode, seq));
+
+        ptr_thread -> count   ++;
+        ptr_thread -> retries += loops - 1;
+    }
+
+    if(epicsAtomicDecrIntT(&ptr_shared -> running) == 0)
+        epicsEventSignal(ptr_shared -> doneEvent);
+}
+
+static void INTD_func_lockBenchWriter(void *arg)
+{
+    INTD_struc_lockBenchThread *ptr_thread = (INTD_struc_lockBenchThread *)arg;
+    INTD_struc_lockBench       *ptr_shared = INTD_gvar_lockBenchShared;
+    INTD_struc_node *dataNode = ptr_thread -> dataNode;
+    epicsFloat64 *data;
+    unsigned int i;
+
+    while(!epicsAtomicGetIntT(&ptr_shared -> stop)) {
+        INTD_API_writeBegin(dataNode);
+        data = (epicsFloat64 *)INTD_API_writeBuffer(dataNode);
+        for(i = 0; i < INTD_LOCKBENCH_PNO; i ++)
+            data[i] = (epicsFloat64)ptr_thread -> count;
+        INTD_API_writeEnd(dataNode);
+
+        ptr_thread -> count ++;
+    }
+
+    if(epicsAtomicDecrIntT(&ptr_shared -> running) == 0)
+        epicsEventSignal(ptr_shared -> doneEvent);
+}
+
+/**
+ * Measure the accesses of one writer and several readers on a node in the mutex and the sequence-lock modes,
+ *   the writer and the readers running all the time (worst contention). A private node is used, not in the list
+ * Input:
+ *   readerNum      : Number of reader threads (default 2)
+ *   seconds        : Time of each run (default 1 s)
+ */
+void INTD_API_lockBenchmark(unsigned int readerNum, double seconds)
+{
+    static const INTD_enum_lockMode modes[] = {INTD_LOCK_MUTEX, INTD_LOCK_SEQLOCK};
+    static const char *modeNames[]          = {"mutex  ", "seqlock"};
+
+    unsigned int i, m;
+    unsigned long readCount, retries;
+    epicsFloat64 data[INTD_LOCKBENCH_PNO];
+    INTD_struc_node node;
+    INTD_struc_lockBench        shared;
+    INTD_struc_lockBenchThread *threads;
+
+    if(readerNum == 0)  readerNum = 2;
+    if(seconds  <= 0.0) seconds   = 1.0;
+
+    /* claim the benchmark, two shells calling it at the same time must not share the threads */
+    memset(&shared, 0, sizeof(shared));
+
+    if(epicsAtomicCmpAndSwapPtrT((void **)&INTD_gvar_lockBenchShared, NULL, &shared) != NULL) {
+        printf("INTD_API_lockBenchmark: Benchmark already running\n");
+        return;
+    }
+
+    threads = (INTD_struc_lockBenchThread *)calloc(readerNum + 1, sizeof(INTD_struc_lockBenchThread));
+    if(!threads) {
+        printf("INTD_API_lockBenchmark: Failed to allocate memory\n");
+        epicsAtomicSetPtrT((void **)&INTD_gvar_lockBenchShared, NULL);
+        return;
+    }
+
+    memset(&node, 0, sizeof(node));
+    memset(data,  0, sizeof(data));
+
+    node.moduleName = "INTD_BENCH";
+    node.dataName   = "DATA";
+    node.dataPtr    = data;
+    node.pno        = INTD_LOCKBENCH_PNO;
+    node.dataType   = INTD_DOUBLE;
+    node.mutexId    = epicsMutexMustCreate();
+
+    shared.doneEvent = epicsEventMustCreate(epicsEventEmpty);
+
+    printf("INTD lock modes, 1 writer, %u readers, %u doubles, %.1f s per mode:\n", readerNum, INTD_LOCKBENCH_PNO, seconds);
+
+    for(m = 0; m < sizeof(modes) / sizeof(modes[0]); m ++) {
+        node.lockMode = modes[m];
+        node.seqCount = 0;
+
+        epicsAtomicSetIntT(&shared.stop, 0);
+        epicsAtomicSetIntT(&shared.running, (int)readerNum + 1);
+
+        for(i = 0; i <= readerNum; i ++) {
+            memset(&threads[i], 0, sizeof(threads[i]));
+            threads[i].dataNode = &node;
+
+            epicsThreadCreate(i == 0 ? "INTD_benchW" : "INTD_benchR", epicsThreadPriorityMedium,
+                              epicsThreadGetStackSize(epicsThreadStackSmall),
+                              i == 0 ? INTD_func_lockBenchWriter : INTD_func_lockBenchReader, &threads[i]);
+        }
+
+        epicsThreadSleep(seconds);
+        epicsAtomicSetIntT(&shared.stop, 1);
+        epicsEventMustWait(shared.doneEvent);
+
+        for(i = 1, readCount = 0, retries = 0; i <= readerNum; i ++) {
+            readCount += threads[i].count;
+            retries   += threads[i].retries;
+        }
+
+        printf("    %s: writes %10.0f/s, reads %10.0f/s (%.0f/s per reader), read retries %.2f%%\n", modeNames[m],
+                threads[0].count / seconds, readCount / seconds, readCount / seconds / readerNum,
+                readCount ? 100.0 * retries / readCount : 0.0);
+    }
+
+    epicsEventDestroy(shared.doneEvent);
+    epicsMutexDestroy(node.mutexId);
+    free(threads);
+
+    epicsAtomicSetPtrT((void **)&INTD_gvar_lockBenchShared, NULL);
+}
+
+/**
+ * Track the range of an array node changed by the writers, so that the record, the change detection and the
+ *   derived views only handle the modified points. The writers declare the points they changed with
+ *   INTD_API_putDataRange or INTD_API_markDirty, a write section (INTD_API_writeBegin/INTD_API_writeEnd)
+ *   without them marks the whole array. The record bound to the node (reading through INTD_API_getRecordData)
+ *   copies only the points changed since its last read into its buffer, so the data must only be written through these routines, not directly.
+ *   Only for the mutex mode, the tracking cannot be disabled once selected
+ * Return:
+ *   0              : Successful
+ *  -1              : Failed
+ */
+int INTD_API_enableDirtyRange(INTD_struc_node *dataNode)
+{
+    INTD_struc_dirty *dirty;
+
+    if(!dataNode) return -1;
+    if(dataNode -> dirty) return 0;
+
+    if(dataNode -> pno <= 1 || dataNode -> lockMode != INTD_LOCK_MUTEX) {
+        printf("INTD_API_enableDirtyRange: Dirty range only for arrays in the mutex mode (%s)\n", dataNode -> dataName);
+        return -1;
+    }
+
+    dirty = (INTD_struc_dirty *)calloc(1, sizeof(INTD_struc_dirty));
+    if(!dirty) {
+        printf("INTD_API_enableDirtyRange: Failed to allocate memory for %s\n", dataNode -> dataName);
+        return -1;
+    }
+
+    dirty -> readFirst = dirty -> pubFirst = dataNode -> pno;        /* empty, the first read copies all */
+
+    if(dataNode -> mutexId) epicsMutexMustLock(dataNode -> mutexId);
+    dataNode -> dirty = dirty;
+    INTD_API_setFeature(dataNode, INTD_FEATURE_DIRTY, 1);
+    if(dataNode -> mutexId) epicsMutexUnlock(dataNode -> mutexId);
+
+    return 0;
+}
+
+int INTD_API_setDataDirtyRange(const char *moduleName, const char *dataName)
+{
+    INTD_struc_node *ptr_dataNode = NULL;
+
+    if(!moduleName || !dataName) return -1;
+
+    ptr_dataNode = INTD_func_lookupNode(moduleName, dataName);
+
+    if(!ptr_dataNode) {
+        printf("INTD_API_setDataDirtyRange: Data node %s.%s not found\n", moduleName, dataName);
+        return -1;
+    }
+
+    return INTD_API_enableDirtyRange(ptr_dataNode);
+}
+
+/**
+ * Declare the points [first, first + pno) changed in the current write section (between INTD_API_writeBegin
+ *   and INTD_API_writeEnd), may be called several times. No effect if the range is not tracked
+ */
+void INTD_API_markDirty(INTD_struc_node *dataNode, unsigned int first, unsigned int pno)
+{
+    INTD_struc_dirty *dirty = dataNode -> dirty;
+
+    if(!dirty) return;
+
+    if(first < dataNode -> pno && pno > 0)
+        INTD_func_dirtyExtend(dirty, first, pno > dataNode -> pno - first ? dataNode -> pno : first + pno);
+
+    if(!dirty -> marked) dirty -> rangeCnt ++;
+    dirty -> marked = 1;
+}
+
+/**
+ * Write the points [first, first + pno) of an array node. With the dirty range tracked, the points are only
+ *   copied and marked if they changed
+ * Return:
+ *   Number of points written, -1 if failed
+ */
+int INTD_API_putDataRange(INTD_struc_node *dataNode, unsigned int first, unsigned int pno, const void *data)
+{
+    unsigned int size;
+    char *buf;
+
+    if(!dataNode || !data || !dataNode -> dataPtr || first >= dataNode -> pno || pno == 0)
+        return -1;
+
+    if(dataNode -> lockMode == INTD_LOCK_TRIPLEBUF) {               /* the back buffer holds older data */
+        printf("INTD_API_putDataRange: Partial writes not allowed in the triple-buffer mode (%s)\n", dataNode -> dataName);
+        return -1;
+    }
+
+    if(pno > dataNode -> pno - first) pno = dataNode -> pno - first;
+    size = INTD_func_getDataSize(dataNode -> dataType);
+
+    INTD_API_writeBegin(dataNode);
+    buf = (char *)INTD_API_writeBuffer(dataNode) + (size_t)first * size;
+
+    if(dataNode -> dirty && memcmp(buf, data, (size_t)pno * size) == 0) {
+        dataNode -> dirty -> skipCnt ++;
+        INTD_API_markDirty(dataNode, first, 0);
+    } else {
+        memcpy(buf, data, (size_t)pno * size);
+        INTD_API_markDirty(dataNode, first, pno);
+    }
+
+    if(dataNode -> validPno && first + pno > dataNode -> validPno)   /* the valid points extend to the range */
+        dataNode -> validPno = first + pno < dataNode -> pno ? first + pno : 0;
+
+    INTD_API_writeEnd(dataNode);
+    return (int)pno;
+}
+
+/**
+ * Read the points [first, first + pno) of an array node
+ * Return:
+ *   Number of points read, -1 if failed
+ */
+int INTD_API_getDataRange(INTD_struc_node *dataNode, unsigned int first, unsigned int pno, void *data)
+{
+    unsigned int seq, size;
+
+    if(!dataNode || !data || !dataNode -> dataPtr || first >= dataNode -> pno || pno == 0)
+        return -1;
+
+    if(pno > dataNode -> pno - first) pno = dataNode -> pno - first;
+    size = INTD_func_getDataSize(dataNode -> dataType);
+
+    do {
+        seq = INTD_API_readBegin(dataNode);
+        memcpy(data, (char *)INTD_API_readBuffer(dataNode) + (size_t)first * size, (size_t)pno * size);
+    } while(INTD_API_readRetry(dataNode, seq));
+
+    return (int)pno;
+}
+
+/**
+ * Take the points changed since the last publish, [*first, *end) is empty if none
+ */
+static void INTD_func_dirtyTakePublish(INTD_struc_node *dataNode, unsigned int *first, unsigned int *end)
+{
+    if(dataNode -> mutexId) epicsMutexMustLock(dataNode -> mutexId);
+
+    *first = dataNode -> dirty -> pubFirst;
+    *end   = dataNode -> dirty -> pubEnd;
+
+    dataNode -> dirty -> pubFirst = dataNode -> pno;
+    dataNode -> dirty -> pubEnd   = 0;
+
+    if(dataNode -> mutexId) epicsMutexUnlock(dataNode -> mutexId);
+}
+
+/**
+ * Print the nodes with the dirty range tracked: writes with range, full writes, range writes without change
+ *   and the fraction of the points copied to the record
+ */
+void INTD_API_dirtyReport(const char *moduleName)
+{
+    INTD_struc_node *dataNode;
+    INTD_struc_dirty *dirty;
+
+    printf("INTD dirty range tracking:\n");
+
+    for(dataNode = INTD_API_firstNode(); dataNode; dataNode = INTD_API_nextNode(dataNode)) {
+        if(!(dirty = dataNode -> dirty)) continue;
+        if(moduleName && moduleName[0] && strcmp(moduleName, "MOD_ALL") != 0 && strcmp(moduleName, dataNode -> moduleName) != 0) continue;
+
+        printf("    %s.%s (%u points): range writes %lu, full writes %lu, unchanged %lu, copied %.1f%%\n",
+                dataNode -> moduleName, dataNode -> dataName, dataNode -> pno,
+                dirty -> rangeCnt, dirty -> fullCnt, dirty -> skipCnt,
+                dirty -> pointsFull > 0 ? dirty -> pointsRead * 100.0 / dirty -> pointsFull : 0.0);
+    }
+}
+
+/**
+ * Records that are processed on request (settings, I/O Intr, event) rather than periodically
+ */
+static int INTD_func_eventDriven(INTD_struc_node *dataNode)
+{
+    return dataNode -> scanType == INTD_IOINT || dataNode -> scanType == INTD_PASSIVE || dataNode -> scanType == INTD_EVENT;
+}
+
+/**
+ * Generate the full file name of path and file name (without path if it is empty), fail if it does not fit in the buffer
+ */
+static int INTD_func_genFileName(char *fullFileName, size_t size, const char *path, const char *fileName, const char *funcName)
+{
+    int var_len;
+
+    if(path && path[0]) var_len = snprintf(fullFileName, size, "%s/%s", path, fileName);
+    else                var_len = snprintf(fullFileName, size, "%s", fileName);
+
+    if(var_len < 0 || (size_t)var_len >= size) {
+        printf("%s: File name too long (%s/%s)\n", funcName, path ? path : "", fileName);
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * Generate records for the internal data
+ * Input:
+ *   moduleName:    the module instance that this file for. Please note that the module name will be hardcoded in the file
+ *   path:          the path for the file
+ *   dbFileName:    full file name of the output db file
+ * Return:
+ *   0              : Successful
+ *  -1              : Failed
+ */
+int INTD_API_genRecord(const char *moduleName, const char *path, const char *dbFileName)
+{
+    /* check the input */
+    if(!dbFileName || !dbFileName[0]) return -1;
+
+    return INTD_API_genFiles(moduleName, path, dbFileName, NULL, NULL, NULL, NULL, 0, 0, 0, NULL);
+}
+
+/**
+ * Generate save/restore request file for the internal data
+ * Input:
+ *   moduleName:    the module instance that this file for. Please note that the module name will be hardcoded in the file
+ *   path:          the path for the file
+ *   reqFileName:   full file name of the output req file
+ *   withMacro:     chose to use macro or hardcoded PV names (0 - same module name; 1 - use macro; 2 - use destModuleName)
+ *   sel:           0 - scalar output PVs; 1 - waveform output PVs; 2 - all output PVs
+ *   destModuleName:generate a file for other module with the same type
+ * Return:
+ *   0              : Successful
+ *  -1              : Failed
+ */
+int INTD_API_genSRReqt(const char *moduleName, const char *path, const char *reqFileName, int withMacro, int sel, const char *destModuleName)
+{
+    /* check the input */
+    if(!reqFileName || !reqFileName[0]) return -1;
+
+    return INTD_API_genFiles(moduleName, path, NULL, reqFileName, NULL, NULL, NULL, withMacro, sel, 0, destModuleName);
+}
+
+/**
+ * Generate archiver configuration file
+ * Input:
+ *   moduleName:    the module instance that this file for. Please note that the module name will be hardcoded in the file
+ *   path:          the path for the file
+ *   confFileName:  full file name of the output config file
+ *   methodStr:     string for archive method for short/medium/long term. These apply only on the results PVs (IPV) with periodic scanning
+ *   withMacro:     chose to use macro or hardcoded PV names (0 - same module name; 1 - use macro; 2 - use destModuleName)
+ *   sel:           0 - short term; 1 - medium term; 2 - long term; 3 - combined
+ *   destModuleName:generate a file for other module with the same type
+ * Return:
+ *   0              : Successful
+ *  -1              : Failed
+ */
+int INTD_API_genArchive(const char *moduleName, const char *path, const char *confFileName, const char *methodStr, int withMacro, int sel, const char *destModuleName)
+{
+    /* check the input */
+    if(!confFileName || !confFileName[0]) return -1;
+
+    return INTD_API_genFiles(moduleName, path, NULL, NULL, confFileName, NULL, methodStr, withMacro, 0, sel, destModuleName);
+}
+
+/**
+ * Generate a list file for the internal data
+ * Input:
+ *   moduleName:    the module instance that this file for. Please note that the module name will be hardcoded in the file
+ *   path:          the path for the file
+ *   lstFileName:   full file name of the output list file
+ * Return:
+ *   0              : Successful
+ *  -1              : Failed
+ */
+int INTD_API_genDbList(const char *moduleName, const char *path, const char *lstFileName)
+{
+    /* check the input */
+    if(!lstFileName || !lstFileName[0]) return -1;
+
+    return INTD_API_genFiles(moduleName, path, NULL, NULL, NULL, lstFileName, NULL, 0, 0, 0, NULL);
+}
+
+/**
+ * Streaming file generation. The artefacts of genRecord, genSRReqt, genArchive and genDbList are written
+ *   in one traversal of the nodes of the module (module index, or the full list for MOD_ALL) into fully
+ *   buffered files. The node strings are passed directly without copying to the stack
+ */
+#define INTD_GEN_FILE_BUF_SIZE  65536                               /* stdio buffer of each generated file */
+#define INTD_GEN_NAME_MAX       512                                 /* max length of the PV names and archive method in the req/archive files */
+
+typedef struct {
+    FILE               *dbFile;
+    FILE               *reqFile;
+    FILE               *confFile;
+    FILE               *lstFile;
+    int                 withMacro;
+    int                 reqSel;
+    const char         *destModName;
+    const char         *OPVArchiveMethod;
+    const char         *IPVArchiveMethod;
+    char                lineBuf[INTD_GEN_NAME_MAX * 20];            /* PV name and the lines of one node for the req/archive files */
+} INTD_struc_genCtx;
+
+static const char *INTD_gvar_limitFields[] = {".HIHI", ".HIGH", ".LOW", ".LOLO", ".DRVL", ".DRVH", ".LSV", ".HSV"};
+
+/**
+ * Field data type string of the waveform records
+ */
+static const char *INTD_func_ftvlStr(INTD_enum_dataType dataType)
+{
+    switch(dataType) {
+        case INTD_CHAR:         return "CHAR";
+        case INTD_UCHAR:        return "UCHAR";
+        case INTD_SHORT:        return "SHORT";
+        case INTD_USHORT:       return "USHORT";
+        case INTD_INT:          return "LONG";
+        case INTD_UINT:         return "ULONG";
+        case INTD_LONG:         return "LONG";
+        case INTD_ULONG:        return "ULONG";
+        case INTD_FLOAT:        return "FLOAT";
+        case INTD_DOUBLE:       return "DOUBLE";
+        case INTD_OLDSTRING:    return "STRING";
+        default:                return "";
+    }
+}
+
+/**
+ * Open a generated file with a large stdio buffer. Empty file name means the file is not requested
+ */
+static FILE *INTD_func_genOpen(const char *path, const char *fileName)
+{
+    char var_fullFileName[256] = "";
+    FILE *var_outFile;
+
+    if(INTD_func_genFileName(var_fullFileName, sizeof(var_fullFileName), path, fileName, "INTD_API_genFiles") != 0) return NULL;
+
+    var_outFile = fopen(var_fullFileName, "w");
+
+    if(!var_outFile) {
+        printf("INTD_API_genFiles: Failed to create file of %s\n", var_fullFileName);
+        return NULL;
+    }
+
+    setvbuf(var_outFile, NULL, _IOFBF, INTD_GEN_FILE_BUF_SIZE);
+    return var_outFile;
+}
+
+/**
+ * Append a string to the line buffer, return the new end
+ */
+static char *INTD_func_genAppend(char *dst, const char *str)
+{
+    size_t len = strlen(str);
+
+    memcpy(dst, str, len);
+    return dst + len;
+}
+
+/**
+ * Write the PV name with the limit fields for the req/archive files, all lines of the node with one write.
+ *   The method is NULL for the req file
+ *   withBase:   write the PV itself
+ *   withLimits: write the alarm limit and severity fields
+ *   withDrv:    also write the DRVL/DRVH fields (output records)
+ */
+static void INTD_func_genPVs(INTD_struc_genCtx *ctx, FILE *outFile, const char *prefix, INTD_struc_node *dataNode, int withBase, int withLimits, int withDrv, const char *method)
+{
+    unsigned int i;
+    size_t var_nameLen;
+    char *ptr_out, *ptr_end;
+
+    if(strlen(prefix) + strlen(dataNode -> subModuleName) + strlen(dataNode -> recName) >= INTD_GEN_NAME_MAX ||
+       (method && strlen(method) >= INTD_GEN_NAME_MAX)) {
+        printf("INTD_func_genPVs: PV name or archive method too long for %s\n", dataNode -> dataName);
+        return;
+    }
+
+    /* the PV name is built once at the beginning of the buffer, the lines follow it */
+    ptr_end = INTD_func_genAppend(ctx -> lineBuf, prefix);
+    ptr_end = INTD_func_genAppend(ptr_end, dataNode -> subModuleName);
+    *ptr_end ++ = ':';
+    ptr_end = INTD_func_genAppend(ptr_end, dataNode -> recName);
+
+    var_nameLen = ptr_end - ctx -> lineBuf;
+    ptr_out     = ptr_end;
+
+    for(i = withBase ? 0 : 1; i <= (withLimits ? 8 : 0); i ++) {
+        if(!withDrv && (i == 5 || i == 6)) continue;                /* DRVL, DRVH */
+
+        memcpy(ptr_end, ctx -> lineBuf, var_nameLen);
+        ptr_end += var_nameLen;
+
+        if(i > 0) ptr_end = INTD_func_genAppend(ptr_end, INTD_gvar_limitFields[i - 1]);
+
+        if(method) {
+            *ptr_end ++ = ' ';
+            ptr_end = INTD_func_genAppend(ptr_end, method);
+        }
+
+        *ptr_end ++ = '\n';
+    }
+
+    fwrite(ptr_out, 1, ptr_end - ptr_out, outFile);
+}
+
+/**
+ * Write the head of a record (name, alias, DESC, SCAN and ASG fields) to the db file
+ */
+static void INTD_func_genRecHead(FILE *dbFile, INTD_struc_node *dataNode, const char *recType, const char *descPrefix, const char *scanMethod)
+{
+    fprintf(dbFile, "record(%s, $(name_space)$(module_name)%s:%s) {\n", recType, dataNode -> subModuleName, dataNode -> recName);
+
+    if(dataNode -> alias[0])
+        fprintf(dbFile, "        alias($(name_space)$(module_name)-%s)\n", dataNode -> alias);
+
+    fprintf(dbFile, "        field(DESC, \"%s%s\")\n        field(SCAN, \"%s\")\n        field(ASG, \"%s\")\n",
+            descPrefix, dataNode -> desc, scanMethod, dataNode -> asg);
+}
+
+/**
+ * Write the link field (INP or OUT) to the data node
+ */
+static void INTD_func_genRecLink(FILE *dbFile, INTD_struc_node *dataNode, const char *linkField)
+{
+    fprintf(dbFile, "        field(%s, \"@$(module_name).%s\")\n", linkField, dataNode -> dataName);
+}
+
+/**
+ * Write the state strings of the mbbo/mbbi records (ZRST;ONST;...). The pieces are taken from the additional
+ *   string of the node without copying, the missing ones are empty
+ */
+static void INTD_func_genRecStates(FILE *dbFile, INTD_struc_node *dataNode)
+{
+    static const char *var_fields[] = {"ZRST", "ONST", "TWST", "THST", "FRST", "FVST", "SXST", "SVST",
+                                       "EIST", "NIST", "TEST", "ELST", "TVST", "TTST", "FTST", "FFST"};
+    int i, var_len;
+    const char *ptr_str = dataNode -> supStr;
+    const char *ptr_sep = NULL;
+
+    for(i = 0; i < 16; i ++) {
+        if(ptr_str) {
+            ptr_sep = strchr(ptr_str, ';');
+            var_len = ptr_sep ? (int)(ptr_sep - ptr_str) : (int)strlen(ptr_str);
+        } else {
+            var_len = 0;
+        }
+
+        fprintf(dbFile, "        field(%s, \"%.*s\")\n", var_fields[i], var_len, ptr_str ? ptr_str : "");
+
+        ptr_str = (ptr_str && ptr_sep) ? ptr_sep + 1 : NULL;        /* the last piece has no separator */
+    }
+}
+
+/**
+ * Write the end of a record, with the EVNT field for the INTD_EVENT scan
+ */
+static void INTD_func_genRecEnd(FILE *dbFile, INTD_struc_node *dataNode)
+{
+    if(dataNode -> scanType == INTD_EVENT && dataNode -> scanEvent[0])
+        fprintf(dbFile, "        field(EVNT, \"%s\")\n", dataNode -> scanEvent);
 
-    /* Execute the call back if defined */    
-    if(dataNode -> writeCallback && dataNode -> enableCallback) 
-        (*dataNode -> writeCallback)(dataNode -> privateData);    
+    fputs("}\n\n", dbFile);
+}
 
-    if(!dataNode -> enableCallback)
-        dataNode -> enableCallback = 1;
+/**
+ * Write the record of one data node to the db file. The strings of the node are written directly with
+ *   bounded formats into the buffered file, the format is the same as the INTD_RECORD_* functions
+ */
+static void INTD_func_genRecord(FILE *dbFile, INTD_struc_node *dataNode, const char *scanMethod, const char *dataType)
+{
+    const char *ptr_sep;
+
+    switch(dataNode -> recordType) {
+        case INTD_AO:
+        case INTD_AI:
+            INTD_func_genRecHead(dbFile, dataNode, dataNode -> recordType == INTD_AO ? "ao" : "ai", "", scanMethod);
+            fprintf(dbFile, "        field(EGU, \"%s\")\n        field(PREC, \"%u\")\n        field(DTYP, \"InternalData\")\n",
+                    dataNode -> unitStr, dataNode -> prec);
+            INTD_func_genRecLink(dbFile, dataNode, dataNode -> recordType == INTD_AO ? "OUT" : "INP");
+            break;
 
-    /* Signal the event if it is specified */
-    if(dataNode -> eventId) epicsEventSignal(dataNode -> eventId);
+        case INTD_BO:
+        case INTD_BI:
+            INTD_func_genRecHead(dbFile, dataNode, dataNode -> recordType == INTD_BO ? "bo" : "bi", "", scanMethod);
+            fputs("        field(DTYP, \"InternalData\")\n", dbFile);
+            INTD_func_genRecLink(dbFile, dataNode, dataNode -> recordType == INTD_BO ? "OUT" : "INP");
 
-    return 0;
+            /* ONAM;ZNAM, both empty without the separator */
+            ptr_sep = dataNode -> supStr ? strchr(dataNode -> supStr, ';') : NULL;
+
+            if(ptr_sep)
+                fprintf(dbFile, "        field(ONAM, \"%.*s\")\n        field(ZNAM, \"%s\")\n",
+                        (int)(ptr_sep - dataNode -> supStr), dataNode -> supStr, ptr_sep + 1);
+            else
+                fputs("        field(ONAM, \"\")\n        field(ZNAM, \"\")\n", dbFile);
+            break;
+
+        case INTD_LO:
+        case INTD_LI:
+            INTD_func_genRecHead(dbFile, dataNode, dataNode -> recordType == INTD_LO ? "longout" : "longin", "", scanMethod);
+            fprintf(dbFile, "        field(EGU, \"%s\")\n        field(DTYP, \"InternalData\")\n", dataNode -> unitStr);
+            INTD_func_genRecLink(dbFile, dataNode, dataNode -> recordType == INTD_LO ? "OUT" : "INP");
+            break;
+
+        case INTD_MBBO:
+        case INTD_MBBI:
+            INTD_func_genRecHead(dbFile, dataNode, dataNode -> recordType == INTD_MBBO ? "mbbo" : "mbbi", "", scanMethod);
+            fputs("        field(DTYP, \"InternalData\")\n", dbFile);
+            INTD_func_genRecLink(dbFile, dataNode, dataNode -> recordType == INTD_MBBO ? "OUT" : "INP");
+            INTD_func_genRecStates(dbFile, dataNode);
+            break;
+
+        case INTD_WFO:
+        case INTD_WFI:
+            if(INTD_gvar_arrayRecords)
+                INTD_func_genRecHead(dbFile, dataNode, dataNode -> recordType == INTD_WFO ? "aao" : "aai", "", scanMethod);
+            else
+                INTD_func_genRecHead(dbFile, dataNode, "waveform", dataNode -> recordType == INTD_WFO ? "[W]" : "", scanMethod);
+
+            fprintf(dbFile, "        field(EGU, \"%s\")\n        field(NELM, \"%u\")\n        field(DTYP, \"InternalData\")\n        field(FTVL, \"%s\")\n",
+                    dataNode -> unitStr, dataNode -> pno, dataType);
+
+            /* the waveform of settings reads the data node as well, only aao writes it */
+            INTD_func_genRecLink(dbFile, dataNode, (INTD_gvar_arrayRecords && dataNode -> recordType == INTD_WFO) ? "OUT" : "INP");
+            break;
+
+        case INTD_SO:
+        case INTD_SI:
+            INTD_func_genRecHead(dbFile, dataNode, dataNode -> recordType == INTD_SO ? "stringout" : "stringin", "", scanMethod);
+            fputs("        field(DTYP, \"InternalData\")\n", dbFile);
+            INTD_func_genRecLink(dbFile, dataNode, dataNode -> recordType == INTD_SO ? "OUT" : "INP");
+            break;
+
+        case INTD_LSO:
+        case INTD_LSI:
+            INTD_func_genRecHead(dbFile, dataNode, dataNode -> recordType == INTD_LSO ? "lso" : "lsi", "", scanMethod);
+            fprintf(dbFile, "        field(SIZV, \"%u\")\n        field(DTYP, \"InternalData\")\n", dataNode -> pno);
+            INTD_func_genRecLink(dbFile, dataNode, dataNode -> recordType == INTD_LSO ? "OUT" : "INP");
+            break;
+
+        default:
+            fputs("\n\n", dbFile);                                  /* unknown record type, empty entry */
+            return;
+    }
+
+    INTD_func_genRecEnd(dbFile, dataNode);
 }
 
 /**
- * Generate records for the internal data
+ * Write all requested artefacts of one data node
+ */
+static void INTD_func_genNode(INTD_struc_genCtx *ctx, INTD_struc_node *dataNode)
+{
+    char var_pno[16];
+    const char *var_scanMethod = INTD_gvar_scanStrs[(int)dataNode -> scanType];
+    const char *var_dataType   = INTD_func_ftvlStr(dataNode -> dataType);
+    const char *var_prefix;
+    const char *var_method;
+
+    sprintf(var_pno, "%u", dataNode -> pno);
+
+    /* db file */
+    if(ctx -> dbFile) INTD_func_genRecord(ctx -> dbFile, dataNode, var_scanMethod, var_dataType);
+
+    /* PV name prefix of the req/archive files */
+    if(ctx -> withMacro == 1)       var_prefix = "$(name_space)$(module_name)";
+    else if(ctx -> withMacro == 2)  var_prefix = ctx -> destModName;
+    else                            var_prefix = dataNode -> moduleName;
+
+    /* req file */
+    if(ctx -> reqFile && (ctx -> reqSel == 0 || ctx -> reqSel == 2)) {
+        switch(dataNode -> recordType) {
+            case INTD_AO:
+            case INTD_LO:       INTD_func_genPVs(ctx, ctx -> reqFile, var_prefix, dataNode, 1, 1, 1, NULL); break;
+            case INTD_AI:
+            case INTD_LI:       INTD_func_genPVs(ctx, ctx -> reqFile, var_prefix, dataNode, 0, 1, 0, NULL); break;
+            case INTD_BO:
+            case INTD_MBBO:
+            case INTD_WFO:
+            case INTD_SO:
+            case INTD_LSO:      INTD_func_genPVs(ctx, ctx -> reqFile, var_prefix, dataNode, 1, 0, 0, NULL); break;
+            default: break;
+        }
+    }
+
+    /* archive file, event driven results and settings are monitored, periodic results use the assigned method */
+    if(ctx -> confFile) {
+        if(INTD_func_eventDriven(dataNode))
+            var_method = ctx -> OPVArchiveMethod;
+        else
+            var_method = ctx -> IPVArchiveMethod;
+
+        switch(dataNode -> recordType) {
+            case INTD_AO:
+            case INTD_LO:       INTD_func_genPVs(ctx, ctx -> confFile, var_prefix, dataNode, 1, 1, 1, var_method); break;
+            case INTD_AI:
+            case INTD_LI:       INTD_func_genPVs(ctx, ctx -> confFile, var_prefix, dataNode, 1, 1, 0, var_method); break;
+            case INTD_BO:
+            case INTD_BI:
+            case INTD_MBBO:
+            case INTD_MBBI:
+            case INTD_WFO:      INTD_func_genPVs(ctx, ctx -> confFile, var_prefix, dataNode, 1, 0, 0, var_method); break;
+            default: break;
+        }
+    }
+
+    /* list file */
+    if(ctx -> lstFile) {
+        switch(dataNode -> recordType) {
+            case INTD_AO:       fprintf(ctx -> lstFile, "$(name_space)$(module_name)%s:%s\tao\t%s\tDOUBLE\t1\n",    dataNode -> subModuleName, dataNode -> recName, var_scanMethod); break;
+            case INTD_AI:       fprintf(ctx -> lstFile, "$(name_space)$(module_name)%s:%s\tai\t%s\tDOUBLE\t1\n",    dataNode -> subModuleName, dataNode -> recName, var_scanMethod); break;
+            case INTD_BO:       fprintf(ctx -> lstFile, "$(name_space)$(module_name)%s:%s\tbo\t%s\tUSHORT\t1\n",    dataNode -> subModuleName, dataNode -> recName, var_scanMethod); break;
+            case INTD_BI:       fprintf(ctx -> lstFile, "$(name_space)$(module_name)%s:%s\tbi\t%s\tUSHORT\t1\n",    dataNode -> subModuleName, dataNode -> recName, var_scanMethod); break;
+            case INTD_LO:       fprintf(ctx -> lstFile, "$(name_space)$(module_name)%s:%s\tlongout\t%s\tLONG\t1\n", dataNode -> subModuleName, dataNode -> recName, var_scanMethod); break;
+            case INTD_LI:       fprintf(ctx -> lstFile, "$(name_space)$(module_name)%s:%s\tlongin\t%s\tLONG\t1\n",  dataNode -> subModuleName, dataNode -> recName, var_scanMethod); break;
+            case INTD_MBBO:     fprintf(ctx -> lstFile, "$(name_space)$(module_name)%s:%s\tmbbo\t%s\tULONG\t1\n",   dataNode -> subModuleName, dataNode -> recName, var_scanMethod); break;
+            case INTD_MBBI:     fprintf(ctx -> lstFile, "$(name_space)$(module_name)%s:%s\tmbbi\t%s\tULONG\t1\n",   dataNode -> subModuleName, dataNode -> recName, var_scanMethod); break;
+            case INTD_WFO:      fprintf(ctx -> lstFile, "$(name_space)$(module_name)%s:%s\t%s\t%s\t%s\t%s\n", dataNode -> subModuleName, dataNode -> recName, INTD_gvar_arrayRecords ? "aao" : "waveform(out)", var_scanMethod, var_dataType, var_pno); break;
+            case INTD_WFI:      fprintf(ctx -> lstFile, "$(name_space)$(module_name)%s:%s\t%s\t%s\t%s\t%s\n", dataNode -> subModuleName, dataNode -> recName, INTD_gvar_arrayRecords ? "aai" : "waveform(in)",  var_scanMethod, var_dataType, var_pno); break;
+            case INTD_SO:       fprintf(ctx -> lstFile, "$(name_space)$(module_name)%s:%s\tstringout\t%s\tSTRING\t1\n",  dataNode -> subModuleName, dataNode -> recName, var_scanMethod); break;
+            case INTD_SI:       fprintf(ctx -> lstFile, "$(name_space)$(module_name)%s:%s\tstringin\t%s\tSTRING\t1\n",   dataNode -> subModuleName, dataNode -> recName, var_scanMethod); break;
+            case INTD_LSO:      fprintf(ctx -> lstFile, "$(name_space)$(module_name)%s:%s\tlso\t%s\tSTRING\t%s\n",       dataNode -> subModuleName, dataNode -> recName, var_scanMethod, var_pno); break;
+            case INTD_LSI:      fprintf(ctx -> lstFile, "$(name_space)$(module_name)%s:%s\tlsi\t%s\tSTRING\t%s\n",       dataNode -> subModuleName, dataNode -> recName, var_scanMethod, var_pno); break;
+            default: break;
+        }
+    }
+}
+
+/**
+ * Generate the db, save/restore request, archiver configuration and list files in one pass. The contents are
+ *   the same as INTD_API_genRecord, INTD_API_genSRReqt, INTD_API_genArchive and INTD_API_genDbList
  * Input:
- *   moduleName:    the module instance that this file for. Please note that the module name will be hardcoded in the file
- *   path:          the path for the file
- *   dbFileName:    full file name of the output db file
+ *   moduleName:    the module instance that the files for, "MOD_ALL" for all modules
+ *   path:          the path for the files
+ *   dbFileName, reqFileName, confFileName, lstFileName:
+ *                  file names of the artefacts, NULL or empty string to skip the file
+ *   methodStr:     archive method (see INTD_API_genArchive)
+ *   withMacro:     chose to use macro or hardcoded PV names in the req/archive files (0 - same module name; 1 - use macro; 2 - use destModuleName)
+ *   reqSel:        sel of INTD_API_genSRReqt
+ *   archSel:       sel of INTD_API_genArchive
+ *   destModuleName:generate the req/archive files for other module with the same type
  * Return:
  *   0              : Successful
  *  -1              : Failed
  */
-int INTD_API_genRecord(const char *moduleName, const char *path, const char *dbFileName)
+int INTD_API_genFiles(const char *moduleName, const char *path,
+                      const char *dbFileName, const char *reqFileName, const char *confFileName, const char *lstFileName,
+                      const char *methodStr, int withMacro, int reqSel, int archSel, const char *destModuleName)
 {
-    char var_fullFileName[256] = "";
-    char var_recStr[2048]      = "";                                   /* final string of the record */
-
-    char var_modName[128]      = "";                                   /* module name, identify the record for internal data node */
-    char var_datName[128]      = "";                                   /* data name,   identify the record for internal data node */
-    char var_subModName[128]   = "";                                   /* sub module name */
-    char var_recName[128]      = "";                                   /* record name. The final record "{name_space}{module_name}{sub_module_name}:record_name" */
-    char var_scanMethod[128]   = "";
-    char var_pno[128]          = "";
-    char var_dataType[128]     = "";
-    char var_supStr[1024]      = "";
-    char var_unitStr[16]       = "";
-    char var_descStr[128]      = "";
-    char var_aliasStr[128]     = "";
-    char var_asgStr[128]       = "";
-    unsigned int var_prec      = 0;
-
-    FILE *var_outFile = NULL;
+    int var_status = 0;
+    INTD_struc_genCtx   *ptr_ctx;
+    INTD_struc_modIndex *ptr_mod = NULL;
+    INTD_struc_node     *ptr_dataNode;
 
-    INTD_struc_node *ptr_dataNode  = NULL;
-    
     /* check the input */
-    if(!dbFileName || !dbFileName[0]) return -1;
+    if(!moduleName || !moduleName[0]) return -1;
+
+    if(confFileName && confFileName[0] && !methodStr) {
+        printf("INTD_API_genFiles: Archive method missing for %s\n", confFileName);
+        return -1;
+    }
+
+    ptr_ctx = (INTD_struc_genCtx *)calloc(1, sizeof(INTD_struc_genCtx));
+    if(!ptr_ctx) return -1;
 
-    /* generate the full file name and open the file */
-    if(path && path[0]) {
-        strcpy(var_fullFileName, path);
-        strcat(var_fullFileName, "/");
-        strcat(var_fullFileName, dbFileName);
+    ptr_ctx -> withMacro   = withMacro;
+    ptr_ctx -> reqSel      = reqSel;
+    ptr_ctx -> destModName = (withMacro == 2 && destModuleName) ? destModuleName : "";
+
+    if(archSel == 3) {                                              /* combined, method string should have 3 items seperated with space */
+        ptr_ctx -> OPVArchiveMethod = "None None Monitor";
+        ptr_ctx -> IPVArchiveMethod = methodStr;
     } else {
-        strcpy(var_fullFileName, dbFileName);
+        ptr_ctx -> OPVArchiveMethod = "Monitor";
+        ptr_ctx -> IPVArchiveMethod = methodStr;
     }
 
-    var_outFile = fopen(var_fullFileName, "w");
+    /* open the files and write the headers */
+    if(dbFileName && dbFileName[0]) {
+        if((ptr_ctx -> dbFile = INTD_func_genOpen(path, dbFileName))) {
+            fprintf(ptr_ctx -> dbFile, "#-------------------------------------------------------------------------------------\n");
+            fprintf(ptr_ctx -> dbFile, "# %s\n", dbFileName);
+            fprintf(ptr_ctx -> dbFile, "# EPICS database file for the module instance of %s\n", moduleName);
+            fprintf(ptr_ctx -> dbFile, "# Auto generated by InternalData module! Do not modify...\n");
+            fprintf(ptr_ctx -> dbFile, "#-------------------------------------------------------------------------------------\n");
+            fprintf(ptr_ctx -> dbFile, "\n");
+        } else var_status = -1;
+    }
 
-    if(!var_outFile) {
-        printf("INTD_API_genRecord: Failed to create file of %s\n", var_fullFileName);
-        return -1;
+    if(reqFileName && reqFileName[0]) {
+        if((ptr_ctx -> reqFile = INTD_func_genOpen(path, reqFileName))) {
+            fprintf(ptr_ctx -> reqFile, "#//UPDATE-FREQ=60\n");
+            fprintf(ptr_ctx -> reqFile, "#ENABLE-PASS=1\n");
+            fprintf(ptr_ctx -> reqFile, "#-------------------------------------------------------------------------------------\n");
+            fprintf(ptr_ctx -> reqFile, "# %s\n", reqFileName);
+            fprintf(ptr_ctx -> reqFile, "# Autosave request file for the module instance of %s\n", moduleName);
+            fprintf(ptr_ctx -> reqFile, "# Auto generated by InternalData module!\n");
+            fprintf(ptr_ctx -> reqFile, "#-------------------------------------------------------------------------------------\n");
+            fprintf(ptr_ctx -> reqFile, "\n");
+        } else var_status = -1;
     }
 
-    /* write to file */
+    if(confFileName && confFileName[0]) {
+        if((ptr_ctx -> confFile = INTD_func_genOpen(path, confFileName))) {
+            fprintf(ptr_ctx -> confFile, "#-------------------------------------------------------------------------------------\n");
+            fprintf(ptr_ctx -> confFile, "# %s\n", confFileName);
+            fprintf(ptr_ctx -> confFile, "# Archiver configure file for the module instance of %s\n", moduleName);
+            fprintf(ptr_ctx -> confFile, "# Auto generated by InternalData module!\n");
+            fprintf(ptr_ctx -> confFile, "#-------------------------------------------------------------------------------------\n");
+            fprintf(ptr_ctx -> confFile, "\n");
+        } else var_status = -1;
+    }
 
-    fprintf(var_outFile, "#-------------------------------------------------------------------------------------\n");
-    fprintf(var_outFile, "# %s\n", dbFileName);
-    fprintf(var_outFile, "# EPICS database file for the module instance of %s\n", moduleName);
-    fprintf(var_outFile, "# Auto generated by InternalData module! Do not modify...\n");
-    fprintf(var_outFile, "#-------------------------------------------------------------------------------------\n");
-    fprintf(var_outFile, "\n");
+    if(lstFileName && lstFileName[0]) {
+        if((ptr_ctx -> lstFile = INTD_func_genOpen(path, lstFileName))) {
+            fprintf(ptr_ctx -> lstFile, "#-------------------------------------------------------------------------------------\n");
+            fprintf(ptr_ctx -> lstFile, "# %s\n", lstFileName);
+            fprintf(ptr_ctx -> lstFile, "# Generate the list of records for the module instance of %s\n", moduleName);
+            fprintf(ptr_ctx -> lstFile, "# Auto generated by InternalData module!\n");
+            fprintf(ptr_ctx -> lstFile, "#\n");
+            fprintf(ptr_ctx -> lstFile, "# variable-id string, record type, scan type, data type, num of point\n");
+            fprintf(ptr_ctx -> lstFile, "#-------------------------------------------------------------------------------------\n");
+            fprintf(ptr_ctx -> lstFile, "\n");
+        } else var_status = -1;
+    }
 
-    for(ptr_dataNode = (INTD_struc_node *)ellFirst(&INTD_gvar_dataList);
-        ptr_dataNode;
-        ptr_dataNode = (INTD_struc_node *)ellNext(&ptr_dataNode -> node)) {
-        
-        /* get the necessary information */
-        strcpy(var_modName,    ptr_dataNode -> moduleName);     /* module name */
-        strcpy(var_datName,    ptr_dataNode -> dataName);       /* data name */
-        strcpy(var_subModName, ptr_dataNode -> subModuleName);  /* sub module name */
-        strcpy(var_recName,    ptr_dataNode -> recName);        /* record name */
-        strcpy(var_supStr,     ptr_dataNode -> supStr);	        /* extra string */
-        strcpy(var_unitStr,    ptr_dataNode -> unitStr);        /* unit string */
-        strcpy(var_descStr,    ptr_dataNode -> desc);
-        strcpy(var_aliasStr,   ptr_dataNode -> alias);
-        strcpy(var_asgStr,     ptr_dataNode -> asg);
-        strcpy(var_scanMethod, INTD_gvar_scanStrs[(int)ptr_dataNode -> scanType]);   /* scan method */
-        sprintf(var_pno, "%d", ptr_dataNode -> pno);                                        /* point number (only used for waveform) */
-        var_prec = ptr_dataNode -> prec;
-        
-        switch(ptr_dataNode -> dataType) {                                                  /* field data type (only used for waveform) */
-            case INTD_CHAR:     strcpy(var_dataType, "CHAR");   break;
-            case INTD_UCHAR:    strcpy(var_dataType, "UCHAR");  break;
-            case INTD_SHORT:    strcpy(var_dataType, "SHORT");  break;
-            case INTD_USHORT:   strcpy(var_dataType, "USHORT"); break;
-            case INTD_INT:      strcpy(var_dataType, "LONG");   break;
-            case INTD_UINT:     strcpy(var_dataType, "ULONG");  break;
-            case INTD_LONG:     strcpy(var_dataType, "LONG");   break;
-            case INTD_ULONG:    strcpy(var_dataType, "ULONG");  break;
-            case INTD_FLOAT:    strcpy(var_dataType, "FLOAT");  break;
-            case INTD_DOUBLE:   strcpy(var_dataType, "DOUBLE"); break;
-            case INTD_OLDSTRING: strcpy(var_dataType, "STRING"); break;
-            default:            strcpy(var_dataType, "");       break;
-        }
-        
-        /* generate the string for record */
-        switch(ptr_dataNode -> recordType) {
-            case INTD_AO:       INTD_RECORD_AO(  var_datName, var_subModName, var_recName, var_scanMethod, var_unitStr, var_descStr, var_prec, var_aliasStr, var_asgStr, var_recStr); break;
-            case INTD_AI:       INTD_RECORD_AI(  var_datName, var_subModName, var_recName, var_scanMethod, var_unitStr, var_descStr, var_prec, var_aliasStr, var_asgStr, var_recStr); break;
-            case INTD_BO:       INTD_RECORD_BO(  var_datName, var_subModName, var_recName, var_scanMethod, var_supStr,  var_descStr, var_aliasStr, var_asgStr, var_recStr); break;
-            case INTD_BI:       INTD_RECORD_BI(  var_datName, var_subModName, var_recName, var_scanMethod, var_supStr,  var_descStr, var_aliasStr, var_asgStr, var_recStr); break;
-            case INTD_LO:       INTD_RECORD_LO(  var_datName, var_subModName, var_recName, var_scanMethod, var_unitStr, var_descStr, var_aliasStr, var_asgStr, var_recStr); break;
-            case INTD_LI:       INTD_RECORD_LI(  var_datName, var_subModName, var_recName, var_scanMethod, var_unitStr, var_descStr, var_aliasStr, var_asgStr, var_recStr); break;
-            case INTD_MBBO:     INTD_RECORD_MBBO(var_datName, var_subModName, var_recName, var_scanMethod, var_supStr,  var_descStr, var_aliasStr, var_asgStr, var_recStr); break;
-            case INTD_MBBI:     INTD_RECORD_MBBI(var_datName, var_subModName, var_recName, var_scanMethod, var_supStr,  var_descStr, var_aliasStr, var_asgStr, var_recStr); break;
-            case INTD_WFO:      INTD_RECORD_WFO( var_datName, var_subModName, var_recName, var_scanMethod, var_pno, var_dataType, var_unitStr, var_descStr, var_aliasStr, var_asgStr, var_recStr); break;
-            case INTD_WFI:      INTD_RECORD_WFI( var_datName, var_subModName, var_recName, var_scanMethod, var_pno, var_dataType, var_unitStr, var_descStr, var_aliasStr, var_asgStr, var_recStr); break;
-            case INTD_SO:       INTD_RECORD_SO(  var_datName, var_subModName, var_recName, var_scanMethod, var_descStr, var_aliasStr, var_asgStr, var_recStr); break;
-            case INTD_SI:       INTD_RECORD_SI(  var_datName, var_subModName, var_recName, var_scanMethod, var_descStr, var_aliasStr, var_asgStr, var_recStr); break;
-            default: strcpy(var_recStr, "");
+    /* one pass over the nodes of the module */
+    if(var_status == 0) {
+        if(strcmp(moduleName, "MOD_ALL") == 0) {
+            for(ptr_dataNode = INTD_gvar_dataListInitialized ? INTD_func_firstNode() : NULL;
+                ptr_dataNode;
+                ptr_dataNode = INTD_func_nextNode(ptr_dataNode))
+                INTD_func_genNode(ptr_ctx, ptr_dataNode);
+        } else {
+            ptr_mod = INTD_func_modIndexFind(moduleName);
+
+            for(ptr_dataNode = ptr_mod ? ptr_mod -> first : NULL;
+                ptr_dataNode;
+                ptr_dataNode = ptr_dataNode -> modNext)
+                INTD_func_genNode(ptr_ctx, ptr_dataNode);
         }
-            
-        /* save to file only for this module */
-		if(strcmp(moduleName, "MOD_ALL") == 0 || strcmp(moduleName, var_modName) == 0)
-        	fprintf(var_outFile, "%s\n\n", var_recStr);
-
-    }    
+    }
 
-    /* close to file */
-    fflush(var_outFile);
-    fclose(var_outFile);
+    /* close the files */
+    if(ptr_ctx -> dbFile)   fclose(ptr_ctx -> dbFile);
+    if(ptr_ctx -> reqFile)  fclose(ptr_ctx -> reqFile);
+    if(ptr_ctx -> confFile) fclose(ptr_ctx -> confFile);
+    if(ptr_ctx -> lstFile)  fclose(ptr_ctx -> lstFile);
 
-    return 0;
+    free(ptr_ctx);
+    return var_status;
 }
 
 /**
- * Generate save/restore request file for the internal data
- * Input:
- *   moduleName:    the module instance that this file for. Please note that the module name will be hardcoded in the file
- *   path:          the path for the file
- *   reqFileName:   full file name of the output req file
- *   withMacro:     chose to use macro or hardcoded PV names (0 - same module name; 1 - use macro; 2 - use destModuleName)
- *   sel:           0 - scalar output PVs; 1 - waveform output PVs; 2 - all output PVs
- *   destModuleName:generate a file for other module with the same type
- * Return:
- *   0              : Successful
- *  -1              : Failed
+ * Skip the header of a generated file (up to the first empty line), it contains the file name
  */
-int INTD_API_genSRReqt(const char *moduleName, const char *path, const char *reqFileName, int withMacro, int sel, const char *destModuleName)
+static void INTD_func_genSkipHeader(FILE *file)
 {
-    char var_fullSRFileName[256]    = "";
-    char var_modName[128]           = "";
-    char var_destModName[128]       = "";
-    char var_subModName[128]        = ""; 
-    char var_recName[128]           = "";                                   /* record name */
-    char var_scanMethod[128]        = "";
-    char var_pno[128]               = "";
-
-    FILE *var_outFile_sr = NULL;
-    INTD_struc_node *ptr_dataNode = NULL;
-    
-    /* check the input */
-    if( !moduleName     || !moduleName[0]   ||
-        !reqFileName    || !reqFileName[0]) 
-        return -1;
+    int var_ch, var_last = '\n';
 
-    /* generate the full file names */
-    if(path && path[0]) {
-        strcpy(var_fullSRFileName,   path);
-        strcat(var_fullSRFileName,   "/");
-        strcat(var_fullSRFileName,   reqFileName);
-    } else {
-        strcpy(var_fullSRFileName,   reqFileName);
+    while((var_ch = fgetc(file)) != EOF) {
+        if(var_ch == '\n' && var_last == '\n') return;
+        var_last = var_ch;
     }
+}
 
-    /* other module name with the same type */
-    if(withMacro == 2 && destModuleName && destModuleName[0])
-        strcpy(var_destModName, destModuleName);                                      
+/**
+ * Compare the bodies of two generated files, return 1 if they are identical
+ */
+static int INTD_func_genCompare(const char *path, const char *fileNameA, const char *fileNameB)
+{
+    char var_fullFileName[256];
+    int  var_chA, var_chB;
+    FILE *var_fileA, *var_fileB;
 
-    /* open the file */
-    var_outFile_sr  = fopen(var_fullSRFileName, "w");
+    var_fileA = NULL;
+    var_fileB = NULL;
 
-    if(!var_outFile_sr) {
-		printf("INTD_API_genSRReqt: Failed to create file of %s\n", var_fullSRFileName);
-        return -1;
-    }
+    if(INTD_func_genFileName(var_fullFileName, sizeof(var_fullFileName), path, fileNameA, "INTD_API_genTiming") == 0)
+        var_fileA = fopen(var_fullFileName, "r");
 
-    /* write to file */
+    if(INTD_func_genFileName(var_fullFileName, sizeof(var_fullFileName), path, fileNameB, "INTD_API_genTiming") == 0)
+        var_fileB = fopen(var_fullFileName, "r");
 
-    fprintf(var_outFile_sr, "#//UPDATE-FREQ=60\n");
-    fprintf(var_outFile_sr, "#ENABLE-PASS=1\n");
-    fprintf(var_outFile_sr, "#-------------------------------------------------------------------------------------\n");
-    fprintf(var_outFile_sr, "# %s\n", reqFileName);
-    fprintf(var_outFile_sr, "# Autosave request file for the module instance of %s\n", moduleName); 
-    fprintf(var_outFile_sr, "# Auto generated by InternalData module!\n");
-    fprintf(var_outFile_sr, "#-------------------------------------------------------------------------------------\n");
-    fprintf(var_outFile_sr, "\n");
+    if(!var_fileA || !var_fileB) {
+        if(var_fileA) fclose(var_fileA);
+        if(var_fileB) fclose(var_fileB);
+        return 0;
+    }
 
-    for(ptr_dataNode = (INTD_struc_node *)ellFirst(&INTD_gvar_dataList);
-        ptr_dataNode;
-        ptr_dataNode = (INTD_struc_node *)ellNext(&ptr_dataNode -> node)) {
-        
-        /* get the necessary information */
-        strcpy(var_modName,        ptr_dataNode -> moduleName);     /* module name */
-        strcpy(var_subModName,     ptr_dataNode -> subModuleName);  /* sub module name */
-        strcpy(var_recName,        ptr_dataNode -> recName);        /* record name */
-        strcpy(var_scanMethod,     INTD_gvar_scanStrs[(int)ptr_dataNode -> scanType]);   /* scan method */
-        sprintf(var_pno, "%d", ptr_dataNode -> pno);                                     /* point number (only used for waveform) */      
-     
-        /* generate the string for record and save to file for this module instance */
-		if(strcmp(moduleName, "MOD_ALL") == 0 || strcmp(moduleName, var_modName) == 0) {
-
-            switch(ptr_dataNode -> recordType) {
-                case INTD_AO:
-                case INTD_LO:
-                    if(sel == 0 || sel == 2) {   
-                        if(withMacro == 1) {
-                            fprintf(var_outFile_sr, "$(name_space)$(module_name)%s:%s\n",      var_subModName, var_recName);  
-                            fprintf(var_outFile_sr, "$(name_space)$(module_name)%s:%s.HIHI\n", var_subModName, var_recName);  
-                            fprintf(var_outFile_sr, "$(name_space)$(module_name)%s:%s.HIGH\n", var_subModName, var_recName);  
-                            fprintf(var_outFile_sr, "$(name_space)$(module_name)%s:%s.LOW\n",  var_subModName, var_recName);  
-                            fprintf(var_outFile_sr, "$(name_space)$(module_name)%s:%s.LOLO\n", var_subModName, var_recName);
-                            fprintf(var_outFile_sr, "$(name_space)$(module_name)%s:%s.DRVL\n", var_subModName, var_recName);
-                            fprintf(var_outFile_sr, "$(name_space)$(module_name)%s:%s.DRVH\n", var_subModName, var_recName);
-                            fprintf(var_outFile_sr, "$(name_space)$(module_name)%s:%s.LSV\n",  var_subModName, var_recName);
-                            fprintf(var_outFile_sr, "$(name_space)$(module_name)%s:%s.HSV\n",  var_subModName, var_recName);
-                        } else if(withMacro == 2) {
-                            fprintf(var_outFile_sr, "%s%s:%s\n",      var_destModName, var_subModName, var_recName);  
-                            fprintf(var_outFile_sr, "%s%s:%s.HIHI\n", var_destModName, var_subModName, var_recName);  
-                            fprintf(var_outFile_sr, "%s%s:%s.HIGH\n", var_destModName, var_subModName, var_recName);  
-                            fprintf(var_outFile_sr, "%s%s:%s.LOW\n",  var_destModName, var_subModName, var_recName);  
-                            fprintf(var_outFile_sr, "%s%s:%s.LOLO\n", var_destModName, var_subModName, var_recName);
-                            fprintf(var_outFile_sr, "%s%s:%s.DRVL\n", var_destModName, var_subModName, var_recName);
-                            fprintf(var_outFile_sr, "%s%s:%s.DRVH\n", var_destModName, var_subModName, var_recName);
-                            fprintf(var_outFile_sr, "%s%s:%s.LSV\n",  var_destModName, var_subModName, var_recName);
-                            fprintf(var_outFile_sr, "%s%s:%s.HSV\n",  var_destModName, var_subModName, var_recName);
-                        } else {
-                            fprintf(var_outFile_sr, "%s%s:%s\n",      var_modName, var_subModName, var_recName);  
-                            fprintf(var_outFile_sr, "%s%s:%s.HIHI\n", var_modName, var_subModName, var_recName);  
-                            fprintf(var_outFile_sr, "%s%s:%s.HIGH\n", var_modName, var_subModName, var_recName);  
-                            fprintf(var_outFile_sr, "%s%s:%s.LOW\n",  var_modName, var_subModName, var_recName);  
-                            fprintf(var_outFile_sr, "%s%s:%s.LOLO\n", var_modName, var_subModName, var_recName);
-                            fprintf(var_outFile_sr, "%s%s:%s.DRVL\n", var_modName, var_subModName, var_recName);
-                            fprintf(var_outFile_sr, "%s%s:%s.DRVH\n", var_modName, var_subModName, var_recName);
-                            fprintf(var_outFile_sr, "%s%s:%s.LSV\n",  var_modName, var_subModName, var_recName);
-                            fprintf(var_outFile_sr, "%s%s:%s.HSV\n",  var_modName, var_subModName, var_recName);
-                        } 
-                    }
-                    break;
-
-                case INTD_AI:
-                case INTD_LI:
-                    if(sel == 0 || sel == 2) {   
-                        if(withMacro == 1) {
-                            fprintf(var_outFile_sr, "$(name_space)$(module_name)%s:%s.HIHI\n", var_subModName, var_recName);  
-                            fprintf(var_outFile_sr, "$(name_space)$(module_name)%s:%s.HIGH\n", var_subModName, var_recName);  
-                            fprintf(var_outFile_sr, "$(name_space)$(module_name)%s:%s.LOW\n",  var_subModName, var_recName);  
-                            fprintf(var_outFile_sr, "$(name_space)$(module_name)%s:%s.LOLO\n", var_subModName, var_recName);
-                            fprintf(var_outFile_sr, "$(name_space)$(module_name)%s:%s.LSV\n",  var_subModName, var_recName);
-                            fprintf(var_outFile_sr, "$(name_space)$(module_name)%s:%s.HSV\n",  var_subModName, var_recName);
-                        } else if(withMacro == 2) {
-                            fprintf(var_outFile_sr, "%s%s:%s.HIHI\n", var_destModName, var_subModName, var_recName);  
-                            fprintf(var_outFile_sr, "%s%s:%s.HIGH\n", var_destModName, var_subModName, var_recName);  
-                            fprintf(var_outFile_sr, "%s%s:%s.LOW\n",  var_destModName, var_subModName, var_recName);  
-                            fprintf(var_outFile_sr, "%s%s:%s.LOLO\n", var_destModName, var_subModName, var_recName);
-                            fprintf(var_outFile_sr, "%s%s:%s.LSV\n",  var_destModName, var_subModName, var_recName);
-                            fprintf(var_outFile_sr, "%s%s:%s.HSV\n",  var_destModName, var_subModName, var_recName);
-                        } else {
-                            fprintf(var_outFile_sr, "%s%s:%s.HIHI\n", var_modName, var_subModName, var_recName);  
-                            fprintf(var_outFile_sr, "%s%s:%s.HIGH\n", var_modName, var_subModName, var_recName);  
-                            fprintf(var_outFile_sr, "%s%s:%s.LOW\n",  var_modName, var_subModName, var_recName);  
-                            fprintf(var_outFile_sr, "%s%s:%s.LOLO\n", var_modName, var_subModName, var_recName);
-                            fprintf(var_outFile_sr, "%s%s:%s.LSV\n",  var_modName, var_subModName, var_recName);
-                            fprintf(var_outFile_sr, "%s%s:%s.HSV\n",  var_modName, var_subModName, var_recName);
-                        }
-                    }
-                    break;
-
-	            case INTD_BO:  
-            	case INTD_MBBO:  
-            	case INTD_WFO:  
-            	case INTD_SO:  
-                    if(sel == 0 || sel == 2) {     
-                        if(withMacro == 1) {
-                            fprintf(var_outFile_sr, "$(name_space)$(module_name)%s:%s\n", var_subModName, var_recName);
-                        } else if(withMacro == 2) {
-                            fprintf(var_outFile_sr, "%s%s:%s\n", var_destModName, var_subModName, var_recName);
-                        } else {
-                            fprintf(var_outFile_sr, "%s%s:%s\n", var_modName, var_subModName, var_recName);
-                        }
-                    }
-                    break;
+    INTD_func_genSkipHeader(var_fileA);
+    INTD_func_genSkipHeader(var_fileB);
 
-            	default: break;
-        	}        
-		}    
-    }    
+    do {
+        var_chA = fgetc(var_fileA);
+        var_chB = fgetc(var_fileB);
+    } while(var_chA == var_chB && var_chA != EOF);
 
-    /* close to file */
-    fflush(var_outFile_sr);
-    fclose(var_outFile_sr);
+    fclose(var_fileA);
+    fclose(var_fileB);
 
-    return 0;
+    return var_chA == var_chB;
 }
 
 /**
- * Generate archiver configuration file
- * Input:
- *   moduleName:    the module instance that this file for. Please note that the module name will be hardcoded in the file
- *   path:          the path for the file
- *   confFileName:  full file name of the output config file
- *   methodStr:     string for archive method for short/medium/long term. These apply only on the results PVs (IPV) with periodic scanning
- *   withMacro:     chose to use macro or hardcoded PV names (0 - same module name; 1 - use macro; 2 - use destModuleName)
- *   sel:           0 - short term; 1 - medium term; 2 - long term; 3 - combined
- *   destModuleName:generate a file for other module with the same type
- * Return:
- *   0              : Successful
- *  -1              : Failed
+ * Compare the time of generating the artefacts with one call each (one traversal per artefact) with one
+ *   combined call. The files are written to the path with the names INTD_timing_single.* and INTD_timing_stream.*,
+ *   and removed when their contents (except the header with the file name) are identical
  */
-int INTD_API_genArchive(const char *moduleName, const char *path, const char *confFileName, const char *methodStr, int withMacro, int sel, const char *destModuleName)
+void INTD_API_genTiming(const char *moduleName, const char *path, int loops)
 {
-    char var_fullFileName[256]      = "";
-    char var_modName[128]           = "";
-    char var_destModName[128]       = "";
-    char var_subModName[128]        = ""; 
-    char var_recName[128]           = "";                                   /* record name */
-    char var_OPVArchiveMethod[128]  = "";
-    char var_IPVArchiveMethod[128]  = "";
+    int i, var_same = 1;
+    char var_fullFileName[256];
+    double var_singleTime, var_streamTime;
+    unsigned int var_nodeNum;
+    epicsTimeStamp var_start, var_end;
+    INTD_struc_modIndex *ptr_mod;
 
-    FILE *var_outFile_conf = NULL;
-    INTD_struc_node *ptr_dataNode = NULL;
-    
-    /* check the input */
-    if(!moduleName || !moduleName[0] || !confFileName || !confFileName[0]) return -1;
+    static const char *var_suffix[] = {"db", "req", "arch", "lst"};
+
+    if(!moduleName || !moduleName[0]) return;
+    if(!path || !path[0]) path = ".";
+    if(loops <= 0)        loops = 1;
 
-    /* generate the full file names */
-    if(path && path[0]) {
-        strcpy(var_fullFileName, path);
-        strcat(var_fullFileName, "/");
-        strcat(var_fullFileName, confFileName);
+    /* the longest of the file names must fit, otherwise nothing is generated */
+    if(INTD_func_genFileName(var_fullFileName, sizeof(var_fullFileName), path, "INTD_timing_single.arch", "INTD_API_genTiming") != 0) return;
+
+    if(strcmp(moduleName, "MOD_ALL") == 0) {
+        var_nodeNum = INTD_gvar_dataListInitialized ? (unsigned int)ellCount(&INTD_gvar_dataList) : 0;
     } else {
-        strcpy(var_fullFileName, confFileName);
+        ptr_mod     = INTD_func_modIndexFind(moduleName);
+        var_nodeNum = ptr_mod ? ptr_mod -> nodeNum : 0;
     }
 
-    /* other module name with the same type */
-    if(withMacro == 2 && destModuleName && destModuleName[0])
-        strcpy(var_destModName, destModuleName);
+    epicsTimeGetCurrent(&var_start);
+    for(i = 0; i < loops; i ++) {
+        INTD_API_genRecord (moduleName, path, "INTD_timing_single.db");
+        INTD_API_genSRReqt (moduleName, path, "INTD_timing_single.req",  1, 2, NULL);
+        INTD_API_genArchive(moduleName, path, "INTD_timing_single.arch", "Monitor", 1, 0, NULL);
+        INTD_API_genDbList (moduleName, path, "INTD_timing_single.lst");
+    }
+    epicsTimeGetCurrent(&var_end);
+    var_singleTime = epicsTimeDiffInSeconds(&var_end, &var_start) / loops;
 
-    /* generate the archive string:
-       - for output PVs for parameters setting, always use monitor method
-       - for input PVs for results, if it is event driven, always use monitor method
-       - for input PVs for results, if it is updated periodically, use the assigned method
-    */
-    if(sel == 3) {                                                  /* combined */
-        strcpy(var_OPVArchiveMethod, "None None Monitor");
-        strcpy(var_IPVArchiveMethod, methodStr);                    /* here method string should have 3 items seperated with space */
-    } else {
-        strcpy(var_OPVArchiveMethod, "Monitor");
-        strcpy(var_IPVArchiveMethod, methodStr);                    /* here method string only have one */
+    epicsTimeGetCurrent(&var_start);
+    for(i = 0; i < loops; i ++) {
+        INTD_API_genFiles(moduleName, path, "INTD_timing_stream.db", "INTD_timing_stream.req", "INTD_timing_stream.arch", "INTD_timing_stream.lst",
+                          "Monitor", 1, 2, 0, NULL);
     }
- 
-    /* open the file */
-    var_outFile_conf  = fopen(var_fullFileName, "w");
+    epicsTimeGetCurrent(&var_end);
+    var_streamTime = epicsTimeDiffInSeconds(&var_end, &var_start) / loops;
 
-    if(!var_outFile_conf) {
-		printf("INTD_API_genArchive: Failed to create file of %s\n", var_fullFileName);
-        return -1;
+    /* compare the outputs */
+    for(i = 0; i < 4; i ++) {
+        char var_nameA[64], var_nameB[64];
+
+        sprintf(var_nameA, "INTD_timing_single.%s", var_suffix[i]);
+        sprintf(var_nameB, "INTD_timing_stream.%s", var_suffix[i]);
+
+        if(!INTD_func_genCompare(path, var_nameA, var_nameB)) {
+            printf("INTD_API_genTiming: %s/%s differs from %s/%s\n", path, var_nameB, path, var_nameA);
+            var_same = 0;
+        }
     }
 
-    /* write to file */
+    printf("INTD_API_genTiming: %s, %u nodes, single %.3f ms, combined %.3f ms (x%.1f), outputs %s\n",
+            moduleName, var_nodeNum, var_singleTime * 1e3, var_streamTime * 1e3,
+            var_streamTime > 0 ? var_singleTime / var_streamTime : 0.0,
+            var_same ? "identical" : "DIFFERENT");
 
-    fprintf(var_outFile_conf, "#-------------------------------------------------------------------------------------\n");
-    fprintf(var_outFile_conf, "# %s\n", confFileName);
-    fprintf(var_outFile_conf, "# Archiver configure file for the module instance of %s\n", moduleName); 
-    fprintf(var_outFile_conf, "# Auto generated by InternalData module!\n");
-    fprintf(var_outFile_conf, "#-------------------------------------------------------------------------------------\n");
-    fprintf(var_outFile_conf, "\n");
+    /* remove the files, keep them for inspection when they differ */
+    if(var_same) {
+        for(i = 0; i < 4; i ++) {
+            char var_name[64];
 
-    for(ptr_dataNode = (INTD_struc_node *)ellFirst(&INTD_gvar_dataList);
-        ptr_dataNode;
-        ptr_dataNode = (INTD_struc_node *)ellNext(&ptr_dataNode -> node)) {
-        
-        /* get the necessary information */
-        strcpy(var_modName,    ptr_dataNode -> moduleName);     /* module name */
-        strcpy(var_subModName, ptr_dataNode -> subModuleName);  /* sub module name */
-        strcpy(var_recName,    ptr_dataNode -> recName);        /* record name */
-               
-        /* generate the string for record and save to file for this module instance */
-		if(strcmp(moduleName, "MOD_ALL") == 0 || strcmp(moduleName, var_modName) == 0) {
-
-            switch(ptr_dataNode -> recordType) {
-                case INTD_AO:
-        	    case INTD_LO:
-                    if(ptr_dataNode -> scanType == INTD_IOINT || ptr_dataNode -> scanType == INTD_PASSIVE) {    /* means event driven scanning for results, passive scanning for settings */
-                        if(withMacro == 1) {
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s %s\n",      var_subModName, var_recName, var_OPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s.HIHI %s\n", var_subModName, var_recName, var_OPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s.HIGH %s\n", var_subModName, var_recName, var_OPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s.LOW %s\n",  var_subModName, var_recName, var_OPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s.LOLO %s\n", var_subModName, var_recName, var_OPVArchiveMethod);
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s.DRVL %s\n", var_subModName, var_recName, var_OPVArchiveMethod);
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s.DRVH %s\n", var_subModName, var_recName, var_OPVArchiveMethod);
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s.LSV %s\n",  var_subModName, var_recName, var_OPVArchiveMethod);
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s.HSV %s\n",  var_subModName, var_recName, var_OPVArchiveMethod);
-                        } else if(withMacro == 2) {
-                            fprintf(var_outFile_conf, "%s%s:%s %s\n",      var_destModName, var_subModName, var_recName, var_OPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.HIHI %s\n", var_destModName, var_subModName, var_recName, var_OPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.HIGH %s\n", var_destModName, var_subModName, var_recName, var_OPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.LOW %s\n",  var_destModName, var_subModName, var_recName, var_OPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.LOLO %s\n", var_destModName, var_subModName, var_recName, var_OPVArchiveMethod);
-                            fprintf(var_outFile_conf, "%s%s:%s.DRVL %s\n", var_destModName, var_subModName, var_recName, var_OPVArchiveMethod);
-                            fprintf(var_outFile_conf, "%s%s:%s.DRVH %s\n", var_destModName, var_subModName, var_recName, var_OPVArchiveMethod);
-                            fprintf(var_outFile_conf, "%s%s:%s.LSV %s\n",  var_destModName, var_subModName, var_recName, var_OPVArchiveMethod);
-                            fprintf(var_outFile_conf, "%s%s:%s.HSV %s\n",  var_destModName, var_subModName, var_recName, var_OPVArchiveMethod);
-                        } else {
-                            fprintf(var_outFile_conf, "%s%s:%s %s\n",      var_modName, var_subModName, var_recName, var_OPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.HIHI %s\n", var_modName, var_subModName, var_recName, var_OPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.HIGH %s\n", var_modName, var_subModName, var_recName, var_OPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.LOW %s\n",  var_modName, var_subModName, var_recName, var_OPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.LOLO %s\n", var_modName, var_subModName, var_recName, var_OPVArchiveMethod);
-                            fprintf(var_outFile_conf, "%s%s:%s.DRVL %s\n", var_modName, var_subModName, var_recName, var_OPVArchiveMethod);
-                            fprintf(var_outFile_conf, "%s%s:%s.DRVH %s\n", var_modName, var_subModName, var_recName, var_OPVArchiveMethod);
-                            fprintf(var_outFile_conf, "%s%s:%s.LSV %s\n",  var_modName, var_subModName, var_recName, var_OPVArchiveMethod);
-                            fprintf(var_outFile_conf, "%s%s:%s.HSV %s\n",  var_modName, var_subModName, var_recName, var_OPVArchiveMethod);
-                        }
-                    } else {                                                                                    /* means periodic scanning for results */
-                        if(withMacro == 1) {
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s %s\n",      var_subModName, var_recName, var_IPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s.HIHI %s\n", var_subModName, var_recName, var_IPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s.HIGH %s\n", var_subModName, var_recName, var_IPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s.LOW %s\n",  var_subModName, var_recName, var_IPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s.LOLO %s\n", var_subModName, var_recName, var_IPVArchiveMethod);
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s.DRVL %s\n", var_subModName, var_recName, var_IPVArchiveMethod);
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s.DRVH %s\n", var_subModName, var_recName, var_IPVArchiveMethod);
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s.LSV %s\n",  var_subModName, var_recName, var_IPVArchiveMethod);
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s.HSV %s\n",  var_subModName, var_recName, var_IPVArchiveMethod);
-                        } else if(withMacro == 2) {
-                            fprintf(var_outFile_conf, "%s%s:%s %s\n",      var_destModName, var_subModName, var_recName, var_IPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.HIHI %s\n", var_destModName, var_subModName, var_recName, var_IPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.HIGH %s\n", var_destModName, var_subModName, var_recName, var_IPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.LOW %s\n",  var_destModName, var_subModName, var_recName, var_IPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.LOLO %s\n", var_destModName, var_subModName, var_recName, var_IPVArchiveMethod);
-                            fprintf(var_outFile_conf, "%s%s:%s.DRVL %s\n", var_destModName, var_subModName, var_recName, var_IPVArchiveMethod);
-                            fprintf(var_outFile_conf, "%s%s:%s.DRVH %s\n", var_destModName, var_subModName, var_recName, var_IPVArchiveMethod);
-                            fprintf(var_outFile_conf, "%s%s:%s.LSV %s\n",  var_destModName, var_subModName, var_recName, var_IPVArchiveMethod);
-                            fprintf(var_outFile_conf, "%s%s:%s.HSV %s\n",  var_destModName, var_subModName, var_recName, var_IPVArchiveMethod);
-                        } else {
-                            fprintf(var_outFile_conf, "%s%s:%s %s\n",      var_modName, var_subModName, var_recName, var_IPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.HIHI %s\n", var_modName, var_subModName, var_recName, var_IPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.HIGH %s\n", var_modName, var_subModName, var_recName, var_IPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.LOW %s\n",  var_modName, var_subModName, var_recName, var_IPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.LOLO %s\n", var_modName, var_subModName, var_recName, var_IPVArchiveMethod);
-                            fprintf(var_outFile_conf, "%s%s:%s.DRVL %s\n", var_modName, var_subModName, var_recName, var_IPVArchiveMethod);
-                            fprintf(var_outFile_conf, "%s%s:%s.DRVH %s\n", var_modName, var_subModName, var_recName, var_IPVArchiveMethod);
-                            fprintf(var_outFile_conf, "%s%s:%s.LSV %s\n",  var_modName, var_subModName, var_recName, var_IPVArchiveMethod);
-                            fprintf(var_outFile_conf, "%s%s:%s.HSV %s\n",  var_modName, var_subModName, var_recName, var_IPVArchiveMethod);
-                        }
-                    }
-                    break;
-
-                case INTD_AI:
-                case INTD_LI:
-                    if(ptr_dataNode -> scanType == INTD_IOINT || ptr_dataNode -> scanType == INTD_PASSIVE) {    /* means event driven scanning for results, passive scanning for settings */
-                        if(withMacro == 1) {
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s %s\n",      var_subModName, var_recName, var_OPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s.HIHI %s\n", var_subModName, var_recName, var_OPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s.HIGH %s\n", var_subModName, var_recName, var_OPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s.LOW %s\n",  var_subModName, var_recName, var_OPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s.LOLO %s\n", var_subModName, var_recName, var_OPVArchiveMethod);
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s.LSV %s\n",  var_subModName, var_recName, var_OPVArchiveMethod);
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s.HSV %s\n",  var_subModName, var_recName, var_OPVArchiveMethod);
-                        } else if(withMacro == 2) {
-                            fprintf(var_outFile_conf, "%s%s:%s %s\n",      var_destModName, var_subModName, var_recName, var_OPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.HIHI %s\n", var_destModName, var_subModName, var_recName, var_OPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.HIGH %s\n", var_destModName, var_subModName, var_recName, var_OPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.LOW %s\n",  var_destModName, var_subModName, var_recName, var_OPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.LOLO %s\n", var_destModName, var_subModName, var_recName, var_OPVArchiveMethod);
-                            fprintf(var_outFile_conf, "%s%s:%s.LSV %s\n",  var_destModName, var_subModName, var_recName, var_OPVArchiveMethod);
-                            fprintf(var_outFile_conf, "%s%s:%s.HSV %s\n",  var_destModName, var_subModName, var_recName, var_OPVArchiveMethod);
-                        } else {
-                            fprintf(var_outFile_conf, "%s%s:%s %s\n",      var_modName, var_subModName, var_recName, var_OPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.HIHI %s\n", var_modName, var_subModName, var_recName, var_OPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.HIGH %s\n", var_modName, var_subModName, var_recName, var_OPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.LOW %s\n",  var_modName, var_subModName, var_recName, var_OPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.LOLO %s\n", var_modName, var_subModName, var_recName, var_OPVArchiveMethod);
-                            fprintf(var_outFile_conf, "%s%s:%s.LSV %s\n",  var_modName, var_subModName, var_recName, var_OPVArchiveMethod);
-                            fprintf(var_outFile_conf, "%s%s:%s.HSV %s\n",  var_modName, var_subModName, var_recName, var_OPVArchiveMethod);
-                        }
-                    } else {                                                                                    /* means periodic scanning for results */
-                        if(withMacro == 1) {
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s %s\n",      var_subModName, var_recName, var_IPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s.HIHI %s\n", var_subModName, var_recName, var_IPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s.HIGH %s\n", var_subModName, var_recName, var_IPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s.LOW %s\n",  var_subModName, var_recName, var_IPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s.LOLO %s\n", var_subModName, var_recName, var_IPVArchiveMethod);
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s.LSV %s\n",  var_subModName, var_recName, var_IPVArchiveMethod);
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s.HSV %s\n",  var_subModName, var_recName, var_IPVArchiveMethod);
-                        } else if(withMacro == 2) {
-                            fprintf(var_outFile_conf, "%s%s:%s %s\n",      var_destModName, var_subModName, var_recName, var_IPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.HIHI %s\n", var_destModName, var_subModName, var_recName, var_IPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.HIGH %s\n", var_destModName, var_subModName, var_recName, var_IPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.LOW %s\n",  var_destModName, var_subModName, var_recName, var_IPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.LOLO %s\n", var_destModName, var_subModName, var_recName, var_IPVArchiveMethod);
-                            fprintf(var_outFile_conf, "%s%s:%s.LSV %s\n",  var_destModName, var_subModName, var_recName, var_IPVArchiveMethod);
-                            fprintf(var_outFile_conf, "%s%s:%s.HSV %s\n",  var_destModName, var_subModName, var_recName, var_IPVArchiveMethod);
-                        } else {
-                            fprintf(var_outFile_conf, "%s%s:%s %s\n",      var_modName, var_subModName, var_recName, var_IPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.HIHI %s\n", var_modName, var_subModName, var_recName, var_IPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.HIGH %s\n", var_modName, var_subModName, var_recName, var_IPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.LOW %s\n",  var_modName, var_subModName, var_recName, var_IPVArchiveMethod);  
-                            fprintf(var_outFile_conf, "%s%s:%s.LOLO %s\n", var_modName, var_subModName, var_recName, var_IPVArchiveMethod);
-                            fprintf(var_outFile_conf, "%s%s:%s.LSV %s\n",  var_modName, var_subModName, var_recName, var_IPVArchiveMethod);
-                            fprintf(var_outFile_conf, "%s%s:%s.HSV %s\n",  var_modName, var_subModName, var_recName, var_IPVArchiveMethod);
-                        }
-                    }
-                    break;
-
-	            case INTD_BO:
-	            case INTD_BI:
-	            case INTD_MBBO:
-	            case INTD_MBBI:
-	            case INTD_WFO:
-                    if(ptr_dataNode -> scanType == INTD_IOINT || ptr_dataNode -> scanType == INTD_PASSIVE) {
-                        if(withMacro == 1) {
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s %s\n", var_subModName, var_recName, var_OPVArchiveMethod);
-                        } else if(withMacro == 2) {
-                            fprintf(var_outFile_conf, "%s%s:%s %s\n", var_destModName, var_subModName, var_recName, var_OPVArchiveMethod);
-                        } else {
-                            fprintf(var_outFile_conf, "%s%s:%s %s\n", var_modName, var_subModName, var_recName, var_OPVArchiveMethod);
-                        }
-                    } else {
-                        if(withMacro == 1) {
-                            fprintf(var_outFile_conf, "$(name_space)$(module_name)%s:%s %s\n", var_subModName, var_recName, var_IPVArchiveMethod);
-                        } else if(withMacro == 2) {
-                            fprintf(var_outFile_conf, "%s%s:%s %s\n", var_destModName, var_subModName, var_recName, var_IPVArchiveMethod);
-                        } else {
-                            fprintf(var_outFile_conf, "%s%s:%s %s\n", var_modName, var_subModName, var_recName, var_IPVArchiveMethod);
-                        }
-                    }
-                    break;
+            sprintf(var_name, "INTD_timing_single.%s", var_suffix[i]);
+            if(INTD_func_genFileName(var_fullFileName, sizeof(var_fullFileName), path, var_name, "INTD_API_genTiming") == 0) remove(var_fullFileName);
 
-            	default: break;
-        	}        
-		}    
-    }    
+            sprintf(var_name, "INTD_timing_stream.%s", var_suffix[i]);
+            if(INTD_func_genFileName(var_fullFileName, sizeof(var_fullFileName), path, var_name, "INTD_API_genTiming") == 0) remove(var_fullFileName);
+        }
+    }
+}
+
+/**
+ * Synchronization of the internal data with the records. The records are queued to the scanOnce task in a
+ *   window of at most INTD_gvar_syncBatchSize outstanding records, so the scanOnce ring does not overflow.
+ *   With EPICS 3.16 and later the completion is reported by scanOnceCallback, and the records still active
+ *   then (PACT set by the asynchronous completion, see InternalData_async.c) are waited until they complete.
+ *   For the older versions a record is regarded as processed when it is queued successfully, the barrier
+ *   does not cover the asynchronous completion there
+ */
+#if EPICS_VERSION > 3 || (EPICS_VERSION == 3 && EPICS_REVISION >= 16)
+#define INTD_SYNC_WITH_COMPLETION
+#endif
+
+#define INTD_SYNC_STALL_TIMEOUT 10.0                                /* give up when no record completes within this time (s) */
+
+static unsigned int     INTD_gvar_syncBatchSize   = 500;            /* max number of records in the scanOnce queue */
+static int              INTD_gvar_syncPending     = 0;              /* records queued but not yet processed */
+static int              INTD_gvar_syncDone        = 0;              /* last synchronization finished */
+static epicsEventId     INTD_gvar_syncEvent       = NULL;           /* signaled when records complete */
+static epicsEventId     INTD_gvar_syncDoneEvent   = NULL;           /* signaled when the synchronization finished */
+static epicsThreadOnceId INTD_gvar_syncOnce       = EPICS_THREAD_ONCE_INIT;
+
+static void INTD_func_syncInit(void *arg)
+{
+    INTD_gvar_syncEvent     = epicsEventMustCreate(epicsEventEmpty);
+    INTD_gvar_syncDoneEvent = epicsEventMustCreate(epicsEventEmpty);
+}
 
-    /* close to file */
-    fflush(var_outFile_conf);
-    fclose(var_outFile_conf);
+#ifdef INTD_SYNC_WITH_COMPLETION
+static void INTD_func_syncComplete(void *usr, dbCommon *epicsRecord)
+{
+    epicsAtomicDecrIntT(&INTD_gvar_syncPending);
+    epicsEventSignal(INTD_gvar_syncEvent);
+}
+#endif
 
+/**
+ * Queue a record to the scanOnce task, return 0 if queued
+ */
+static int INTD_func_syncQueue(dbCommon *epicsRecord)
+{
+#if defined(INTD_SYNC_WITH_COMPLETION)
+    return scanOnceCallback(epicsRecord, INTD_func_syncComplete, NULL);
+#elif EPICS_VERSION > 3 || (EPICS_VERSION == 3 && EPICS_REVISION >= 15)
+    if(scanOnce(epicsRecord)) return -1;
+    epicsAtomicDecrIntT(&INTD_gvar_syncPending);
+    return 0;
+#else
+    scanOnce(epicsRecord);
+    epicsAtomicDecrIntT(&INTD_gvar_syncPending);
     return 0;
+#endif
 }
 
 /**
- * Generate a list file for the internal data
- * Input:
- *   moduleName:    the module instance that this file for. Please note that the module name will be hardcoded in the file
- *   path:          the path for the file
- *   lstFileName:   full file name of the output list file
- * Return:
- *   0              : Successful
- *  -1              : Failed
+ * Wait until the number of outstanding records drops below the limit, return -1 if the scanOnce task stalls
  */
-int INTD_API_genDbList(const char *moduleName, const char *path, const char *lstFileName)
+static int INTD_func_syncWait(int limit)
 {
-    char var_fullListFileName[256] = "";
-    char var_modName[128]    = "";
-    char var_subModName[128] = ""; 
-    char var_recName[128]    = "";                                   /* record name */
-    char var_scanMethod[128] = "";
-    char var_pno[128]        = "";
-    char var_dataType[128]   = "";
+    int var_pending = epicsAtomicGetIntT(&INTD_gvar_syncPending);
+    int var_last    = var_pending;
+    epicsTimeStamp var_lastProgress, var_now;
 
+    epicsTimeGetCurrent(&var_lastProgress);
 
-    FILE *var_outFile       = NULL;
+    while(var_pending > limit) {
+        epicsEventWaitWithTimeout(INTD_gvar_syncEvent, 1.0);
+        epicsTimeGetCurrent(&var_now);
 
-    INTD_struc_node *ptr_dataNode  = NULL;
-    
-    /* check the input */
-    if(!lstFileName || !lstFileName[0]) return -1;
+        var_pending = epicsAtomicGetIntT(&INTD_gvar_syncPending);
 
-    /* generate the full file names */
-    if(path && path[0]) {
-        strcpy(var_fullListFileName, path);
-        strcat(var_fullListFileName, "/");
-        strcat(var_fullListFileName, lstFileName);
-    } else {
-        strcpy(var_fullListFileName, lstFileName);
+        if(var_pending < var_last) {
+            var_last         = var_pending;
+            var_lastProgress = var_now;
+        } else if(epicsTimeDiffInSeconds(&var_now, &var_lastProgress) > INTD_SYNC_STALL_TIMEOUT) {
+            printf("INTD_func_syncWait: scanOnce task stalled with %d records outstanding\n", var_pending);
+            return -1;
+        }
     }
 
-    /* open the file */
-    var_outFile     = fopen(var_fullListFileName, "w");
+    return 0;
+}
+
+/**
+ * Output records synchronized with the internal data
+ */
+static int INTD_func_syncOutput(INTD_struc_node *dataNode)
+{
+    return  dataNode -> epicsRecord                 &&
+           (dataNode -> recordType == INTD_AO    ||
+            dataNode -> recordType == INTD_BO    ||
+            dataNode -> recordType == INTD_LO    ||
+            dataNode -> recordType == INTD_MBBO  ||
+            dataNode -> recordType == INTD_WFO   ||
+            dataNode -> recordType == INTD_SO    ||
+            dataNode -> recordType == INTD_LSO);
+}
 
-    if(!var_outFile) {
-		printf("INTD_API_genDbList: Failed to create file of %s\n", var_fullListFileName);
-        return -1;
-    }
+#ifdef INTD_SYNC_WITH_COMPLETION
+/**
+ * Wait until the asynchronous records (PACT still set after scanOnce returned) completed, return -1 if one stalls
+ */
+static int INTD_func_syncWaitAsync(void)
+{
+    int var_active;
+    epicsTimeStamp var_start, var_now;
+    INTD_struc_node *ptr_dataNode;
 
-    /* write to file */
+    for(ptr_dataNode = INTD_func_firstNode(); ptr_dataNode; ptr_dataNode = INTD_func_nextNode(ptr_dataNode)) {
+        if(!INTD_func_syncOutput(ptr_dataNode)) continue;
 
-    fprintf(var_outFile, "#-------------------------------------------------------------------------------------\n");
-    fprintf(var_outFile, "# %s\n", lstFileName);
-    fprintf(var_outFile, "# Generate the list of records for the module instance of %s\n", moduleName);
-    fprintf(var_outFile, "# Auto generated by InternalData module!\n");
-    fprintf(var_outFile, "#\n");
-    fprintf(var_outFile, "# variable-id string, record type, scan type, data type, num of point\n"); 
-    fprintf(var_outFile, "#-------------------------------------------------------------------------------------\n");
-    fprintf(var_outFile, "\n");
+        epicsTimeGetCurrent(&var_start);
 
-    for(ptr_dataNode = (INTD_struc_node *)ellFirst(&INTD_gvar_dataList);
-        ptr_dataNode;
-        ptr_dataNode = (INTD_struc_node *)ellNext(&ptr_dataNode -> node)) {
-        
-        /* get the necessary information */
-        strcpy(var_modName,    ptr_dataNode -> moduleName);     /* module name */
-        strcpy(var_subModName, ptr_dataNode -> subModuleName);  /* sub module name */
-        strcpy(var_recName,    ptr_dataNode -> recName);        /* record name */
-        strcpy(var_scanMethod, INTD_gvar_scanStrs[(int)ptr_dataNode -> scanType]);          /* scan method */
-        sprintf(var_pno, "%d", ptr_dataNode -> pno);                                        /* point number (only used for waveform) */
-        
-        switch(ptr_dataNode -> dataType) {                                                  /* field data type (only used for waveform) */
-            case INTD_CHAR:     strcpy(var_dataType, "CHAR");   break;
-            case INTD_UCHAR:    strcpy(var_dataType, "UCHAR");  break;
-            case INTD_SHORT:    strcpy(var_dataType, "SHORT");  break;
-            case INTD_USHORT:   strcpy(var_dataType, "USHORT"); break;
-            case INTD_INT:      strcpy(var_dataType, "LONG");   break;
-            case INTD_UINT:     strcpy(var_dataType, "ULONG");  break;
-            case INTD_LONG:     strcpy(var_dataType, "LONG");   break;
-            case INTD_ULONG:    strcpy(var_dataType, "ULONG");  break;
-            case INTD_FLOAT:    strcpy(var_dataType, "FLOAT");  break;
-            case INTD_DOUBLE:   strcpy(var_dataType, "DOUBLE"); break;
-            case INTD_OLDSTRING:   strcpy(var_dataType, "STRING"); break;
-            default:            strcpy(var_dataType, "");       break;
-        }
-        
-        /* generate the string for record and save to file for this module instance */
-		if(strcmp(moduleName, "MOD_ALL") == 0 || strcmp(moduleName, var_modName) == 0) {
-        	switch(ptr_dataNode -> recordType) {
-            	case INTD_AO:       fprintf(var_outFile, "$(name_space)$(module_name)%s:%s\tao\t%s\tDOUBLE\t1\n",    var_subModName, var_recName, var_scanMethod); break;
-            	case INTD_AI:       fprintf(var_outFile, "$(name_space)$(module_name)%s:%s\tai\t%s\tDOUBLE\t1\n",    var_subModName, var_recName, var_scanMethod); break;
-            	case INTD_BO:       fprintf(var_outFile, "$(name_space)$(module_name)%s:%s\tbo\t%s\tUSHORT\t1\n",    var_subModName, var_recName, var_scanMethod); break;
-            	case INTD_BI:       fprintf(var_outFile, "$(name_space)$(module_name)%s:%s\tbi\t%s\tUSHORT\t1\n",    var_subModName, var_recName, var_scanMethod); break;
-            	case INTD_LO:       fprintf(var_outFile, "$(name_space)$(module_name)%s:%s\tlongout\t%s\tLONG\t1\n", var_subModName, var_recName, var_scanMethod); break;
-            	case INTD_LI:       fprintf(var_outFile, "$(name_space)$(module_name)%s:%s\tlongin\t%s\tLONG\t1\n",  var_subModName, var_recName, var_scanMethod); break;
-            	case INTD_MBBO:     fprintf(var_outFile, "$(name_space)$(module_name)%s:%s\tmbbo\t%s\tULONG\t1\n",   var_subModName, var_recName, var_scanMethod); break;
-            	case INTD_MBBI:     fprintf(var_outFile, "$(name_space)$(module_name)%s:%s\tmbbi\t%s\tULONG\t1\n",   var_subModName, var_recName, var_scanMethod); break;
-            	case INTD_WFO:      fprintf(var_outFile, "$(name_space)$(module_name)%s:%s\twaveform(out)\t%s\t%s\t%s\n", var_subModName, var_recName, var_scanMethod, var_dataType, var_pno); break;
-            	case INTD_WFI:      fprintf(var_outFile, "$(name_space)$(module_name)%s:%s\twaveform(in)\t%s\t%s\t%s\n",  var_subModName, var_recName, var_scanMethod, var_dataType, var_pno); break;
-            	case INTD_SO:       fprintf(var_outFile, "$(name_space)$(module_name)%s:%s\tstringout\t%s\tSTRING\t1\n",  var_subModName, var_recName, var_scanMethod); break;
-            	case INTD_SI:       fprintf(var_outFile, "$(name_space)$(module_name)%s:%s\tstringin\t%s\tSTRING\t1\n",   var_subModName, var_recName, var_scanMethod); break;
-            	default: break;
-        	}            
-		}
-    }    
+        for(;;) {
+            dbScanLock(ptr_dataNode -> epicsRecord);
+            var_active = ptr_dataNode -> epicsRecord -> pact;
+            dbScanUnlock(ptr_dataNode -> epicsRecord);
+
+            if(!var_active) break;
+
+            epicsTimeGetCurrent(&var_now);
+            if(epicsTimeDiffInSeconds(&var_now, &var_start) > INTD_SYNC_STALL_TIMEOUT) {
+                printf("INTD_func_syncWaitAsync: Record %s did not complete\n", ptr_dataNode -> epicsRecord -> name);
+                return -1;
+            }
 
-    /* close to file */
-    fflush(var_outFile);
-    fclose(var_outFile);
+            epicsThreadSleep(0.01);
+        }
+    }
 
     return 0;
 }
+#endif
+
+/**
+ * Set the max number of records in the scanOnce queue during the synchronization. It should be well below
+ *   the size of the scanOnce ring (scanOnceSetQueueSize, 1000 by default)
+ */
+void INTD_API_setSyncBatchSize(unsigned int batchSize)
+{
+    INTD_gvar_syncBatchSize = batchSize > 0 ? batchSize : 1;
+}
 
 /**
  * Synchronize the internal data with the records
  * senario 1: put the record data into the internal data and read the internal data to the record, without executing the call back functions
  * senario 2: put the record data into the internal data and read the internal data to the record, wit executing the call back functions
+ * The routine returns when all records have been processed (or the scanOnce task stalled), the threads waiting
+ * in INTD_API_waitSyncDone are released then
  */
 int INTD_API_syncWithRecords(int enaCallback)
 {
+    int var_status = 0;
+    unsigned int var_recNum = 0, var_retryNum = 0, var_retryRun;
+    epicsTimeStamp var_start, var_end;
     INTD_struc_node *ptr_dataNode  = NULL;
 
+    epicsThreadOnce(&INTD_gvar_syncOnce, INTD_func_syncInit, NULL);
+
+    INTD_gvar_syncDone = 0;
+    epicsAtomicSetIntT(&INTD_gvar_syncPending, 0);
+    epicsTimeGetCurrent(&var_start);
+
     /* process the records */
-    for(ptr_dataNode = (INTD_struc_node *)ellFirst(&INTD_gvar_dataList);
-        ptr_dataNode;
-        ptr_dataNode = (INTD_struc_node *)ellNext(&ptr_dataNode -> node)) {
+    for(ptr_dataNode = INTD_gvar_dataListInitialized ? INTD_func_firstNode() : NULL;
+        ptr_dataNode && var_status == 0;
+        ptr_dataNode = INTD_func_nextNode(ptr_dataNode)) {
         
         if(ptr_dataNode -> epicsRecord) {
-            if( ptr_dataNode -> recordType == INTD_AO    ||
-                ptr_dataNode -> recordType == INTD_BO    ||
-                ptr_dataNode -> recordType == INTD_LO    ||
-                ptr_dataNode -> recordType == INTD_MBBO  ||
-                ptr_dataNode -> recordType == INTD_WFO   ||
-                ptr_dataNode -> recordType == INTD_SO) {    
+            if(INTD_func_syncOutput(ptr_dataNode)) {
+
+                /* back pressure, keep the number of records in the queue within the batch size */
+                if((var_status = INTD_func_syncWait((int)INTD_gvar_syncBatchSize - 1)) != 0) break;
+
                 ptr_dataNode -> enableCallback = enaCallback;
-                scanOnce(ptr_dataNode -> epicsRecord);
+                epicsAtomicIncrIntT(&INTD_gvar_syncPending);
+
+                /* the ring is shared with other users, retry when it is full */
+                for(var_retryRun = 0; INTD_func_syncQueue(ptr_dataNode -> epicsRecord) != 0; var_retryRun ++) {
+                    if(var_retryRun * 0.01 > INTD_SYNC_STALL_TIMEOUT) {
+                        printf("INTD_API_syncWithRecords: Failed to queue the record %s\n", ptr_dataNode -> epicsRecord -> name);
+                        epicsAtomicDecrIntT(&INTD_gvar_syncPending);
+                        var_status = -1;
+                        break;
+                    }
+
+                    var_retryNum ++;
+                    epicsThreadSleep(0.01);
+                }
+
+                if(var_status != 0) break;
+                var_recNum ++;
+
+#ifndef INTD_SYNC_WITH_COMPLETION
+                if(var_recNum % INTD_gvar_syncBatchSize == 0)      /* no completion from EPICS, give the scanOnce task time for a batch */
+                    epicsThreadSleep(0.01);
+#endif
             }
         }
     }    
 
-    return 0;
+    /* wait for the completion of the last records */
+    if(var_status == 0)
+        var_status = INTD_func_syncWait(0);
+
+#ifdef INTD_SYNC_WITH_COMPLETION
+    /* scanOnce reports the completion when process() returns, the asynchronous records complete later */
+    if(var_status == 0 && var_recNum > 0)
+        var_status = INTD_func_syncWaitAsync();
+#endif
+
+    epicsTimeGetCurrent(&var_end);
+
+    printf("INTD_API_syncWithRecords: %u records synchronized in %.3f s (batch size %u, %u retries)%s\n",
+            var_recNum, epicsTimeDiffInSeconds(&var_end, &var_start), INTD_gvar_syncBatchSize, var_retryNum,
+            var_status == 0 ? "" : ", NOT COMPLETED");
+
+    /* release the waiting threads */
+    INTD_gvar_syncDone = 1;
+    epicsEventSignal(INTD_gvar_syncDoneEvent);
+
+    return var_status;
+}
+
+/**
+ * Wait until INTD_API_syncWithRecords finished
+ * Input:
+ *   timeout:       max time to wait (s), 0 or negative to wait forever
+ * Return:
+ *   0              : Synchronization finished
+ *  -1              : Timeout
+ */
+int INTD_API_waitSyncDone(double timeout)
+{
+    epicsTimeStamp var_start, var_now;
+
+    epicsThreadOnce(&INTD_gvar_syncOnce, INTD_func_syncInit, NULL);
+    epicsTimeGetCurrent(&var_start);
+
+    while(!INTD_gvar_syncDone) {
+        if(timeout > 0) {
+            epicsTimeGetCurrent(&var_now);
+            if(epicsTimeDiffInSeconds(&var_now, &var_start) >= timeout) return -1;
+            epicsEventWaitWithTimeout(INTD_gvar_syncDoneEvent, 0.5);
+        } else {
+            epicsEventWait(INTD_gvar_syncDoneEvent);
+        }
+    }
+
+    epicsEventSignal(INTD_gvar_syncDoneEvent);                      /* pass the wakeup to the next waiting thread */
+    return 0;
+}
+
+/**
+ * Select the record type generated for the waveform nodes: aao/aai records (1) or waveform records (0, default).
+ *   The aao/aai device support resolves the direction from the record type, no [W] in DESC is needed
+ */
+void INTD_API_setArrayRecords(int enable)
+{
+    INTD_gvar_arrayRecords = enable ? 1 : 0;
+}
+
+/**
+ * Get the FTVL (menuFtype) of the array records that matches the data type of the node, -1 if no match
+ */
+int INTD_API_getFtvl(INTD_struc_node *dataNode)
+{
+    if(!dataNode) return -1;
+
+    switch(dataNode -> dataType) {
+        case INTD_CHAR:         return menuFtypeCHAR;
+        case INTD_UCHAR:        return menuFtypeUCHAR;
+        case INTD_SHORT:        return menuFtypeSHORT;
+        case INTD_USHORT:       return menuFtypeUSHORT;
+        case INTD_INT:
+        case INTD_LONG:         return menuFtypeLONG;
+        case INTD_UINT:
+        case INTD_ULONG:        return menuFtypeULONG;
+        case INTD_FLOAT:        return menuFtypeFLOAT;
+        case INTD_DOUBLE:       return menuFtypeDOUBLE;
+        case INTD_OLDSTRING:    return menuFtypeSTRING;
+        default:                return -1;
+    }
 }
 
 /**
@@ -1191,86 +3261,682 @@ int INTD_API_getIocInitStatus()
  */
 int INTD_API_getFieldInfo(INTD_struc_node *dataNode, const char *fieldName, short *dbrType, long *nelm)
 {
-	struct dbAddr paddr;    
-    char  fullName[128] = "";
-
-	// check the input
-	if(!dataNode || !fieldName || !dataNode -> epicsRecord) return -1;
-
-    // get the full name
-    strcpy(fullName, dataNode -> epicsRecord -> name);
-    strcat(fullName, ".");
-    strcat(fullName, fieldName);
+    INTD_struc_fieldHandle *ptr_handle = INTD_API_getFieldHandle(dataNode, fieldName);
 
-	// use dbGetField
-	dbNameToAddr(fullName, &paddr);
+    if(!ptr_handle) return -1;
 
-    if(dbrType) *dbrType = paddr.dbr_field_type;
-    if(nelm)    *nelm    = paddr.no_elements;
+    if(dbrType) *dbrType = ptr_handle -> addr.dbr_field_type;
+    if(nelm)    *nelm    = ptr_handle -> addr.no_elements;
 
     return 0;
 }
 
 int INTD_API_getFieldData(INTD_struc_node *dataNode, const char *fieldName, void *data, long pno)
 {
-	struct dbAddr paddr;    
-    long  options       = 0;
-    long  nelm          = 0;
-    char  fullName[128] = "";
+    return INTD_API_getFieldByHandle(INTD_API_getFieldHandle(dataNode, fieldName), data, pno);
+}
 
-	// check the input
-	if(!dataNode || !fieldName || !data || !dataNode -> epicsRecord || pno <= 0) return -1;
+int INTD_API_putFieldData(INTD_struc_node *dataNode, const char *fieldName, double *data, long pno)
+{
+    return INTD_API_putFieldByHandle(INTD_API_getFieldHandle(dataNode, fieldName), data, pno);
+}
+
+/**
+ * Get the resolved field of the record of the node. The field is resolved by dbNameToAddr only at the first
+ *   access and then taken from the cache of the node. The cache is searched without locking, new handles are
+ *   added at the head atomically
+ * Return:
+ *   handle, NULL if the record is not linked or the field does not exist
+ */
+INTD_struc_fieldHandle *INTD_API_getFieldHandle(INTD_struc_node *dataNode, const char *fieldName)
+{
+    char fullName[128] = "";
+    INTD_struc_fieldHandle *ptr_handle, *ptr_head;
+
+    // check the input
+    if(!dataNode || !fieldName || !fieldName[0] || !dataNode -> epicsRecord) return NULL;
+
+    // the field accessed last, typical for the loops
+    ptr_handle = (INTD_struc_fieldHandle *)epicsAtomicGetPtrT((void * const *)&dataNode -> fieldLast);
+    if(ptr_handle && strcmp(ptr_handle -> fieldName, fieldName) == 0) return ptr_handle;
+
+    // the cache of the node
+    for(ptr_handle = (INTD_struc_fieldHandle *)epicsAtomicGetPtrT((void * const *)&dataNode -> fieldHandles);
+        ptr_handle;
+        ptr_handle = ptr_handle -> next) {
+        if(strcmp(ptr_handle -> fieldName, fieldName) == 0) {
+            epicsAtomicSetPtrT((void **)&dataNode -> fieldLast, ptr_handle);
+            return ptr_handle;
+        }
+    }
+
+    // resolve the field
+    if(strlen(dataNode -> epicsRecord -> name) + strlen(fieldName) + 2 > sizeof(fullName)) {
+        printf("INTD_API_getFieldHandle: Name of the field %s.%s longer than %u characters\n",
+                dataNode -> epicsRecord -> name, fieldName, (unsigned int)sizeof(fullName) - 1);
+        return NULL;
+    }
 
-    // get the full name
     strcpy(fullName, dataNode -> epicsRecord -> name);
     strcat(fullName, ".");
     strcat(fullName, fieldName);
 
-	// use dbGetField
-	dbNameToAddr(fullName, &paddr);
+    ptr_handle = (INTD_struc_fieldHandle *)calloc(1, sizeof(INTD_struc_fieldHandle) + strlen(fieldName) + 1);   // name stored after the handle
+    if(!ptr_handle) {
+        printf("INTD_API_getFieldHandle: Failed to allocate memory for %s\n", fullName);
+        return NULL;
+    }
+
+    if(dbNameToAddr(fullName, &ptr_handle -> addr) != 0) {
+        printf("INTD_API_getFieldHandle: Failed to find the field %s\n", fullName);
+        free(ptr_handle);
+        return NULL;
+    }
 
-    nelm = paddr.no_elements;
-    if(nelm > pno) nelm = pno;
+    ptr_handle -> dataNode  = dataNode;
+    ptr_handle -> fieldName = strcpy((char *)(ptr_handle + 1), fieldName);
 
-    return dbGetField(&paddr, paddr.dbr_field_type, data, &options, &nelm, NULL);
+    // publish the handle, another thread may have added one meanwhile (then two handles of the same field exist, both valid)
+    do {
+        ptr_head           = (INTD_struc_fieldHandle *)epicsAtomicGetPtrT((void * const *)&dataNode -> fieldHandles);
+        ptr_handle -> next = ptr_head;
+        epicsAtomicWriteMemoryBarrier();
+    } while(epicsAtomicCmpAndSwapPtrT((void **)&dataNode -> fieldHandles, ptr_head, ptr_handle) != ptr_head);
+
+    epicsAtomicSetPtrT((void **)&dataNode -> fieldLast, ptr_handle);
+    return ptr_handle;
 }
 
-int INTD_API_putFieldData(INTD_struc_node *dataNode, const char *fieldName, double *data, long pno)
+/**
+ * Read the field with its native type (at most pno elements)
+ */
+int INTD_API_getFieldByHandle(INTD_struc_fieldHandle *handle, void *data, long pno)
 {
-	struct dbAddr paddr;    
-    long  nelm          = 0;
-    char  fullName[128] = "";
+    long options = 0;
+    long nelm;
 
-	// check the input
-	if(!dataNode || !fieldName || !data || !dataNode -> epicsRecord || pno <= 0) return -1;
+    if(!handle || !data || pno <= 0) return -1;
 
-    // get the full name
-    strcpy(fullName, dataNode -> epicsRecord -> name);
-    strcat(fullName, ".");
-    strcat(fullName, fieldName);
+    nelm = handle -> addr.no_elements;
+    if(nelm > pno) nelm = pno;
 
-	// use dbPutField
-	dbNameToAddr(fullName, &paddr);
+    return dbGetField(&handle -> addr, handle -> addr.dbr_field_type, data, &options, &nelm, NULL);
+}
+
+/**
+ * Write the field from double values (at most pno elements)
+ */
+int INTD_API_putFieldByHandle(INTD_struc_fieldHandle *handle, double *data, long pno)
+{
+    long nelm;
+
+    if(!handle || !data || pno <= 0) return -1;
 
-    nelm = paddr.no_elements;
+    nelm = handle -> addr.no_elements;
     if(nelm > pno) nelm = pno;
 
-    return dbPutField(&paddr, DBR_DOUBLE, data, nelm);
+    return dbPutField(&handle -> addr, DBR_DOUBLE, data, nelm);
+}
+
+/**
+ * Read the first element of the field converted to double
+ */
+int INTD_API_getFieldDouble(INTD_struc_fieldHandle *handle, double *data)
+{
+    long options = 0;
+    long nelm    = 1;
+
+    if(!handle || !data) return -1;
+
+    return dbGetField(&handle -> addr, DBR_DOUBLE, data, &options, &nelm, NULL);
+}
+
+/**
+ * Print the statistics of the hash index of the data nodes
+ * Input:
+ *   level          : 0 - summary; 1 - also the histogram of the chain lengths
+ */
+void INTD_API_hashReport(int level)
+{
+    unsigned int i, len;
+    unsigned int usedBuckets = 0;
+    unsigned int maxLen      = 0;
+    unsigned int hist[9]     = {0};                                 /* chain length 0..7 and >=8 */
+    INTD_struc_node *ptr_dataNode;
+
+    if(!INTD_gvar_hashBuckets) {
+        printf("INTD_API_hashReport: No data node created\n");
+        return;
+    }
+
+    for(i = 0; i < INTD_gvar_hashBucketNum; i ++) {
+        len = 0;
+        for(ptr_dataNode = INTD_gvar_hashBuckets[i]; ptr_dataNode; ptr_dataNode = ptr_dataNode -> hashNext)
+            len ++;
+
+        if(len > 0)      usedBuckets ++;
+        if(len > maxLen) maxLen = len;
+
+        hist[len < 8 ? len : 8] ++;
+    }
+
+    printf("INTD hash index:\n");
+    printf("    nodes           : %u\n", INTD_gvar_hashNodeNum);
+    printf("    buckets         : %u\n", INTD_gvar_hashBucketNum);
+    printf("    used buckets    : %u\n", usedBuckets);
+    printf("    load factor     : %.3f\n", (double)INTD_gvar_hashNodeNum / INTD_gvar_hashBucketNum);
+    printf("    avg chain length: %.3f\n", usedBuckets ? (double)INTD_gvar_hashNodeNum / usedBuckets : 0.0);
+    printf("    max chain length: %u\n", maxLen);
+
+    if(level > 0) {
+        printf("    chain length histogram:\n");
+        for(i = 0; i < 8; i ++)
+            printf("        %u   : %u\n", i, hist[i]);
+        printf("        >=8 : %u\n", hist[8]);
+    }
+}
+
+/**
+ * Print the memory used by the data nodes and the string pool
+ */
+void INTD_API_memReport()
+{
+    unsigned int nodeNum = INTD_gvar_dataListInitialized ? (unsigned int)ellCount(&INTD_gvar_dataList) : 0;
+
+    printf("INTD memory:\n");
+    printf("    nodes             : %u (%u bytes each, %u slabs of %u)\n", nodeNum, (unsigned int)INTD_NODE_STRIDE, INTD_gvar_nodeSlabNum, INTD_NODE_SLAB_NUM);
+    printf("    node memory       : %lu bytes\n", (unsigned long)INTD_gvar_nodeSlabNum * INTD_NODE_SLAB_NUM * INTD_NODE_STRIDE);
+    printf("    string pool       : %lu bytes\n", (unsigned long)INTD_gvar_strPoolBytes);
+    printf("    interned strings  : %u (%u references shared)\n", INTD_gvar_internStrNum, INTD_gvar_internHitNum);
+}
+
+/**
+ * Enable or disable the access statistics of all data nodes (also the ones created later). When disabled, the
+ *   only overhead in INTD_API_getData/INTD_API_putData is the test of the INTD_FEATURE_STATS bit. The counters are
+ *   kept when disabled and continue when enabled again
+ */
+void INTD_API_enableStats(int enable)
+{
+    INTD_struc_node *ptr_dataNode;
+
+    INTD_gvar_statsEnabled = enable ? 1 : 0;
+
+    if(!INTD_gvar_dataListInitialized) return;
+
+    if(enable) {
+        /* reattach the blocks used before, then create the missing ones */
+        INTD_struc_nodeStats *ptr_stats;
+
+        for(ptr_stats = INTD_gvar_statsList; ptr_stats; ptr_stats = ptr_stats -> next) {
+            ptr_stats -> dataNode -> stats = ptr_stats;
+            INTD_API_setFeature(ptr_stats -> dataNode, INTD_FEATURE_STATS, 1);
+        }
+
+        for(ptr_dataNode = INTD_func_firstNode(); ptr_dataNode; ptr_dataNode = INTD_func_nextNode(ptr_dataNode))
+            if(!ptr_dataNode -> stats) INTD_func_statsNew(ptr_dataNode);
+    } else {
+        /* the blocks stay in the list, a reader that saw the bit before it is cleared still finds them */
+        for(ptr_dataNode = INTD_func_firstNode(); ptr_dataNode; ptr_dataNode = INTD_func_nextNode(ptr_dataNode)) {
+            INTD_API_setFeature(ptr_dataNode, INTD_FEATURE_STATS, 0);
+            ptr_dataNode -> stats = NULL;
+        }
+    }
+}
+
+/**
+ * Clear the access statistics of all data nodes
+ */
+void INTD_API_resetStats()
+{
+    INTD_struc_nodeStats *ptr_stats, *ptr_next;
+    INTD_struc_node *ptr_dataNode;
+
+    for(ptr_stats = INTD_gvar_statsList; ptr_stats; ptr_stats = ptr_next) {
+        ptr_next     = ptr_stats -> next;
+        ptr_dataNode = ptr_stats -> dataNode;
+
+        memset(ptr_stats, 0, sizeof(INTD_struc_nodeStats));
+
+        ptr_stats -> next     = ptr_next;
+        ptr_stats -> dataNode = ptr_dataNode;
+    }
+}
+
+static int INTD_func_statsCompare(const void *a, const void *b)
+{
+    const INTD_struc_nodeStats *sa = *(INTD_struc_nodeStats * const *)a;
+    const INTD_struc_nodeStats *sb = *(INTD_struc_nodeStats * const *)b;
+    size_t na = sa -> getCnt + sa -> putCnt;
+    size_t nb = sb -> getCnt + sb -> putCnt;
+
+    if(na != nb)                 return na > nb ? -1 : 1;
+    if(sa -> cbMax != sb -> cbMax) return sa -> cbMax > sb -> cbMax ? -1 : 1;
+    return 0;
+}
+
+/**
+ * Print the access statistics of the most accessed data nodes
+ * Input:
+ *   moduleName     : Only the nodes of this module, NULL, "" or "*" for all modules
+ *   topN           : Number of nodes to print, 0 for all
+ */
+void INTD_API_statsReport(const char *moduleName, int topN)
+{
+    int i, j, num = 0;
+    char timeStr[64];
+    int allModules = !moduleName || !moduleName[0] || strcmp(moduleName, "*") == 0;
+    INTD_struc_nodeStats  *ptr_stats;
+    INTD_struc_nodeStats **ptr_array;
+
+    if(!INTD_gvar_statsList) {
+        printf("INTD_API_statsReport: No statistics, enable them with INTD_enableStats\n");
+        return;
+    }
+
+    for(ptr_stats = INTD_gvar_statsList; ptr_stats; ptr_stats = ptr_stats -> next)
+        num ++;
+
+    ptr_array = (INTD_struc_nodeStats **)malloc(num * sizeof(INTD_struc_nodeStats *));
+    if(!ptr_array) return;
+
+    num = 0;
+    for(ptr_stats = INTD_gvar_statsList; ptr_stats; ptr_stats = ptr_stats -> next)
+        if(allModules || strcmp(ptr_stats -> dataNode -> moduleName, moduleName) == 0)
+            ptr_array[num ++] = ptr_stats;
+
+    qsort(ptr_array, num, sizeof(INTD_struc_nodeStats *), INTD_func_statsCompare);
+
+    if(topN <= 0 || topN > num) topN = num;
+
+    printf("INTD statistics (%s, %s): %d nodes, top %d\n", allModules ? "all modules" : moduleName, INTD_gvar_statsEnabled ? "enabled" : "disabled", num, topN);
+    printf("%-48s %10s %10s %12s %12s %10s %10s %s\n", "module.data", "gets", "puts", "bytes get", "bytes put", "cb avg(us)", "cb max(us)", "last access");
+
+    for(i = 0; i < topN; i ++) {
+        ptr_stats = ptr_array[i];
+
+        if(ptr_stats -> lastAccess.secPastEpoch || ptr_stats -> lastAccess.nsec)
+            epicsTimeToStrftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S.%03f", &ptr_stats -> lastAccess);
+        else
+            strcpy(timeStr, "never");
+
+        printf("%-24s.%-23s %10lu %10lu %12.0f %12.0f %10.1f %10.1f %s\n", 
+                ptr_stats -> dataNode -> moduleName, ptr_stats -> dataNode -> dataName,
+                (unsigned long)ptr_stats -> getCnt, (unsigned long)ptr_stats -> putCnt, ptr_stats -> bytesGet, ptr_stats -> bytesPut,
+                ptr_stats -> cbNum ? ptr_stats -> cbTotal / ptr_stats -> cbNum * 1e6 : 0.0, ptr_stats -> cbMax * 1e6,
+                timeStr);
+
+        if(ptr_stats -> cbNum) {
+            printf("    callback histogram (us):");
+            for(j = 0; j < INTD_STATS_HIST_BINS; j ++)
+                if(ptr_stats -> cbHist[j]) {
+                    if(j < INTD_STATS_HIST_BINS - 1) printf(" <%u:%lu",  1u << j, (unsigned long)ptr_stats -> cbHist[j]);
+                    else                             printf(" >=%u:%lu", 1u << (j - 1), (unsigned long)ptr_stats -> cbHist[j]);
+                }
+            printf("\n");
+        }
+    }
+
+    free(ptr_array);
+}
+
+/**
+ * Value of a scalar in double for the deadband check
+ */
+static double INTD_func_toDouble(INTD_enum_dataType dataType, const void *data)
+{
+    switch(dataType) {
+        case INTD_CHAR:     return (double)*((const epicsInt8    *)data);
+        case INTD_UCHAR:    return (double)*((const epicsUInt8   *)data);
+        case INTD_SHORT:    return (double)*((const epicsInt16   *)data);
+        case INTD_USHORT:   return (double)*((const epicsUInt16  *)data);
+        case INTD_INT:
+        case INTD_LONG:     return (double)*((const epicsInt32   *)data);
+        case INTD_UINT:
+        case INTD_ULONG:    return (double)*((const epicsUInt32  *)data);
+        case INTD_FLOAT:    return (double)*((const epicsFloat32 *)data);
+        case INTD_DOUBLE:   return (double)*((const epicsFloat64 *)data);
+        default:            return 0.0;
+    }
+}
+
+/**
+ * 64 bit hash of an array for the change detection, FNV-1a on 8-byte words in 4 independent lanes so that
+ *   the multiplications of the lanes overlap
+ */
+static unsigned long long INTD_func_hash64(const void *data, size_t size)
+{
+    const unsigned char *p = (const unsigned char *)data;
+    const unsigned long long prime = 1099511628211ULL;
+    unsigned long long h0 = 14695981039346656037ULL, h1 = h0 ^ 1, h2 = h0 ^ 2, h3 = h0 ^ 3;
+    unsigned long long w0, w1, w2, w3;
+
+    for(; size >= 32; p += 32, size -= 32) {
+        memcpy(&w0, p,      8);
+        memcpy(&w1, p + 8,  8);
+        memcpy(&w2, p + 16, 8);
+        memcpy(&w3, p + 24, 8);
+
+        h0 = (h0 ^ w0) * prime;
+        h1 = (h1 ^ w1) * prime;
+        h2 = (h2 ^ w2) * prime;
+        h3 = (h3 ^ w3) * prime;
+    }
+
+    for(; size >= 8; p += 8, size -= 8) {
+        memcpy(&w0, p, 8);
+        h0 = (h0 ^ w0) * prime;
+    }
+
+    if(size) {
+        w0 = 0;
+        memcpy(&w0, p, size);
+        h1 = (h1 ^ w0) * prime;
+    }
+
+    h0 = (h0 ^ (h1 >> 29) ^ (h1 << 35)) * prime;
+    h0 = (h0 ^ (h2 >> 19) ^ (h2 << 45)) * prime;
+    h0 = (h0 ^ (h3 >> 43) ^ (h3 << 21)) * prime;
+
+    return h0 ^ (h0 >> 32);
+}
+
+/**
+ * Allocate the block hashes for an array of size bytes, a larger array is checked in full the next time
+ */
+static int INTD_func_changeAlloc(INTD_struc_change *change, size_t size)
+{
+    unsigned int blockNum = (unsigned int)((size + INTD_CHANGE_BLOCK_SIZE - 1) / INTD_CHANGE_BLOCK_SIZE);
+    unsigned long long *blockHash;
+
+    if(blockNum <= change -> blockNum) return 0;
+
+    blockHash = (unsigned long long *)calloc(2 * (size_t)blockNum, sizeof(unsigned long long));
+    if(!blockHash) return -1;
+
+    free(change -> blockHash);
+
+    change -> blockHash = blockHash;
+    change -> blockNum  = blockNum;
+    change -> valid     = 0;
+    return 0;
+}
+
+/**
+ * Hash the blocks of an array overlapping the bytes [first, end) (all blocks if no last data is kept yet),
+ *   return 1 if one of them differs from the last data passed. The new hashes are only kept by
+ *   INTD_func_changeKeep, so a sequence-lock reader can repeat the check
+ */
+static int INTD_func_changeHash(INTD_struc_change *change, const void *data, size_t size, size_t first, size_t end)
+{
+    unsigned int blk;
+    size_t off;
+    int changed = !change -> valid;
+
+    if(!change -> valid) {
+        first = 0;
+        end   = size;
+    }
+
+    if(end > size) end = size;
+
+    change -> hashFirst = (unsigned int)(first / INTD_CHANGE_BLOCK_SIZE);
+    change -> hashEnd   = first < end ? (unsigned int)((end + INTD_CHANGE_BLOCK_SIZE - 1) / INTD_CHANGE_BLOCK_SIZE) : change -> hashFirst;
+
+    for(blk = change -> hashFirst; blk < change -> hashEnd; blk ++) {
+        off = (size_t)blk * INTD_CHANGE_BLOCK_SIZE;
+
+        change -> blockHash[change -> blockNum + blk] = INTD_func_hash64((const char *)data + off,
+                size - off < INTD_CHANGE_BLOCK_SIZE ? size - off : INTD_CHANGE_BLOCK_SIZE);
+
+        if(change -> blockHash[change -> blockNum + blk] != change -> blockHash[blk])
+            changed = 1;
+    }
+
+    return changed;
+}
+
+static void INTD_func_changeKeep(INTD_struc_change *change)
+{
+    memcpy(change -> blockHash + change -> hashFirst, change -> blockHash + change -> blockNum + change -> hashFirst,
+           (size_t)(change -> hashEnd - change -> hashFirst) * sizeof(unsigned long long));
+
+    change -> valid = 1;
+}
+
+/**
+ * Compare the data with the last value passed, and remember it if changed
+ */
+static int INTD_func_changeCheck(INTD_struc_change *change, INTD_enum_dataType dataType, unsigned int pno, const void *data)
+{
+    double value, diff, limit;
+    size_t size;
+    int changed;
+
+    change -> checkCnt ++;
+
+    if(dataType == INTD_OLDSTRING || pno > 1) {
+        size = (size_t)pno * INTD_func_getDataSize(dataType);
+
+        if(INTD_func_changeAlloc(change, size) != 0) return 1;
+
+        changed = INTD_func_changeHash(change, data, size, 0, size);
+
+        if(changed) INTD_func_changeKeep(change);
+    } else {
+        value   = INTD_func_toDouble(dataType, data);
+        diff    = fabs(value - change -> lastValue);
+        limit   = change -> absDeadband;
+
+        if(change -> relDeadband * fabs(change -> lastValue) > limit)
+            limit = change -> relDeadband * fabs(change -> lastValue);
+
+        changed = !change -> valid || diff > limit;
+
+        if(changed) change -> lastValue = value;
+
+        change -> valid = 1;
+    }
+
+    if(!changed) change -> suppressCnt ++;
+    return changed;
+}
+
+/**
+ * Enable the change detection of a data node. A scalar is changed when it moved more than both the absolute
+ *   deadband and the relative deadband (fraction of the last value), with both 0 any change counts. An array
+ *   (or string) is changed when the hash of one of its blocks (INTD_CHANGE_BLOCK_SIZE bytes) changed, with
+ *   the dirty range tracked only the blocks of the range are checked. For the nodes with periodic scan, the input
+ *   records (ai, bi, longin, mbbi) keep the last value if the new one is not changed, so no monitor is posted.
+ *   For the I/O Intr nodes, INTD_API_publishNode only requests the scan if the data is changed
+ * Input:
+ *   dataNode       : Data node to be configured
+ *   absDeadband    : Absolute deadband (scalars)
+ *   relDeadband    : Relative deadband (scalars)
+ * Return:
+ *   0              : Successful
+ *  -1              : Failed
+ */
+int INTD_API_setDeadband(INTD_struc_node *dataNode, double absDeadband, double relDeadband)
+{
+    INTD_struc_change *change;
+
+    if(!dataNode) return -1;
+
+    if(!dataNode -> change) {
+        change = (INTD_struc_change *)calloc(1, sizeof(INTD_struc_change));
+
+        if(!change) {
+            printf("INTD_API_setDeadband: Failed to allocate memory for %s\n", dataNode -> dataName);
+            return -1;
+        }
+
+        change -> absDeadband = absDeadband > 0 ? absDeadband : 0.0;
+        change -> relDeadband = relDeadband > 0 ? relDeadband : 0.0;
+
+        epicsAtomicWriteMemoryBarrier();
+        dataNode -> change = change;
+        INTD_API_setFeature(dataNode, INTD_FEATURE_CHANGE, 1);
+    } else {
+        dataNode -> change -> absDeadband = absDeadband > 0 ? absDeadband : 0.0;
+        dataNode -> change -> relDeadband = relDeadband > 0 ? relDeadband : 0.0;
+    }
+
+    return 0;
+}
+
+int INTD_API_setDataDeadband(const char *moduleName, const char *dataName, double absDeadband, double relDeadband)
+{
+    INTD_struc_node *ptr_dataNode = NULL;
+
+    if(!moduleName || !dataName) return -1;
+
+    ptr_dataNode = INTD_func_lookupNode(moduleName, dataName);
+
+    if(!ptr_dataNode) {
+        printf("INTD_API_setDataDeadband: Data node %s.%s not found\n", moduleName, dataName);
+        return -1;
+    }
+
+    return INTD_API_setDeadband(ptr_dataNode, absDeadband, relDeadband);
+}
+
+/**
+ * Check the value read by an input record. Return 1 if the record should take the new value, 0 if it is not
+ *   changed. It always returns 1 without change detection or for the I/O Intr nodes (checked when publishing)
+ */
+int INTD_API_checkRecordChange(INTD_struc_node *dataNode, unsigned int pno, const void *data)
+{
+    if(!INTD_HAS_FEATURE(dataNode, INTD_FEATURE_CHANGE) || dataNode -> scanType == INTD_IOINT) return 1;
+
+    return INTD_func_changeCheck(dataNode -> change, dataNode -> dataType, pno, data);
 }
 
+/**
+ * Check the current data of the node, return 1 if changed (or without change detection). The arrays are
+ *   hashed in place, only the points [first, end) if the rest is known to be unchanged
+ */
+static int INTD_func_checkDataChange(INTD_struc_node *dataNode, unsigned int first, unsigned int end)
+{
+    unsigned int seq;
+    int changed = 1;
+    size_t dataSize;
+    epicsFloat64 value;
+    INTD_struc_change *change = dataNode -> change;
+
+    if(dataNode -> pno > 1 || dataNode -> dataType == INTD_OLDSTRING) {
+        dataSize = INTD_func_getDataSize(dataNode -> dataType);
+
+        change -> checkCnt ++;
+        if(INTD_func_changeAlloc(change, (size_t)dataNode -> pno * dataSize) != 0) return 1;
+
+        do {
+            seq     = INTD_API_readBegin(dataNode);
+            changed = INTD_func_changeHash(change, INTD_API_readBuffer(dataNode), (size_t)dataNode -> pno * dataSize,
+                                           (size_t)first * dataSize, (size_t)end * dataSize);
+        } while(INTD_API_readRetry(dataNode, seq));
+
+        if(changed) INTD_func_changeKeep(change);
+        else        change -> suppressCnt ++;
+    } else {
+        INTD_func_readData(dataNode, 1, (void *)&value, NULL);
+        changed = INTD_func_changeCheck(change, dataNode -> dataType, 1, (void *)&value);
+    }
+
+    return changed;
+}
+
+int INTD_API_checkDataChange(INTD_struc_node *dataNode)
+{
+    if(!dataNode || !INTD_HAS_FEATURE(dataNode, INTD_FEATURE_CHANGE)) return 1;
+
+    return INTD_func_checkDataChange(dataNode, 0, dataNode -> pno);
+}
+
+/**
+ * Prepare the I/O Intr scan of the node: check the data change and update the derived statistics and views.
+ *   Used by INTD_API_publishNode, and by the callers requesting one scan for several nodes (LocalPVGroup)
+ * Return:
+ *   1              : Changed, the scan should be requested
+ *   0              : Suppressed, not changed
+ *  -1              : Failed
+ */
+int INTD_API_publishPrepare(INTD_struc_node *dataNode)
+{
+    unsigned int first = 0, end = 0;
 
+    if(!dataNode || !dataNode -> ioIntScan) return -1;
 
+    if(INTD_HAS_FEATURE(dataNode, INTD_FEATURE_DIRTY)) {
+        /* only the points changed since the last publish are hashed */
+        INTD_func_dirtyTakePublish(dataNode, &first, &end);
 
+        if(INTD_HAS_FEATURE(dataNode, INTD_FEATURE_CHANGE) && !INTD_func_checkDataChange(dataNode, first, end)) return 0;
+    } else if(!INTD_API_checkDataChange(dataNode)) {
+        return 0;
+    }
 
+    /* The derived statistics and views are on the same scan */
+    if(dataNode -> wfStats)
+        INTD_API_updateWfStats(dataNode, 0);
 
+    if(dataNode -> wfViews) {
+        if(!dataNode -> dirty)
+            INTD_API_updateWfViews(dataNode);
+        else if(first < end)
+            INTD_API_updateWfViewsRange(dataNode, first, end - 1);
+    }
 
+    return 1;
+}
 
+/**
+ * Request the I/O Intr scan of the node through the publisher, only if the data is changed
+ * Return:
+ *   0              : Scan requested
+ *   1              : Suppressed, not changed
+ *  -1              : Failed
+ */
+int INTD_API_publishNode(INTD_struc_node *dataNode)
+{
+    int changed = INTD_API_publishPrepare(dataNode);
 
+    if(changed < 0)  return -1;
+    if(changed == 0) return 1;
 
+    return INTD_API_publish(dataNode -> ioIntScan);
+}
 
+/**
+ * Print the suppression ratios of the change detection
+ * Input:
+ *   moduleName     : Only the nodes of this module, NULL, "" or "*" for all modules
+ */
+void INTD_API_changeReport(const char *moduleName)
+{
+    int num = 0;
+    int allModules = !moduleName || !moduleName[0] || strcmp(moduleName, "*") == 0;
+    unsigned long checkSum = 0, suppressSum = 0;
+    INTD_struc_node *ptr_dataNode;
+    INTD_struc_change *change;
 
+    if(!INTD_gvar_dataListInitialized) return;
 
+    printf("%-48s %10s %10s %8s %12s %12s\n", "module.data", "checks", "suppressed", "ratio", "abs deadband", "rel deadband");
 
+    for(ptr_dataNode = INTD_func_firstNode(); ptr_dataNode; ptr_dataNode = INTD_func_nextNode(ptr_dataNode)) {
+        if(!(change = ptr_dataNode -> change)) continue;
+        if(!allModules && strcmp(ptr_dataNode -> moduleName, moduleName) != 0) continue;
 
+        printf("%-24s.%-23s %10lu %10lu %7.1f%% %12g %12g\n", ptr_dataNode -> moduleName, ptr_dataNode -> dataName,
+                change -> checkCnt, change -> suppressCnt,
+                change -> checkCnt ? 100.0 * change -> suppressCnt / change -> checkCnt : 0.0,
+                change -> absDeadband, change -> relDeadband);
 
+        checkSum    += change -> checkCnt;
+        suppressSum += change -> suppressCnt;
+        num ++;
+    }
 
+    printf("INTD change detection (%s): %d nodes, checks %lu, suppressed %lu (%.1f%%)\n", allModules ? "all modules" : moduleName, 
+            num, checkSum, suppressSum, checkSum ? 100.0 * suppressSum / checkSum : 0.0);
+}
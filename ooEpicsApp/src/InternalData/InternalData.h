@@ -22,12 +22,14 @@
 #include <epicsMutex.h>
 #include <epicsEvent.h>
 #include <epicsTypes.h>
+#include <epicsTime.h>
 #include <epicsExit.h>
 #include <ellLib.h>
 #include <alarm.h>
 #include <recGbl.h>
 
 #define INTD_STR_RECORD_LEN 40
+#define INTD_SEQLOCK_MAX_SIZE 256                /* max data size (bytes) of a node in the sequence-lock mode */
 
 #ifdef __cplusplus
 extern "C" {
@@ -65,7 +67,9 @@ typedef enum {
     INTD_WFO,
     INTD_WFI,
     INTD_SO,
-    INTD_SI
+    INTD_SI,
+    INTD_LSO,                                   /* long string (lso/lsi records), the data is INTD_CHAR, pno is the size with the terminating 0 */
+    INTD_LSI
 } INTD_enum_recordType;
 
 typedef enum {
@@ -77,46 +81,152 @@ typedef enum {
     INTD_1S,
     INTD_D5S,
     INTD_D2S,
-    INTD_D1S
+    INTD_D1S,
+    INTD_50HZ,                                   /* custom rates, I/O Intr on the shared timer of InternalData_scan.c */
+    INTD_100HZ,
+    INTD_EVENT,                                  /* SCAN=Event, EVNT set by INTD_API_setScanEvent */
+    INTD_PERIOD                                  /* custom period set by INTD_API_setScanPeriod, I/O Intr as INTD_50HZ */
 } INTD_enum_scanType;
 
+/**
+ * Locking strategy of the data buffer
+ */
+typedef enum {
+    INTD_LOCK_MUTEX,                             /* readers and writers take the node mutex (default) */
+    INTD_LOCK_SEQLOCK,                           /* writers bump a sequence counter, readers retry instead of blocking */
+    INTD_LOCK_TRIPLEBUF,                         /* arrays: writer fills a back buffer and publishes it by an atomic swap */
+    INTD_LOCK_SHARED                             /* waveforms in a shared memory segment: sequence lock on the counter of the segment */
+} INTD_enum_lockMode;
+
+/**
+ * Statistics derived from a waveform node (InternalData_wfStats.c), the masks select them
+ */
+typedef enum {
+    INTD_WFSTAT_MIN_IDX,
+    INTD_WFSTAT_MAX_IDX,
+    INTD_WFSTAT_MEAN_IDX,
+    INTD_WFSTAT_RMS_IDX,
+    INTD_WFSTAT_PEAK_IDX,                        /* index of the (first) maximum */
+    INTD_WFSTAT_NUM
+} INTD_enum_wfStat;
+
+#define INTD_WFSTAT_MIN     (1u << INTD_WFSTAT_MIN_IDX)
+#define INTD_WFSTAT_MAX     (1u << INTD_WFSTAT_MAX_IDX)
+#define INTD_WFSTAT_MEAN    (1u << INTD_WFSTAT_MEAN_IDX)
+#define INTD_WFSTAT_RMS     (1u << INTD_WFSTAT_RMS_IDX)
+#define INTD_WFSTAT_PEAK    (1u << INTD_WFSTAT_PEAK_IDX)
+#define INTD_WFSTAT_ALL     ((1u << INTD_WFSTAT_NUM) - 1)
+
+/**
+ * Decimation of the views of a waveform node (InternalData_wfView.c)
+ */
+typedef enum {
+    INTD_VIEW_STRIDE,                            /* first point of each bin */
+    INTD_VIEW_MEAN,                              /* mean of each bin */
+    INTD_VIEW_MINMAX                             /* min and max of each bin (envelope), 2 points per bin */
+} INTD_enum_wfViewType;
+
+struct INTD_struc_tripleBuf_tag;                 /* buffers of the triple-buffer mode, private to InternalData.c */
+struct INTD_struc_nodeStats_tag;                 /* access statistics, private to InternalData.c */
+struct INTD_struc_change_tag;                    /* change detection, private to InternalData.c */
+struct INTD_struc_dirty_tag;                     /* dirty range tracking, private to InternalData.c */
+struct INTD_struc_fieldHandle_tag;
+struct INTD_struc_async_tag;                  /* asynchronous write completion, private to InternalData_async.c */
+struct INTD_struc_prefetch_tag;               /* read callback prefetch, private to InternalData_async.c */
+struct INTD_struc_wfStats_tag;                /* derived waveform statistics, private to InternalData_wfStats.c */
+struct INTD_struc_wfView_tag;                 /* decimated waveform views, private to InternalData_wfView.c */
+struct INTD_struc_history_tag;                /* history ring buffer of a scalar, private to InternalData_history.c */
+struct INTD_struc_shmNode_tag;                /* buffer in a shared memory segment, private to InternalData_shm.c */
+
 /**
  * Function pointer definition
  */
 typedef void (*INTD_CALLBACK)(void*);
 
 /**
- * Data structure of the internal data
+ * Optional blocks attached to a node. The bits are tested on the hot path before following the pointers,
+ *   so that a node without them does not touch the warm cache lines. The bit is set after the block is
+ *   published and cleared before it is detached (the triple buffers are selected by the lock mode)
  */
-typedef struct {
-    ELLNODE              node;                   /* node for elllist */
-    char                 moduleName[128];        /* module name that this data belongs to */
-    char                 dataName[128];          /* internal data name */
-    char                 subModuleName[128];     /* sub-module name - used for db generation */
-    char                 recName[128];           /* record name - used for db generation */
-    char                 supStr[256];			 /* additional string for bi,bi,mbbi or mbbo */
-    char                 unitStr[16];            /* unit string */
-    char                 desc[128];              /* description of the PV */
-    char                 alias[128];
-    char                 asg[128];
+#define INTD_FEATURE_EVENT      (1 << 0)         /* eventId is set */
+#define INTD_FEATURE_STATS      (1 << 1)         /* stats is attached */
+#define INTD_FEATURE_CHANGE     (1 << 2)         /* change is attached */
+#define INTD_FEATURE_DIRTY      (1 << 3)         /* dirty is attached */
+#define INTD_FEATURE_PREFETCH   (1 << 4)         /* prefetch is attached */
+
+#define INTD_HAS_FEATURE(dataNode, feature)     ((dataNode) -> features & (feature))
+
+/**
+ * Data structure of the internal data. The nodes are allocated from slabs and the fields used when processing
+ *   the records are placed in the first cache line. The strings are only needed for the file generation and
+ *   are kept in a shared string pool (module, sub-module, unit, supplementary and ASG strings are interned)
+ */
+typedef struct INTD_struc_node_tag {
+    /* hot fields, used in every data access */
     void                *dataPtr;                /* pointer to the data (use volatile, later the module may be extended to allow dynamic internal variable association) */
     void                *privateData;            /* private data that might be useful in the call back functions */
-    unsigned int         pno;                    /* number of the points */
-    unsigned int         prec;                   /* precision for displaying */
-    IOSCANPVT           *ioIntScan;              /* pointer of the ioscanpvt */
-    INTD_enum_dataType   dataType;               /* data type */
     INTD_CALLBACK        readCallback;           /* call back function when reading the data */
     INTD_CALLBACK        writeCallback;          /* call back function when writing the data */
-    dbCommon            *epicsRecord;            /* EPICS record that is associate with this internal data node */    
     epicsMutexId         mutexId;                /* provide the possibility for locking, the mutex should be defined in user code */
+    int                  features;               /* INTD_FEATURE_* bits of the optional blocks below that are attached */
+    unsigned int         pno;                    /* number of the points */
+    INTD_enum_dataType   dataType;               /* data type */
+    INTD_enum_lockMode   lockMode;               /* locking strategy of the data buffer */
+    int                  seqCount;               /* sequence counter for the sequence-lock mode, odd while writing */
+
+    /* warm fields, used by the device support and the management routines */
     epicsEventId         eventId;                /* allow signal a event when this internal data is accessed */
-    INTD_enum_recordType recordType;             /* record type for this data */
-    INTD_enum_scanType   scanType;               /* scan type for this data */
     int                  enableCallback;         /* enable/disable the callback */
     epicsEnum16          nsta;                   /* alarm status */
     epicsEnum16          nsevr;                  /* alarm severity */
+    IOSCANPVT           *ioIntScan;              /* pointer of the ioscanpvt */
+    dbCommon            *epicsRecord;            /* EPICS record that is associate with this internal data node */    
+    INTD_enum_recordType recordType;             /* record type for this data */
+    INTD_enum_scanType   scanType;               /* scan type for this data */
+    unsigned int         prec;                   /* precision for displaying */
+    unsigned int         strLen;                 /* length of the string of INTD_LSO/INTD_LSI (without the terminating 0) */
+    unsigned int         validPno;               /* points of an array written by the last put, 0 if all are valid */
+    unsigned int         hashKey;                /* hash value of (moduleName, dataName), kept for rehashing */
+    struct INTD_struc_node_tag *hashNext;        /* next node in the same bucket of the hash index */
+    struct INTD_struc_node_tag *modNext;         /* next node of the same module (creation order), for the file generators */
+    struct INTD_struc_tripleBuf_tag *tripleBuf;  /* buffers of the triple-buffer mode, NULL otherwise */
+    struct INTD_struc_nodeStats_tag *stats;      /* access statistics, NULL when disabled */
+    struct INTD_struc_change_tag *change;        /* change detection, NULL when disabled */
+    struct INTD_struc_dirty_tag *dirty;          /* dirty range of an array, NULL when not tracked */
+    struct INTD_struc_fieldHandle_tag *fieldHandles; /* resolved fields of the record, most recent first */
+    struct INTD_struc_fieldHandle_tag *fieldLast;    /* field accessed last */
+    struct INTD_struc_async_tag *async;          /* asynchronous write completion, NULL for synchronous writes */
+    struct INTD_struc_prefetch_tag *prefetch;    /* read callback prefetch, NULL when the callback runs in the scan */
+    struct INTD_struc_wfStats_tag *wfStats;      /* derived statistics of a waveform, NULL if not declared */
+    struct INTD_struc_wfView_tag *wfViews;       /* decimated views of a waveform, NULL if not declared */
+    struct INTD_struc_history_tag *history;      /* history of a scalar, NULL if not declared */
+    struct INTD_struc_shmNode_tag *shm;          /* buffer in a shared memory segment, NULL otherwise */
+    ELLNODE              node;                   /* node for elllist (keeps the creation order) */
+
+    /* cold fields, strings in the string pool */
+    const char          *moduleName;             /* module name that this data belongs to */
+    const char          *dataName;               /* internal data name */
+    const char          *subModuleName;          /* sub-module name - used for db generation */
+    const char          *recName;                /* record name - used for db generation */
+    const char          *supStr;                 /* additional string for bi,bi,mbbi or mbbo */
+    const char          *unitStr;                /* unit string */
+    const char          *desc;                   /* description of the PV */
+    const char          *alias;
+    const char          *asg;
+    const char          *scanEvent;              /* event name of the INTD_EVENT scan */
 } INTD_struc_node;
 
+/**
+ * Resolved field of the record of a data node. The handles are created once per (node, field), cached in
+ *   the node and valid until EPICS exits
+ */
+typedef struct INTD_struc_fieldHandle_tag {
+    struct INTD_struc_fieldHandle_tag *next;     /* next handle of the same node */
+    INTD_struc_node     *dataNode;
+    const char          *fieldName;
+    struct dbAddr        addr;                   /* resolved by dbNameToAddr */
+} INTD_struc_fieldHandle;
+
 /**
  * Management routines
  */
@@ -137,16 +247,50 @@ INTD_struc_node *INTD_API_createDataNode(const char *moduleName,
                             INTD_enum_scanType   scanType);
 
 INTD_struc_node *INTD_API_findDataNode(const char *moduleName, const char *dataName, dbCommon *epicsRecord);
+INTD_struc_node *INTD_API_firstNode();
+INTD_struc_node *INTD_API_nextNode(INTD_struc_node *dataNode);
 
+int INTD_API_getDataSize(INTD_enum_dataType dataType);
 int INTD_API_getData(INTD_struc_node *dataNode, unsigned int pno, void *data);
+int INTD_API_getRecordData(INTD_struc_node *dataNode, unsigned int pno, void *data, dbCommon *record);
+int INTD_API_getRecordString(INTD_struc_node *dataNode, char *str, unsigned int size, dbCommon *record);
 int INTD_API_putData(INTD_struc_node *dataNode, unsigned int pno, void *data);
+int INTD_API_putDataAsync(INTD_struc_node *dataNode, unsigned int pno, void *data, dbCommon *epicsRecord);
+int INTD_API_putString(INTD_struc_node *dataNode, const char *str, unsigned int len);
+int INTD_API_getString(INTD_struc_node *dataNode, char *str, unsigned int size);
+
+int INTD_API_setLockMode(INTD_struc_node *dataNode, INTD_enum_lockMode lockMode);
+void INTD_API_setFeature(INTD_struc_node *dataNode, int feature, int enable);
+unsigned int INTD_API_readBegin(INTD_struc_node *dataNode);
+int  INTD_API_readRetry(INTD_struc_node *dataNode, unsigned int seq);
+void INTD_API_writeBegin(INTD_struc_node *dataNode);
+void INTD_API_writeBeginFull(INTD_struc_node *dataNode);
+void INTD_API_writeEnd(INTD_struc_node *dataNode);
+void *INTD_API_readBuffer(INTD_struc_node *dataNode);
+void *INTD_API_writeBuffer(INTD_struc_node *dataNode);
+const void *INTD_API_readLock(INTD_struc_node *dataNode);
+void INTD_API_readUnlock(INTD_struc_node *dataNode);
+void INTD_API_lockBenchmark(unsigned int readerNum, double seconds);
+
+int  INTD_API_enableDirtyRange(INTD_struc_node *dataNode);
+int  INTD_API_setDataDirtyRange(const char *moduleName, const char *dataName);
+void INTD_API_markDirty(INTD_struc_node *dataNode, unsigned int first, unsigned int pno);
+int  INTD_API_putDataRange(INTD_struc_node *dataNode, unsigned int first, unsigned int pno, const void *data);
+int  INTD_API_getDataRange(INTD_struc_node *dataNode, unsigned int first, unsigned int pno, void *data);
+void INTD_API_dirtyReport(const char *moduleName);
 
 int INTD_API_genRecord(const char *moduleName, const char *path, const char *dbFileName);
 int INTD_API_genSRReqt(const char *moduleName, const char *path, const char *reqFileName, int withMacro, int sel, const char *destModuleName);
 int INTD_API_genArchive(const char *moduleName, const char *path, const char *confFileName, const char *methodStr, int withMacro, int sel, const char *destModuleName);
 int INTD_API_genDbList(const char *moduleName, const char *path, const char *lstFileName);
+int INTD_API_genFiles(const char *moduleName, const char *path,
+                      const char *dbFileName, const char *reqFileName, const char *confFileName, const char *lstFileName,
+                      const char *methodStr, int withMacro, int reqSel, int archSel, const char *destModuleName);
+void INTD_API_genTiming(const char *moduleName, const char *path, int loops);
 
 int INTD_API_syncWithRecords(int enaCallback);
+void INTD_API_setSyncBatchSize(unsigned int batchSize);
+int INTD_API_waitSyncDone(double timeout);
 
 int INTD_API_forceOPVValue(INTD_struc_node *dataNode, void *dataPtr);
 int INTD_API_forcePVProcess(INTD_struc_node *dataNode);
@@ -156,12 +300,112 @@ int INTD_API_setDescription(INTD_struc_node *dataNode, const char *descStr);
 int INTD_API_setPrecision(INTD_struc_node *dataNode, unsigned int precVal);
 int INTD_API_setAlias(INTD_struc_node *dataNode, const char *aliasStr);
 int INTD_API_setAsg(INTD_struc_node *dataNode, const char *asgStr);
+int INTD_API_setScanEvent(INTD_struc_node *dataNode, const char *eventName);
 
 int INTD_API_getFieldInfo(INTD_struc_node *dataNode, const char *fieldName, short *dbrType, long *nelm);
 int INTD_API_getFieldData(INTD_struc_node *dataNode, const char *fieldName, void *data,   long pno);
 int INTD_API_putFieldData(INTD_struc_node *dataNode, const char *fieldName, double *data, long pno);
 
+INTD_struc_fieldHandle *INTD_API_getFieldHandle(INTD_struc_node *dataNode, const char *fieldName);
+int INTD_API_getFieldByHandle(INTD_struc_fieldHandle *handle, void *data, long pno);
+int INTD_API_putFieldByHandle(INTD_struc_fieldHandle *handle, double *data, long pno);
+int INTD_API_getFieldDouble(INTD_struc_fieldHandle *handle, double *data);
+
 int INTD_API_getIocInitStatus();
+int INTD_API_getFtvl(INTD_struc_node *dataNode);
+void INTD_API_setArrayRecords(int enable);
+
+void INTD_API_hashReport(int level);
+void INTD_API_memReport();
+
+void INTD_API_enableStats(int enable);
+void INTD_API_resetStats();
+void INTD_API_statsReport(const char *moduleName, int topN);
+
+int  INTD_API_setDeadband(INTD_struc_node *dataNode, double absDeadband, double relDeadband);
+int  INTD_API_setDataDeadband(const char *moduleName, const char *dataName, double absDeadband, double relDeadband);
+int  INTD_API_checkRecordChange(INTD_struc_node *dataNode, unsigned int pno, const void *data);
+int  INTD_API_checkDataChange(INTD_struc_node *dataNode);
+int  INTD_API_publishPrepare(INTD_struc_node *dataNode);
+int  INTD_API_publishNode(INTD_struc_node *dataNode);
+void INTD_API_changeReport(const char *moduleName);
+
+/**
+ * Rate limited I/O Intr publisher (InternalData_publisher.c)
+ */
+int  INTD_API_publish(IOSCANPVT *ioIntScan);
+int  INTD_API_setPublishRate(IOSCANPVT *ioIntScan, double maxRate);
+int  INTD_API_setDataPublishRate(const char *moduleName, const char *dataName, double maxRate);
+void INTD_API_setPublishDefaultRate(double maxRate);
+void INTD_API_publishReport(int level);
+void INTD_API_publishResetStats();
+
+/**
+ * Asynchronous completion of the output records and prefetch of the read callbacks (InternalData_async.c)
+ */
+int  INTD_API_setAsyncPool(unsigned int threadNum, unsigned int queueSize);
+int  INTD_API_setAsyncWrite(INTD_struc_node *dataNode, int enable);
+int  INTD_API_setDataAsyncWrite(const char *moduleName, const char *dataName, int enable);
+int  INTD_API_asyncSubmit(INTD_struc_node *dataNode, dbCommon *epicsRecord);
+int  INTD_API_setPrefetch(INTD_struc_node *dataNode, int enable, double budget);
+int  INTD_API_setDataPrefetch(const char *moduleName, const char *dataName, int enable, double budget);
+int  INTD_API_prefetchCheck(INTD_struc_node *dataNode);
+void INTD_API_asyncReport(int level);
+void INTD_API_asyncResetStats();
+
+/**
+ * Vector kernels (InternalData_simd.c) and derived waveform statistics (InternalData_wfStats.c)
+ */
+const char  *INTD_API_vecIsa();
+int          INTD_API_vecStats(INTD_enum_dataType dataType, const void *data, unsigned int pno, double *minVal, double *maxVal, double *sum, double *sumSq);
+unsigned int INTD_API_vecFind(INTD_enum_dataType dataType, const void *data, unsigned int pno, double value);
+int          INTD_API_vecMinMax(INTD_enum_dataType dataType, const void *data, unsigned int pno, double *minVal, double *maxVal);
+double       INTD_API_vecSum(INTD_enum_dataType dataType, const void *data, unsigned int pno);
+int          INTD_API_vecConvert(INTD_enum_dataType dstType, void *dst, INTD_enum_dataType srcType, const void *src, unsigned int pno);
+void         INTD_API_vecBenchmark(unsigned int pno, unsigned int loops);
+
+int  INTD_API_addWfStats(INTD_struc_node *dataNode, unsigned int statMask);
+int  INTD_API_setDataWfStats(const char *moduleName, const char *dataName, unsigned int statMask);
+int  INTD_API_updateWfStats(INTD_struc_node *dataNode, unsigned int pno);
+int  INTD_API_getWfStats(INTD_struc_node *dataNode, double *val);
+void INTD_API_wfStatsReport(const char *moduleName);
+
+/**
+ * Decimated views of waveform nodes (InternalData_wfView.c)
+ */
+INTD_struc_node *INTD_API_addWfView(INTD_struc_node *dataNode, const char *suffix, INTD_enum_wfViewType viewType, unsigned int points);
+int  INTD_API_setDataWfView(const char *moduleName, const char *dataName, const char *suffix, INTD_enum_wfViewType viewType, unsigned int points);
+int  INTD_API_updateWfViews(INTD_struc_node *dataNode);
+int  INTD_API_updateWfViewsRange(INTD_struc_node *dataNode, unsigned int first, unsigned int last);
+void INTD_API_wfViewReport(const char *moduleName);
+
+/**
+ * History of scalar nodes (InternalData_history.c)
+ */
+int  INTD_API_addHistory(INTD_struc_node *dataNode, unsigned int depth);
+int  INTD_API_setDataHistory(const char *moduleName, const char *dataName, unsigned int depth);
+int  INTD_API_historyAppend(INTD_struc_node *dataNode, double value, const epicsTimeStamp *timeStamp);
+void INTD_API_historyReport(const char *moduleName);
+
+/**
+ * Buffers in shared memory segments for the processes outside of the IOC (InternalData_shm.c)
+ */
+int  INTD_API_shmCreate(const char *segName, unsigned int sizeKB, double period);
+int  INTD_API_shmAttach(INTD_struc_node *dataNode, const char *segName);
+int  INTD_API_setDataShm(const char *moduleName, const char *dataName, const char *segName);
+unsigned int INTD_API_shmReadBegin(INTD_struc_node *dataNode);
+int  INTD_API_shmReadRetry(INTD_struc_node *dataNode, unsigned int seq);
+void INTD_API_shmWriteBegin(INTD_struc_node *dataNode);
+void INTD_API_shmWriteEnd(INTD_struc_node *dataNode);
+void INTD_API_shmReport(int level);
+
+/**
+ * Custom period and event scans (InternalData_scan.c)
+ */
+int  INTD_API_scanAttach(INTD_struc_node *dataNode);
+int  INTD_API_setScanPeriod(INTD_struc_node *dataNode, double period);
+int  INTD_API_postEvent(const char *eventName);
+void INTD_API_scanReport();
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,573 @@
+/***************************************************************************
+ *  Copyright (c) 2023 by Paul Scherrer Institute, Switzerland
+ *  All rights reserved.
+ *  Authors: Zheqiao Geng
+ ***************************************************************************/
+/***************************************************************************
+ * InternalData_async.c
+ *
+ * Asynchronous completion of the output records. For the nodes switched to
+ * the asynchronous mode, the device support writes the data, sets PACT and
+ * queues the node to a bounded worker pool. A worker executes the write
+ * callback and completes the record with callbackRequestProcessCallback, so
+ * a slow callback only blocks the pool and not the scan thread or the CA
+ * server thread that processed the record.
+ *
+ * The same pool prefetches the read callbacks of the periodically scanned
+ * input nodes: a timer per scan period queues the read callbacks, and the
+ * records only pick up the data left by the last callback. A record whose
+ * data is older than the period plus the time budget gets a TIMEOUT alarm.
+ ***************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <epicsMutex.h>
+#include <epicsTime.h>
+#include <epicsThread.h>
+#include <epicsMessageQueue.h>
+#include <epicsTimer.h>
+#include <epicsAtomic.h>
+#include <alarm.h>
+#include <dbCommon.h>
+#include <recGbl.h>
+#include <callback.h>
+
+#include "InternalData.h"
+
+/*======================================
+ * Global variables
+ *======================================*/
+#define INTD_ASYNC_THREADS      4                                   /* default number of the worker threads */
+#define INTD_ASYNC_QUEUE_SIZE   256                                 /* default capacity of the job queue */
+#define INTD_PREFETCH_PERIODS   (INTD_D1S - INTD_10S + 1)           /* periodic scan types */
+
+typedef enum {
+    INTD_JOB_WRITE,                                                 /* write callback of an output record, then complete the record */
+    INTD_JOB_PREFETCH                                               /* read callback of a periodically scanned input */
+} INTD_enum_jobType;
+
+typedef struct {
+    INTD_enum_jobType   type;
+    void               *block;                                      /* INTD_struc_async or INTD_struc_prefetch */
+} INTD_struc_job;
+
+typedef struct INTD_struc_async_tag {
+    struct INTD_struc_async_tag *next;                              /* next block in the global list, for the report */
+    INTD_struc_node    *dataNode;                                   /* node owning this block */
+    dbCommon           *epicsRecord;                                /* record waiting for the completion */
+    CALLBACK            callback;                                   /* used to process the record again after the write callback */
+    int                 enabled;                                    /* 1 to complete the writes asynchronously */
+    epicsTimeStamp      queued;                                     /* time when the job was queued */
+    unsigned long       reqCnt;                                     /* number of jobs queued */
+    unsigned long       doneCnt;                                    /* number of jobs executed */
+    unsigned long       syncCnt;                                    /* number of callbacks executed in the caller because the queue was full */
+    unsigned int        depthLast;                                  /* queue depth seen by the last job */
+    unsigned int        depthMax;                                   /* max queue depth seen by the jobs */
+    double              waitSum, waitMax;                           /* time in the queue (s) */
+    double              execSum, execMax;                           /* time of the write callback (s) */
+} INTD_struc_async;
+
+typedef struct INTD_struc_prefetch_tag {
+    struct INTD_struc_prefetch_tag *next;                           /* next node of the same scan period */
+    INTD_struc_node    *dataNode;                                   /* node owning this block */
+    double              period;                                     /* scan period of the node (s) */
+    double              budget;                                     /* time budget of the read callback (s) */
+    int                 enabled;                                    /* 1 to prefetch, 0 to execute the callback in the scan */
+    int                 busy;                                       /* a job is queued or running, accessed atomically */
+    epicsTimeStamp      queued;                                     /* time when the last job was queued */
+    epicsTimeStamp      done;                                       /* time when the last callback finished */
+    unsigned long       runCnt;                                     /* number of callbacks executed */
+    unsigned long       skipCnt;                                    /* number of periods skipped because the last job was not finished */
+    unsigned long       overrunCnt;                                 /* number of callbacks exceeding the budget */
+    unsigned long       lateCnt;                                    /* number of record reads with data older than period + budget */
+    double              execSum, execMax;                           /* time of the read callback (s) */
+} INTD_struc_prefetch;
+
+typedef struct {
+    epicsTimerId        timer;                                      /* restarted every period */
+    INTD_struc_prefetch *nodes;                                     /* prefetched nodes of the period */
+} INTD_struc_prefetchList;
+
+static INTD_struc_async    *INTD_gvar_asyncList        = NULL;
+static epicsMutexId         INTD_gvar_asyncMutex       = NULL;
+static epicsMessageQueueId  INTD_gvar_asyncQueue       = NULL;
+static unsigned int         INTD_gvar_asyncThreadNum   = INTD_ASYNC_THREADS;
+static unsigned int         INTD_gvar_asyncQueueSize   = INTD_ASYNC_QUEUE_SIZE;
+static unsigned int         INTD_gvar_asyncDepthMax    = 0;
+static unsigned long        INTD_gvar_asyncOverflowCnt = 0;
+static int                  INTD_gvar_asyncStatus      = -1;        /* result of the pool creation, 0 when running */
+static epicsThreadOnceId    INTD_gvar_asyncOnce        = EPICS_THREAD_ONCE_INIT;
+
+static const double         INTD_gvar_prefetchPeriods[INTD_PREFETCH_PERIODS] = {10.0, 5.0, 2.0, 1.0, 0.5, 0.2, 0.1};
+static INTD_struc_prefetchList INTD_gvar_prefetchLists[INTD_PREFETCH_PERIODS];
+static epicsTimerQueueId    INTD_gvar_prefetchTimerQueue = NULL;
+static unsigned long        INTD_gvar_prefetchOverflowCnt = 0;
+
+/*======================================
+ * Private Routines
+ *======================================*/
+/**
+ * Execute the write callback of the job and request the completion of the record
+ */
+static void INTD_func_asyncExecute(INTD_struc_async *async)
+{
+    double waitTime, execTime;
+    epicsTimeStamp start, end;
+    INTD_struc_node *dataNode = async -> dataNode;
+    dbCommon *epicsRecord     = async -> epicsRecord;
+
+    epicsTimeGetCurrent(&start);
+
+    if(dataNode -> writeCallback && dataNode -> enableCallback)
+        (*dataNode -> writeCallback)(dataNode -> privateData);
+
+    if(!dataNode -> enableCallback)
+        dataNode -> enableCallback = 1;
+
+    if(INTD_HAS_FEATURE(dataNode, INTD_FEATURE_EVENT)) epicsEventSignal(dataNode -> eventId);
+
+    epicsTimeGetCurrent(&end);
+
+    waitTime = epicsTimeDiffInSeconds(&start, &async -> queued);
+    execTime = epicsTimeDiffInSeconds(&end,   &start);
+
+    epicsMutexMustLock(INTD_gvar_asyncMutex);
+    async -> doneCnt ++;
+    async -> waitSum += waitTime;
+    async -> execSum += execTime;
+    if(waitTime > async -> waitMax) async -> waitMax = waitTime;
+    if(execTime > async -> execMax) async -> execMax = execTime;
+    epicsMutexUnlock(INTD_gvar_asyncMutex);
+
+    /* Process the record again, the device support sees PACT set and completes it */
+    callbackRequestProcessCallback(&async -> callback, epicsRecord -> prio, epicsRecord);
+}
+
+/**
+ * Execute the read callback of a prefetched node, the data is picked up by the next scans of the record
+ */
+static void INTD_func_prefetchExecute(INTD_struc_prefetch *prefetch)
+{
+    double execTime;
+    epicsTimeStamp start, end;
+    INTD_struc_node *dataNode = prefetch -> dataNode;
+
+    epicsTimeGetCurrent(&start);
+
+    if(dataNode -> readCallback)
+        (*dataNode -> readCallback)(dataNode -> privateData);
+
+    epicsTimeGetCurrent(&end);
+    execTime = epicsTimeDiffInSeconds(&end, &start);
+
+    epicsMutexMustLock(INTD_gvar_asyncMutex);
+    prefetch -> done = end;
+    prefetch -> runCnt ++;
+    prefetch -> execSum += execTime;
+    if(execTime > prefetch -> execMax) prefetch -> execMax = execTime;
+    if(execTime > prefetch -> budget) {
+        if(!prefetch -> overrunCnt)
+            printf("INTD_func_prefetchExecute: Read callback of %s.%s took %.3f ms (budget %.3f ms)\n",
+                    dataNode -> moduleName, dataNode -> dataName, execTime * 1e3, prefetch -> budget * 1e3);
+        prefetch -> overrunCnt ++;
+    }
+    epicsMutexUnlock(INTD_gvar_asyncMutex);
+
+    epicsAtomicSetIntT(&prefetch -> busy, 0);
+}
+
+/**
+ * Timer callback, queue the read callbacks of the nodes of one scan period. A node whose last job is
+ * not finished is skipped, so a slow callback never piles up in the queue
+ */
+static void INTD_func_prefetchTimerCallback(void *arg)
+{
+    INTD_struc_job job;
+    INTD_struc_prefetch *prefetch;
+    INTD_struc_prefetchList *list = (INTD_struc_prefetchList *)arg;
+
+    epicsMutexMustLock(INTD_gvar_asyncMutex);
+
+    for(prefetch = list -> nodes; prefetch; prefetch = prefetch -> next) {
+        if(!prefetch -> enabled) continue;
+
+        if(epicsAtomicGetIntT(&prefetch -> busy)) {
+            prefetch -> skipCnt ++;
+            continue;
+        }
+
+        job.type  = INTD_JOB_PREFETCH;
+        job.block = (void *)prefetch;
+
+        epicsAtomicSetIntT(&prefetch -> busy, 1);
+        epicsTimeGetCurrent(&prefetch -> queued);
+
+        if(epicsMessageQueueTrySend(INTD_gvar_asyncQueue, &job, sizeof(job)) != 0) {
+            epicsAtomicSetIntT(&prefetch -> busy, 0);
+            INTD_gvar_prefetchOverflowCnt ++;
+        }
+    }
+
+    epicsMutexUnlock(INTD_gvar_asyncMutex);
+
+    epicsTimerStartDelay(list -> timer, INTD_gvar_prefetchPeriods[list - INTD_gvar_prefetchLists]);
+}
+
+/**
+ * Thread function of the workers
+ */
+static void INTD_func_asyncWorker(void *arg)
+{
+    INTD_struc_job job;
+
+    for(;;) {
+        if(epicsMessageQueueReceive(INTD_gvar_asyncQueue, &job, sizeof(job)) != sizeof(job))
+            continue;
+
+        if(job.type == INTD_JOB_WRITE)
+            INTD_func_asyncExecute((INTD_struc_async *)job.block);
+        else
+            INTD_func_prefetchExecute((INTD_struc_prefetch *)job.block);
+    }
+}
+
+/**
+ * Create the job queue and start the workers, executed only once
+ */
+static void INTD_func_asyncOnce(void *arg)
+{
+    unsigned int i;
+    char threadName[32];
+
+    INTD_gvar_asyncMutex = epicsMutexMustCreate();
+
+    INTD_gvar_asyncQueue = epicsMessageQueueCreate(INTD_gvar_asyncQueueSize, sizeof(INTD_struc_job));
+    if(!INTD_gvar_asyncQueue) {
+        printf("INTD_func_asyncInit: Failed to create the job queue\n");
+        return;
+    }
+
+    for(i = 0; i < INTD_gvar_asyncThreadNum; i ++) {
+        sprintf(threadName, "INTD_async%u", i);
+
+        if(!epicsThreadCreate(threadName, epicsThreadPriorityMedium,
+                              epicsThreadGetStackSize(epicsThreadStackMedium),
+                              INTD_func_asyncWorker, NULL)) {
+            printf("INTD_func_asyncInit: Failed to create the worker thread %s\n", threadName);
+            if(i == 0) return;
+            break;
+        }
+    }
+
+    INTD_gvar_asyncStatus = 0;
+}
+
+/**
+ * Create the job queue and start the workers, safe to be called for several times and from several threads
+ */
+static int INTD_func_asyncInit()
+{
+    epicsThreadOnce(&INTD_gvar_asyncOnce, INTD_func_asyncOnce, NULL);
+    return INTD_gvar_asyncStatus;
+}
+
+/*======================================
+ * Public Routines
+ *======================================*/
+/**
+ * Set the number of the worker threads and the capacity of the job queue. Only effective before the
+ * first node is switched to the asynchronous mode
+ */
+int INTD_API_setAsyncPool(unsigned int threadNum, unsigned int queueSize)
+{
+    if(INTD_gvar_asyncQueue) {
+        printf("INTD_API_setAsyncPool: Worker pool already running with %u threads\n", INTD_gvar_asyncThreadNum);
+        return -1;
+    }
+
+    if(threadNum > 0) INTD_gvar_asyncThreadNum = threadNum;
+    if(queueSize > 0) INTD_gvar_asyncQueueSize = queueSize;
+
+    return 0;
+}
+
+/**
+ * Switch the data node to complete the writes asynchronously (enable = 1) or in the processing thread (enable = 0)
+ */
+int INTD_API_setAsyncWrite(INTD_struc_node *dataNode, int enable)
+{
+    INTD_struc_async *async;
+
+    if(!dataNode) return -1;
+
+    if(dataNode -> async) {
+        dataNode -> async -> enabled = enable ? 1 : 0;
+        return 0;
+    }
+
+    if(!enable) return 0;
+
+    if(dataNode -> recordType == INTD_AI   || dataNode -> recordType == INTD_BI   ||
+       dataNode -> recordType == INTD_LI   || dataNode -> recordType == INTD_MBBI ||
+       dataNode -> recordType == INTD_SI   || dataNode -> recordType == INTD_LSI) {
+        printf("INTD_API_setAsyncWrite: %s.%s is not an output\n", dataNode -> moduleName, dataNode -> dataName);
+        return -1;
+    }
+
+    if(INTD_func_asyncInit() != 0) return -1;
+
+    async = (INTD_struc_async *)calloc(1, sizeof(INTD_struc_async));
+    if(!async) {
+        printf("INTD_API_setAsyncWrite: Failed to allocate memory for %s.%s\n", dataNode -> moduleName, dataNode -> dataName);
+        return -1;
+    }
+
+    async -> dataNode = dataNode;
+    async -> enabled  = 1;
+
+    epicsMutexMustLock(INTD_gvar_asyncMutex);
+    async -> next       = INTD_gvar_asyncList;
+    INTD_gvar_asyncList = async;
+    epicsMutexUnlock(INTD_gvar_asyncMutex);
+
+    dataNode -> async = async;
+    return 0;
+}
+
+/**
+ * Queue the write callback of the node to the worker pool. The data has been written by the caller.
+ * Return:
+ *   0              : Queued, the caller should set PACT and return
+ *  -1              : Not queued (asynchronous mode disabled or queue full), the caller executes the callback
+ */
+int INTD_API_asyncSubmit(INTD_struc_node *dataNode, dbCommon *epicsRecord)
+{
+    unsigned int depth;
+    INTD_struc_job job;
+    INTD_struc_async *async;
+
+    if(!dataNode || !epicsRecord || !INTD_gvar_asyncQueue) return -1;
+
+    async = dataNode -> async;
+    if(!async || !async -> enabled) return -1;
+
+    async -> epicsRecord = epicsRecord;
+    epicsTimeGetCurrent(&async -> queued);
+
+    job.type  = INTD_JOB_WRITE;
+    job.block = (void *)async;
+
+    if(epicsMessageQueueTrySend(INTD_gvar_asyncQueue, &job, sizeof(job)) != 0) {
+        epicsMutexMustLock(INTD_gvar_asyncMutex);
+        async -> syncCnt ++;
+        INTD_gvar_asyncOverflowCnt ++;
+        epicsMutexUnlock(INTD_gvar_asyncMutex);
+        return -1;
+    }
+
+    depth = (unsigned int)epicsMessageQueuePending(INTD_gvar_asyncQueue);
+
+    epicsMutexMustLock(INTD_gvar_asyncMutex);
+    async -> reqCnt    ++;
+    async -> depthLast  = depth;
+    if(depth > async -> depthMax)       async -> depthMax       = depth;
+    if(depth > INTD_gvar_asyncDepthMax) INTD_gvar_asyncDepthMax = depth;
+    epicsMutexUnlock(INTD_gvar_asyncMutex);
+
+    return 0;
+}
+
+/**
+ * Execute the read callback of a periodically scanned input node on the worker pool (enable = 1), ahead of
+ * the scan, or in the scan thread as before (enable = 0). budget is the time (s) allowed to the callback,
+ * 0 or negative for one scan period
+ */
+int INTD_API_setPrefetch(INTD_struc_node *dataNode, int enable, double budget)
+{
+    unsigned int idx;
+    INTD_struc_prefetch *prefetch;
+    INTD_struc_prefetchList *list;
+
+    if(!dataNode) return -1;
+
+    if(dataNode -> prefetch) {
+        epicsMutexMustLock(INTD_gvar_asyncMutex);
+        dataNode -> prefetch -> enabled = enable ? 1 : 0;
+        if(budget > 0) dataNode -> prefetch -> budget = budget;
+        epicsMutexUnlock(INTD_gvar_asyncMutex);
+        return 0;
+    }
+
+    if(!enable) return 0;
+
+    if(!dataNode -> readCallback || dataNode -> scanType < INTD_10S || dataNode -> scanType > INTD_D1S) {
+        printf("INTD_API_setPrefetch: %s.%s has no read callback or is not periodically scanned\n", dataNode -> moduleName, dataNode -> dataName);
+        return -1;
+    }
+
+    if(INTD_func_asyncInit() != 0) return -1;
+
+    epicsMutexMustLock(INTD_gvar_asyncMutex);
+    if(!INTD_gvar_prefetchTimerQueue)
+        INTD_gvar_prefetchTimerQueue = epicsTimerQueueAllocate(1, epicsThreadPriorityScanHigh);
+    epicsMutexUnlock(INTD_gvar_asyncMutex);
+
+    if(!INTD_gvar_prefetchTimerQueue) {
+        printf("INTD_API_setPrefetch: Failed to create the timer queue\n");
+        return -1;
+    }
+
+    idx  = (unsigned int)(dataNode -> scanType - INTD_10S);
+    list = &INTD_gvar_prefetchLists[idx];
+
+    prefetch = (INTD_struc_prefetch *)calloc(1, sizeof(INTD_struc_prefetch));
+    if(!prefetch) {
+        printf("INTD_API_setPrefetch: Failed to allocate memory for %s.%s\n", dataNode -> moduleName, dataNode -> dataName);
+        return -1;
+    }
+
+    prefetch -> dataNode = dataNode;
+    prefetch -> period   = INTD_gvar_prefetchPeriods[idx];
+    prefetch -> budget   = budget > 0 ? budget : prefetch -> period;
+    prefetch -> enabled  = 1;
+    epicsTimeGetCurrent(&prefetch -> done);                         /* no alarm before the first period */
+
+    epicsMutexMustLock(INTD_gvar_asyncMutex);
+
+    prefetch -> next = list -> nodes;
+    list -> nodes    = prefetch;
+
+    if(!list -> timer) {
+        list -> timer = epicsTimerQueueCreateTimer(INTD_gvar_prefetchTimerQueue, INTD_func_prefetchTimerCallback, (void *)list);
+        if(list -> timer) epicsTimerStartDelay(list -> timer, 0.0);
+    }
+
+    epicsMutexUnlock(INTD_gvar_asyncMutex);
+
+    dataNode -> prefetch = prefetch;
+    INTD_API_setFeature(dataNode, INTD_FEATURE_PREFETCH, 1);
+    return 0;
+}
+
+/**
+ * Called by INTD_API_getData for the prefetched nodes. Set the TIMEOUT alarm of the record if the data
+ * was not refreshed within the scan period plus the time budget
+ * Return:
+ *   0              : Data fresh
+ *   1              : Data prefetched but late
+ *  -1              : Prefetch disabled
+ */
+int INTD_API_prefetchCheck(INTD_struc_node *dataNode)
+{
+    double age;
+    epicsTimeStamp now, done;
+    INTD_struc_prefetch *prefetch = dataNode -> prefetch;
+
+    if(!prefetch || !prefetch -> enabled) return -1;
+
+    epicsMutexMustLock(INTD_gvar_asyncMutex);
+    done = prefetch -> done;
+    epicsMutexUnlock(INTD_gvar_asyncMutex);
+
+    epicsTimeGetCurrent(&now);
+    age = epicsTimeDiffInSeconds(&now, &done);
+
+    if(age <= prefetch -> period + prefetch -> budget) return 0;
+
+    prefetch -> lateCnt ++;
+    if(dataNode -> epicsRecord)
+        recGblSetSevr(dataNode -> epicsRecord, TIMEOUT_ALARM, MINOR_ALARM);
+
+    return 1;
+}
+
+/**
+ * Print the statistics of the asynchronous writes and the prefetch. Level 0 prints the pool only, level 1
+ * also the nodes that have been written or prefetched, level 2 all nodes
+ */
+void INTD_API_asyncReport(int level)
+{
+    unsigned int i;
+    unsigned long jobs;
+    INTD_struc_async *async;
+    INTD_struc_prefetch *prefetch;
+
+    if(!INTD_gvar_asyncQueue) {
+        printf("INTD_API_asyncReport: asynchronous writes and prefetch not used\n");
+        return;
+    }
+
+    epicsMutexMustLock(INTD_gvar_asyncMutex);
+
+    printf("INTD async pool: %u threads, queue %d/%u, max depth %u, overflows %lu\n",
+            INTD_gvar_asyncThreadNum, epicsMessageQueuePending(INTD_gvar_asyncQueue),
+            INTD_gvar_asyncQueueSize, INTD_gvar_asyncDepthMax, INTD_gvar_asyncOverflowCnt);
+
+    for(async = INTD_gvar_asyncList; async && level > 0; async = async -> next) {
+        jobs = async -> doneCnt;
+        if(!jobs && level < 2) continue;
+
+        printf("    %s.%s%s: queued %lu, done %lu, sync %lu, depth %u (max %u), wait %.3f/%.3f ms, callback %.3f/%.3f ms (avg/max)\n",
+                async -> dataNode -> moduleName, async -> dataNode -> dataName, async -> enabled ? "" : " (disabled)",
+                async -> reqCnt, jobs, async -> syncCnt, async -> depthLast, async -> depthMax,
+                jobs ? async -> waitSum * 1e3 / jobs : 0.0, async -> waitMax * 1e3,
+                jobs ? async -> execSum * 1e3 / jobs : 0.0, async -> execMax * 1e3);
+    }
+
+    printf("INTD prefetch: queue overflows %lu\n", INTD_gvar_prefetchOverflowCnt);
+
+    for(i = 0; i < INTD_PREFETCH_PERIODS && level > 0; i ++) {
+        for(prefetch = INTD_gvar_prefetchLists[i].nodes; prefetch; prefetch = prefetch -> next) {
+            jobs = prefetch -> runCnt;
+            if(!jobs && level < 2) continue;
+
+            printf("    %s.%s (%.1f s)%s: runs %lu, skipped %lu, overruns %lu, late reads %lu, callback %.3f/%.3f ms (avg/max), budget %.3f ms\n",
+                    prefetch -> dataNode -> moduleName, prefetch -> dataNode -> dataName, prefetch -> period,
+                    prefetch -> enabled ? "" : " (disabled)",
+                    jobs, prefetch -> skipCnt, prefetch -> overrunCnt, prefetch -> lateCnt,
+                    jobs ? prefetch -> execSum * 1e3 / jobs : 0.0, prefetch -> execMax * 1e3, prefetch -> budget * 1e3);
+        }
+    }
+
+    epicsMutexUnlock(INTD_gvar_asyncMutex);
+}
+
+/**
+ * Reset the statistics of the asynchronous writes and the prefetch
+ */
+void INTD_API_asyncResetStats()
+{
+    unsigned int i;
+    INTD_struc_async *async;
+    INTD_struc_prefetch *prefetch;
+
+    if(!INTD_gvar_asyncMutex) return;
+
+    epicsMutexMustLock(INTD_gvar_asyncMutex);
+
+    for(async = INTD_gvar_asyncList; async; async = async -> next) {
+        async -> reqCnt   = 0;
+        async -> doneCnt  = 0;
+        async -> syncCnt  = 0;
+        async -> depthMax = 0;
+        async -> waitSum  = async -> waitMax = 0.0;
+        async -> execSum  = async -> execMax = 0.0;
+    }
+
+    for(i = 0; i < INTD_PREFETCH_PERIODS; i ++) {
+        for(prefetch = INTD_gvar_prefetchLists[i].nodes; prefetch; prefetch = prefetch -> next) {
+            prefetch -> runCnt     = 0;
+            prefetch -> skipCnt    = 0;
+            prefetch -> overrunCnt = 0;
+            prefetch -> lateCnt    = 0;
+            prefetch -> execSum    = prefetch -> execMax = 0.0;
+        }
+    }
+
+    INTD_gvar_asyncDepthMax       = 0;
+    INTD_gvar_asyncOverflowCnt    = 0;
+    INTD_gvar_prefetchOverflowCnt = 0;
+
+    epicsMutexUnlock(INTD_gvar_asyncMutex);
+}
@@ -0,0 +1,121 @@
+/***************************************************************************
+ *  Copyright (c) 2023 by Paul Scherrer Institute, Switzerland
+ *  All rights reserved.
+ *  Authors: Zheqiao Geng
+ ***************************************************************************/
+/***************************************************************************
+ * InternalData_devAai.c
+ *
+ * Device support for aai record. The record always reads the internal data,
+ * so there is nothing to decide when processing
+ ***************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "alarm.h"
+#include "dbDefs.h"
+#include "dbAccess.h"
+#include "recGbl.h"
+#include "recSup.h"
+#include "devSup.h"
+#include "link.h"
+#include "menuFtype.h"
+#include "aaiRecord.h"
+#include "epicsExport.h"
+
+#include "InternalData.h"
+
+/* Create the dset for devAaiSoft */
+static long init_record();
+static long read_aai();
+static long get_ioint_info(int delFrom, dbCommon *prec, IOSCANPVT *ppvt);
+
+struct {
+	long		number;
+	DEVSUPFUN	report;
+	DEVSUPFUN	init;
+	DEVSUPFUN	init_record;
+	DEVSUPFUN	get_ioint_info;
+	DEVSUPFUN	read_aai;
+}devAai_internalData={
+	5,
+	NULL,
+	NULL,
+	init_record,
+	get_ioint_info,
+	read_aai
+};
+epicsExportAddress(dset,devAai_internalData);
+
+/* Init the record */
+static long init_record(aaiRecord *paai)
+{
+    char moduleName[128] = "";
+    char dataName[128]   = "";
+    INTD_struc_node *dataNode;
+
+    /* Get the link strings, should be "moduleName.dataName" */
+    sscanf(paai -> inp.value.instio.string, "%127[^.].%127c", moduleName, dataName);
+
+    /* Init value */
+    paai -> nord = 0;
+
+    /* Attach to a internal data */
+    dataNode = INTD_API_findDataNode(moduleName, dataName, (dbCommon *)paai);
+
+    if(!dataNode) {
+        printf("aai:init_record: Failed to find the internal data of %s for the module of %s\n", dataName, moduleName);
+        return -1;
+    }
+
+    /* The element type must be the same as the internal data */
+    if(INTD_API_getFtvl(dataNode) != paai -> ftvl) {
+        printf("aai:init_record: FTVL of %s does not match the type of the internal data %s.%s\n", paai -> name, moduleName, dataName);
+        return -1;
+    }
+
+    paai -> dpvt = (void *)dataNode;
+    return 0;
+}
+
+/* For I/O interrupt scanning */
+static long get_ioint_info(int delFrom, dbCommon *prec, IOSCANPVT *ppvt)
+{
+    aaiRecord       *paai     = (aaiRecord *)prec;
+    INTD_struc_node *dataNode = (INTD_struc_node *)paai -> dpvt;
+
+    if(!dataNode || !dataNode -> ioIntScan) return -1;
+
+    *ppvt = *dataNode -> ioIntScan;
+    return 0;
+}
+
+/* Read the internal data */
+static long read_aai(aaiRecord *paai)
+{
+    long status;
+    unsigned int pno;
+    INTD_struc_node *dataNode = (INTD_struc_node *)paai -> dpvt;
+
+    if(!dataNode) return -1;
+
+    pno = (paai->nelm < dataNode->pno)?paai->nelm:dataNode->pno;                            /* find the minimum as point number to be processed */
+
+    status = INTD_API_getRecordData(dataNode, pno, paai -> bptr, (dbCommon *)paai);
+
+    if(status != 0) {
+        recGblSetSevr(paai, READ_ALARM, INVALID_ALARM);
+        return status;
+    }
+
+    /* alarm except for UDF, only the points written by the last put are valid (all if 0) */
+    if(dataNode -> nsta != UDF_ALARM)
+        recGblSetSevr(paai, dataNode -> nsta, dataNode -> nsevr);
+
+    if(dataNode -> validPno && dataNode -> validPno < pno) pno = dataNode -> validPno;
+
+    paai -> nord = pno;
+
+    return status;
+}
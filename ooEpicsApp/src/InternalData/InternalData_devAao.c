@@ -0,0 +1,92 @@
+/***************************************************************************
+ *  Copyright (c) 2023 by Paul Scherrer Institute, Switzerland
+ *  All rights reserved.
+ *  Authors: Zheqiao Geng
+ ***************************************************************************/
+/***************************************************************************
+ * InternalData_devAao.c
+ *
+ * Device support for aao record. The record always writes the internal data,
+ * so there is nothing to decide when processing
+ ***************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "alarm.h"
+#include "dbDefs.h"
+#include "dbAccess.h"
+#include "recGbl.h"
+#include "recSup.h"
+#include "devSup.h"
+#include "link.h"
+#include "menuFtype.h"
+#include "aaoRecord.h"
+#include "epicsExport.h"
+
+#include "InternalData.h"
+
+/* Create the dset for devAaoSoft */
+static long init_record();
+static long write_aao();
+
+struct {
+	long		number;
+	DEVSUPFUN	report;
+	DEVSUPFUN	init;
+	DEVSUPFUN	init_record;
+	DEVSUPFUN	get_ioint_info;
+	DEVSUPFUN	write_aao;
+}devAao_internalData={
+	5,
+	NULL,
+	NULL,
+	init_record,
+	NULL,
+	write_aao
+};
+epicsExportAddress(dset,devAao_internalData);
+
+/* Init the record */
+static long init_record(aaoRecord *paao)
+{
+    char moduleName[128] = "";
+    char dataName[128]   = "";
+    INTD_struc_node *dataNode;
+
+    /* Get the link strings, should be "moduleName.dataName" */
+    sscanf(paao -> out.value.instio.string, "%127[^.].%127c", moduleName, dataName);
+
+    /* Attach to a internal data */
+    dataNode = INTD_API_findDataNode(moduleName, dataName, (dbCommon *)paao);
+
+    if(!dataNode) {
+        printf("aao:init_record: Failed to find the internal data of %s for the module of %s\n", dataName, moduleName);
+        return -1;
+    }
+
+    /* The element type must be the same as the internal data */
+    if(INTD_API_getFtvl(dataNode) != paao -> ftvl) {
+        printf("aao:init_record: FTVL of %s does not match the type of the internal data %s.%s\n", paao -> name, moduleName, dataName);
+        return -1;
+    }
+
+    paao -> dpvt = (void *)dataNode;
+    return 0;
+}
+
+/* Write the internal data, only the elements that have been written to the record (NORD), nothing before the first write */
+static long write_aao(aaoRecord *paao)
+{
+    unsigned int pno;
+    INTD_struc_node *dataNode = (INTD_struc_node *)paao -> dpvt;
+
+    if(!dataNode) return -1;
+
+    if(!paao -> nord) return 0;
+
+    pno = paao -> nord;
+    if(pno > dataNode -> pno) pno = dataNode -> pno;
+
+    return INTD_API_putDataAsync(dataNode, pno, paao -> bptr, (dbCommon *)paao);
+}
@@ -92,11 +92,17 @@ static long read_ai(aiRecord *pai)
 {
     long status;    
     INTD_struc_node *dataNode = (INTD_struc_node *)pai -> dpvt;
+    epicsFloat64    val;
 
     if(!dataNode) return -1;
 
     /* Get data. Please note that the type of the waveform must be same as the internal data node */
-    status = INTD_API_getData(dataNode, 1, (void *)(&pai -> val));
+    status = INTD_API_getData(dataNode, 1, (void *)(&val));
+
+    /* keep the last value if not changed (change detection), then no monitor is posted */
+    if(status == 0 && INTD_API_checkRecordChange(dataNode, 1, (void *)(&val)))
+        pai -> val = val;
+
     pai -> udf = FALSE;
 
     /* alarm except for UDF */
@@ -77,7 +77,7 @@ static long write_ao(aoRecord *pao)
 
     if(!pao -> dpvt) return -1;
 
-    status = INTD_API_putData((INTD_struc_node *)pao -> dpvt, 1, (void *)(&pao -> oval));
+    status = INTD_API_putDataAsync((INTD_struc_node *)pao -> dpvt, 1, (void *)(&pao -> oval), (dbCommon *)pao);
     pao -> val = pao -> oval;
 
     return status;
@@ -82,10 +82,16 @@ static long read_bi(biRecord *pbi)
 {
     long status;
     INTD_struc_node *dataNode = (INTD_struc_node *)pbi -> dpvt;
+    epicsEnum16     val;
 
     if(!dataNode) return -1;
 
-    status = INTD_API_getData(dataNode, 1, (void *)(&pbi -> val));
+    status = INTD_API_getData(dataNode, 1, (void *)(&val));
+
+    /* keep the last value if not changed (change detection), then no monitor is posted */
+    if(status == 0 && INTD_API_checkRecordChange(dataNode, 1, (void *)(&val)))
+        pbi -> val = val;
+
     pbi -> udf = FALSE;
 
     /* alarm except for UDF */
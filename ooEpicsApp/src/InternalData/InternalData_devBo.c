@@ -72,7 +72,7 @@ static long write_bo(boRecord *pbo)
 
     if(!pbo -> dpvt) return -1;
 
-    status = INTD_API_putData((INTD_struc_node *)pbo -> dpvt, 1, (void *)(&pbo -> val));
+    status = INTD_API_putDataAsync((INTD_struc_node *)pbo -> dpvt, 1, (void *)(&pbo -> val), (dbCommon *)pbo);
 
     return status;
 }
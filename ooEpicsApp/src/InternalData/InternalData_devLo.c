@@ -70,7 +70,7 @@ static long write_longout(longoutRecord	*plongout)
 
     if(!plongout -> dpvt) return -1;
 
-    status = INTD_API_putData((INTD_struc_node *)plongout -> dpvt, 1, (void *)(&plongout -> val));
+    status = INTD_API_putDataAsync((INTD_struc_node *)plongout -> dpvt, 1, (void *)(&plongout -> val), (dbCommon *)plongout);
 
     return status;
 }
@@ -0,0 +1,104 @@
+/***************************************************************************
+ *  Copyright (c) 2023 by Paul Scherrer Institute, Switzerland
+ *  All rights reserved.
+ *  Authors: Zheqiao Geng
+ ***************************************************************************/
+/***************************************************************************
+ * InternalData_devLsi.c
+ *
+ * Device support for lsi record (long string input, EPICS base 3.15 or later)
+ ***************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "dbScan.h"
+#include "alarm.h"
+#include "dbDefs.h"
+#include "dbAccess.h"
+#include "epicsTime.h"
+#include "recGbl.h"
+#include "recSup.h"
+#include "devSup.h"
+#include "link.h"
+#include "lsiRecord.h"
+#include "epicsExport.h"
+
+#include "InternalData.h"
+
+/* Create the dset for devLsi */
+static long init_record();
+static long read_lsi();
+static long get_ioint_info(int delFrom, dbCommon *prec, IOSCANPVT *ppvt);
+
+struct {
+	long		number;
+	DEVSUPFUN	report;
+	DEVSUPFUN	init;
+	DEVSUPFUN	init_record;
+	DEVSUPFUN	get_ioint_info;
+	DEVSUPFUN	read_lsi;
+}devLsi_internalData={
+	5,
+	NULL,
+	NULL,
+	init_record,
+	get_ioint_info,
+	read_lsi
+};
+epicsExportAddress(dset,devLsi_internalData);
+
+/* Init the record */
+static long init_record(lsiRecord *prec)
+{
+    char moduleName[128] = "";
+    char dataName[128]   = "";
+
+    /* Get the link strings, should be "moduleName.dataName" */
+    sscanf(prec -> inp.value.instio.string, "%127[^.].%127c", moduleName, dataName);
+
+    /* Attach to a internal data */
+    prec -> dpvt = (void *)INTD_API_findDataNode(moduleName, dataName, (dbCommon *)prec);
+
+    if(prec -> dpvt) {        
+        return 0;
+    } else {
+        printf("lsi:init_record: Failed to find the internal data of %s for the module of %s\n", dataName, moduleName);
+        return -1;
+    }   
+}
+
+/* For I/O interrupt scanning */
+static long get_ioint_info(int delFrom, dbCommon *prec, IOSCANPVT *ppvt)
+{
+    lsiRecord       *plsi     = (lsiRecord *)prec;
+    INTD_struc_node *dataNode = (INTD_struc_node *)plsi -> dpvt;
+
+    if(!dataNode || !dataNode -> ioIntScan) return -1;
+
+    *ppvt = *dataNode -> ioIntScan;
+    return 0;
+}
+
+/* Read lsi, only the characters of the string are copied */
+static long read_lsi(lsiRecord *prec)
+{
+    long status;    
+    int  len;
+    INTD_struc_node *dataNode = (INTD_struc_node *)prec -> dpvt;
+
+    if(!dataNode || prec -> sizv == 0) return -1;
+
+    /* Get data, the string is terminated within SIZV and its length is kept by the node */
+    len = INTD_API_getRecordString(dataNode, prec -> val, prec -> sizv, (dbCommon *)prec);
+    if(len >= 0) prec -> len = (epicsUInt32)len + 1;
+    status = len >= 0 ? 0 : -1;
+    prec -> udf = FALSE;
+
+    /* alarm except for UDF */
+    if(dataNode -> nsta != UDF_ALARM)
+        recGblSetSevr(prec, dataNode -> nsta, dataNode -> nsevr);
+
+    return status;
+}
+
@@ -0,0 +1,82 @@
+/***************************************************************************
+ *  Copyright (c) 2023 by Paul Scherrer Institute, Switzerland
+ *  All rights reserved.
+ *  Authors: Zheqiao Geng
+ ***************************************************************************/
+/***************************************************************************
+ * InternalData_devLso.c
+ *
+ * Device support for lso record (long string output, EPICS base 3.15 or later)
+ ***************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "alarm.h"
+#include "dbDefs.h"
+#include "dbAccess.h"
+#include "recGbl.h"
+#include "recSup.h"
+#include "devSup.h"
+#include "link.h"
+#include "lsoRecord.h"
+#include "epicsExport.h"
+
+#include "InternalData.h"
+
+/* added for Channel Access Links */
+static long init_record();
+
+/* Create the dset for devLso */
+static long write_lso();
+
+/* Device support entry point */
+struct {
+    long        number;
+    DEVSUPFUN   report;
+    DEVSUPFUN   init;
+    DEVSUPFUN   init_record;
+    DEVSUPFUN   get_ioint_info;
+    DEVSUPFUN   write_lso;
+}devLso_internalData={
+	5,
+	NULL,
+	NULL,
+	init_record,
+	NULL,
+	write_lso
+};
+epicsExportAddress(dset,devLso_internalData);
+
+/* Init the record */
+static long init_record(lsoRecord *prec)
+{
+    char moduleName[128] = "";
+    char dataName[128]   = "";
+
+    /* Get the link strings, should be "moduleName.dataName" */
+    sscanf(prec -> out.value.instio.string, "%127[^.].%127c", moduleName, dataName);
+
+    /* Attach to a internal data */
+    prec -> dpvt = (void *)INTD_API_findDataNode(moduleName, dataName, (dbCommon *)prec);
+
+    if(prec -> dpvt) {
+        return 0;
+    } else {
+        printf("lso:init_record: Failed to find the internal data of %s for the module of %s\n", dataName, moduleName);
+        return -1;
+    }    
+}
+
+/* Process the record, LEN is the length of the string with the terminating 0 */
+static long write_lso(lsoRecord *prec)
+{    
+    long status;
+
+    if(!prec -> dpvt) return -1;
+
+    status = INTD_API_putDataAsync((INTD_struc_node *)prec -> dpvt, prec -> len ? prec -> len : 1, (void *)(prec -> val), (dbCommon *)prec);
+
+    return status;
+}
+
@@ -86,10 +86,16 @@ static long read_mbbi(mbbiRecord *pmbbi)
 {
     long status;
     INTD_struc_node *dataNode = (INTD_struc_node *)pmbbi -> dpvt;
+    epicsEnum16     val;
 
     if(!dataNode) return -1;
 
-    status = INTD_API_getData(dataNode, 1, (void *)(&pmbbi -> val));
+    status = INTD_API_getData(dataNode, 1, (void *)(&val));
+
+    /* keep the last value if not changed (change detection), then no monitor is posted */
+    if(status == 0 && INTD_API_checkRecordChange(dataNode, 1, (void *)(&val)))
+        pmbbi -> val = val;
+
     pmbbi -> udf = FALSE;
 
     /* alarm except for UDF */
@@ -81,7 +81,7 @@ static long write_mbbo(mbboRecord *pmbbo)
     if(!pmbbo -> dpvt) return -1;
 
     data = pmbbo->val;
-    status = INTD_API_putData((INTD_struc_node *)pmbbo -> dpvt, 1, (void *)(&data));
+    status = INTD_API_putDataAsync((INTD_struc_node *)pmbbo -> dpvt, 1, (void *)(&data), (dbCommon *)pmbbo);
 
     return status;
 }
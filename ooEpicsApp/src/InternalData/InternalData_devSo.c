@@ -76,7 +76,7 @@ static long write_stringout(stringoutRecord *prec)
 
     if(!prec -> dpvt) return -1;
 
-    status = INTD_API_putData((INTD_struc_node *)prec -> dpvt, INTD_STR_RECORD_LEN, (void *)(prec -> val));
+    status = INTD_API_putDataAsync((INTD_struc_node *)prec -> dpvt, INTD_STR_RECORD_LEN, (void *)(prec -> val), (dbCommon *)prec);
 
     return status;
 }
@@ -24,6 +24,12 @@
 
 #include "InternalData.h"
 
+/* Private data of the record, the direction is resolved when initializing the record */
+typedef struct {
+    INTD_struc_node *dataNode;
+    int              write;                                     /* 1: the record writes the internal data */
+} devWf_private;
+
 /* Create the dset for devWfSoft */
 static long init_record();
 static long process_wf();
@@ -51,6 +57,8 @@ static long init_record(waveformRecord *pwf)
 {
     char moduleName[128] = "";
     char dataName[128]   = "";
+    INTD_struc_node *dataNode;
+    devWf_private   *priv;
 
     /* Get the link strings, should be "moduleName.dataName" */
     sscanf(pwf -> inp.value.instio.string, "%127[^.].%127c", moduleName, dataName);
@@ -59,23 +67,34 @@ static long init_record(waveformRecord *pwf)
     pwf -> nord = 0;
 
     /* Attach to a internal data */
-    pwf -> dpvt = (void *)INTD_API_findDataNode(moduleName, dataName, (dbCommon *)pwf);
-
-    if(pwf -> dpvt) {        
-        /* Later check the type */
+    dataNode = INTD_API_findDataNode(moduleName, dataName, (dbCommon *)pwf);
 
-        return 0;
-    } else {
+    if(!dataNode) {
         printf("waveform:init_record: Failed to find the internal data of %s for the module of %s\n", dataName, moduleName);
         return -1;
     }   
+
+    priv = (devWf_private *)malloc(sizeof(devWf_private));
+    if(!priv) {
+        printf("waveform:init_record: Failed to allocate memory for %s\n", pwf -> name);
+        return -1;
+    }
+
+    /* [W] or [w] in the desc field means writing the internal data (the generated INTD_WFO records have it), 
+       only checked here instead of on every process */
+    priv -> dataNode = dataNode;
+    priv -> write    = strstr(pwf -> desc, "[W]") || strstr(pwf -> desc, "[w]");
+
+    pwf -> dpvt = (void *)priv;
+    return 0;
 }
 
 /* For I/O interrupt scanning */
 static long get_ioint_info(int delFrom, dbCommon *prec, IOSCANPVT *ppvt)
 {
     waveformRecord  *pwf      = (waveformRecord *)prec;
-    INTD_struc_node *dataNode = (INTD_struc_node *)pwf -> dpvt;
+    devWf_private   *priv     = (devWf_private *)pwf -> dpvt;
+    INTD_struc_node *dataNode = priv ? priv -> dataNode : NULL;
 
     if(!dataNode || !dataNode -> ioIntScan) return -1;
 
@@ -88,18 +107,37 @@ static long process_wf(waveformRecord *pwf)
 {
     long status;  
     unsigned int pno;      
-    INTD_struc_node *dataNode = (INTD_struc_node *)pwf -> dpvt;                             /* get the data node */
+    devWf_private   *priv = (devWf_private *)pwf -> dpvt;
+    INTD_struc_node *dataNode;
 
-    if(!dataNode) return -1;
+    if(!priv) return -1;
 
+    dataNode = priv -> dataNode;                                                            /* get the data node */
     pno = (pwf->nelm < dataNode->pno)?pwf->nelm:dataNode->pno;                              /* find the minimum as point number to be processed */
 
     /* Get/put data. Please note that the type of the waveform must be same as the internal data node */
-    if(strstr(pwf -> desc, "[W]") || strstr(pwf -> desc, "[w]")) {                                  /* [W] or [w] in desc field indicate to write the waveform */
-        status = INTD_API_putData(dataNode, pno, pwf -> bptr);
+    if(priv -> write) {
+        status = INTD_API_putDataAsync(dataNode, pno, pwf -> bptr, (dbCommon *)pwf);
     } else {
         /*printf("Read waveform for record of %s\n", pwf->name);      */  
-        status = INTD_API_getData(dataNode, pno, pwf -> bptr);
+        status = INTD_API_getRecordData(dataNode, pno, pwf -> bptr, (dbCommon *)pwf);
+
+        /* data not readable (writer of a shared memory buffer stalled), keep the old value */
+        if(status != 0) {
+            recGblSetSevr(pwf, READ_ALARM, INVALID_ALARM);
+            return status;
+        }
+
+        /* alarm except for UDF (e.g. the history given up) */
+        if(dataNode -> nsta != UDF_ALARM)
+            recGblSetSevr(pwf, dataNode -> nsta, dataNode -> nsevr);
+
+        /* unchanged data (change detection of the periodic scans) keeps NORD of the last change */
+        if(!INTD_API_checkRecordChange(dataNode, pno, pwf -> bptr))
+            return status;
+
+        /* only the points written by the last put are valid (e.g. the history not filled yet), all if 0 */
+        if(dataNode -> validPno && dataNode -> validPno < pno) pno = dataNode -> validPno;
     }
 
     if(pno > 0) pwf -> nord = pno;
@@ -0,0 +1,314 @@
+/***************************************************************************
+ *  Copyright (c) 2023 by Paul Scherrer Institute, Switzerland
+ *  All rights reserved.
+ *  Authors: Zheqiao Geng
+ ***************************************************************************/
+/***************************************************************************
+ * InternalData_history.c
+ *
+ * History of scalar nodes. The producer appends (value, timestamp) to a
+ * single-producer ring buffer, which is wait-free (no lock, no loop) so it
+ * can be used in the fast control loops. Two WFI nodes <data name>-HIST
+ * and <data name>-HIST-TS show the last N values and timestamps in the
+ * chronological order. The ring is only unrolled to them when their
+ * records are processed, not for each append.
+ *
+ * The ring has at least 2 * N slots, the reader unrolls it into a scratch
+ * buffer and validates that the producer did not overwrite the slots
+ * copied, it copies again otherwise. Only a valid copy is written to the
+ * WFI nodes, the records show the INVALID alarm if the reader gives up.
+ ***************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <epicsMutex.h>
+#include <epicsTime.h>
+#include <epicsAtomic.h>
+
+#include "InternalData.h"
+
+/*======================================
+ * Global variables
+ *======================================*/
+#define INTD_HISTORY_RETRY_MAX  4                                   /* copies of the ring before giving up a scan */
+
+typedef struct {
+    double              value;
+    double              time;                                       /* POSIX seconds */
+} INTD_struc_historySlot;
+
+typedef struct INTD_struc_history_tag {
+    INTD_struc_historySlot *ring;
+    size_t              mask;                                       /* slots - 1, the slots are a power of 2 */
+    size_t              head;                                       /* number of samples appended, written by the producer only */
+    size_t              lastHead;                                   /* head of the last unroll */
+    unsigned int        depth;                                      /* N, points of the WFI nodes */
+    double             *values;                                     /* data of the WFI nodes */
+    double             *times;
+    double             *scratch;                                    /* unrolled values and times, 2 * N, not validated yet */
+    INTD_struc_node    *valueNode;
+    INTD_struc_node    *timeNode;
+    epicsMutexId        readMutex;                                  /* serializes the readers, never taken by the producer */
+    unsigned long       unrollCnt;                                  /* number of unrolls */
+    unsigned long       retryCnt;                                   /* copies repeated due to the producer lapping the reader */
+    unsigned long       lostCnt;                                    /* unrolls given up */
+} INTD_struc_history;
+
+/*======================================
+ * Private Routines
+ *======================================*/
+/**
+ * Copy the last samples of the ring in the chronological order into the scratch buffer. Return the head
+ *   copied, or 0 if the producer overwrote the slots during the copy
+ * Output:
+ *   num            : Number of samples copied (less than N until the ring has N samples)
+ */
+static size_t INTD_func_historyCopy(INTD_struc_history *hist, size_t *num)
+{
+    size_t head, start, i, pos;
+    double *values = hist -> scratch;
+    double *times  = hist -> scratch + hist -> depth;
+
+    head = epicsAtomicGetSizeT(&hist -> head);
+    epicsAtomicReadMemoryBarrier();
+
+    *num  = head < hist -> depth ? head : hist -> depth;
+    start = head - *num;
+
+    for(i = 0; i < *num; i ++) {
+        pos = (start + i) & hist -> mask;
+        values[i] = hist -> ring[pos].value;
+        times[i]  = hist -> ring[pos].time;
+    }
+
+    /* the producer must not have reached the first slot copied again */
+    epicsAtomicReadMemoryBarrier();
+    if(epicsAtomicGetSizeT(&hist -> head) - start >= hist -> mask + 1) return 0;
+
+    return head;
+}
+
+/**
+ * Write the validated copy of the scratch buffer to a WFI node. The valid points give NORD of the records
+ *   while the ring has less than N samples
+ */
+static void INTD_func_historyPublish(INTD_struc_node *dataNode, const double *data, size_t num)
+{
+    INTD_API_writeBegin(dataNode);
+    memcpy(INTD_API_writeBuffer(dataNode), data, num * sizeof(double));
+    dataNode -> validPno = num < dataNode -> pno ? (unsigned int)num : 0;
+    INTD_API_writeEnd(dataNode);
+
+    INTD_API_raiseAlarm(dataNode, NO_ALARM, NO_ALARM);
+}
+
+/**
+ * Free the history, NULL is accepted
+ */
+static void INTD_func_historyFree(INTD_struc_history *hist)
+{
+    if(!hist) return;
+
+    if(hist -> readMutex) epicsMutexDestroy(hist -> readMutex);
+    free(hist -> ring);
+    free(hist -> values);
+    free(hist -> times);
+    free(hist -> scratch);
+    free(hist);
+}
+
+/**
+ * Read callback of the WFI nodes, unroll the ring if new samples were appended since the last scan
+ */
+static void INTD_func_historyRead(void *arg)
+{
+    unsigned int i;
+    size_t head = 0, num = 0;
+    INTD_struc_history *hist = (INTD_struc_history *)arg;
+
+    if(!hist || epicsAtomicGetSizeT(&hist -> head) == hist -> lastHead) return;
+
+    epicsMutexMustLock(hist -> readMutex);
+
+    if(epicsAtomicGetSizeT(&hist -> head) != hist -> lastHead) {
+        for(i = 0; i < INTD_HISTORY_RETRY_MAX; i ++) {
+            if((head = INTD_func_historyCopy(hist, &num)) != 0) break;
+            hist -> retryCnt ++;
+        }
+
+        if(head) {
+            INTD_func_historyPublish(hist -> valueNode, hist -> scratch, num);
+            INTD_func_historyPublish(hist -> timeNode,  hist -> scratch + hist -> depth, num);
+
+            hist -> lastHead = head;
+            hist -> unrollCnt ++;
+        } else {
+            /* the records keep the last valid copy with the INVALID alarm, the next scan tries again */
+            INTD_API_raiseAlarm(hist -> valueNode, READ_ALARM, INVALID_ALARM);
+            INTD_API_raiseAlarm(hist -> timeNode,  READ_ALARM, INVALID_ALARM);
+            hist -> lostCnt ++;
+        }
+    }
+
+    epicsMutexUnlock(hist -> readMutex);
+}
+
+/*======================================
+ * Public Routines
+ *======================================*/
+/**
+ * Keep the history of a scalar node. Two INTD_WFI nodes (double) <data name>-HIST and <data name>-HIST-TS
+ *   are created in the same module and sub-module, with the scan type, IOSCANPVT and mutex of the node.
+ *   Must be called before the records are generated
+ * Input:
+ *   dataNode       : Scalar numeric node
+ *   depth          : Number of samples shown (N)
+ * Return:
+ *   0              : Successful
+ *  -1              : Failed
+ */
+int INTD_API_addHistory(INTD_struc_node *dataNode, unsigned int depth)
+{
+    size_t slots = 1;
+    char dataName[256];
+    char descStr[41];
+    INTD_struc_history *hist;
+
+    if(!dataNode || dataNode -> pno != 1 || depth == 0 ||
+       dataNode -> dataType == INTD_OLDSTRING || dataNode -> recordType == INTD_WFI || dataNode -> recordType == INTD_WFO) {
+        printf("INTD_API_addHistory: History only for scalar numeric nodes\n");
+        return -1;
+    }
+
+    if(dataNode -> history) {
+        printf("INTD_API_addHistory: History of %s.%s already declared\n", dataNode -> moduleName, dataNode -> dataName);
+        return -1;
+    }
+
+    while(slots < 2 * (size_t)depth) slots <<= 1;
+
+    hist = (INTD_struc_history *)calloc(1, sizeof(INTD_struc_history));
+    if(hist) {
+        hist -> ring      = (INTD_struc_historySlot *)calloc(slots, sizeof(INTD_struc_historySlot));
+        hist -> values    = (double *)calloc(depth, sizeof(double));
+        hist -> times     = (double *)calloc(depth, sizeof(double));
+        hist -> scratch   = (double *)calloc(2 * (size_t)depth, sizeof(double));
+        hist -> readMutex = epicsMutexCreate();
+    }
+
+    if(!hist || !hist -> ring || !hist -> values || !hist -> times || !hist -> scratch || !hist -> readMutex) {
+        printf("INTD_API_addHistory: Failed to allocate memory for %s.%s\n", dataNode -> moduleName, dataNode -> dataName);
+        INTD_func_historyFree(hist);
+        return -1;
+    }
+
+    hist -> mask  = slots - 1;
+    hist -> depth = depth;
+
+    /* keep the sub-module part, the '|' is converted to '-' by INTD_API_createDataNode */
+    if(dataNode -> subModuleName[0])
+        sprintf(dataName, "%s|%s-HIST", dataNode -> subModuleName + 1, dataNode -> recName);
+    else
+        sprintf(dataName, "%s-HIST", dataNode -> recName);
+
+    hist -> valueNode = INTD_API_createDataNode(dataNode -> moduleName, dataName, "", dataNode -> unitStr,
+                            (void *)hist -> values, (void *)hist, depth, dataNode -> ioIntScan,
+                            INTD_DOUBLE, INTD_func_historyRead, NULL, dataNode -> mutexId, NULL,
+                            INTD_WFI, dataNode -> scanType);
+
+    strcat(dataName, "-TS");
+    hist -> timeNode  = INTD_API_createDataNode(dataNode -> moduleName, dataName, "", "s",
+                            (void *)hist -> times, (void *)hist, depth, dataNode -> ioIntScan,
+                            INTD_DOUBLE, INTD_func_historyRead, NULL, dataNode -> mutexId, NULL,
+                            INTD_WFI, dataNode -> scanType);
+
+    if(!hist -> valueNode || !hist -> timeNode) {
+        printf("INTD_API_addHistory: Failed to create the nodes of %s.%s\n", dataNode -> moduleName, dataNode -> dataName);
+
+        /* the nodes cannot be removed, a node created keeps its buffer but no longer refers to the history */
+        if(hist -> valueNode) {
+            hist -> valueNode -> readCallback = NULL;
+            hist -> valueNode -> privateData  = NULL;
+            hist -> values = NULL;
+        }
+        if(hist -> timeNode) {
+            hist -> timeNode -> readCallback = NULL;
+            hist -> timeNode -> privateData  = NULL;
+            hist -> times = NULL;
+        }
+
+        INTD_func_historyFree(hist);
+        return -1;
+    }
+
+    snprintf(descStr, sizeof(descStr), "History of %s", dataNode -> recName);
+    INTD_API_setDescription(hist -> valueNode, descStr);
+    INTD_API_setPrecision(hist -> valueNode, dataNode -> prec);
+
+    snprintf(descStr, sizeof(descStr), "History time of %s", dataNode -> recName);
+    INTD_API_setDescription(hist -> timeNode, descStr);
+    INTD_API_setPrecision(hist -> timeNode, 3);
+
+    if(dataNode -> scanType == INTD_EVENT) {
+        INTD_API_setScanEvent(hist -> valueNode, dataNode -> scanEvent);
+        INTD_API_setScanEvent(hist -> timeNode,  dataNode -> scanEvent);
+    }
+
+    dataNode -> history = hist;
+    return 0;
+}
+
+/**
+ * Append a sample to the history of the node. Wait-free, only one thread may append to a node
+ * Input:
+ *   dataNode       : Node with history
+ *   value          : Value of the sample
+ *   timeStamp      : Time of the sample, NULL for the current time
+ */
+int INTD_API_historyAppend(INTD_struc_node *dataNode, double value, const epicsTimeStamp *timeStamp)
+{
+    size_t head;
+    epicsTimeStamp now;
+    INTD_struc_history *hist;
+    INTD_struc_historySlot *slot;
+
+    if(!dataNode || !(hist = dataNode -> history)) return -1;
+
+    if(!timeStamp) {
+        epicsTimeGetCurrent(&now);
+        timeStamp = &now;
+    }
+
+    head  = hist -> head;
+    slot  = &hist -> ring[head & hist -> mask];
+
+    slot -> value = value;
+    slot -> time  = (double)timeStamp -> secPastEpoch + POSIX_TIME_AT_EPICS_EPOCH + timeStamp -> nsec * 1e-9;
+
+    /* publish the slot */
+    epicsAtomicWriteMemoryBarrier();
+    epicsAtomicSetSizeT(&hist -> head, head + 1);
+
+    return 0;
+}
+
+/**
+ * Print the nodes with history
+ */
+void INTD_API_historyReport(const char *moduleName)
+{
+    INTD_struc_node *dataNode;
+    INTD_struc_history *hist;
+
+    printf("INTD history:\n");
+
+    for(dataNode = INTD_API_firstNode(); dataNode; dataNode = INTD_API_nextNode(dataNode)) {
+        if(!(hist = dataNode -> history)) continue;
+        if(moduleName && moduleName[0] && strcmp(moduleName, "MOD_ALL") != 0 && strcmp(moduleName, dataNode -> moduleName) != 0) continue;
+
+        printf("    %s.%s: depth %u (%lu slots), appended %lu, unrolls %lu, retries %lu, lost %lu\n",
+                dataNode -> moduleName, dataNode -> dataName, hist -> depth, (unsigned long)(hist -> mask + 1),
+                (unsigned long)epicsAtomicGetSizeT(&hist -> head), hist -> unrollCnt, hist -> retryCnt, hist -> lostCnt);
+    }
+}
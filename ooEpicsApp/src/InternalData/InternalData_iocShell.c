@@ -60,19 +60,286 @@ static const iocshArg *const INTD_generateRecList_Args[3] = {&INTD_generateRecLi
 static const iocshFuncDef    INTD_generateRecList_FuncDef = {"INTD_generateRecList", 3, INTD_generateRecList_Args};
 static void  INTD_generateRecList_CallFunc(const iocshArgBuf *args) {INTD_API_genDbList(args[0].sval, args[1].sval, args[2].sval);}
 
+/* INTD_API_genFiles */
+static const iocshArg        INTD_generateFiles_Arg0     = {"moduleName",   iocshArgString};
+static const iocshArg        INTD_generateFiles_Arg1     = {"path",         iocshArgString};
+static const iocshArg        INTD_generateFiles_Arg2     = {"dbFileName",   iocshArgString};
+static const iocshArg        INTD_generateFiles_Arg3     = {"reqFileName",  iocshArgString};
+static const iocshArg        INTD_generateFiles_Arg4     = {"confFileName", iocshArgString};
+static const iocshArg        INTD_generateFiles_Arg5     = {"lstFileName",  iocshArgString};
+static const iocshArg        INTD_generateFiles_Arg6     = {"methodStr",    iocshArgString};
+static const iocshArg        INTD_generateFiles_Arg7     = {"withMacro",    iocshArgInt};
+static const iocshArg        INTD_generateFiles_Arg8     = {"reqSel",       iocshArgInt};
+static const iocshArg        INTD_generateFiles_Arg9     = {"archSel",      iocshArgInt};
+static const iocshArg        INTD_generateFiles_Arg10    = {"destModName",  iocshArgString};
+static const iocshArg *const INTD_generateFiles_Args[11] = {&INTD_generateFiles_Arg0, &INTD_generateFiles_Arg1, &INTD_generateFiles_Arg2, &INTD_generateFiles_Arg3, &INTD_generateFiles_Arg4, &INTD_generateFiles_Arg5,
+                                                            &INTD_generateFiles_Arg6, &INTD_generateFiles_Arg7, &INTD_generateFiles_Arg8, &INTD_generateFiles_Arg9, &INTD_generateFiles_Arg10};
+static const iocshFuncDef    INTD_generateFiles_FuncDef  = {"INTD_generateFiles", 11, INTD_generateFiles_Args};
+static void  INTD_generateFiles_CallFunc(const iocshArgBuf *args) {INTD_API_genFiles(args[0].sval, args[1].sval, args[2].sval, args[3].sval, args[4].sval, args[5].sval, args[6].sval, args[7].ival, args[8].ival, args[9].ival, args[10].sval);}
+
+/* INTD_API_genTiming */
+static const iocshArg        INTD_generateTiming_Arg0    = {"moduleName",  iocshArgString};
+static const iocshArg        INTD_generateTiming_Arg1    = {"path",        iocshArgString};
+static const iocshArg        INTD_generateTiming_Arg2    = {"loops",       iocshArgInt};
+static const iocshArg *const INTD_generateTiming_Args[3] = {&INTD_generateTiming_Arg0, &INTD_generateTiming_Arg1, &INTD_generateTiming_Arg2};
+static const iocshFuncDef    INTD_generateTiming_FuncDef = {"INTD_generateTiming", 3, INTD_generateTiming_Args};
+static void  INTD_generateTiming_CallFunc(const iocshArgBuf *args) {INTD_API_genTiming(args[0].sval, args[1].sval, args[2].ival);}
+
+/* INTD_API_setArrayRecords */
+static const iocshArg        INTD_useArrayRecords_Arg0    = {"enable", iocshArgInt};
+static const iocshArg *const INTD_useArrayRecords_Args[1] = {&INTD_useArrayRecords_Arg0};
+static const iocshFuncDef    INTD_useArrayRecords_FuncDef = {"INTD_useArrayRecords", 1, INTD_useArrayRecords_Args};
+static void  INTD_useArrayRecords_CallFunc(const iocshArgBuf *args) {INTD_API_setArrayRecords(args[0].ival);}
+
 /* INTD_API_syncWithRecords */
 static const iocshArg        INTD_syncWithRecords_Arg0    = {"enaCallback", iocshArgInt};
 static const iocshArg *const INTD_syncWithRecords_Args[1] = {&INTD_syncWithRecords_Arg0};
 static const iocshFuncDef    INTD_syncWithRecords_FuncDef = {"INTD_syncWithRecords", 1, INTD_syncWithRecords_Args};
 static void  INTD_syncWithRecords_CallFunc(const iocshArgBuf *args) {INTD_API_syncWithRecords(args[0].ival);}
 
+/* INTD_API_setSyncBatchSize */
+static const iocshArg        INTD_setSyncBatchSize_Arg0    = {"batchSize", iocshArgInt};
+static const iocshArg *const INTD_setSyncBatchSize_Args[1] = {&INTD_setSyncBatchSize_Arg0};
+static const iocshFuncDef    INTD_setSyncBatchSize_FuncDef = {"INTD_setSyncBatchSize", 1, INTD_setSyncBatchSize_Args};
+static void  INTD_setSyncBatchSize_CallFunc(const iocshArgBuf *args) {INTD_API_setSyncBatchSize(args[0].ival > 0 ? (unsigned int)args[0].ival : 0);}
+
+/* INTD_API_hashReport */
+static const iocshArg        INTD_hashReport_Arg0    = {"level", iocshArgInt};
+static const iocshArg *const INTD_hashReport_Args[1] = {&INTD_hashReport_Arg0};
+static const iocshFuncDef    INTD_hashReport_FuncDef = {"INTD_hashReport", 1, INTD_hashReport_Args};
+static void  INTD_hashReport_CallFunc(const iocshArgBuf *args) {INTD_API_hashReport(args[0].ival);}
+
+/* INTD_API_memReport */
+static const iocshFuncDef    INTD_memReport_FuncDef = {"INTD_memReport", 0, NULL};
+static void  INTD_memReport_CallFunc(const iocshArgBuf *args) {INTD_API_memReport();}
+
+/* INTD_API_enableStats */
+static const iocshArg        INTD_enableStats_Arg0    = {"enable", iocshArgInt};
+static const iocshArg *const INTD_enableStats_Args[1] = {&INTD_enableStats_Arg0};
+static const iocshFuncDef    INTD_enableStats_FuncDef = {"INTD_enableStats", 1, INTD_enableStats_Args};
+static void  INTD_enableStats_CallFunc(const iocshArgBuf *args) {INTD_API_enableStats(args[0].ival);}
+
+/* INTD_API_resetStats */
+static const iocshFuncDef    INTD_resetStats_FuncDef = {"INTD_resetStats", 0, NULL};
+static void  INTD_resetStats_CallFunc(const iocshArgBuf *args) {INTD_API_resetStats();}
+
+/* INTD_API_statsReport */
+static const iocshArg        INTD_report_Arg0    = {"moduleName", iocshArgString};
+static const iocshArg        INTD_report_Arg1    = {"topN",       iocshArgInt};
+static const iocshArg *const INTD_report_Args[2] = {&INTD_report_Arg0, &INTD_report_Arg1};
+static const iocshFuncDef    INTD_report_FuncDef = {"INTD_report", 2, INTD_report_Args};
+static void  INTD_report_CallFunc(const iocshArgBuf *args) {INTD_API_statsReport(args[0].sval, args[1].ival);}
+
+/* INTD_API_setDataDeadband */
+static const iocshArg        INTD_setDeadband_Arg0    = {"moduleName",  iocshArgString};
+static const iocshArg        INTD_setDeadband_Arg1    = {"dataName",    iocshArgString};
+static const iocshArg        INTD_setDeadband_Arg2    = {"absDeadband", iocshArgDouble};
+static const iocshArg        INTD_setDeadband_Arg3    = {"relDeadband", iocshArgDouble};
+static const iocshArg *const INTD_setDeadband_Args[4] = {&INTD_setDeadband_Arg0, &INTD_setDeadband_Arg1, &INTD_setDeadband_Arg2, &INTD_setDeadband_Arg3};
+static const iocshFuncDef    INTD_setDeadband_FuncDef = {"INTD_setDeadband", 4, INTD_setDeadband_Args};
+static void  INTD_setDeadband_CallFunc(const iocshArgBuf *args) {INTD_API_setDataDeadband(args[0].sval, args[1].sval, args[2].dval, args[3].dval);}
+
+/* INTD_API_changeReport */
+static const iocshArg        INTD_changeReport_Arg0    = {"moduleName", iocshArgString};
+static const iocshArg *const INTD_changeReport_Args[1] = {&INTD_changeReport_Arg0};
+static const iocshFuncDef    INTD_changeReport_FuncDef = {"INTD_changeReport", 1, INTD_changeReport_Args};
+static void  INTD_changeReport_CallFunc(const iocshArgBuf *args) {INTD_API_changeReport(args[0].sval);}
+
+/* INTD_API_setDataPublishRate */
+static const iocshArg        INTD_setPublishRate_Arg0    = {"moduleName",  iocshArgString};
+static const iocshArg        INTD_setPublishRate_Arg1    = {"dataName",    iocshArgString};
+static const iocshArg        INTD_setPublishRate_Arg2    = {"maxRate",     iocshArgDouble};
+static const iocshArg *const INTD_setPublishRate_Args[3] = {&INTD_setPublishRate_Arg0, &INTD_setPublishRate_Arg1, &INTD_setPublishRate_Arg2};
+static const iocshFuncDef    INTD_setPublishRate_FuncDef = {"INTD_setPublishRate", 3, INTD_setPublishRate_Args};
+static void  INTD_setPublishRate_CallFunc(const iocshArgBuf *args) {INTD_API_setDataPublishRate(args[0].sval, args[1].sval, args[2].dval);}
+
+/* INTD_API_setPublishDefaultRate */
+static const iocshArg        INTD_setPublishDefaultRate_Arg0    = {"maxRate", iocshArgDouble};
+static const iocshArg *const INTD_setPublishDefaultRate_Args[1] = {&INTD_setPublishDefaultRate_Arg0};
+static const iocshFuncDef    INTD_setPublishDefaultRate_FuncDef = {"INTD_setPublishDefaultRate", 1, INTD_setPublishDefaultRate_Args};
+static void  INTD_setPublishDefaultRate_CallFunc(const iocshArgBuf *args) {INTD_API_setPublishDefaultRate(args[0].dval);}
+
+/* INTD_API_publishReport */
+static const iocshArg        INTD_publishReport_Arg0    = {"level", iocshArgInt};
+static const iocshArg *const INTD_publishReport_Args[1] = {&INTD_publishReport_Arg0};
+static const iocshFuncDef    INTD_publishReport_FuncDef = {"INTD_publishReport", 1, INTD_publishReport_Args};
+static void  INTD_publishReport_CallFunc(const iocshArgBuf *args) {INTD_API_publishReport(args[0].ival);}
+
+/* INTD_API_setAsyncPool */
+static const iocshArg        INTD_setAsyncPool_Arg0    = {"threadNum", iocshArgInt};
+static const iocshArg        INTD_setAsyncPool_Arg1    = {"queueSize", iocshArgInt};
+static const iocshArg *const INTD_setAsyncPool_Args[2] = {&INTD_setAsyncPool_Arg0, &INTD_setAsyncPool_Arg1};
+static const iocshFuncDef    INTD_setAsyncPool_FuncDef = {"INTD_setAsyncPool", 2, INTD_setAsyncPool_Args};
+static void  INTD_setAsyncPool_CallFunc(const iocshArgBuf *args) {INTD_API_setAsyncPool(args[0].ival > 0 ? args[0].ival : 0, args[1].ival > 0 ? args[1].ival : 0);}
+
+/* INTD_API_setDataAsyncWrite */
+static const iocshArg        INTD_setAsyncWrite_Arg0    = {"moduleName",  iocshArgString};
+static const iocshArg        INTD_setAsyncWrite_Arg1    = {"dataName",    iocshArgString};
+static const iocshArg        INTD_setAsyncWrite_Arg2    = {"enable",      iocshArgInt};
+static const iocshArg *const INTD_setAsyncWrite_Args[3] = {&INTD_setAsyncWrite_Arg0, &INTD_setAsyncWrite_Arg1, &INTD_setAsyncWrite_Arg2};
+static const iocshFuncDef    INTD_setAsyncWrite_FuncDef = {"INTD_setAsyncWrite", 3, INTD_setAsyncWrite_Args};
+static void  INTD_setAsyncWrite_CallFunc(const iocshArgBuf *args) {INTD_API_setDataAsyncWrite(args[0].sval, args[1].sval, args[2].ival);}
+
+/* INTD_API_setDataPrefetch */
+static const iocshArg        INTD_setPrefetch_Arg0    = {"moduleName",  iocshArgString};
+static const iocshArg        INTD_setPrefetch_Arg1    = {"dataName",    iocshArgString};
+static const iocshArg        INTD_setPrefetch_Arg2    = {"enable",      iocshArgInt};
+static const iocshArg        INTD_setPrefetch_Arg3    = {"budget",      iocshArgDouble};
+static const iocshArg *const INTD_setPrefetch_Args[4] = {&INTD_setPrefetch_Arg0, &INTD_setPrefetch_Arg1, &INTD_setPrefetch_Arg2, &INTD_setPrefetch_Arg3};
+static const iocshFuncDef    INTD_setPrefetch_FuncDef = {"INTD_setPrefetch", 4, INTD_setPrefetch_Args};
+static void  INTD_setPrefetch_CallFunc(const iocshArgBuf *args) {INTD_API_setDataPrefetch(args[0].sval, args[1].sval, args[2].ival, args[3].dval);}
+
+/* INTD_API_postEvent */
+static const iocshArg        INTD_postEvent_Arg0    = {"eventName", iocshArgString};
+static const iocshArg *const INTD_postEvent_Args[1] = {&INTD_postEvent_Arg0};
+static const iocshFuncDef    INTD_postEvent_FuncDef = {"INTD_postEvent", 1, INTD_postEvent_Args};
+static void  INTD_postEvent_CallFunc(const iocshArgBuf *args) {INTD_API_postEvent(args[0].sval);}
+
+/* INTD_API_scanReport */
+static const iocshFuncDef    INTD_scanReport_FuncDef = {"INTD_scanReport", 0, NULL};
+static void  INTD_scanReport_CallFunc(const iocshArgBuf *args) {INTD_API_scanReport();}
+
+/* INTD_API_setDataWfStats */
+static const iocshArg        INTD_addWfStats_Arg0    = {"moduleName",  iocshArgString};
+static const iocshArg        INTD_addWfStats_Arg1    = {"dataName",    iocshArgString};
+static const iocshArg        INTD_addWfStats_Arg2    = {"statMask",    iocshArgInt};
+static const iocshArg *const INTD_addWfStats_Args[3] = {&INTD_addWfStats_Arg0, &INTD_addWfStats_Arg1, &INTD_addWfStats_Arg2};
+static const iocshFuncDef    INTD_addWfStats_FuncDef = {"INTD_addWfStats", 3, INTD_addWfStats_Args};
+static void  INTD_addWfStats_CallFunc(const iocshArgBuf *args) {INTD_API_setDataWfStats(args[0].sval, args[1].sval, (unsigned int)args[2].ival);}
+
+/* INTD_API_wfStatsReport */
+static const iocshArg        INTD_wfStatsReport_Arg0    = {"moduleName", iocshArgString};
+static const iocshArg *const INTD_wfStatsReport_Args[1] = {&INTD_wfStatsReport_Arg0};
+static const iocshFuncDef    INTD_wfStatsReport_FuncDef = {"INTD_wfStatsReport", 1, INTD_wfStatsReport_Args};
+static void  INTD_wfStatsReport_CallFunc(const iocshArgBuf *args) {INTD_API_wfStatsReport(args[0].sval);}
+
+/* INTD_API_setDataWfView */
+static const iocshArg        INTD_addWfView_Arg0    = {"moduleName",  iocshArgString};
+static const iocshArg        INTD_addWfView_Arg1    = {"dataName",    iocshArgString};
+static const iocshArg        INTD_addWfView_Arg2    = {"suffix",      iocshArgString};
+static const iocshArg        INTD_addWfView_Arg3    = {"viewType",    iocshArgInt};
+static const iocshArg        INTD_addWfView_Arg4    = {"points",      iocshArgInt};
+static const iocshArg *const INTD_addWfView_Args[5] = {&INTD_addWfView_Arg0, &INTD_addWfView_Arg1, &INTD_addWfView_Arg2,
+                                                       &INTD_addWfView_Arg3, &INTD_addWfView_Arg4};
+static const iocshFuncDef    INTD_addWfView_FuncDef = {"INTD_addWfView", 5, INTD_addWfView_Args};
+static void  INTD_addWfView_CallFunc(const iocshArgBuf *args) {INTD_API_setDataWfView(args[0].sval, args[1].sval, args[2].sval,
+                                                                   (INTD_enum_wfViewType)args[3].ival, (unsigned int)args[4].ival);}
+
+/* INTD_API_wfViewReport */
+static const iocshArg        INTD_wfViewReport_Arg0    = {"moduleName", iocshArgString};
+static const iocshArg *const INTD_wfViewReport_Args[1] = {&INTD_wfViewReport_Arg0};
+static const iocshFuncDef    INTD_wfViewReport_FuncDef = {"INTD_wfViewReport", 1, INTD_wfViewReport_Args};
+static void  INTD_wfViewReport_CallFunc(const iocshArgBuf *args) {INTD_API_wfViewReport(args[0].sval);}
+
+/* INTD_API_setDataHistory */
+static const iocshArg        INTD_addHistory_Arg0    = {"moduleName",  iocshArgString};
+static const iocshArg        INTD_addHistory_Arg1    = {"dataName",    iocshArgString};
+static const iocshArg        INTD_addHistory_Arg2    = {"depth",       iocshArgInt};
+static const iocshArg *const INTD_addHistory_Args[3] = {&INTD_addHistory_Arg0, &INTD_addHistory_Arg1, &INTD_addHistory_Arg2};
+static const iocshFuncDef    INTD_addHistory_FuncDef = {"INTD_addHistory", 3, INTD_addHistory_Args};
+static void  INTD_addHistory_CallFunc(const iocshArgBuf *args) {INTD_API_setDataHistory(args[0].sval, args[1].sval, (unsigned int)args[2].ival);}
+
+/* INTD_API_historyReport */
+static const iocshArg        INTD_historyReport_Arg0    = {"moduleName", iocshArgString};
+static const iocshArg *const INTD_historyReport_Args[1] = {&INTD_historyReport_Arg0};
+static const iocshFuncDef    INTD_historyReport_FuncDef = {"INTD_historyReport", 1, INTD_historyReport_Args};
+static void  INTD_historyReport_CallFunc(const iocshArgBuf *args) {INTD_API_historyReport(args[0].sval);}
+
+/* INTD_API_setDataDirtyRange */
+static const iocshArg        INTD_setDirtyRange_Arg0    = {"moduleName",  iocshArgString};
+static const iocshArg        INTD_setDirtyRange_Arg1    = {"dataName",    iocshArgString};
+static const iocshArg *const INTD_setDirtyRange_Args[2] = {&INTD_setDirtyRange_Arg0, &INTD_setDirtyRange_Arg1};
+static const iocshFuncDef    INTD_setDirtyRange_FuncDef = {"INTD_setDirtyRange", 2, INTD_setDirtyRange_Args};
+static void  INTD_setDirtyRange_CallFunc(const iocshArgBuf *args) {INTD_API_setDataDirtyRange(args[0].sval, args[1].sval);}
+
+/* INTD_API_dirtyReport */
+static const iocshArg        INTD_dirtyReport_Arg0    = {"moduleName", iocshArgString};
+static const iocshArg *const INTD_dirtyReport_Args[1] = {&INTD_dirtyReport_Arg0};
+static const iocshFuncDef    INTD_dirtyReport_FuncDef = {"INTD_dirtyReport", 1, INTD_dirtyReport_Args};
+static void  INTD_dirtyReport_CallFunc(const iocshArgBuf *args) {INTD_API_dirtyReport(args[0].sval);}
+
+/* INTD_API_shmCreate */
+static const iocshArg        INTD_shmCreate_Arg0    = {"segName", iocshArgString};
+static const iocshArg        INTD_shmCreate_Arg1    = {"sizeKB",  iocshArgInt};
+static const iocshArg        INTD_shmCreate_Arg2    = {"period",  iocshArgDouble};
+static const iocshArg *const INTD_shmCreate_Args[3] = {&INTD_shmCreate_Arg0, &INTD_shmCreate_Arg1, &INTD_shmCreate_Arg2};
+static const iocshFuncDef    INTD_shmCreate_FuncDef = {"INTD_shmCreate", 3, INTD_shmCreate_Args};
+static void  INTD_shmCreate_CallFunc(const iocshArgBuf *args) {INTD_API_shmCreate(args[0].sval, (unsigned int)args[1].ival, args[2].dval);}
+
+/* INTD_API_setDataShm */
+static const iocshArg        INTD_setShm_Arg0    = {"moduleName", iocshArgString};
+static const iocshArg        INTD_setShm_Arg1    = {"dataName",   iocshArgString};
+static const iocshArg        INTD_setShm_Arg2    = {"segName",    iocshArgString};
+static const iocshArg *const INTD_setShm_Args[3] = {&INTD_setShm_Arg0, &INTD_setShm_Arg1, &INTD_setShm_Arg2};
+static const iocshFuncDef    INTD_setShm_FuncDef = {"INTD_setShm", 3, INTD_setShm_Args};
+static void  INTD_setShm_CallFunc(const iocshArgBuf *args) {INTD_API_setDataShm(args[0].sval, args[1].sval, args[2].sval);}
+
+/* INTD_API_shmReport */
+static const iocshArg        INTD_shmReport_Arg0    = {"level", iocshArgInt};
+static const iocshArg *const INTD_shmReport_Args[1] = {&INTD_shmReport_Arg0};
+static const iocshFuncDef    INTD_shmReport_FuncDef = {"INTD_shmReport", 1, INTD_shmReport_Args};
+static void  INTD_shmReport_CallFunc(const iocshArgBuf *args) {INTD_API_shmReport(args[0].ival);}
+
+/* INTD_API_vecBenchmark */
+static const iocshArg        INTD_vecBenchmark_Arg0    = {"pointNum", iocshArgInt};
+static const iocshArg        INTD_vecBenchmark_Arg1    = {"loops", iocshArgInt};
+static const iocshArg *const INTD_vecBenchmark_Args[2] = {&INTD_vecBenchmark_Arg0, &INTD_vecBenchmark_Arg1};
+static const iocshFuncDef    INTD_vecBenchmark_FuncDef = {"INTD_vecBenchmark", 2, INTD_vecBenchmark_Args};
+static void  INTD_vecBenchmark_CallFunc(const iocshArgBuf *args) {INTD_API_vecBenchmark((unsigned int)args[0].ival, (unsigned int)args[1].ival);}
+
+/* INTD_API_lockBenchmark */
+static const iocshArg        INTD_lockBenchmark_Arg0    = {"readerNum", iocshArgInt};
+static const iocshArg        INTD_lockBenchmark_Arg1    = {"seconds", iocshArgDouble};
+static const iocshArg *const INTD_lockBenchmark_Args[2] = {&INTD_lockBenchmark_Arg0, &INTD_lockBenchmark_Arg1};
+static const iocshFuncDef    INTD_lockBenchmark_FuncDef = {"INTD_lockBenchmark", 2, INTD_lockBenchmark_Args};
+static void  INTD_lockBenchmark_CallFunc(const iocshArgBuf *args) {INTD_API_lockBenchmark((unsigned int)args[0].ival, args[1].dval);}
+
+/* INTD_API_asyncReport */
+static const iocshArg        INTD_asyncReport_Arg0    = {"level", iocshArgInt};
+static const iocshArg *const INTD_asyncReport_Args[1] = {&INTD_asyncReport_Arg0};
+static const iocshFuncDef    INTD_asyncReport_FuncDef = {"INTD_asyncReport", 1, INTD_asyncReport_Args};
+static void  INTD_asyncReport_CallFunc(const iocshArgBuf *args) {INTD_API_asyncReport(args[0].ival);}
+
 void INTD_IOCShellRegister(void)
 {
     iocshRegister(&INTD_generateRecords_FuncDef,        INTD_generateRecords_CallFunc);
     iocshRegister(&INTD_generateReqFile_FuncDef,        INTD_generateReqFile_CallFunc);
     iocshRegister(&INTD_generateArchCfgFile_FuncDef,    INTD_generateArchCfgFile_CallFunc);
     iocshRegister(&INTD_generateRecList_FuncDef,        INTD_generateRecList_CallFunc);
+    iocshRegister(&INTD_generateFiles_FuncDef,          INTD_generateFiles_CallFunc);
+    iocshRegister(&INTD_generateTiming_FuncDef,         INTD_generateTiming_CallFunc);
+    iocshRegister(&INTD_useArrayRecords_FuncDef,        INTD_useArrayRecords_CallFunc);
     iocshRegister(&INTD_syncWithRecords_FuncDef,        INTD_syncWithRecords_CallFunc);
+    iocshRegister(&INTD_setSyncBatchSize_FuncDef,       INTD_setSyncBatchSize_CallFunc);
+    iocshRegister(&INTD_hashReport_FuncDef,             INTD_hashReport_CallFunc);
+    iocshRegister(&INTD_memReport_FuncDef,              INTD_memReport_CallFunc);
+    iocshRegister(&INTD_enableStats_FuncDef,            INTD_enableStats_CallFunc);
+    iocshRegister(&INTD_resetStats_FuncDef,             INTD_resetStats_CallFunc);
+    iocshRegister(&INTD_report_FuncDef,                 INTD_report_CallFunc);
+    iocshRegister(&INTD_setDeadband_FuncDef,            INTD_setDeadband_CallFunc);
+    iocshRegister(&INTD_changeReport_FuncDef,           INTD_changeReport_CallFunc);
+    iocshRegister(&INTD_setPublishRate_FuncDef,         INTD_setPublishRate_CallFunc);
+    iocshRegister(&INTD_setPublishDefaultRate_FuncDef,  INTD_setPublishDefaultRate_CallFunc);
+    iocshRegister(&INTD_publishReport_FuncDef,          INTD_publishReport_CallFunc);
+    iocshRegister(&INTD_setAsyncPool_FuncDef,           INTD_setAsyncPool_CallFunc);
+    iocshRegister(&INTD_setAsyncWrite_FuncDef,          INTD_setAsyncWrite_CallFunc);
+    iocshRegister(&INTD_setPrefetch_FuncDef,            INTD_setPrefetch_CallFunc);
+    iocshRegister(&INTD_asyncReport_FuncDef,            INTD_asyncReport_CallFunc);
+    iocshRegister(&INTD_postEvent_FuncDef,              INTD_postEvent_CallFunc);
+    iocshRegister(&INTD_scanReport_FuncDef,             INTD_scanReport_CallFunc);
+    iocshRegister(&INTD_addWfStats_FuncDef,             INTD_addWfStats_CallFunc);
+    iocshRegister(&INTD_wfStatsReport_FuncDef,          INTD_wfStatsReport_CallFunc);
+    iocshRegister(&INTD_addWfView_FuncDef,              INTD_addWfView_CallFunc);
+    iocshRegister(&INTD_wfViewReport_FuncDef,           INTD_wfViewReport_CallFunc);
+    iocshRegister(&INTD_addHistory_FuncDef,             INTD_addHistory_CallFunc);
+    iocshRegister(&INTD_historyReport_FuncDef,          INTD_historyReport_CallFunc);
+    iocshRegister(&INTD_setDirtyRange_FuncDef,          INTD_setDirtyRange_CallFunc);
+    iocshRegister(&INTD_dirtyReport_FuncDef,            INTD_dirtyReport_CallFunc);
+    iocshRegister(&INTD_shmCreate_FuncDef,              INTD_shmCreate_CallFunc);
+    iocshRegister(&INTD_setShm_FuncDef,                 INTD_setShm_CallFunc);
+    iocshRegister(&INTD_shmReport_FuncDef,              INTD_shmReport_CallFunc);
+    iocshRegister(&INTD_vecBenchmark_FuncDef,           INTD_vecBenchmark_CallFunc);
+    iocshRegister(&INTD_lockBenchmark_FuncDef,          INTD_lockBenchmark_CallFunc);
 }
 
 epicsExportRegistrar(INTD_IOCShellRegister);
@@ -0,0 +1,291 @@
+/***************************************************************************
+ *  Copyright (c) 2023 by Paul Scherrer Institute, Switzerland
+ *  All rights reserved.
+ *  Authors: Zheqiao Geng
+ ***************************************************************************/
+/***************************************************************************
+ * InternalData_publisher.c
+ *
+ * Rate limited publisher of the I/O Intr scans. The requests to the same
+ * IOSCANPVT that arrive within the minimum interval are merged into one
+ * scan, which is executed by a timer at the end of the interval. This
+ * allows the producers to publish at full rate without flooding the
+ * callback queues.
+ ***************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <epicsVersion.h>
+#include <epicsMutex.h>
+#include <epicsTime.h>
+#include <epicsTimer.h>
+#include <epicsThread.h>
+#include <dbScan.h>
+
+#include "InternalData.h"
+
+/*======================================
+ * Global variables
+ *======================================*/
+#define INTD_PUB_BUCKETS    64                                      /* buckets of the publisher table, must be power of 2 */
+
+typedef struct INTD_struc_pubEntry {
+    struct INTD_struc_pubEntry *next;                               /* next entry in the same bucket */
+    IOSCANPVT           ioIntScan;                                  /* the I/O Intr scan list */
+    double              minInterval;                                /* minimum time between two scans (s), 0 for no limit */
+    epicsTimeStamp      lastScan;                                   /* time of the last scan */
+    int                 pending;                                    /* a scan has been scheduled on the timer */
+    epicsTimerId        timer;                                      /* timer to execute the pending scan */
+    unsigned long       requestCnt;                                 /* number of publish requests */
+    unsigned long       scanCnt;                                    /* number of scans requested to EPICS */
+    unsigned long       mergedCnt;                                  /* number of requests merged into a pending scan */
+    unsigned long       droppedCnt;                                 /* number of scans that EPICS did not queue (queue full) */
+} INTD_struc_pubEntry;
+
+static INTD_struc_pubEntry *INTD_gvar_pubEntries[INTD_PUB_BUCKETS];
+static epicsMutexId         INTD_gvar_pubMutex       = NULL;
+static epicsTimerQueueId    INTD_gvar_pubTimerQueue  = NULL;
+static double               INTD_gvar_pubDefaultRate = 0.0;         /* max rate (Hz) for new entries, 0 for no limit */
+static epicsThreadOnceId    INTD_gvar_pubOnce        = EPICS_THREAD_ONCE_INIT;
+
+/*======================================
+ * Private Routines
+ *======================================*/
+/**
+ * Bucket of the IOSCANPVT
+ */
+static unsigned int INTD_func_pubBucket(IOSCANPVT ioIntScan)
+{
+    size_t key = (size_t)ioIntScan;
+    return (unsigned int)((key >> 4) ^ (key >> 12)) & (INTD_PUB_BUCKETS - 1);
+}
+
+/**
+ * Note the scan of the entry, called with the mutex locked. The scan is requested by INTD_func_pubScan
+ *   after the mutex is released
+ */
+static void INTD_func_pubFire(INTD_struc_pubEntry *entry)
+{
+    epicsTimeGetCurrent(&entry -> lastScan);
+    entry -> scanCnt ++;
+}
+
+/**
+ * Request the scan from EPICS, called without the mutex (scanIoRequest takes the locks of the scan lists)
+ */
+static void INTD_func_pubScan(INTD_struc_pubEntry *entry)
+{
+#if EPICS_VERSION > 3 || (EPICS_VERSION == 3 && EPICS_REVISION >= 15)
+    if(!scanIoRequest(entry -> ioIntScan)) {
+        epicsMutexMustLock(INTD_gvar_pubMutex);
+        entry -> droppedCnt ++;
+        epicsMutexUnlock(INTD_gvar_pubMutex);
+    }
+#else
+    scanIoRequest(entry -> ioIntScan);
+#endif
+}
+
+/**
+ * Timer callback, execute the pending scan
+ */
+static void INTD_func_pubTimerCallback(void *arg)
+{
+    INTD_struc_pubEntry *entry = (INTD_struc_pubEntry *)arg;
+
+    epicsMutexMustLock(INTD_gvar_pubMutex);
+    entry -> pending = 0;
+    INTD_func_pubFire(entry);
+    epicsMutexUnlock(INTD_gvar_pubMutex);
+
+    INTD_func_pubScan(entry);
+}
+
+/**
+ * Create the mutex and the timer queue, once
+ */
+static void INTD_func_pubOnce(void *arg)
+{
+    INTD_gvar_pubMutex      = epicsMutexMustCreate();
+    INTD_gvar_pubTimerQueue = epicsTimerQueueAllocate(1, epicsThreadPriorityScanHigh);
+
+    if(!INTD_gvar_pubTimerQueue)
+        printf("INTD_func_pubOnce: Failed to create the timer queue\n");
+}
+
+/**
+ * Initialize the publisher, safe to be called for several times and from several threads
+ */
+static int INTD_func_pubInit()
+{
+    epicsThreadOnce(&INTD_gvar_pubOnce, INTD_func_pubOnce, NULL);
+
+    return INTD_gvar_pubTimerQueue ? 0 : -1;
+}
+
+/**
+ * Find the entry of the IOSCANPVT, create a new one if not found. Called with the mutex locked
+ */
+static INTD_struc_pubEntry *INTD_func_pubFindEntry(IOSCANPVT ioIntScan)
+{
+    unsigned int bucket = INTD_func_pubBucket(ioIntScan);
+    INTD_struc_pubEntry *entry;
+
+    for(entry = INTD_gvar_pubEntries[bucket]; entry; entry = entry -> next)
+        if(entry -> ioIntScan == ioIntScan) return entry;
+
+    entry = (INTD_struc_pubEntry *)calloc(1, sizeof(INTD_struc_pubEntry));
+    if(!entry) {
+        printf("INTD_func_pubFindEntry: Failed to allocate memory for the publisher\n");
+        return NULL;
+    }
+
+    entry -> ioIntScan   = ioIntScan;
+    entry -> minInterval = INTD_gvar_pubDefaultRate > 0 ? 1.0 / INTD_gvar_pubDefaultRate : 0.0;
+    entry -> timer       = epicsTimerQueueCreateTimer(INTD_gvar_pubTimerQueue, INTD_func_pubTimerCallback, (void *)entry);
+    entry -> next        = INTD_gvar_pubEntries[bucket];
+
+    INTD_gvar_pubEntries[bucket] = entry;
+    return entry;
+}
+
+/*======================================
+ * Public Routines
+ *======================================*/
+/**
+ * Set the maximum scan rate of the IOSCANPVT (Hz). 0 or negative value means no limit
+ */
+int INTD_API_setPublishRate(IOSCANPVT *ioIntScan, double maxRate)
+{
+    INTD_struc_pubEntry *entry;
+
+    if(!ioIntScan || !*ioIntScan) return -1;
+    if(INTD_func_pubInit() != 0)  return -1;
+
+    epicsMutexMustLock(INTD_gvar_pubMutex);
+    entry = INTD_func_pubFindEntry(*ioIntScan);
+    if(entry) entry -> minInterval = maxRate > 0 ? 1.0 / maxRate : 0.0;
+    epicsMutexUnlock(INTD_gvar_pubMutex);
+
+    return entry ? 0 : -1;
+}
+
+/**
+ * Set the maximum scan rate (Hz) for the IOSCANPVTs that are published the first time later
+ */
+void INTD_API_setPublishDefaultRate(double maxRate)
+{
+    INTD_gvar_pubDefaultRate = maxRate > 0 ? maxRate : 0.0;
+}
+
+/**
+ * Request an I/O Intr scan. If the last scan is within the minimum interval, the scan
+ * is postponed to the end of the interval, and the further requests are merged to it
+ */
+int INTD_API_publish(IOSCANPVT *ioIntScan)
+{
+    int fire = 0;
+    double elapsed;
+    epicsTimeStamp now;
+    INTD_struc_pubEntry *entry;
+
+    if(!ioIntScan || !*ioIntScan) return -1;
+    if(INTD_func_pubInit() != 0)  return -1;
+
+    epicsMutexMustLock(INTD_gvar_pubMutex);
+
+    entry = INTD_func_pubFindEntry(*ioIntScan);
+    if(!entry) {
+        epicsMutexUnlock(INTD_gvar_pubMutex);
+        return -1;
+    }
+
+    entry -> requestCnt ++;
+
+    if(entry -> pending) {
+        entry -> mergedCnt ++;
+    } else if(entry -> minInterval <= 0 || !entry -> timer) {
+        fire = 1;
+    } else {
+        epicsTimeGetCurrent(&now);
+        elapsed = epicsTimeDiffInSeconds(&now, &entry -> lastScan);
+
+        if(elapsed >= entry -> minInterval || elapsed < 0) {
+            fire = 1;
+        } else {
+            entry -> pending = 1;
+            epicsTimerStartDelay(entry -> timer, entry -> minInterval - elapsed);
+        }
+    }
+
+    if(fire) INTD_func_pubFire(entry);
+
+    epicsMutexUnlock(INTD_gvar_pubMutex);
+
+    if(fire) INTD_func_pubScan(entry);
+    return 0;
+}
+
+/**
+ * Print the statistics of the publisher
+ */
+void INTD_API_publishReport(int level)
+{
+    unsigned int i;
+    unsigned long reqSum = 0, scanSum = 0, mergedSum = 0, droppedSum = 0, entryNum = 0;
+    INTD_struc_pubEntry *entry;
+
+    if(!INTD_gvar_pubMutex) {
+        printf("INTD_API_publishReport: publisher not used\n");
+        return;
+    }
+
+    epicsMutexMustLock(INTD_gvar_pubMutex);
+
+    for(i = 0; i < INTD_PUB_BUCKETS; i ++) {
+        for(entry = INTD_gvar_pubEntries[i]; entry; entry = entry -> next) {
+            if(level > 0)
+                printf("    ioscan %p: max rate %8.2f Hz, requests %lu, scans %lu, merged %lu, dropped %lu\n",
+                        (void *)entry -> ioIntScan,
+                        entry -> minInterval > 0 ? 1.0 / entry -> minInterval : 0.0,
+                        entry -> requestCnt, entry -> scanCnt, entry -> mergedCnt, entry -> droppedCnt);
+
+            reqSum     += entry -> requestCnt;
+            scanSum    += entry -> scanCnt;
+            mergedSum  += entry -> mergedCnt;
+            droppedSum += entry -> droppedCnt;
+            entryNum   ++;
+        }
+    }
+
+    epicsMutexUnlock(INTD_gvar_pubMutex);
+
+    printf("INTD publisher: %lu ioscans, requests %lu, scans %lu, merged %lu, dropped %lu\n",
+            entryNum, reqSum, scanSum, mergedSum, droppedSum);
+}
+
+/**
+ * Reset the statistics of the publisher
+ */
+void INTD_API_publishResetStats()
+{
+    unsigned int i;
+    INTD_struc_pubEntry *entry;
+
+    if(!INTD_gvar_pubMutex) return;
+
+    epicsMutexMustLock(INTD_gvar_pubMutex);
+
+    for(i = 0; i < INTD_PUB_BUCKETS; i ++) {
+        for(entry = INTD_gvar_pubEntries[i]; entry; entry = entry -> next) {
+            entry -> requestCnt = 0;
+            entry -> scanCnt    = 0;
+            entry -> mergedCnt  = 0;
+            entry -> droppedCnt = 0;
+        }
+    }
+
+    epicsMutexUnlock(INTD_gvar_pubMutex);
+}
+
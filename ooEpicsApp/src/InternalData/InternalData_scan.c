@@ -0,0 +1,309 @@
+/***************************************************************************
+ *  Copyright (c) 2023 by Paul Scherrer Institute, Switzerland
+ *  All rights reserved.
+ *  Authors: Zheqiao Geng
+ ***************************************************************************/
+/***************************************************************************
+ * InternalData_scan.c
+ *
+ * Scan types beyond the EPICS periodic scans:
+ *   - Custom periods (50 Hz, 100 Hz or any period set by the user): the
+ *     records are generated with I/O Intr scan on a shared IOSCANPVT per
+ *     distinct period, which is scanned by one timer thread of the period
+ *     on absolute deadlines (no drift)
+ *   - Event: the records are generated with SCAN=Event and the EVNT of the
+ *     node, the module posts the named event to process all of them
+ ***************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <epicsVersion.h>
+#include <epicsMutex.h>
+#include <epicsTime.h>
+#include <epicsThread.h>
+#include <dbScan.h>
+
+#include "InternalData.h"
+
+/*======================================
+ * Global variables
+ *======================================*/
+#define INTD_SCAN_PERIOD_MIN    0.001                               /* shortest custom period (s) */
+
+typedef struct INTD_struc_scanRate {
+    struct INTD_struc_scanRate *next;
+    double              period;                                     /* seconds between the scans */
+    IOSCANPVT           ioIntScan;                                  /* shared by all nodes of the period */
+    epicsThreadId       thread;                                     /* timer thread of the period */
+    unsigned int        nodeNum;                                    /* number of nodes attached */
+    unsigned long       scanCnt;                                    /* number of scans requested */
+    unsigned long       droppedCnt;                                 /* number of scans not queued by EPICS */
+    unsigned long       lateCnt;                                    /* scans started later than one period after the deadline */
+} INTD_struc_scanRate;
+
+typedef struct INTD_struc_scanEvent {
+    struct INTD_struc_scanEvent *next;
+    char               *name;                                       /* event name */
+#if EPICS_VERSION > 3 || (EPICS_VERSION == 3 && EPICS_REVISION >= 15)
+    EVENTPVT            handle;                                     /* resolved once */
+#else
+    int                 number;                                     /* numbered soft event of the old EPICS versions */
+#endif
+    unsigned long       postCnt;
+} INTD_struc_scanEvent;
+
+static INTD_struc_scanRate  *INTD_gvar_scanRates    = NULL;         /* distinct periods, in creation order */
+static INTD_struc_scanEvent *INTD_gvar_scanEvents   = NULL;
+static epicsMutexId          INTD_gvar_scanMutex    = NULL;
+static epicsThreadOnceId     INTD_gvar_scanOnce     = EPICS_THREAD_ONCE_INIT;
+
+/*======================================
+ * Private Routines
+ *======================================*/
+/**
+ * Create the mutex, executed only once
+ */
+static void INTD_func_scanOnce(void *arg)
+{
+    INTD_gvar_scanMutex = epicsMutexMustCreate();
+}
+
+/**
+ * Initialize the mutex, safe to be called for several times and from several threads
+ */
+static void INTD_func_scanInit()
+{
+    epicsThreadOnce(&INTD_gvar_scanOnce, INTD_func_scanOnce, NULL);
+}
+
+/**
+ * Timer thread of a custom period. The deadlines are absolute, a late scan is executed immediately and
+ * the following ones keep the original phase
+ */
+static void INTD_func_scanThread(void *arg)
+{
+    INTD_struc_scanRate *rate = (INTD_struc_scanRate *)arg;
+    double delay;
+    epicsTimeStamp next, now;
+
+    epicsTimeGetCurrent(&next);
+
+    for(;;) {
+        epicsTimeAddSeconds(&next, rate -> period);
+
+        epicsTimeGetCurrent(&now);
+        delay = epicsTimeDiffInSeconds(&next, &now);
+
+        if(delay > 0) {
+            epicsThreadSleep(delay);
+        } else if(delay < -rate -> period) {
+            rate -> lateCnt ++;
+            next = now;                                             /* give up the missed scans */
+        }
+
+        rate -> scanCnt ++;
+#if EPICS_VERSION > 3 || (EPICS_VERSION == 3 && EPICS_REVISION >= 15)
+        if(!scanIoRequest(rate -> ioIntScan))
+            rate -> droppedCnt ++;
+#else
+        scanIoRequest(rate -> ioIntScan);
+#endif
+    }
+}
+
+/**
+ * Find the custom period, create it and start its timer thread if not found and create is set. Periods
+ * closer than 1 us share the timer. Called with the mutex locked
+ */
+static INTD_struc_scanRate *INTD_func_scanFindRate(double period, int create)
+{
+    char threadName[32];
+    INTD_struc_scanRate *rate, **last;
+
+    for(last = &INTD_gvar_scanRates; (rate = *last); last = &rate -> next)
+        if(rate -> period > period - 1e-6 && rate -> period < period + 1e-6) return rate;
+
+    if(!create) return NULL;
+
+    rate = (INTD_struc_scanRate *)calloc(1, sizeof(INTD_struc_scanRate));
+    if(!rate) {
+        printf("INTD_func_scanFindRate: Failed to allocate memory for the period %g s\n", period);
+        return NULL;
+    }
+
+    rate -> period = period;
+    scanIoInit(&rate -> ioIntScan);
+
+    sprintf(threadName, "INTD_scan%g", period * 1e3);
+    rate -> thread = epicsThreadCreate(threadName, epicsThreadPriorityScanHigh + 1,
+                                       epicsThreadGetStackSize(epicsThreadStackSmall),
+                                       INTD_func_scanThread, (void *)rate);
+    if(!rate -> thread) {
+        printf("INTD_func_scanFindRate: Failed to create the timer thread for the period %g s\n", period);
+        free(rate);
+        return NULL;
+    }
+
+    *last = rate;                                                   /* append, keep the order for the report */
+    return rate;
+}
+
+/**
+ * Attach the node to the IOSCANPVT of the period. An IOSCANPVT given by the user is not replaced, it would
+ * not be scanned any more (the IOSCANPVT of the same period is accepted, e.g. derived nodes)
+ */
+static int INTD_func_scanAttachPeriod(INTD_struc_node *dataNode, double period, const char *funcName)
+{
+    INTD_struc_scanRate *rate;
+
+    if(period < INTD_SCAN_PERIOD_MIN) {
+        printf("%s: The period %g s of %s.%s is shorter than %g s\n", funcName, period,
+                dataNode -> moduleName, dataNode -> dataName, INTD_SCAN_PERIOD_MIN);
+        return -1;
+    }
+
+    INTD_func_scanInit();
+    epicsMutexMustLock(INTD_gvar_scanMutex);
+
+    rate = INTD_func_scanFindRate(period, !dataNode -> ioIntScan);
+
+    if(dataNode -> ioIntScan && (!rate || dataNode -> ioIntScan != &rate -> ioIntScan)) {
+        printf("%s: %s.%s has its own IOSCANPVT, not scanned with the period %g s\n", funcName,
+                dataNode -> moduleName, dataNode -> dataName, period);
+        rate = NULL;
+    } else if(rate) {
+        rate -> nodeNum ++;
+        dataNode -> ioIntScan = &rate -> ioIntScan;
+    }
+
+    epicsMutexUnlock(INTD_gvar_scanMutex);
+    return rate ? 0 : -1;
+}
+
+/**
+ * Find the named event, create it if not found. Called with the mutex locked
+ */
+static INTD_struc_scanEvent *INTD_func_scanFindEvent(const char *eventName)
+{
+    INTD_struc_scanEvent *event;
+
+    for(event = INTD_gvar_scanEvents; event; event = event -> next)
+        if(strcmp(event -> name, eventName) == 0) return event;
+
+    event = (INTD_struc_scanEvent *)calloc(1, sizeof(INTD_struc_scanEvent) + strlen(eventName) + 1);
+    if(!event) {
+        printf("INTD_func_scanFindEvent: Failed to allocate memory for the event %s\n", eventName);
+        return NULL;
+    }
+
+    event -> name = (char *)(event + 1);
+    strcpy(event -> name, eventName);
+
+#if EPICS_VERSION > 3 || (EPICS_VERSION == 3 && EPICS_REVISION >= 15)
+    event -> handle = eventNameToHandle(eventName);
+#else
+    event -> number = atoi(eventName);
+#endif
+
+    event -> next        = INTD_gvar_scanEvents;
+    INTD_gvar_scanEvents = event;
+    return event;
+}
+
+/*======================================
+ * Public Routines
+ *======================================*/
+/**
+ * Attach a node of a fixed custom rate scan type (INTD_50HZ, INTD_100HZ) to the IOSCANPVT of its period and
+ * start the timer thread. Called when creating the node, refused if the user gave another IOSCANPVT
+ */
+int INTD_API_scanAttach(INTD_struc_node *dataNode)
+{
+    if(!dataNode || dataNode -> scanType < INTD_50HZ || dataNode -> scanType > INTD_100HZ) return -1;
+
+    return INTD_func_scanAttachPeriod(dataNode, dataNode -> scanType == INTD_50HZ ? 0.02 : 0.01, "INTD_API_scanAttach");
+}
+
+/**
+ * Set the period of a node with the INTD_PERIOD scan, the nodes with the same period share one IOSCANPVT and
+ * one timer thread. Must be called before iocInit (the records take the IOSCANPVT when initialized) and before
+ * the derived nodes (statistics, views, history) are added
+ * Input:
+ *   dataNode       : Data node with the INTD_PERIOD scan
+ *   period         : Seconds between the scans, at least INTD_SCAN_PERIOD_MIN
+ * Return:
+ *   0              : Successful
+ *  -1              : Failed
+ */
+int INTD_API_setScanPeriod(INTD_struc_node *dataNode, double period)
+{
+    if(!dataNode) return -1;
+
+    if(dataNode -> scanType != INTD_PERIOD) {
+        printf("INTD_API_setScanPeriod: %s.%s is not scanned with a custom period\n", dataNode -> moduleName, dataNode -> dataName);
+        return -1;
+    }
+
+    if(INTD_API_getIocInitStatus()) {
+        printf("INTD_API_setScanPeriod: Must be called before iocInit (%s.%s)\n", dataNode -> moduleName, dataNode -> dataName);
+        return -1;
+    }
+
+    return INTD_func_scanAttachPeriod(dataNode, period, "INTD_API_setScanPeriod");
+}
+
+/**
+ * Post a named soft event, all records with SCAN=Event and this EVNT are processed. With EPICS before 3.15
+ * the name must be the event number
+ */
+int INTD_API_postEvent(const char *eventName)
+{
+    INTD_struc_scanEvent *event;
+
+    if(!eventName || !eventName[0]) return -1;
+
+    INTD_func_scanInit();
+    epicsMutexMustLock(INTD_gvar_scanMutex);
+
+    event = INTD_func_scanFindEvent(eventName);
+    if(event) event -> postCnt ++;
+
+    epicsMutexUnlock(INTD_gvar_scanMutex);
+
+    if(!event) return -1;
+
+#if EPICS_VERSION > 3 || (EPICS_VERSION == 3 && EPICS_REVISION >= 15)
+    postEvent(event -> handle);
+#else
+    post_event(event -> number);
+#endif
+
+    return 0;
+}
+
+/**
+ * Print the custom periods and the posted events
+ */
+void INTD_API_scanReport()
+{
+    INTD_struc_scanRate  *rate;
+    INTD_struc_scanEvent *event;
+
+    INTD_func_scanInit();
+    epicsMutexMustLock(INTD_gvar_scanMutex);
+
+    printf("INTD custom period scans:\n");
+
+    for(rate = INTD_gvar_scanRates; rate; rate = rate -> next)
+        printf("    %8.3f ms (%.1f Hz): %u nodes, scans %lu, dropped %lu, late %lu\n",
+                rate -> period * 1e3, 1.0 / rate -> period, rate -> nodeNum,
+                rate -> scanCnt, rate -> droppedCnt, rate -> lateCnt);
+
+    printf("INTD events:\n");
+
+    for(event = INTD_gvar_scanEvents; event; event = event -> next)
+        printf("    %s: posted %lu\n", event -> name, event -> postCnt);
+
+    epicsMutexUnlock(INTD_gvar_scanMutex);
+}
@@ -0,0 +1,536 @@
+/***************************************************************************
+ *  Copyright (c) 2023 by Paul Scherrer Institute, Switzerland
+ *  All rights reserved.
+ *  Authors: Zheqiao Geng
+ ***************************************************************************/
+/***************************************************************************
+ * InternalData_shm.c
+ *
+ * Buffers of waveform nodes in named POSIX shared memory segments, so that
+ * a process outside of the IOC on the same host writes (or reads) the data
+ * in place, without Channel Access, instead of a copy at each end.
+ *   - The node buffer is moved to the segment and the node is switched to
+ *     the INTD_LOCK_SHARED mode: the sequence-lock protocol on the counter
+ *     of the buffer in the segment, for the IOC and the external process
+ *   - One thread per segment waits for the notifications of the producers
+ *     (process-shared semaphore, with the poll period as timeout) and
+ *     publishes the WFI nodes whose counter changed
+ * The layout and the routines of the external process are in
+ * InternalData_shm.h. Linux only.
+ ***************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <epicsMutex.h>
+#include <epicsTime.h>
+#include <epicsThread.h>
+#include <epicsAtomic.h>
+#include <epicsExit.h>
+
+#include "InternalData.h"
+#include "InternalData_shm.h"
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <time.h>
+
+/*======================================
+ * Global variables
+ *======================================*/
+#define INTD_SHM_DEFAULT_SIZE   (16u * 1024u * 1024u)               /* bytes of a segment created by INTD_API_shmAttach */
+#define INTD_SHM_DEFAULT_PERIOD 0.01                                /* poll period (s) without notification */
+#define INTD_SHM_BUF_MAX        256                                 /* descriptors of a segment */
+#define INTD_SHM_STALL_TIME     0.1                                 /* a writer holding the counter odd longer is dead */
+
+typedef struct INTD_struc_shmSeg_tag {
+    struct INTD_struc_shmSeg_tag *next;
+    char                path[128];                                  /* name of the shared memory object */
+    INTD_struc_shmMap   map;
+    double              period;
+    struct INTD_struc_shmNode_tag **nodes;                          /* IOC side of the buffers, by index */
+    epicsThreadId       thread;                                     /* created for the first INTD_SHM_TO_IOC buffer */
+    unsigned long       wakeCnt;                                    /* passes of the thread */
+    unsigned long       notifyCnt;                                  /* passes started by a notification */
+} INTD_struc_shmSeg;
+
+typedef struct INTD_struc_shmNode_tag {
+    INTD_struc_shmBuf  *buf;                                        /* descriptor in the segment */
+    INTD_struc_shmSeg  *seg;
+    INTD_struc_node    *dataNode;
+    int                 lastSeq;                                    /* counter of the last publish */
+    int                 stallSeq;                                   /* counter left odd by a dead writer */
+    unsigned long       pubCnt;
+    unsigned long       retryCnt;                                   /* copies repeated by the readers */
+    unsigned long       stallCnt;                                   /* reads given up waiting for a writer */
+} INTD_struc_shmNode;
+
+static INTD_struc_shmSeg *INTD_gvar_shmSegs  = NULL;
+static epicsMutexId       INTD_gvar_shmMutex = NULL;
+static epicsThreadOnceId  INTD_gvar_shmOnce  = EPICS_THREAD_ONCE_INIT;
+
+/*======================================
+ * Private Routines
+ *======================================*/
+/**
+ * Create the mutex, executed only once
+ */
+static void INTD_func_shmOnce(void *arg)
+{
+    INTD_gvar_shmMutex = epicsMutexMustCreate();
+}
+
+/**
+ * Initialize the mutex, safe to be called for several times and from several threads
+ */
+static void INTD_func_shmInit()
+{
+    epicsThreadOnce(&INTD_gvar_shmOnce, INTD_func_shmOnce, NULL);
+}
+
+/**
+ * Find a segment by name. Called with the mutex locked
+ */
+static INTD_struc_shmSeg *INTD_func_shmFind(const char *segName)
+{
+    char path[128];
+    INTD_struc_shmSeg *seg;
+
+    INTD_SHM_path(segName, path, sizeof(path));
+
+    for(seg = INTD_gvar_shmSegs; seg; seg = seg -> next)
+        if(strcmp(seg -> path, path) == 0) return seg;
+
+    return NULL;
+}
+
+/**
+ * Invalidate the segments when EPICS exits, the producers see it with INTD_SHM_valid. The memory is kept
+ *   mapped, as the records may still be processed
+ */
+static void INTD_func_shmExit(void *arg)
+{
+    INTD_struc_shmSeg *seg;
+
+    for(seg = INTD_gvar_shmSegs; seg; seg = seg -> next) {
+        seg -> map.header -> magic = 0;
+        shm_unlink(seg -> path);
+    }
+}
+
+/**
+ * Create a segment. Called with the mutex locked
+ */
+static INTD_struc_shmSeg *INTD_func_shmCreate(const char *segName, size_t size, double period)
+{
+    void *base;
+    int fd;
+    size_t dataStart;
+    INTD_struc_shmSeg *seg;
+    INTD_struc_shmHeader *header;
+
+    dataStart = (INTD_SHM_TABLE_OFFSET + INTD_SHM_BUF_MAX * sizeof(INTD_struc_shmBuf) + INTD_SHM_ALIGN - 1) & ~(size_t)(INTD_SHM_ALIGN - 1);
+
+    if(size <= dataStart) {
+        printf("INTD_API_shmCreate: Segment %s is too small\n", segName);
+        return NULL;
+    }
+
+    seg = (INTD_struc_shmSeg *)calloc(1, sizeof(INTD_struc_shmSeg));
+    if(seg) seg -> nodes = (INTD_struc_shmNode **)calloc(INTD_SHM_BUF_MAX, sizeof(INTD_struc_shmNode *));
+
+    if(!seg || !seg -> nodes) {
+        printf("INTD_API_shmCreate: Failed to allocate memory for %s\n", segName);
+        if(seg) free(seg);
+        return NULL;
+    }
+
+    INTD_SHM_path(segName, seg -> path, sizeof(seg -> path));
+
+    /* a segment left by an IOC before is replaced, the producers mapping it see the cleared magic */
+    shm_unlink(seg -> path);
+
+    fd = shm_open(seg -> path, O_CREAT | O_EXCL | O_RDWR, 0660);
+    if(fd < 0 || ftruncate(fd, (off_t)size) != 0) {
+        printf("INTD_API_shmCreate: Failed to create the shared memory %s (%s)\n", seg -> path, strerror(errno));
+        if(fd >= 0) close(fd);
+        free(seg -> nodes);
+        free(seg);
+        return NULL;
+    }
+
+    base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if(base == MAP_FAILED) {
+        printf("INTD_API_shmCreate: Failed to map the shared memory %s (%s)\n", seg -> path, strerror(errno));
+        shm_unlink(seg -> path);
+        free(seg -> nodes);
+        free(seg);
+        return NULL;
+    }
+
+    header = (INTD_struc_shmHeader *)base;
+
+    header -> version  = INTD_SHM_VERSION;
+    header -> size     = size;
+    header -> bufNum   = 0;
+    header -> bufMax   = INTD_SHM_BUF_MAX;
+    header -> dataUsed = dataStart;
+    header -> iocPid   = (int32_t)getpid();
+
+    if(sem_init(&header -> notify.sem, 1, 0) != 0) {
+        printf("INTD_API_shmCreate: Failed to create the semaphore of %s\n", seg -> path);
+        munmap(base, size);
+        shm_unlink(seg -> path);
+        free(seg -> nodes);
+        free(seg);
+        return NULL;
+    }
+
+    epicsAtomicWriteMemoryBarrier();
+    header -> magic = INTD_SHM_MAGIC;
+
+    seg -> map.header = header;
+    seg -> map.bufs   = (INTD_struc_shmBuf *)((char *)base + INTD_SHM_TABLE_OFFSET);
+    seg -> map.size   = size;
+    seg -> period     = period > 0 ? period : INTD_SHM_DEFAULT_PERIOD;
+
+    if(!INTD_gvar_shmSegs)
+        epicsAtExit(INTD_func_shmExit, NULL);
+
+    seg -> next       = INTD_gvar_shmSegs;
+    INTD_gvar_shmSegs = seg;
+
+    return seg;
+}
+
+/**
+ * Thread of a segment, publish the nodes of the buffers written by the producers. Woken up by
+ *   INTD_SHM_notify, or after the poll period
+ */
+static void INTD_func_shmThread(void *arg)
+{
+    uint32_t i, num;
+    int seq, status;
+    struct timespec deadline;
+    INTD_struc_shmSeg  *seg = (INTD_struc_shmSeg *)arg;
+    INTD_struc_shmNode *shmNode;
+    sem_t *sem = &seg -> map.header -> notify.sem;
+
+    for(;;) {
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += (long)(seg -> period * 1e9);
+        deadline.tv_sec  += deadline.tv_nsec / 1000000000L;
+        deadline.tv_nsec %= 1000000000L;
+
+        while((status = sem_timedwait(sem, &deadline)) != 0 && errno == EINTR) ;
+
+        if(status == 0) {
+            seg -> notifyCnt ++;
+            while(sem_trywait(sem) == 0) ;                          /* one pass for the posts meanwhile */
+        }
+
+        seg -> wakeCnt ++;
+
+        if(!INTD_API_getIocInitStatus()) continue;
+
+        num = epicsAtomicGetIntT((int *)&seg -> map.header -> bufNum);
+        epicsAtomicReadMemoryBarrier();
+
+        for(i = 0; i < num; i ++) {
+            shmNode = seg -> nodes[i];
+            if(!shmNode || shmNode -> buf -> direction != INTD_SHM_TO_IOC) continue;
+
+            seq = epicsAtomicGetIntT((int *)&shmNode -> buf -> seq);
+            if((seq & 1) || seq == shmNode -> lastSeq) continue;
+
+            shmNode -> lastSeq = seq;
+            shmNode -> pubCnt ++;
+
+            if(shmNode -> dataNode -> ioIntScan)
+                INTD_API_publishNode(shmNode -> dataNode);
+        }
+    }
+}
+
+/*======================================
+ * Public Routines
+ *======================================*/
+/**
+ * Create a named shared memory segment for the buffers of the nodes. A segment is also created with the
+ *   default size (16 MB) by the first INTD_API_shmAttach. The memory is only used when the buffers are
+ *   written (tmpfs)
+ * Input:
+ *   segName        : Name of the segment, e.g. "ioc-daq" (/dev/shm/ioc-daq)
+ *   sizeKB         : Size of the segment (kB), 0 for the default
+ *   period         : Poll period (s) of the buffers without notification, 0 for the default (10 ms)
+ * Return:
+ *   0              : Successful
+ *  -1              : Failed
+ */
+int INTD_API_shmCreate(const char *segName, unsigned int sizeKB, double period)
+{
+    INTD_struc_shmSeg *seg = NULL;
+
+    if(!segName || !segName[0]) return -1;
+
+    INTD_func_shmInit();
+    epicsMutexMustLock(INTD_gvar_shmMutex);
+
+    if(INTD_func_shmFind(segName))
+        printf("INTD_API_shmCreate: Segment %s already created\n", segName);
+    else
+        seg = INTD_func_shmCreate(segName, sizeKB ? (size_t)sizeKB * 1024 : INTD_SHM_DEFAULT_SIZE, period);
+
+    epicsMutexUnlock(INTD_gvar_shmMutex);
+    return seg ? 0 : -1;
+}
+
+/**
+ * Move the buffer of a waveform node to a shared memory segment. The current data is copied, the node is
+ *   switched to the INTD_LOCK_SHARED mode and its data must then only be accessed through the routines of
+ *   InternalData (the pointer given when creating the node is not used any more). The buffer of a WFI node
+ *   is written by the external process, the one of a WFO node by the IOC. Must be called before iocInit,
+ *   the mode cannot be left
+ * Input:
+ *   dataNode       : Waveform node (INTD_WFI, INTD_WFO) in the mutex or sequence-lock mode, without dirty range
+ *   segName        : Name of the segment, created if not yet
+ * Return:
+ *   0              : Successful
+ *  -1              : Failed
+ */
+int INTD_API_shmAttach(INTD_struc_node *dataNode, const char *segName)
+{
+    int status = -1;
+    size_t dataSize;
+    void *data;
+    INTD_struc_shmSeg    *seg;
+    INTD_struc_shmNode   *shmNode;
+    INTD_struc_shmBuf    *buf;
+    INTD_struc_shmHeader *header;
+
+    if(!dataNode || !segName || !segName[0] || !dataNode -> dataPtr) return -1;
+
+    if(dataNode -> lockMode == INTD_LOCK_SHARED) {
+        printf("INTD_API_shmAttach: Data of %s.%s is already in a shared memory\n", dataNode -> moduleName, dataNode -> dataName);
+        return -1;
+    }
+
+    if((dataNode -> recordType != INTD_WFI && dataNode -> recordType != INTD_WFO) ||
+       dataNode -> dataType == INTD_OLDSTRING || dataNode -> lockMode == INTD_LOCK_TRIPLEBUF || dataNode -> dirty) {
+        printf("INTD_API_shmAttach: Only the waveforms in the mutex or sequence-lock mode without dirty range (%s.%s)\n",
+                dataNode -> moduleName, dataNode -> dataName);
+        return -1;
+    }
+
+    if(INTD_API_getIocInitStatus()) {
+        printf("INTD_API_shmAttach: Must be called before iocInit (%s.%s)\n", dataNode -> moduleName, dataNode -> dataName);
+        return -1;
+    }
+
+    dataSize = (size_t)dataNode -> pno * INTD_API_getDataSize(dataNode -> dataType);
+
+    INTD_func_shmInit();
+    epicsMutexMustLock(INTD_gvar_shmMutex);
+
+    if(!(seg = INTD_func_shmFind(segName)))
+        seg = INTD_func_shmCreate(segName, INTD_SHM_DEFAULT_SIZE, INTD_SHM_DEFAULT_PERIOD);
+
+    if(!seg) goto done;
+
+    header = seg -> map.header;
+
+    if(header -> bufNum >= header -> bufMax || header -> dataUsed + dataSize > header -> size) {
+        printf("INTD_API_shmAttach: No space for %s.%s in %s\n", dataNode -> moduleName, dataNode -> dataName, seg -> path);
+        goto done;
+    }
+
+    if(!(shmNode = (INTD_struc_shmNode *)calloc(1, sizeof(INTD_struc_shmNode)))) {
+        printf("INTD_API_shmAttach: Failed to allocate memory for %s.%s\n", dataNode -> moduleName, dataNode -> dataName);
+        goto done;
+    }
+
+    /* the descriptor, visible to the producers when bufNum is incremented */
+    buf = &seg -> map.bufs[header -> bufNum];
+
+    snprintf(buf -> name, sizeof(buf -> name), "%s.%s", dataNode -> moduleName, dataNode -> dataName);
+    buf -> seq       = 0;
+    buf -> dataType  = (uint32_t)dataNode -> dataType;
+    buf -> elemSize  = (uint32_t)INTD_API_getDataSize(dataNode -> dataType);
+    buf -> pno       = dataNode -> pno;
+    buf -> direction = dataNode -> recordType == INTD_WFI ? INTD_SHM_TO_IOC : INTD_SHM_FROM_IOC;
+    buf -> offset    = header -> dataUsed;
+
+    data = INTD_SHM_data(&seg -> map, buf);
+
+    shmNode -> buf      = buf;
+    shmNode -> seg      = seg;
+    shmNode -> dataNode = dataNode;
+    shmNode -> stallSeq = -1;
+
+    /* move the data, the readers and writers of the node wait on its mutex */
+    if(dataNode -> mutexId) epicsMutexMustLock(dataNode -> mutexId);
+
+    memcpy(data, dataNode -> dataPtr, dataSize);
+
+    dataNode -> shm     = shmNode;
+    dataNode -> dataPtr = data;
+    epicsAtomicWriteMemoryBarrier();
+    dataNode -> lockMode = INTD_LOCK_SHARED;
+
+    if(dataNode -> mutexId) epicsMutexUnlock(dataNode -> mutexId);
+
+    seg -> nodes[header -> bufNum] = shmNode;
+    header -> dataUsed = (header -> dataUsed + dataSize + INTD_SHM_ALIGN - 1) & ~(uint64_t)(INTD_SHM_ALIGN - 1);
+
+    epicsAtomicWriteMemoryBarrier();
+    header -> bufNum ++;
+
+    /* publish the buffers written by the producers */
+    if(buf -> direction == INTD_SHM_TO_IOC && !seg -> thread) {
+        seg -> thread = epicsThreadCreate("INTD_shm", epicsThreadPriorityScanHigh,
+                                          epicsThreadGetStackSize(epicsThreadStackSmall),
+                                          INTD_func_shmThread, (void *)seg);
+        if(!seg -> thread)
+            printf("INTD_API_shmAttach: Failed to create the thread of %s\n", seg -> path);
+    }
+
+    status = 0;
+
+done:
+    epicsMutexUnlock(INTD_gvar_shmMutex);
+    return status;
+}
+
+/**
+ * Read protocol of INTD_LOCK_SHARED (INTD_API_readBegin/INTD_API_readRetry). A writer keeping the counter odd
+ *   longer than INTD_SHM_STALL_TIME (dead producer) is given up: the odd counter is returned, the read is not
+ *   retried and the caller must treat the data as invalid (INTD_API_getRecordData fails, the device support
+ *   raises the READ/INVALID alarm). The following reads do not wait until the counter changes
+ */
+unsigned int INTD_API_shmReadBegin(INTD_struc_node *dataNode)
+{
+    int waiting = 0;
+    unsigned int seq;
+    unsigned int spin = 0;
+    epicsTimeStamp start, now;
+    INTD_struc_shmNode *shmNode = dataNode -> shm;
+
+    while((seq = (unsigned int)epicsAtomicGetIntT((int *)&shmNode -> buf -> seq)) & 1) {
+        if((int)seq == shmNode -> stallSeq) break;
+
+        if(++ spin > 1000) {                                        /* writer preempted, give it the CPU */
+            epicsTimeGetCurrent(&now);
+
+            if(!waiting) {
+                start   = now;
+                waiting = 1;
+            } else if(epicsTimeDiffInSeconds(&now, &start) > INTD_SHM_STALL_TIME) {
+                shmNode -> stallSeq = (int)seq;
+                shmNode -> stallCnt ++;
+                break;
+            }
+
+            epicsThreadSleep(0.0);
+            spin = 0;
+        }
+    }
+
+    epicsAtomicReadMemoryBarrier();
+    return seq;
+}
+
+int INTD_API_shmReadRetry(INTD_struc_node *dataNode, unsigned int seq)
+{
+    INTD_struc_shmNode *shmNode = dataNode -> shm;
+
+    epicsAtomicReadMemoryBarrier();
+
+    if(seq & 1) return 0;                                           /* writer given up */
+    if((unsigned int)epicsAtomicGetIntT((int *)&shmNode -> buf -> seq) == seq) return 0;
+
+    shmNode -> retryCnt ++;
+    return 1;
+}
+
+/**
+ * Write protocol of INTD_LOCK_SHARED, for the writers in the IOC (the node mutex is held)
+ */
+void INTD_API_shmWriteBegin(INTD_struc_node *dataNode)
+{
+    epicsAtomicIncrIntT((int *)&dataNode -> shm -> buf -> seq);
+    epicsAtomicWriteMemoryBarrier();
+}
+
+void INTD_API_shmWriteEnd(INTD_struc_node *dataNode)
+{
+    epicsAtomicWriteMemoryBarrier();
+    epicsAtomicIncrIntT((int *)&dataNode -> shm -> buf -> seq);
+}
+
+/**
+ * Print the segments, and the buffers with level > 0
+ */
+void INTD_API_shmReport(int level)
+{
+    uint32_t i;
+    INTD_struc_shmSeg  *seg;
+    INTD_struc_shmNode *shmNode;
+    INTD_struc_shmHeader *header;
+
+    INTD_func_shmInit();
+    epicsMutexMustLock(INTD_gvar_shmMutex);
+
+    printf("INTD shared memory:\n");
+
+    for(seg = INTD_gvar_shmSegs; seg; seg = seg -> next) {
+        header = seg -> map.header;
+
+        printf("    %s: %lu kB, %lu kB used, %u/%u buffers, period %g s, passes %lu (notified %lu), producer notifications %u\n",
+                seg -> path, (unsigned long)(header -> size / 1024), (unsigned long)(header -> dataUsed / 1024),
+                header -> bufNum, header -> bufMax, seg -> period, seg -> wakeCnt, seg -> notifyCnt, header -> notifyCnt);
+
+        if(level <= 0) continue;
+
+        for(i = 0; i < header -> bufNum; i ++) {
+            if(!(shmNode = seg -> nodes[i])) continue;
+
+            printf("        %s: %s, %u points, counter %d, published %lu, read retries %lu, writer stalls %lu\n",
+                    shmNode -> buf -> name, shmNode -> buf -> direction == INTD_SHM_TO_IOC ? "to IOC" : "from IOC",
+                    shmNode -> buf -> pno, (int)shmNode -> buf -> seq, shmNode -> pubCnt, shmNode -> retryCnt, shmNode -> stallCnt);
+        }
+    }
+
+    epicsMutexUnlock(INTD_gvar_shmMutex);
+}
+
+#else
+
+/*======================================
+ * Not supported on this OS
+ *======================================*/
+int INTD_API_shmCreate(const char *segName, unsigned int sizeKB, double period)
+{
+    printf("INTD_API_shmCreate: Shared memory is only supported on Linux\n");
+    return -1;
+}
+
+int INTD_API_shmAttach(INTD_struc_node *dataNode, const char *segName)
+{
+    printf("INTD_API_shmAttach: Shared memory is only supported on Linux\n");
+    return -1;
+}
+
+unsigned int INTD_API_shmReadBegin(INTD_struc_node *dataNode)                   {return 0;}
+int  INTD_API_shmReadRetry(INTD_struc_node *dataNode, unsigned int seq)         {return 0;}
+void INTD_API_shmWriteBegin(INTD_struc_node *dataNode)                          {}
+void INTD_API_shmWriteEnd(INTD_struc_node *dataNode)                            {}
+
+void INTD_API_shmReport(int level)
+{
+    printf("INTD shared memory: not supported on this OS\n");
+}
+
+#endif
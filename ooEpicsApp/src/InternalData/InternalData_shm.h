@@ -0,0 +1,247 @@
+/***************************************************************************
+ *  Copyright (c) 2023 by Paul Scherrer Institute, Switzerland
+ *  All rights reserved.
+ *  Authors: Zheqiao Geng
+ ***************************************************************************/
+/***************************************************************************
+ * InternalData_shm.h
+ *
+ * Layout of the POSIX shared memory segments of InternalData (see
+ * InternalData_shm.c) and the routines for the external processes on the
+ * same host. This header does not depend on EPICS, a producer only needs
+ * it and -lrt -pthread (Linux):
+ *
+ *     INTD_struc_shmMap  map;
+ *     INTD_struc_shmBuf *buf;
+ *     double *data;
+ *
+ *     if(INTD_SHM_open("ioc-daq", &map) != 0) ...
+ *     buf  = INTD_SHM_find(&map, "MOD1", "ADC-WF");
+ *     data = (double *)INTD_SHM_data(&map, buf);
+ *
+ *     INTD_SHM_writeBegin(buf);
+ *     ... fill data[0 .. buf -> pno - 1] ...
+ *     INTD_SHM_writeEnd(buf);
+ *     INTD_SHM_notify(&map);                  // wake up the IOC, once per batch of buffers
+ *
+ * Each buffer has a sequence counter, odd while written. The IOC copies
+ * the buffers written by the external process (INTD_SHM_TO_IOC, WFI
+ * nodes) with the sequence-lock protocol and publishes them, and writes
+ * the buffers of the output nodes (INTD_SHM_FROM_IOC, WFO) with the same
+ * protocol for the external readers (INTD_SHM_readBegin/readRetry).
+ * Only one process may write a buffer. When the IOC exits the magic is
+ * cleared, the producer must open the segment again (INTD_SHM_valid).
+ ***************************************************************************/
+#ifndef INTERNAL_DATA_SHM_H
+#define INTERNAL_DATA_SHM_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define INTD_SHM_MAGIC          0x44544e49u             /* "INTD" */
+#define INTD_SHM_VERSION        1
+#define INTD_SHM_NAME_LEN       96                      /* "moduleName.dataName" */
+#define INTD_SHM_ALIGN          64                      /* alignment of the data of the buffers (cache line) */
+
+/**
+ * Direction of the data of a buffer
+ */
+#define INTD_SHM_TO_IOC         0                       /* written by the external process (WFI node) */
+#define INTD_SHM_FROM_IOC       1                       /* written by the IOC (WFO node) */
+
+/**
+ * Descriptor of a buffer, 128 bytes. dataType is the INTD_enum_dataType of InternalData.h
+ */
+typedef struct {
+    char                name[INTD_SHM_NAME_LEN];
+    volatile int32_t    seq;                            /* sequence counter, odd while writing */
+    uint32_t            dataType;
+    uint32_t            elemSize;                       /* bytes of one point */
+    uint32_t            pno;                            /* number of points */
+    uint32_t            direction;                      /* INTD_SHM_TO_IOC or INTD_SHM_FROM_IOC */
+    uint32_t            reserved;
+    uint64_t            offset;                         /* of the data from the start of the segment */
+} INTD_struc_shmBuf;
+
+/**
+ * Header at the start of the segment, followed by the table of bufMax descriptors and the data
+ */
+typedef struct {
+    volatile uint32_t   magic;                          /* INTD_SHM_MAGIC when valid, written last */
+    uint32_t            version;
+    uint64_t            size;                           /* bytes of the segment */
+    volatile uint32_t   bufNum;                         /* buffers defined, the descriptors are complete */
+    uint32_t            bufMax;
+    uint64_t            dataUsed;                       /* offset of the free data space */
+    volatile uint32_t   notifyCnt;                      /* incremented by INTD_SHM_notify */
+    int32_t             iocPid;
+    union {
+#ifdef __linux__
+        sem_t           sem;                            /* process-shared, posted by the producers */
+#endif
+        char            pad[64];
+    } notify;
+} INTD_struc_shmHeader;
+
+#define INTD_SHM_TABLE_OFFSET   ((sizeof(INTD_struc_shmHeader) + INTD_SHM_ALIGN - 1) & ~(size_t)(INTD_SHM_ALIGN - 1))
+
+/**
+ * Mapping of a segment in the process
+ */
+typedef struct {
+    INTD_struc_shmHeader *header;
+    INTD_struc_shmBuf    *bufs;
+    size_t                size;
+} INTD_struc_shmMap;
+
+/**
+ * Name of the shared memory object, "/" is added if missing
+ */
+static inline void INTD_SHM_path(const char *segName, char *path, size_t size)
+{
+    snprintf(path, size, "%s%s", segName[0] == '/' ? "" : "/", segName);
+}
+
+#ifdef __linux__
+/**
+ * Map the segment created by the IOC. Return 0 if successful
+ */
+static inline int INTD_SHM_open(const char *segName, INTD_struc_shmMap *map)
+{
+    char path[256];
+    struct stat st;
+    void *base;
+    int fd;
+
+    if(!segName || !map) return -1;
+
+    INTD_SHM_path(segName, path, sizeof(path));
+
+    if((fd = shm_open(path, O_RDWR, 0)) < 0) return -1;
+
+    if(fstat(fd, &st) != 0 || (size_t)st.st_size < INTD_SHM_TABLE_OFFSET) {
+        close(fd);
+        return -1;
+    }
+
+    base = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if(base == MAP_FAILED) return -1;
+
+    map -> header = (INTD_struc_shmHeader *)base;
+    map -> bufs   = (INTD_struc_shmBuf *)((char *)base + INTD_SHM_TABLE_OFFSET);
+    map -> size   = (size_t)st.st_size;
+
+    if(__atomic_load_n(&map -> header -> magic, __ATOMIC_ACQUIRE) != INTD_SHM_MAGIC ||
+       map -> header -> version != INTD_SHM_VERSION) {
+        munmap(base, map -> size);
+        return -1;
+    }
+
+    return 0;
+}
+
+static inline void INTD_SHM_close(INTD_struc_shmMap *map)
+{
+    if(map && map -> header) munmap((void *)map -> header, map -> size);
+    if(map) map -> header = NULL;
+}
+
+/**
+ * Wake up the IOC to publish the buffers written
+ */
+static inline void INTD_SHM_notify(INTD_struc_shmMap *map)
+{
+    __atomic_fetch_add(&map -> header -> notifyCnt, 1, __ATOMIC_RELEASE);
+    sem_post(&map -> header -> notify.sem);
+}
+#endif
+
+/**
+ * The segment is still used by the IOC (it clears the magic when exiting)
+ */
+static inline int INTD_SHM_valid(const INTD_struc_shmMap *map)
+{
+    return map && map -> header && __atomic_load_n(&map -> header -> magic, __ATOMIC_ACQUIRE) == INTD_SHM_MAGIC;
+}
+
+/**
+ * Descriptor of the buffer of a node, NULL if the node is not in the segment
+ */
+static inline INTD_struc_shmBuf *INTD_SHM_find(const INTD_struc_shmMap *map, const char *moduleName, const char *dataName)
+{
+    char name[INTD_SHM_NAME_LEN];
+    uint32_t i, num;
+
+    if(!INTD_SHM_valid(map) || !moduleName || !dataName) return NULL;
+
+    snprintf(name, sizeof(name), "%s.%s", moduleName, dataName);
+    num = __atomic_load_n(&map -> header -> bufNum, __ATOMIC_ACQUIRE);
+
+    for(i = 0; i < num; i ++)
+        if(strcmp(map -> bufs[i].name, name) == 0) return &map -> bufs[i];
+
+    return NULL;
+}
+
+static inline void *INTD_SHM_data(const INTD_struc_shmMap *map, const INTD_struc_shmBuf *buf)
+{
+    return (char *)map -> header + buf -> offset;
+}
+
+/**
+ * Write protocol of a buffer: the counter is odd during the write
+ */
+static inline void INTD_SHM_writeBegin(INTD_struc_shmBuf *buf)
+{
+    __atomic_fetch_add(&buf -> seq, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void INTD_SHM_writeEnd(INTD_struc_shmBuf *buf)
+{
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_fetch_add(&buf -> seq, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * Read protocol of a buffer written by the IOC:
+ *   do {
+ *       seq = INTD_SHM_readBegin(buf);
+ *       ... copy the data ...
+ *   } while(INTD_SHM_readRetry(buf, seq));
+ */
+static inline int32_t INTD_SHM_readBegin(const INTD_struc_shmBuf *buf)
+{
+    int32_t seq;
+
+    while((seq = __atomic_load_n(&buf -> seq, __ATOMIC_ACQUIRE)) & 1) ;
+
+    return seq;
+}
+
+static inline int INTD_SHM_readRetry(const INTD_struc_shmBuf *buf, int32_t seq)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&buf -> seq, __ATOMIC_RELAXED) != seq;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,1422 @@
+/***************************************************************************
+ *  Copyright (c) 2023 by Paul Scherrer Institute, Switzerland
+ *  All rights reserved.
+ *  Authors: Zheqiao Geng
+ ***************************************************************************/
+/***************************************************************************
+ * InternalData_simd.c
+ *
+ * Vector kernels for the waveform data of the internal data nodes. The
+ * float and double kernels use SSE2 on x86, plus an AVX version that is
+ * selected at the first call when the CPU supports it, and plain C
+ * elsewhere. The integer types always use the plain C version.
+ *
+ * The type conversions of the waveforms (LocalPV, ChannelAccess) have
+ * SSE2, AVX2 and AVX-512 versions, the best one supported by the CPU is
+ * selected at the first call. The AVX2/AVX-512 versions are compiled with
+ * the target attribute of GCC/clang, so the module does not need to be
+ * compiled for them. The results are the same as the C casts of the plain
+ * loops.
+ ***************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <epicsTime.h>
+#include <epicsThread.h>
+#include <epicsAtomic.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__) && \
+    (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5))
+#include <immintrin.h>
+#define INTD_SIMD_SSE2
+#define INTD_SIMD_DISPATCH                                          /* AVX/AVX2/AVX-512 selected at run time */
+#define INTD_SIMD_AVX_TARGET        __attribute__((target("avx")))
+#define INTD_SIMD_AVX2_TARGET       __attribute__((target("avx2")))
+#define INTD_SIMD_AVX512_TARGET     __attribute__((target("avx512f")))
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define INTD_SIMD_SSE2
+#endif
+
+#include "InternalData.h"
+
+/*======================================
+ * Private Routines
+ *======================================*/
+/**
+ * Plain C statistics for all data types
+ */
+#define INTD_VEC_STATS_SCALAR(dtp)                                                      \
+    {const dtp *ptr = (const dtp *)data;                                                \
+    double x, minv = (double)ptr[0], maxv = (double)ptr[0], s = 0.0, sq = 0.0;          \
+    for(i = 0; i < pno; i ++) {                                                         \
+        x = (double)ptr[i];                                                             \
+        if(x < minv) minv = x;                                                          \
+        if(x > maxv) maxv = x;                                                          \
+        s  += x;                                                                        \
+        sq += x * x;                                                                    \
+    }                                                                                   \
+    *minVal = minv; *maxVal = maxv; *sum = s; *sumSq = sq;}
+
+#define INTD_VEC_MINMAX_SCALAR(dtp)                                                     \
+    {const dtp *ptr = (const dtp *)data;                                                \
+    dtp minv = ptr[0], maxv = ptr[0];                                                   \
+    for(i = 1; i < pno; i ++) {                                                         \
+        if(ptr[i] < minv) minv = ptr[i];                                                \
+        if(ptr[i] > maxv) maxv = ptr[i];                                                \
+    }                                                                                   \
+    *minVal = (double)minv; *maxVal = (double)maxv;}
+
+#define INTD_VEC_SUM_SCALAR(dtp)                                                        \
+    {const dtp *ptr = (const dtp *)data;                                                \
+    double s = 0.0;                                                                     \
+    for(i = 0; i < pno; i ++) s += (double)ptr[i];                                      \
+    return s;}
+
+#define INTD_VEC_FIND_SCALAR(dtp)                                                       \
+    {const dtp *ptr = (const dtp *)data;                                                \
+    for(i = 0; i < pno; i ++)                                                           \
+        if((double)ptr[i] == value) return i;                                           \
+    return pno;}
+
+/**
+ * Statistics of a double array, pno > 0
+ */
+static void INTD_func_vecStatsDouble(const double *ptr, unsigned int pno, double *minVal, double *maxVal, double *sum, double *sumSq)
+{
+    unsigned int i = 0;
+    double minv = ptr[0], maxv = ptr[0], s = 0.0, sq = 0.0;
+
+#if defined(INTD_SIMD_SSE2)
+    double buf[2];
+    __m128d x0, x1;
+    __m128d vmin = _mm_set1_pd(ptr[0]), vmax = vmin;
+    __m128d vs0  = _mm_setzero_pd(), vs1 = vs0, vq0 = vs0, vq1 = vs0;
+
+    for(; i + 4 <= pno; i += 4) {
+        x0   = _mm_loadu_pd(ptr + i);
+        x1   = _mm_loadu_pd(ptr + i + 2);
+        vmin = _mm_min_pd(vmin, _mm_min_pd(x0, x1));
+        vmax = _mm_max_pd(vmax, _mm_max_pd(x0, x1));
+        vs0  = _mm_add_pd(vs0, x0);
+        vs1  = _mm_add_pd(vs1, x1);
+        vq0  = _mm_add_pd(vq0, _mm_mul_pd(x0, x0));
+        vq1  = _mm_add_pd(vq1, _mm_mul_pd(x1, x1));
+    }
+
+    _mm_storeu_pd(buf, vmin); minv = buf[0] < buf[1] ? buf[0] : buf[1];
+    _mm_storeu_pd(buf, vmax); maxv = buf[0] > buf[1] ? buf[0] : buf[1];
+    _mm_storeu_pd(buf, _mm_add_pd(vs0, vs1)); s  = buf[0] + buf[1];
+    _mm_storeu_pd(buf, _mm_add_pd(vq0, vq1)); sq = buf[0] + buf[1];
+#endif
+
+    for(; i < pno; i ++) {
+        if(ptr[i] < minv) minv = ptr[i];
+        if(ptr[i] > maxv) maxv = ptr[i];
+        s  += ptr[i];
+        sq += ptr[i] * ptr[i];
+    }
+
+    *minVal = minv; *maxVal = maxv; *sum = s; *sumSq = sq;
+}
+
+/**
+ * Statistics of a float array, pno > 0. Min/max are taken in float, the sums are accumulated in double
+ */
+static void INTD_func_vecStatsFloat(const float *ptr, unsigned int pno, double *minVal, double *maxVal, double *sum, double *sumSq)
+{
+    unsigned int i = 0;
+    float  minf = ptr[0], maxf = ptr[0];
+    double s = 0.0, sq = 0.0;
+
+#if defined(INTD_SIMD_SSE2)
+    float  fbuf[4];
+    double buf[2];
+    __m128  x;
+    __m128d d0, d1;
+    __m128  vmin = _mm_set1_ps(ptr[0]), vmax = vmin;
+    __m128d vs0  = _mm_setzero_pd(), vs1 = vs0, vq0 = vs0, vq1 = vs0;
+    unsigned int k;
+
+    for(; i + 4 <= pno; i += 4) {
+        x    = _mm_loadu_ps(ptr + i);
+        vmin = _mm_min_ps(vmin, x);
+        vmax = _mm_max_ps(vmax, x);
+        d0   = _mm_cvtps_pd(x);
+        d1   = _mm_cvtps_pd(_mm_movehl_ps(x, x));
+        vs0  = _mm_add_pd(vs0, d0);
+        vs1  = _mm_add_pd(vs1, d1);
+        vq0  = _mm_add_pd(vq0, _mm_mul_pd(d0, d0));
+        vq1  = _mm_add_pd(vq1, _mm_mul_pd(d1, d1));
+    }
+
+    _mm_storeu_ps(fbuf, vmin); for(k = 0; k < 4; k ++) if(fbuf[k] < minf) minf = fbuf[k];
+    _mm_storeu_ps(fbuf, vmax); for(k = 0; k < 4; k ++) if(fbuf[k] > maxf) maxf = fbuf[k];
+    _mm_storeu_pd(buf, _mm_add_pd(vs0, vs1)); s  = buf[0] + buf[1];
+    _mm_storeu_pd(buf, _mm_add_pd(vq0, vq1)); sq = buf[0] + buf[1];
+#endif
+
+    for(; i < pno; i ++) {
+        if(ptr[i] < minf) minf = ptr[i];
+        if(ptr[i] > maxf) maxf = ptr[i];
+        s  += (double)ptr[i];
+        sq += (double)ptr[i] * ptr[i];
+    }
+
+    *minVal = minf; *maxVal = maxf; *sum = s; *sumSq = sq;
+}
+
+/**
+ * Min and max of a double array, pno > 0
+ */
+static void INTD_func_vecMinMaxDouble(const double *ptr, unsigned int pno, double *minVal, double *maxVal)
+{
+    unsigned int i = 0;
+    double minv = ptr[0], maxv = ptr[0];
+
+#if defined(INTD_SIMD_SSE2)
+    double buf[2];
+    __m128d x0, x1;
+    __m128d vmin = _mm_set1_pd(ptr[0]), vmax = vmin;
+
+    for(; i + 4 <= pno; i += 4) {
+        x0   = _mm_loadu_pd(ptr + i);
+        x1   = _mm_loadu_pd(ptr + i + 2);
+        vmin = _mm_min_pd(vmin, _mm_min_pd(x0, x1));
+        vmax = _mm_max_pd(vmax, _mm_max_pd(x0, x1));
+    }
+
+    _mm_storeu_pd(buf, vmin); minv = buf[0] < buf[1] ? buf[0] : buf[1];
+    _mm_storeu_pd(buf, vmax); maxv = buf[0] > buf[1] ? buf[0] : buf[1];
+#endif
+
+    for(; i < pno; i ++) {
+        if(ptr[i] < minv) minv = ptr[i];
+        if(ptr[i] > maxv) maxv = ptr[i];
+    }
+
+    *minVal = minv; *maxVal = maxv;
+}
+
+/**
+ * Min and max of a float array, pno > 0
+ */
+static void INTD_func_vecMinMaxFloat(const float *ptr, unsigned int pno, double *minVal, double *maxVal)
+{
+    unsigned int i = 0;
+    float minf = ptr[0], maxf = ptr[0];
+
+#if defined(INTD_SIMD_SSE2)
+    float fbuf[4];
+    unsigned int k;
+    __m128 x0, x1;
+    __m128 vmin = _mm_set1_ps(ptr[0]), vmax = vmin;
+
+    for(; i + 8 <= pno; i += 8) {
+        x0   = _mm_loadu_ps(ptr + i);
+        x1   = _mm_loadu_ps(ptr + i + 4);
+        vmin = _mm_min_ps(vmin, _mm_min_ps(x0, x1));
+        vmax = _mm_max_ps(vmax, _mm_max_ps(x0, x1));
+    }
+
+    _mm_storeu_ps(fbuf, vmin); for(k = 0; k < 4; k ++) if(fbuf[k] < minf) minf = fbuf[k];
+    _mm_storeu_ps(fbuf, vmax); for(k = 0; k < 4; k ++) if(fbuf[k] > maxf) maxf = fbuf[k];
+#endif
+
+    for(; i < pno; i ++) {
+        if(ptr[i] < minf) minf = ptr[i];
+        if(ptr[i] > maxf) maxf = ptr[i];
+    }
+
+    *minVal = minf; *maxVal = maxf;
+}
+
+/**
+ * Sum of a double array
+ */
+static double INTD_func_vecSumDouble(const double *ptr, unsigned int pno)
+{
+    unsigned int i = 0;
+    double s = 0.0;
+
+#if defined(INTD_SIMD_SSE2)
+    double buf[2];
+    __m128d vs0 = _mm_setzero_pd(), vs1 = vs0;
+
+    for(; i + 4 <= pno; i += 4) {
+        vs0 = _mm_add_pd(vs0, _mm_loadu_pd(ptr + i));
+        vs1 = _mm_add_pd(vs1, _mm_loadu_pd(ptr + i + 2));
+    }
+
+    _mm_storeu_pd(buf, _mm_add_pd(vs0, vs1)); s = buf[0] + buf[1];
+#endif
+
+    for(; i < pno; i ++) s += ptr[i];
+
+    return s;
+}
+
+/**
+ * Sum of a float array, accumulated in double
+ */
+static double INTD_func_vecSumFloat(const float *ptr, unsigned int pno)
+{
+    unsigned int i = 0;
+    double s = 0.0;
+
+#if defined(INTD_SIMD_SSE2)
+    double buf[2];
+    __m128  x;
+    __m128d vs0 = _mm_setzero_pd(), vs1 = vs0;
+
+    for(; i + 4 <= pno; i += 4) {
+        x   = _mm_loadu_ps(ptr + i);
+        vs0 = _mm_add_pd(vs0, _mm_cvtps_pd(x));
+        vs1 = _mm_add_pd(vs1, _mm_cvtps_pd(_mm_movehl_ps(x, x)));
+    }
+
+    _mm_storeu_pd(buf, _mm_add_pd(vs0, vs1)); s = buf[0] + buf[1];
+#endif
+
+    for(; i < pno; i ++) s += (double)ptr[i];
+
+    return s;
+}
+
+/**
+ * Index of the first element equal to value in a double array, pno if not found
+ */
+static unsigned int INTD_func_vecFindDouble(const double *ptr, unsigned int pno, double value)
+{
+    unsigned int i = 0;
+
+#if defined(INTD_SIMD_SSE2)
+    int mask;
+    __m128d v = _mm_set1_pd(value);
+
+    for(; i + 2 <= pno; i += 2) {
+        mask = _mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(ptr + i), v));
+        if(mask) break;
+    }
+#endif
+
+    for(; i < pno; i ++)
+        if(ptr[i] == value) return i;
+
+    return pno;
+}
+
+/**
+ * Index of the first element equal to value in a float array, pno if not found
+ */
+static unsigned int INTD_func_vecFindFloat(const float *ptr, unsigned int pno, float value)
+{
+    unsigned int i = 0;
+
+#if defined(INTD_SIMD_SSE2)
+    int mask;
+    __m128 v = _mm_set1_ps(value);
+
+    for(; i + 4 <= pno; i += 4) {
+        mask = _mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(ptr + i), v));
+        if(mask) break;
+    }
+#endif
+
+    for(; i < pno; i ++)
+        if(ptr[i] == value) return i;
+
+    return pno;
+}
+
+
+#if defined(INTD_SIMD_DISPATCH)
+/**
+ * Statistics of a double array, pno > 0 (AVX)
+ */
+static INTD_SIMD_AVX_TARGET void INTD_func_vecStatsDoubleAvx(const double *ptr, unsigned int pno, double *minVal, double *maxVal, double *sum, double *sumSq)
+{
+    unsigned int i = 0;
+    double minv = ptr[0], maxv = ptr[0], s = 0.0, sq = 0.0;
+
+    double buf[4];
+    __m256d x0, x1;
+    __m256d vmin = _mm256_set1_pd(ptr[0]), vmax = vmin;
+    __m256d vs0  = _mm256_setzero_pd(), vs1 = vs0, vq0 = vs0, vq1 = vs0;
+
+    for(; i + 8 <= pno; i += 8) {
+        x0   = _mm256_loadu_pd(ptr + i);
+        x1   = _mm256_loadu_pd(ptr + i + 4);
+        vmin = _mm256_min_pd(vmin, _mm256_min_pd(x0, x1));
+        vmax = _mm256_max_pd(vmax, _mm256_max_pd(x0, x1));
+        vs0  = _mm256_add_pd(vs0, x0);
+        vs1  = _mm256_add_pd(vs1, x1);
+        vq0  = _mm256_add_pd(vq0, _mm256_mul_pd(x0, x0));
+        vq1  = _mm256_add_pd(vq1, _mm256_mul_pd(x1, x1));
+    }
+
+    _mm256_storeu_pd(buf, vmin); minv = buf[0]; if(buf[1] < minv) minv = buf[1]; if(buf[2] < minv) minv = buf[2]; if(buf[3] < minv) minv = buf[3];
+    _mm256_storeu_pd(buf, vmax); maxv = buf[0]; if(buf[1] > maxv) maxv = buf[1]; if(buf[2] > maxv) maxv = buf[2]; if(buf[3] > maxv) maxv = buf[3];
+    _mm256_storeu_pd(buf, _mm256_add_pd(vs0, vs1)); s  = buf[0] + buf[1] + buf[2] + buf[3];
+    _mm256_storeu_pd(buf, _mm256_add_pd(vq0, vq1)); sq = buf[0] + buf[1] + buf[2] + buf[3];
+
+    for(; i < pno; i ++) {
+        if(ptr[i] < minv) minv = ptr[i];
+        if(ptr[i] > maxv) maxv = ptr[i];
+        s  += ptr[i];
+        sq += ptr[i] * ptr[i];
+    }
+
+    *minVal = minv; *maxVal = maxv; *sum = s; *sumSq = sq;
+}
+
+/**
+ * Statistics of a float array, pno > 0. Min/max are taken in float, the sums are accumulated in double (AVX)
+ */
+static INTD_SIMD_AVX_TARGET void INTD_func_vecStatsFloatAvx(const float *ptr, unsigned int pno, double *minVal, double *maxVal, double *sum, double *sumSq)
+{
+    unsigned int i = 0;
+    float  minf = ptr[0], maxf = ptr[0];
+    double s = 0.0, sq = 0.0;
+
+    float  fbuf[8];
+    double buf[4];
+    __m256  x;
+    __m256d d0, d1;
+    __m256  vmin = _mm256_set1_ps(ptr[0]), vmax = vmin;
+    __m256d vs0  = _mm256_setzero_pd(), vs1 = vs0, vq0 = vs0, vq1 = vs0;
+    unsigned int k;
+
+    for(; i + 8 <= pno; i += 8) {
+        x    = _mm256_loadu_ps(ptr + i);
+        vmin = _mm256_min_ps(vmin, x);
+        vmax = _mm256_max_ps(vmax, x);
+        d0   = _mm256_cvtps_pd(_mm256_castps256_ps128(x));
+        d1   = _mm256_cvtps_pd(_mm256_extractf128_ps(x, 1));
+        vs0  = _mm256_add_pd(vs0, d0);
+        vs1  = _mm256_add_pd(vs1, d1);
+        vq0  = _mm256_add_pd(vq0, _mm256_mul_pd(d0, d0));
+        vq1  = _mm256_add_pd(vq1, _mm256_mul_pd(d1, d1));
+    }
+
+    _mm256_storeu_ps(fbuf, vmin); for(k = 0; k < 8; k ++) if(fbuf[k] < minf) minf = fbuf[k];
+    _mm256_storeu_ps(fbuf, vmax); for(k = 0; k < 8; k ++) if(fbuf[k] > maxf) maxf = fbuf[k];
+    _mm256_storeu_pd(buf, _mm256_add_pd(vs0, vs1)); s  = buf[0] + buf[1] + buf[2] + buf[3];
+    _mm256_storeu_pd(buf, _mm256_add_pd(vq0, vq1)); sq = buf[0] + buf[1] + buf[2] + buf[3];
+
+    for(; i < pno; i ++) {
+        if(ptr[i] < minf) minf = ptr[i];
+        if(ptr[i] > maxf) maxf = ptr[i];
+        s  += (double)ptr[i];
+        sq += (double)ptr[i] * ptr[i];
+    }
+
+    *minVal = minf; *maxVal = maxf; *sum = s; *sumSq = sq;
+}
+
+/**
+ * Min and max of a double array, pno > 0 (AVX)
+ */
+static INTD_SIMD_AVX_TARGET void INTD_func_vecMinMaxDoubleAvx(const double *ptr, unsigned int pno, double *minVal, double *maxVal)
+{
+    unsigned int i = 0;
+    double minv = ptr[0], maxv = ptr[0];
+
+    double buf[4];
+    __m256d x0, x1;
+    __m256d vmin = _mm256_set1_pd(ptr[0]), vmax = vmin;
+
+    for(; i + 8 <= pno; i += 8) {
+        x0   = _mm256_loadu_pd(ptr + i);
+        x1   = _mm256_loadu_pd(ptr + i + 4);
+        vmin = _mm256_min_pd(vmin, _mm256_min_pd(x0, x1));
+        vmax = _mm256_max_pd(vmax, _mm256_max_pd(x0, x1));
+    }
+
+    _mm256_storeu_pd(buf, vmin); minv = buf[0]; if(buf[1] < minv) minv = buf[1]; if(buf[2] < minv) minv = buf[2]; if(buf[3] < minv) minv = buf[3];
+    _mm256_storeu_pd(buf, vmax); maxv = buf[0]; if(buf[1] > maxv) maxv = buf[1]; if(buf[2] > maxv) maxv = buf[2]; if(buf[3] > maxv) maxv = buf[3];
+
+    for(; i < pno; i ++) {
+        if(ptr[i] < minv) minv = ptr[i];
+        if(ptr[i] > maxv) maxv = ptr[i];
+    }
+
+    *minVal = minv; *maxVal = maxv;
+}
+
+/**
+ * Min and max of a float array, pno > 0 (AVX)
+ */
+static INTD_SIMD_AVX_TARGET void INTD_func_vecMinMaxFloatAvx(const float *ptr, unsigned int pno, double *minVal, double *maxVal)
+{
+    unsigned int i = 0;
+    float minf = ptr[0], maxf = ptr[0];
+
+    float fbuf[8];
+    unsigned int k;
+    __m256 x0, x1;
+    __m256 vmin = _mm256_set1_ps(ptr[0]), vmax = vmin;
+
+    for(; i + 16 <= pno; i += 16) {
+        x0   = _mm256_loadu_ps(ptr + i);
+        x1   = _mm256_loadu_ps(ptr + i + 8);
+        vmin = _mm256_min_ps(vmin, _mm256_min_ps(x0, x1));
+        vmax = _mm256_max_ps(vmax, _mm256_max_ps(x0, x1));
+    }
+
+    _mm256_storeu_ps(fbuf, vmin); for(k = 0; k < 8; k ++) if(fbuf[k] < minf) minf = fbuf[k];
+    _mm256_storeu_ps(fbuf, vmax); for(k = 0; k < 8; k ++) if(fbuf[k] > maxf) maxf = fbuf[k];
+
+    for(; i < pno; i ++) {
+        if(ptr[i] < minf) minf = ptr[i];
+        if(ptr[i] > maxf) maxf = ptr[i];
+    }
+
+    *minVal = minf; *maxVal = maxf;
+}
+
+/**
+ * Sum of a double array (AVX)
+ */
+static INTD_SIMD_AVX_TARGET double INTD_func_vecSumDoubleAvx(const double *ptr, unsigned int pno)
+{
+    unsigned int i = 0;
+    double s = 0.0;
+
+    double buf[4];
+    __m256d vs0 = _mm256_setzero_pd(), vs1 = vs0;
+
+    for(; i + 8 <= pno; i += 8) {
+        vs0 = _mm256_add_pd(vs0, _mm256_loadu_pd(ptr + i));
+        vs1 = _mm256_add_pd(vs1, _mm256_loadu_pd(ptr + i + 4));
+    }
+
+    _mm256_storeu_pd(buf, _mm256_add_pd(vs0, vs1)); s = buf[0] + buf[1] + buf[2] + buf[3];
+
+    for(; i < pno; i ++) s += ptr[i];
+
+    return s;
+}
+
+/**
+ * Sum of a float array, accumulated in double (AVX)
+ */
+static INTD_SIMD_AVX_TARGET double INTD_func_vecSumFloatAvx(const float *ptr, unsigned int pno)
+{
+    unsigned int i = 0;
+    double s = 0.0;
+
+    double buf[4];
+    __m256  x;
+    __m256d vs0 = _mm256_setzero_pd(), vs1 = vs0;
+
+    for(; i + 8 <= pno; i += 8) {
+        x   = _mm256_loadu_ps(ptr + i);
+        vs0 = _mm256_add_pd(vs0, _mm256_cvtps_pd(_mm256_castps256_ps128(x)));
+        vs1 = _mm256_add_pd(vs1, _mm256_cvtps_pd(_mm256_extractf128_ps(x, 1)));
+    }
+
+    _mm256_storeu_pd(buf, _mm256_add_pd(vs0, vs1)); s = buf[0] + buf[1] + buf[2] + buf[3];
+
+    for(; i < pno; i ++) s += (double)ptr[i];
+
+    return s;
+}
+
+/**
+ * Index of the first element equal to value in a double array, pno if not found (AVX)
+ */
+static INTD_SIMD_AVX_TARGET unsigned int INTD_func_vecFindDoubleAvx(const double *ptr, unsigned int pno, double value)
+{
+    unsigned int i = 0;
+
+    int mask;
+    __m256d v = _mm256_set1_pd(value);
+
+    for(; i + 4 <= pno; i += 4) {
+        mask = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(ptr + i), v, _CMP_EQ_OQ));
+        if(mask) break;
+    }
+
+    for(; i < pno; i ++)
+        if(ptr[i] == value) return i;
+
+    return pno;
+}
+
+/**
+ * Index of the first element equal to value in a float array, pno if not found (AVX)
+ */
+static INTD_SIMD_AVX_TARGET unsigned int INTD_func_vecFindFloatAvx(const float *ptr, unsigned int pno, float value)
+{
+    unsigned int i = 0;
+
+    int mask;
+    __m256 v = _mm256_set1_ps(value);
+
+    for(; i + 8 <= pno; i += 8) {
+        mask = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(ptr + i), v, _CMP_EQ_OQ));
+        if(mask) break;
+    }
+
+    for(; i < pno; i ++)
+        if(ptr[i] == value) return i;
+
+    return pno;
+}
+
+#endif
+
+/**
+ * Plain C conversion between all data types, the same loops as LocalPV and ChannelAccess used before. The
+ *   types are normalized (INTD_INT/INTD_UINT as INTD_LONG/INTD_ULONG)
+ */
+#define INTD_VEC_CVT_SCALAR(dtp, stp)                                                   \
+    {dtp *d = (dtp *)dst;                                                               \
+    const stp *s = (const stp *)src;                                                    \
+    for(i = 0; i < pno; i ++) d[i] = (dtp)s[i];}                                        \
+    break;
+
+#define INTD_VEC_CVT_SCALAR_FROM(stp)                                                   \
+    switch(dstType) {                                                                   \
+        case INTD_CHAR:     INTD_VEC_CVT_SCALAR(epicsInt8,    stp)                      \
+        case INTD_UCHAR:    INTD_VEC_CVT_SCALAR(epicsUInt8,   stp)                      \
+        case INTD_SHORT:    INTD_VEC_CVT_SCALAR(epicsInt16,   stp)                      \
+        case INTD_USHORT:   INTD_VEC_CVT_SCALAR(epicsUInt16,  stp)                      \
+        case INTD_LONG:     INTD_VEC_CVT_SCALAR(epicsInt32,   stp)                      \
+        case INTD_ULONG:    INTD_VEC_CVT_SCALAR(epicsUInt32,  stp)                      \
+        case INTD_FLOAT:    INTD_VEC_CVT_SCALAR(epicsFloat32, stp)                      \
+        case INTD_DOUBLE:   INTD_VEC_CVT_SCALAR(epicsFloat64, stp)                      \
+        default:            return -1;                                                  \
+    }                                                                                   \
+    break;
+
+static int INTD_func_vecConvertScalar(INTD_enum_dataType dstType, void *dst, INTD_enum_dataType srcType, const void *src, unsigned int pno)
+{
+    unsigned int i;
+
+    switch(srcType) {
+        case INTD_CHAR:     INTD_VEC_CVT_SCALAR_FROM(epicsInt8)
+        case INTD_UCHAR:    INTD_VEC_CVT_SCALAR_FROM(epicsUInt8)
+        case INTD_SHORT:    INTD_VEC_CVT_SCALAR_FROM(epicsInt16)
+        case INTD_USHORT:   INTD_VEC_CVT_SCALAR_FROM(epicsUInt16)
+        case INTD_LONG:     INTD_VEC_CVT_SCALAR_FROM(epicsInt32)
+        case INTD_ULONG:    INTD_VEC_CVT_SCALAR_FROM(epicsUInt32)
+        case INTD_FLOAT:    INTD_VEC_CVT_SCALAR_FROM(epicsFloat32)
+        case INTD_DOUBLE:   INTD_VEC_CVT_SCALAR_FROM(epicsFloat64)
+        default:            return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * Same type for the conversions, width of the integer types (0 for the others)
+ */
+static INTD_enum_dataType INTD_func_vecCvtType(INTD_enum_dataType dataType)
+{
+    if(dataType == INTD_INT)  return INTD_LONG;
+    if(dataType == INTD_UINT) return INTD_ULONG;
+    return dataType;
+}
+
+static unsigned int INTD_func_vecIntWidth(INTD_enum_dataType dataType)
+{
+    switch(dataType) {
+        case INTD_CHAR:
+        case INTD_UCHAR:    return 1;
+        case INTD_SHORT:
+        case INTD_USHORT:   return 2;
+        case INTD_LONG:
+        case INTD_ULONG:    return 4;
+        default:            return 0;
+    }
+}
+
+/**
+ * Vector conversion kernel, table of the kernels of one instruction set indexed by [dstType][srcType]
+ *   (normalized types, NULL for the pairs done by memcpy or the plain loops)
+ */
+typedef void (*INTD_VEC_CVT_FUNC)(void *dst, const void *src, unsigned int pno);
+typedef INTD_VEC_CVT_FUNC INTD_VEC_CVT_TABLE[INTD_OLDSTRING][INTD_OLDSTRING];
+
+#if defined(INTD_SIMD_SSE2)
+/**
+ * The conversions go through int32 lanes: the loader brings INTD_CVT_STEP source elements into INTD_CVT_REGS
+ *   registers of int32 (sign or zero extended integers, floats truncated like the C cast), the storer
+ *   converts them to the destination type (float/double, or the low bits for the narrower integers).
+ *   The signed and unsigned integers of the same width share the loaders and storers where the bits are
+ *   the same. The rest of the array is converted through a zero padded block, so the last elements give
+ *   the same result as the vector part
+ *
+ * Each instruction set defines INTD_CVT_TARGET, INTD_CVT_LANES, INTD_CVT_REGS, INTD_CVT_I32, the loaders
+ *   INTD_CVT_LD_*(v, p), the storers INTD_CVT_ST_*(d, v) and the float <-> double conversions before
+ *   INTD_VEC_CVT_KERNELS(isa), which defines the kernels and their table INTD_gvar_cvt<isa>
+ */
+#define INTD_CVT_STEP               (INTD_CVT_LANES * INTD_CVT_REGS)
+
+#define INTD_VEC_CVT(name, dtp, stp, ld, st)                                            \
+static INTD_CVT_TARGET void name(void *dstBuf, const void *srcBuf, unsigned int pno)    \
+{                                                                                       \
+    dtp *dst = (dtp *)dstBuf;                                                           \
+    const stp *src = (const stp *)srcBuf;                                               \
+    unsigned int i, vecEnd = pno - pno % INTD_CVT_STEP;                                 \
+    INTD_CVT_I32 v[INTD_CVT_REGS];                                                      \
+    stp srcTail[INTD_CVT_STEP];                                                         \
+    dtp dstTail[INTD_CVT_STEP];                                                         \
+                                                                                        \
+    for(i = 0; i < vecEnd; i += INTD_CVT_STEP) {                                        \
+        ld(v, src + i);                                                                 \
+        st(dst + i, v);                                                                 \
+    }                                                                                   \
+                                                                                        \
+    if(i < pno) {                                                                       \
+        memset(srcTail, 0, sizeof(srcTail));                                            \
+        memcpy(srcTail, src + i, (pno - i) * sizeof(stp));                              \
+        ld(v, srcTail);                                                                 \
+        st(dstTail, v);                                                                 \
+        memcpy(dst + i, dstTail, (pno - i) * sizeof(dtp));                              \
+    }                                                                                   \
+}
+
+#define INTD_VEC_CVT_FLT(name, dtp, stp, step, op)                                      \
+static INTD_CVT_TARGET void name(void *dstBuf, const void *srcBuf, unsigned int pno)    \
+{                                                                                       \
+    dtp *dst = (dtp *)dstBuf;                                                           \
+    const stp *src = (const stp *)srcBuf;                                               \
+    unsigned int i, vecEnd = pno - pno % (step);                                        \
+                                                                                        \
+    for(i = 0; i < vecEnd; i += (step))                                                 \
+        op(dst + i, src + i);                                                           \
+                                                                                        \
+    for(; i < pno; i ++) dst[i] = (dtp)src[i];                                          \
+}
+
+#define INTD_VEC_CVT_KERNELS(isa)                                                                               \
+INTD_VEC_CVT(INTD_func_cvtI8ToF64##isa,  epicsFloat64, epicsInt8,    INTD_CVT_LD_I8,   INTD_CVT_ST_F64)        \
+INTD_VEC_CVT(INTD_func_cvtU8ToF64##isa,  epicsFloat64, epicsUInt8,   INTD_CVT_LD_U8,   INTD_CVT_ST_F64)        \
+INTD_VEC_CVT(INTD_func_cvtI16ToF64##isa, epicsFloat64, epicsInt16,   INTD_CVT_LD_I16,  INTD_CVT_ST_F64)        \
+INTD_VEC_CVT(INTD_func_cvtU16ToF64##isa, epicsFloat64, epicsUInt16,  INTD_CVT_LD_U16,  INTD_CVT_ST_F64)        \
+INTD_VEC_CVT(INTD_func_cvtI32ToF64##isa, epicsFloat64, epicsInt32,   INTD_CVT_LD_I32,  INTD_CVT_ST_F64)        \
+INTD_VEC_CVT(INTD_func_cvtU32ToF64##isa, epicsFloat64, epicsUInt32,  INTD_CVT_LD_I32,  INTD_CVT_ST_F64U)       \
+INTD_VEC_CVT(INTD_func_cvtI8ToF32##isa,  epicsFloat32, epicsInt8,    INTD_CVT_LD_I8,   INTD_CVT_ST_F32)        \
+INTD_VEC_CVT(INTD_func_cvtU8ToF32##isa,  epicsFloat32, epicsUInt8,   INTD_CVT_LD_U8,   INTD_CVT_ST_F32)        \
+INTD_VEC_CVT(INTD_func_cvtI16ToF32##isa, epicsFloat32, epicsInt16,   INTD_CVT_LD_I16,  INTD_CVT_ST_F32)        \
+INTD_VEC_CVT(INTD_func_cvtU16ToF32##isa, epicsFloat32, epicsUInt16,  INTD_CVT_LD_U16,  INTD_CVT_ST_F32)        \
+INTD_VEC_CVT(INTD_func_cvtI32ToF32##isa, epicsFloat32, epicsInt32,   INTD_CVT_LD_I32,  INTD_CVT_ST_F32)        \
+INTD_VEC_CVT(INTD_func_cvtU32ToF32##isa, epicsFloat32, epicsUInt32,  INTD_CVT_LD_I32,  INTD_CVT_ST_F32U)       \
+INTD_VEC_CVT(INTD_func_cvtI8ToI32##isa,  epicsInt32,   epicsInt8,    INTD_CVT_LD_I8,   INTD_CVT_ST_I32)        \
+INTD_VEC_CVT(INTD_func_cvtU8ToI32##isa,  epicsInt32,   epicsUInt8,   INTD_CVT_LD_U8,   INTD_CVT_ST_I32)        \
+INTD_VEC_CVT(INTD_func_cvtI16ToI32##isa, epicsInt32,   epicsInt16,   INTD_CVT_LD_I16,  INTD_CVT_ST_I32)        \
+INTD_VEC_CVT(INTD_func_cvtU16ToI32##isa, epicsInt32,   epicsUInt16,  INTD_CVT_LD_U16,  INTD_CVT_ST_I32)        \
+INTD_VEC_CVT(INTD_func_cvtF32ToI32##isa, epicsInt32,   epicsFloat32, INTD_CVT_LD_F32,  INTD_CVT_ST_I32)        \
+INTD_VEC_CVT(INTD_func_cvtF64ToI32##isa, epicsInt32,   epicsFloat64, INTD_CVT_LD_F64,  INTD_CVT_ST_I32)        \
+INTD_VEC_CVT(INTD_func_cvtF32ToU32##isa, epicsUInt32,  epicsFloat32, INTD_CVT_LD_F32U, INTD_CVT_ST_I32)        \
+INTD_VEC_CVT(INTD_func_cvtF64ToU32##isa, epicsUInt32,  epicsFloat64, INTD_CVT_LD_F64U, INTD_CVT_ST_I32)        \
+INTD_VEC_CVT(INTD_func_cvtI8ToI16##isa,  epicsInt16,   epicsInt8,    INTD_CVT_LD_I8,   INTD_CVT_ST_I16)        \
+INTD_VEC_CVT(INTD_func_cvtU8ToI16##isa,  epicsInt16,   epicsUInt8,   INTD_CVT_LD_U8,   INTD_CVT_ST_I16)        \
+INTD_VEC_CVT(INTD_func_cvtI32ToI16##isa, epicsInt16,   epicsInt32,   INTD_CVT_LD_I32,  INTD_CVT_ST_I16)        \
+INTD_VEC_CVT(INTD_func_cvtF32ToI16##isa, epicsInt16,   epicsFloat32, INTD_CVT_LD_F32,  INTD_CVT_ST_I16)        \
+INTD_VEC_CVT(INTD_func_cvtF64ToI16##isa, epicsInt16,   epicsFloat64, INTD_CVT_LD_F64,  INTD_CVT_ST_I16)        \
+INTD_VEC_CVT(INTD_func_cvtI16ToI8##isa,  epicsInt8,    epicsInt16,   INTD_CVT_LD_I16,  INTD_CVT_ST_I8)         \
+INTD_VEC_CVT(INTD_func_cvtI32ToI8##isa,  epicsInt8,    epicsInt32,   INTD_CVT_LD_I32,  INTD_CVT_ST_I8)         \
+INTD_VEC_CVT(INTD_func_cvtF32ToI8##isa,  epicsInt8,    epicsFloat32, INTD_CVT_LD_F32,  INTD_CVT_ST_I8)         \
+INTD_VEC_CVT(INTD_func_cvtF64ToI8##isa,  epicsInt8,    epicsFloat64, INTD_CVT_LD_F64,  INTD_CVT_ST_I8)         \
+INTD_VEC_CVT_FLT(INTD_func_cvtF32ToF64##isa, epicsFloat64, epicsFloat32, INTD_CVT_FLT_STEP, INTD_CVT_F32_TO_F64) \
+INTD_VEC_CVT_FLT(INTD_func_cvtF64ToF32##isa, epicsFloat32, epicsFloat64, INTD_CVT_FLT_STEP, INTD_CVT_F64_TO_F32) \
+                                                                                                                \
+static const INTD_VEC_CVT_TABLE INTD_gvar_cvt##isa = {                                                          \
+    [INTD_DOUBLE] = {[INTD_CHAR]  = INTD_func_cvtI8ToF64##isa,  [INTD_UCHAR]  = INTD_func_cvtU8ToF64##isa,      \
+                     [INTD_SHORT] = INTD_func_cvtI16ToF64##isa, [INTD_USHORT] = INTD_func_cvtU16ToF64##isa,     \
+                     [INTD_LONG]  = INTD_func_cvtI32ToF64##isa, [INTD_ULONG]  = INTD_func_cvtU32ToF64##isa,     \
+                     [INTD_FLOAT] = INTD_func_cvtF32ToF64##isa},                                                \
+    [INTD_FLOAT]  = {[INTD_CHAR]  = INTD_func_cvtI8ToF32##isa,  [INTD_UCHAR]  = INTD_func_cvtU8ToF32##isa,      \
+                     [INTD_SHORT] = INTD_func_cvtI16ToF32##isa, [INTD_USHORT] = INTD_func_cvtU16ToF32##isa,     \
+                     [INTD_LONG]  = INTD_func_cvtI32ToF32##isa, [INTD_ULONG]  = INTD_func_cvtU32ToF32##isa,     \
+                     [INTD_DOUBLE] = INTD_func_cvtF64ToF32##isa},                                               \
+    [INTD_LONG]   = {[INTD_CHAR]  = INTD_func_cvtI8ToI32##isa,  [INTD_UCHAR]  = INTD_func_cvtU8ToI32##isa,      \
+                     [INTD_SHORT] = INTD_func_cvtI16ToI32##isa, [INTD_USHORT] = INTD_func_cvtU16ToI32##isa,     \
+                     [INTD_FLOAT] = INTD_func_cvtF32ToI32##isa, [INTD_DOUBLE] = INTD_func_cvtF64ToI32##isa},    \
+    [INTD_ULONG]  = {[INTD_CHAR]  = INTD_func_cvtI8ToI32##isa,  [INTD_UCHAR]  = INTD_func_cvtU8ToI32##isa,      \
+                     [INTD_SHORT] = INTD_func_cvtI16ToI32##isa, [INTD_USHORT] = INTD_func_cvtU16ToI32##isa,     \
+                     [INTD_FLOAT] = INTD_func_cvtF32ToU32##isa, [INTD_DOUBLE] = INTD_func_cvtF64ToU32##isa},    \
+    [INTD_SHORT]  = {[INTD_CHAR]  = INTD_func_cvtI8ToI16##isa,  [INTD_UCHAR]  = INTD_func_cvtU8ToI16##isa,      \
+                     [INTD_LONG]  = INTD_func_cvtI32ToI16##isa, [INTD_ULONG]  = INTD_func_cvtI32ToI16##isa,     \
+                     [INTD_FLOAT] = INTD_func_cvtF32ToI16##isa, [INTD_DOUBLE] = INTD_func_cvtF64ToI16##isa},    \
+    [INTD_USHORT] = {[INTD_CHAR]  = INTD_func_cvtI8ToI16##isa,  [INTD_UCHAR]  = INTD_func_cvtU8ToI16##isa,      \
+                     [INTD_LONG]  = INTD_func_cvtI32ToI16##isa, [INTD_ULONG]  = INTD_func_cvtI32ToI16##isa,     \
+                     [INTD_FLOAT] = INTD_func_cvtF32ToI16##isa, [INTD_DOUBLE] = INTD_func_cvtF64ToI16##isa},    \
+    [INTD_CHAR]   = {[INTD_SHORT] = INTD_func_cvtI16ToI8##isa,  [INTD_USHORT] = INTD_func_cvtI16ToI8##isa,      \
+                     [INTD_LONG]  = INTD_func_cvtI32ToI8##isa,  [INTD_ULONG]  = INTD_func_cvtI32ToI8##isa,      \
+                     [INTD_FLOAT] = INTD_func_cvtF32ToI8##isa,  [INTD_DOUBLE] = INTD_func_cvtF64ToI8##isa},     \
+    [INTD_UCHAR]  = {[INTD_SHORT] = INTD_func_cvtI16ToI8##isa,  [INTD_USHORT] = INTD_func_cvtI16ToI8##isa,      \
+                     [INTD_LONG]  = INTD_func_cvtI32ToI8##isa,  [INTD_ULONG]  = INTD_func_cvtI32ToI8##isa,      \
+                     [INTD_FLOAT] = INTD_func_cvtF32ToI8##isa,  [INTD_DOUBLE] = INTD_func_cvtF64ToI8##isa}      \
+};
+
+/*--------------------------------------
+ * SSE2, 2 registers of 4 int32 lanes
+ *--------------------------------------*/
+static void INTD_func_cvtLdI8(__m128i *v, const epicsInt8 *p)
+{
+    __m128i x = _mm_loadl_epi64((const __m128i *)p);
+    x = _mm_unpacklo_epi8(x, x);
+    v[0] = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 24);
+    v[1] = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 24);
+}
+
+static void INTD_func_cvtLdU8(__m128i *v, const epicsUInt8 *p)
+{
+    __m128i z = _mm_setzero_si128();
+    __m128i x = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)p), z);
+    v[0] = _mm_unpacklo_epi16(x, z);
+    v[1] = _mm_unpackhi_epi16(x, z);
+}
+
+static void INTD_func_cvtLdI16(__m128i *v, const epicsInt16 *p)
+{
+    __m128i x = _mm_loadu_si128((const __m128i *)p);
+    v[0] = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+    v[1] = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+}
+
+static void INTD_func_cvtLdU16(__m128i *v, const epicsUInt16 *p)
+{
+    __m128i z = _mm_setzero_si128();
+    __m128i x = _mm_loadu_si128((const __m128i *)p);
+    v[0] = _mm_unpacklo_epi16(x, z);
+    v[1] = _mm_unpackhi_epi16(x, z);
+}
+
+/* to uint32: the values from 2^31 are taken 2^32 lower, the low 32 bits are the same as the C cast */
+static __m128i INTD_func_cvtF32U(__m128 x)
+{
+    __m128 big = _mm_cmpge_ps(x, _mm_set1_ps(2147483648.0f));
+    return _mm_cvttps_epi32(_mm_sub_ps(x, _mm_and_ps(big, _mm_set1_ps(4294967296.0f))));
+}
+
+static __m128i INTD_func_cvtF64U(__m128d x)
+{
+    __m128d big = _mm_cmpge_pd(x, _mm_set1_pd(2147483648.0));
+    return _mm_cvttpd_epi32(_mm_sub_pd(x, _mm_and_pd(big, _mm_set1_pd(4294967296.0))));
+}
+
+/* from uint32: the high and low 16 bits are exact in float, the sum is rounded once like the C cast */
+static __m128 INTD_func_cvtU32F(__m128i v)
+{
+    return _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(v, 16)), _mm_set1_ps(65536.0f)),
+                      _mm_cvtepi32_ps(_mm_and_si128(v, _mm_set1_epi32(0xFFFF))));
+}
+
+static __m128d INTD_func_cvtU32D(__m128i v)
+{
+    __m128d x = _mm_cvtepi32_pd(v);
+    return _mm_add_pd(x, _mm_and_pd(_mm_cmplt_pd(x, _mm_setzero_pd()), _mm_set1_pd(4294967296.0)));
+}
+
+static void INTD_func_cvtStI8(epicsInt8 *d, const __m128i *v)
+{
+    __m128i m = _mm_set1_epi32(0xFF);
+    __m128i x = _mm_packs_epi32(_mm_and_si128(v[0], m), _mm_and_si128(v[1], m));
+    _mm_storel_epi64((__m128i *)d, _mm_packus_epi16(x, x));
+}
+
+#define INTD_CVT_TARGET
+#define INTD_CVT_LANES              4                               /* int32 lanes per register */
+#define INTD_CVT_REGS               2                               /* registers per step */
+#define INTD_CVT_I32                __m128i
+#define INTD_CVT_WRAP16(v)          _mm_srai_epi32(_mm_slli_epi32((v), 16), 16)
+#define INTD_CVT_LD_I8(v, p)        INTD_func_cvtLdI8((v), (p))
+#define INTD_CVT_LD_U8(v, p)        INTD_func_cvtLdU8((v), (p))
+#define INTD_CVT_LD_I16(v, p)       INTD_func_cvtLdI16((v), (p))
+#define INTD_CVT_LD_U16(v, p)       INTD_func_cvtLdU16((v), (p))
+#define INTD_CVT_LD_I32(v, p)       {(v)[0] = _mm_loadu_si128((const __m128i *)(p));                                    \
+                                     (v)[1] = _mm_loadu_si128((const __m128i *)(p) + 1);}
+#define INTD_CVT_LD_F32(v, p)       {(v)[0] = _mm_cvttps_epi32(_mm_loadu_ps(p));                                        \
+                                     (v)[1] = _mm_cvttps_epi32(_mm_loadu_ps((p) + 4));}
+#define INTD_CVT_LD_F64(v, p)       {(v)[0] = _mm_unpacklo_epi64(_mm_cvttpd_epi32(_mm_loadu_pd(p)),                     \
+                                                                 _mm_cvttpd_epi32(_mm_loadu_pd((p) + 2)));              \
+                                     (v)[1] = _mm_unpacklo_epi64(_mm_cvttpd_epi32(_mm_loadu_pd((p) + 4)),               \
+                                                                 _mm_cvttpd_epi32(_mm_loadu_pd((p) + 6)));}
+#define INTD_CVT_LD_F32U(v, p)      {(v)[0] = INTD_func_cvtF32U(_mm_loadu_ps(p));                                       \
+                                     (v)[1] = INTD_func_cvtF32U(_mm_loadu_ps((p) + 4));}
+#define INTD_CVT_LD_F64U(v, p)      {(v)[0] = _mm_unpacklo_epi64(INTD_func_cvtF64U(_mm_loadu_pd(p)),                    \
+                                                                 INTD_func_cvtF64U(_mm_loadu_pd((p) + 2)));             \
+                                     (v)[1] = _mm_unpacklo_epi64(INTD_func_cvtF64U(_mm_loadu_pd((p) + 4)),              \
+                                                                 INTD_func_cvtF64U(_mm_loadu_pd((p) + 6)));}
+#define INTD_CVT_ST_F32(d, v)       {_mm_storeu_ps((d),     _mm_cvtepi32_ps((v)[0]));                                   \
+                                     _mm_storeu_ps((d) + 4, _mm_cvtepi32_ps((v)[1]));}
+#define INTD_CVT_ST_F64(d, v)       {_mm_storeu_pd((d),     _mm_cvtepi32_pd((v)[0]));                                   \
+                                     _mm_storeu_pd((d) + 2, _mm_cvtepi32_pd(_mm_shuffle_epi32((v)[0], 0xEE)));          \
+                                     _mm_storeu_pd((d) + 4, _mm_cvtepi32_pd((v)[1]));                                   \
+                                     _mm_storeu_pd((d) + 6, _mm_cvtepi32_pd(_mm_shuffle_epi32((v)[1], 0xEE)));}
+#define INTD_CVT_ST_F32U(d, v)      {_mm_storeu_ps((d),     INTD_func_cvtU32F((v)[0]));                                 \
+                                     _mm_storeu_ps((d) + 4, INTD_func_cvtU32F((v)[1]));}
+#define INTD_CVT_ST_F64U(d, v)      {_mm_storeu_pd((d),     INTD_func_cvtU32D((v)[0]));                                 \
+                                     _mm_storeu_pd((d) + 2, INTD_func_cvtU32D(_mm_shuffle_epi32((v)[0], 0xEE)));        \
+                                     _mm_storeu_pd((d) + 4, INTD_func_cvtU32D((v)[1]));                                 \
+                                     _mm_storeu_pd((d) + 6, INTD_func_cvtU32D(_mm_shuffle_epi32((v)[1], 0xEE)));}
+#define INTD_CVT_ST_I32(d, v)       {_mm_storeu_si128((__m128i *)(d),     (v)[0]);                                      \
+                                     _mm_storeu_si128((__m128i *)(d) + 1, (v)[1]);}
+#define INTD_CVT_ST_I16(d, v)       _mm_storeu_si128((__m128i *)(d), _mm_packs_epi32(INTD_CVT_WRAP16((v)[0]), INTD_CVT_WRAP16((v)[1])))
+#define INTD_CVT_ST_I8(d, v)        INTD_func_cvtStI8((epicsInt8 *)(d), (v))
+#define INTD_CVT_FLT_STEP           4
+#define INTD_CVT_F32_TO_F64(d, s)   {__m128 x = _mm_loadu_ps(s);                                                        \
+                                     _mm_storeu_pd((d),     _mm_cvtps_pd(x));                                           \
+                                     _mm_storeu_pd((d) + 2, _mm_cvtps_pd(_mm_movehl_ps(x, x)));}
+#define INTD_CVT_F64_TO_F32(d, s)   _mm_storeu_ps((d), _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(s)), _mm_cvtpd_ps(_mm_loadu_pd((s) + 2))))
+
+INTD_VEC_CVT_KERNELS(Sse2)
+
+#undef INTD_CVT_TARGET
+#undef INTD_CVT_LANES
+#undef INTD_CVT_REGS
+#undef INTD_CVT_I32
+#undef INTD_CVT_WRAP16
+#undef INTD_CVT_LD_I8
+#undef INTD_CVT_LD_U8
+#undef INTD_CVT_LD_I16
+#undef INTD_CVT_LD_U16
+#undef INTD_CVT_LD_I32
+#undef INTD_CVT_LD_F32
+#undef INTD_CVT_LD_F64
+#undef INTD_CVT_LD_F32U
+#undef INTD_CVT_LD_F64U
+#undef INTD_CVT_ST_F32
+#undef INTD_CVT_ST_F64
+#undef INTD_CVT_ST_F32U
+#undef INTD_CVT_ST_F64U
+#undef INTD_CVT_ST_I32
+#undef INTD_CVT_ST_I16
+#undef INTD_CVT_ST_I8
+#undef INTD_CVT_FLT_STEP
+#undef INTD_CVT_F32_TO_F64
+#undef INTD_CVT_F64_TO_F32
+
+#if defined(INTD_SIMD_DISPATCH)
+/*--------------------------------------
+ * AVX2, 1 register of 8 int32 lanes
+ *--------------------------------------*/
+static INTD_SIMD_AVX2_TARGET __m256i INTD_func_cvtF32UAvx2(__m256 x)
+{
+    __m256 big = _mm256_cmp_ps(x, _mm256_set1_ps(2147483648.0f), _CMP_GE_OQ);
+    return _mm256_cvttps_epi32(_mm256_sub_ps(x, _mm256_and_ps(big, _mm256_set1_ps(4294967296.0f))));
+}
+
+static INTD_SIMD_AVX2_TARGET __m128i INTD_func_cvtF64UAvx2(__m256d x)
+{
+    __m256d big = _mm256_cmp_pd(x, _mm256_set1_pd(2147483648.0), _CMP_GE_OQ);
+    return _mm256_cvttpd_epi32(_mm256_sub_pd(x, _mm256_and_pd(big, _mm256_set1_pd(4294967296.0))));
+}
+
+static INTD_SIMD_AVX2_TARGET __m256 INTD_func_cvtU32FAvx2(__m256i v)
+{
+    return _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(v, 16)), _mm256_set1_ps(65536.0f)),
+                         _mm256_cvtepi32_ps(_mm256_and_si256(v, _mm256_set1_epi32(0xFFFF))));
+}
+
+static INTD_SIMD_AVX2_TARGET __m256d INTD_func_cvtU32DAvx2(__m128i v)
+{
+    __m256d x = _mm256_cvtepi32_pd(v);
+    return _mm256_add_pd(x, _mm256_and_pd(_mm256_cmp_pd(x, _mm256_setzero_pd(), _CMP_LT_OQ), _mm256_set1_pd(4294967296.0)));
+}
+
+static INTD_SIMD_AVX2_TARGET void INTD_func_cvtStI16Avx2(epicsInt16 *d, __m256i v)
+{
+    __m256i w = _mm256_srai_epi32(_mm256_slli_epi32(v, 16), 16);
+    _mm_storeu_si128((__m128i *)d, _mm_packs_epi32(_mm256_castsi256_si128(w), _mm256_extracti128_si256(w, 1)));
+}
+
+static INTD_SIMD_AVX2_TARGET void INTD_func_cvtStI8Avx2(epicsInt8 *d, __m256i v)
+{
+    __m256i w = _mm256_and_si256(v, _mm256_set1_epi32(0xFF));
+    __m128i x = _mm_packs_epi32(_mm256_castsi256_si128(w), _mm256_extracti128_si256(w, 1));
+    _mm_storel_epi64((__m128i *)d, _mm_packus_epi16(x, x));
+}
+
+#define INTD_CVT_TARGET             INTD_SIMD_AVX2_TARGET
+#define INTD_CVT_LANES              8
+#define INTD_CVT_REGS               1
+#define INTD_CVT_I32                __m256i
+#define INTD_CVT_LD_I8(v, p)        (v)[0] = _mm256_cvtepi8_epi32 (_mm_loadl_epi64((const __m128i *)(p)))
+#define INTD_CVT_LD_U8(v, p)        (v)[0] = _mm256_cvtepu8_epi32 (_mm_loadl_epi64((const __m128i *)(p)))
+#define INTD_CVT_LD_I16(v, p)       (v)[0] = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(p)))
+#define INTD_CVT_LD_U16(v, p)       (v)[0] = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(p)))
+#define INTD_CVT_LD_I32(v, p)       (v)[0] = _mm256_loadu_si256((const __m256i *)(p))
+#define INTD_CVT_LD_F32(v, p)       (v)[0] = _mm256_cvttps_epi32(_mm256_loadu_ps(p))
+#define INTD_CVT_LD_F64(v, p)       (v)[0] = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm256_cvttpd_epi32(_mm256_loadu_pd(p))), \
+                                                                     _mm256_cvttpd_epi32(_mm256_loadu_pd((p) + 4)), 1)
+#define INTD_CVT_LD_F32U(v, p)      (v)[0] = INTD_func_cvtF32UAvx2(_mm256_loadu_ps(p))
+#define INTD_CVT_LD_F64U(v, p)      (v)[0] = _mm256_inserti128_si256(_mm256_castsi128_si256(INTD_func_cvtF64UAvx2(_mm256_loadu_pd(p))), \
+                                                                     INTD_func_cvtF64UAvx2(_mm256_loadu_pd((p) + 4)), 1)
+#define INTD_CVT_ST_F32(d, v)       _mm256_storeu_ps((d), _mm256_cvtepi32_ps((v)[0]))
+#define INTD_CVT_ST_F64(d, v)       {_mm256_storeu_pd((d),     _mm256_cvtepi32_pd(_mm256_castsi256_si128((v)[0])));     \
+                                     _mm256_storeu_pd((d) + 4, _mm256_cvtepi32_pd(_mm256_extracti128_si256((v)[0], 1)));}
+#define INTD_CVT_ST_F32U(d, v)      _mm256_storeu_ps((d), INTD_func_cvtU32FAvx2((v)[0]))
+#define INTD_CVT_ST_F64U(d, v)      {_mm256_storeu_pd((d),     INTD_func_cvtU32DAvx2(_mm256_castsi256_si128((v)[0])));  \
+                                     _mm256_storeu_pd((d) + 4, INTD_func_cvtU32DAvx2(_mm256_extracti128_si256((v)[0], 1)));}
+#define INTD_CVT_ST_I32(d, v)       _mm256_storeu_si256((__m256i *)(d), (v)[0])
+#define INTD_CVT_ST_I16(d, v)       INTD_func_cvtStI16Avx2((epicsInt16 *)(d), (v)[0])
+#define INTD_CVT_ST_I8(d, v)        INTD_func_cvtStI8Avx2((epicsInt8 *)(d), (v)[0])
+#define INTD_CVT_FLT_STEP           4
+#define INTD_CVT_F32_TO_F64(d, s)   _mm256_storeu_pd((d), _mm256_cvtps_pd(_mm_loadu_ps(s)))
+#define INTD_CVT_F64_TO_F32(d, s)   _mm_storeu_ps((d), _mm256_cvtpd_ps(_mm256_loadu_pd(s)))
+
+INTD_VEC_CVT_KERNELS(Avx2)
+
+#undef INTD_CVT_TARGET
+#undef INTD_CVT_LANES
+#undef INTD_CVT_REGS
+#undef INTD_CVT_I32
+#undef INTD_CVT_LD_I8
+#undef INTD_CVT_LD_U8
+#undef INTD_CVT_LD_I16
+#undef INTD_CVT_LD_U16
+#undef INTD_CVT_LD_I32
+#undef INTD_CVT_LD_F32
+#undef INTD_CVT_LD_F64
+#undef INTD_CVT_LD_F32U
+#undef INTD_CVT_LD_F64U
+#undef INTD_CVT_ST_F32
+#undef INTD_CVT_ST_F64
+#undef INTD_CVT_ST_F32U
+#undef INTD_CVT_ST_F64U
+#undef INTD_CVT_ST_I32
+#undef INTD_CVT_ST_I16
+#undef INTD_CVT_ST_I8
+#undef INTD_CVT_FLT_STEP
+#undef INTD_CVT_F32_TO_F64
+#undef INTD_CVT_F64_TO_F32
+
+/*--------------------------------------
+ * AVX-512, 1 register of 16 int32 lanes
+ *--------------------------------------*/
+static INTD_SIMD_AVX512_TARGET __m512i INTD_func_cvtF32UAvx512(__m512 x)
+{
+    __mmask16 big = _mm512_cmp_ps_mask(x, _mm512_set1_ps(2147483648.0f), _CMP_GE_OQ);
+    return _mm512_cvttps_epi32(_mm512_mask_sub_ps(x, big, x, _mm512_set1_ps(4294967296.0f)));
+}
+
+static INTD_SIMD_AVX512_TARGET __m256i INTD_func_cvtF64UAvx512(__m512d x)
+{
+    __mmask8 big = _mm512_cmp_pd_mask(x, _mm512_set1_pd(2147483648.0), _CMP_GE_OQ);
+    return _mm512_cvttpd_epi32(_mm512_mask_sub_pd(x, big, x, _mm512_set1_pd(4294967296.0)));
+}
+
+#define INTD_CVT_TARGET             INTD_SIMD_AVX512_TARGET
+#define INTD_CVT_LANES              16
+#define INTD_CVT_REGS               1
+#define INTD_CVT_I32                __m512i
+#define INTD_CVT_LD_I8(v, p)        (v)[0] = _mm512_cvtepi8_epi32 (_mm_loadu_si128((const __m128i *)(p)))
+#define INTD_CVT_LD_U8(v, p)        (v)[0] = _mm512_cvtepu8_epi32 (_mm_loadu_si128((const __m128i *)(p)))
+#define INTD_CVT_LD_I16(v, p)       (v)[0] = _mm512_cvtepi16_epi32(_mm256_loadu_si256((const __m256i *)(p)))
+#define INTD_CVT_LD_U16(v, p)       (v)[0] = _mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i *)(p)))
+#define INTD_CVT_LD_I32(v, p)       (v)[0] = _mm512_loadu_si512((const void *)(p))
+#define INTD_CVT_LD_F32(v, p)       (v)[0] = _mm512_cvttps_epi32(_mm512_loadu_ps(p))
+#define INTD_CVT_LD_F64(v, p)       (v)[0] = _mm512_inserti64x4(_mm512_castsi256_si512(_mm512_cvttpd_epi32(_mm512_loadu_pd(p))), \
+                                                                _mm512_cvttpd_epi32(_mm512_loadu_pd((p) + 8)), 1)
+#define INTD_CVT_LD_F32U(v, p)      (v)[0] = INTD_func_cvtF32UAvx512(_mm512_loadu_ps(p))
+#define INTD_CVT_LD_F64U(v, p)      (v)[0] = _mm512_inserti64x4(_mm512_castsi256_si512(INTD_func_cvtF64UAvx512(_mm512_loadu_pd(p))), \
+                                                                INTD_func_cvtF64UAvx512(_mm512_loadu_pd((p) + 8)), 1)
+#define INTD_CVT_ST_F32(d, v)       _mm512_storeu_ps((d), _mm512_cvtepi32_ps((v)[0]))
+#define INTD_CVT_ST_F64(d, v)       {_mm512_storeu_pd((d),     _mm512_cvtepi32_pd(_mm512_castsi512_si256((v)[0])));     \
+                                     _mm512_storeu_pd((d) + 8, _mm512_cvtepi32_pd(_mm512_extracti64x4_epi64((v)[0], 1)));}
+#define INTD_CVT_ST_F32U(d, v)      _mm512_storeu_ps((d), _mm512_cvtepu32_ps((v)[0]))
+#define INTD_CVT_ST_F64U(d, v)      {_mm512_storeu_pd((d),     _mm512_cvtepu32_pd(_mm512_castsi512_si256((v)[0])));     \
+                                     _mm512_storeu_pd((d) + 8, _mm512_cvtepu32_pd(_mm512_extracti64x4_epi64((v)[0], 1)));}
+#define INTD_CVT_ST_I32(d, v)       _mm512_storeu_si512((void *)(d), (v)[0])
+#define INTD_CVT_ST_I16(d, v)       _mm256_storeu_si256((__m256i *)(d), _mm512_cvtepi32_epi16((v)[0]))
+#define INTD_CVT_ST_I8(d, v)        _mm_storeu_si128((__m128i *)(d), _mm512_cvtepi32_epi8((v)[0]))
+#define INTD_CVT_FLT_STEP           8
+#define INTD_CVT_F32_TO_F64(d, s)   _mm512_storeu_pd((d), _mm512_cvtps_pd(_mm256_loadu_ps(s)))
+#define INTD_CVT_F64_TO_F32(d, s)   _mm256_storeu_ps((d), _mm512_cvtpd_ps(_mm512_loadu_pd(s)))
+
+INTD_VEC_CVT_KERNELS(Avx512)
+#endif
+#endif
+
+/*--------------------------------------
+ * Selection of the kernels
+ *--------------------------------------*/
+/**
+ * Kernels selected for the CPU, the float/double kernels and the conversions separately (AVX-512 only
+ *   helps the conversions). Selected once at the first call
+ */
+typedef struct {
+    const char  *isa;                                               /* float/double kernels */
+    const char  *cvtIsa;                                            /* conversions */
+    void         (*statsDouble) (const double *ptr, unsigned int pno, double *minVal, double *maxVal, double *sum, double *sumSq);
+    void         (*statsFloat)  (const float  *ptr, unsigned int pno, double *minVal, double *maxVal, double *sum, double *sumSq);
+    void         (*minMaxDouble)(const double *ptr, unsigned int pno, double *minVal, double *maxVal);
+    void         (*minMaxFloat) (const float  *ptr, unsigned int pno, double *minVal, double *maxVal);
+    double       (*sumDouble)   (const double *ptr, unsigned int pno);
+    double       (*sumFloat)    (const float  *ptr, unsigned int pno);
+    unsigned int (*findDouble)  (const double *ptr, unsigned int pno, double value);
+    unsigned int (*findFloat)   (const float  *ptr, unsigned int pno, float  value);
+    const INTD_VEC_CVT_TABLE *cvt;                                  /* NULL for the plain loops */
+} INTD_struc_vecKernels;
+
+static INTD_struc_vecKernels INTD_gvar_vecKernels;
+static int                   INTD_gvar_vecReady   = 0;
+static epicsThreadOnceId     INTD_gvar_vecOnce    = EPICS_THREAD_ONCE_INIT;
+
+static void INTD_func_vecInit(void *arg)
+{
+    INTD_struc_vecKernels *k = &INTD_gvar_vecKernels;
+
+#if defined(INTD_SIMD_SSE2)
+    k -> isa    = "SSE2";
+    k -> cvtIsa = "SSE2";
+    k -> cvt    = &INTD_gvar_cvtSse2;
+#else
+    k -> isa    = "scalar";
+    k -> cvtIsa = "scalar";
+    k -> cvt    = NULL;
+#endif
+
+    k -> statsDouble  = INTD_func_vecStatsDouble;
+    k -> statsFloat   = INTD_func_vecStatsFloat;
+    k -> minMaxDouble = INTD_func_vecMinMaxDouble;
+    k -> minMaxFloat  = INTD_func_vecMinMaxFloat;
+    k -> sumDouble    = INTD_func_vecSumDouble;
+    k -> sumFloat     = INTD_func_vecSumFloat;
+    k -> findDouble   = INTD_func_vecFindDouble;
+    k -> findFloat    = INTD_func_vecFindFloat;
+
+#if defined(INTD_SIMD_DISPATCH)
+    __builtin_cpu_init();
+
+    if(__builtin_cpu_supports("avx")) {
+        k -> isa          = "AVX";
+        k -> statsDouble  = INTD_func_vecStatsDoubleAvx;
+        k -> statsFloat   = INTD_func_vecStatsFloatAvx;
+        k -> minMaxDouble = INTD_func_vecMinMaxDoubleAvx;
+        k -> minMaxFloat  = INTD_func_vecMinMaxFloatAvx;
+        k -> sumDouble    = INTD_func_vecSumDoubleAvx;
+        k -> sumFloat     = INTD_func_vecSumFloatAvx;
+        k -> findDouble   = INTD_func_vecFindDoubleAvx;
+        k -> findFloat    = INTD_func_vecFindFloatAvx;
+    }
+
+    if(__builtin_cpu_supports("avx512f")) {
+        k -> cvtIsa = "AVX-512";
+        k -> cvt    = &INTD_gvar_cvtAvx512;
+    } else if(__builtin_cpu_supports("avx2")) {
+        k -> cvtIsa = "AVX2";
+        k -> cvt    = &INTD_gvar_cvtAvx2;
+    }
+#endif
+
+    epicsAtomicSetIntT(&INTD_gvar_vecReady, 1);
+}
+
+static const INTD_struc_vecKernels *INTD_func_vecKernels(void)
+{
+    if(!epicsAtomicGetIntT(&INTD_gvar_vecReady))
+        epicsThreadOnce(&INTD_gvar_vecOnce, INTD_func_vecInit, NULL);
+
+    return &INTD_gvar_vecKernels;
+}
+
+/**
+ * Conversion with a table of kernels, the pairs without a kernel use the plain loops
+ */
+static int INTD_func_vecConvertWith(const INTD_VEC_CVT_TABLE *cvt, INTD_enum_dataType dstType, void *dst, INTD_enum_dataType srcType, const void *src, unsigned int pno)
+{
+    unsigned int width;
+
+    dstType = INTD_func_vecCvtType(dstType);
+    srcType = INTD_func_vecCvtType(srcType);
+
+    /* the integers of the same width only differ in the interpretation */
+    if(dstType == srcType || ((width = INTD_func_vecIntWidth(dstType)) != 0 && width == INTD_func_vecIntWidth(srcType))) {
+        switch(dstType) {
+            case INTD_FLOAT:    width = sizeof(epicsFloat32); break;
+            case INTD_DOUBLE:   width = sizeof(epicsFloat64); break;
+            default:            width = INTD_func_vecIntWidth(dstType); break;
+        }
+
+        if(width == 0) return -1;
+
+        memcpy(dst, src, (size_t)pno * width);
+        return 0;
+    }
+
+    if(cvt && (unsigned int)dstType < INTD_OLDSTRING && (unsigned int)srcType < INTD_OLDSTRING && (*cvt)[dstType][srcType]) {
+        (*cvt)[dstType][srcType](dst, src, pno);
+        return 0;
+    }
+
+    return INTD_func_vecConvertScalar(dstType, dst, srcType, src, pno);
+}
+
+/*======================================
+ * Public Routines
+ *======================================*/
+/**
+ * Name of the instruction set used by the float/double kernels
+ */
+const char *INTD_API_vecIsa()
+{
+    return INTD_func_vecKernels() -> isa;
+}
+
+/**
+ * Min, max, sum and sum of squares of an array in one pass
+ * Input:
+ *   dataType       : Type of the elements
+ *   data           : The array
+ *   pno            : Number of elements, larger than 0
+ * Output:
+ *   minVal, maxVal, sum, sumSq
+ * Return:
+ *   0              : Successful
+ *  -1              : Failed
+ */
+int INTD_API_vecStats(INTD_enum_dataType dataType, const void *data, unsigned int pno, double *minVal, double *maxVal, double *sum, double *sumSq)
+{
+    unsigned int i;
+
+    if(!data || pno == 0 || !minVal || !maxVal || !sum || !sumSq) return -1;
+
+    switch(dataType) {
+        case INTD_DOUBLE:   INTD_func_vecKernels() -> statsDouble((const double *)data, pno, minVal, maxVal, sum, sumSq); break;
+        case INTD_FLOAT:    INTD_func_vecKernels() -> statsFloat ((const float  *)data, pno, minVal, maxVal, sum, sumSq); break;
+        case INTD_CHAR:     INTD_VEC_STATS_SCALAR(epicsInt8);   break;
+        case INTD_UCHAR:    INTD_VEC_STATS_SCALAR(epicsUInt8);  break;
+        case INTD_SHORT:    INTD_VEC_STATS_SCALAR(epicsInt16);  break;
+        case INTD_USHORT:   INTD_VEC_STATS_SCALAR(epicsUInt16); break;
+        case INTD_INT:
+        case INTD_LONG:     INTD_VEC_STATS_SCALAR(epicsInt32);  break;
+        case INTD_UINT:
+        case INTD_ULONG:    INTD_VEC_STATS_SCALAR(epicsUInt32); break;
+        default:            return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * Min and max of an array, pno > 0
+ */
+int INTD_API_vecMinMax(INTD_enum_dataType dataType, const void *data, unsigned int pno, double *minVal, double *maxVal)
+{
+    unsigned int i;
+
+    if(!data || pno == 0 || !minVal || !maxVal) return -1;
+
+    switch(dataType) {
+        case INTD_DOUBLE:   INTD_func_vecKernels() -> minMaxDouble((const double *)data, pno, minVal, maxVal); break;
+        case INTD_FLOAT:    INTD_func_vecKernels() -> minMaxFloat ((const float  *)data, pno, minVal, maxVal); break;
+        case INTD_CHAR:     INTD_VEC_MINMAX_SCALAR(epicsInt8);   break;
+        case INTD_UCHAR:    INTD_VEC_MINMAX_SCALAR(epicsUInt8);  break;
+        case INTD_SHORT:    INTD_VEC_MINMAX_SCALAR(epicsInt16);  break;
+        case INTD_USHORT:   INTD_VEC_MINMAX_SCALAR(epicsUInt16); break;
+        case INTD_INT:
+        case INTD_LONG:     INTD_VEC_MINMAX_SCALAR(epicsInt32);  break;
+        case INTD_UINT:
+        case INTD_ULONG:    INTD_VEC_MINMAX_SCALAR(epicsUInt32); break;
+        default:            return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * Sum of an array (0 for the unsupported types)
+ */
+double INTD_API_vecSum(INTD_enum_dataType dataType, const void *data, unsigned int pno)
+{
+    unsigned int i;
+
+    if(!data) return 0.0;
+
+    switch(dataType) {
+        case INTD_DOUBLE:   return INTD_func_vecKernels() -> sumDouble((const double *)data, pno);
+        case INTD_FLOAT:    return INTD_func_vecKernels() -> sumFloat ((const float  *)data, pno);
+        case INTD_CHAR:     INTD_VEC_SUM_SCALAR(epicsInt8);
+        case INTD_UCHAR:    INTD_VEC_SUM_SCALAR(epicsUInt8);
+        case INTD_SHORT:    INTD_VEC_SUM_SCALAR(epicsInt16);
+        case INTD_USHORT:   INTD_VEC_SUM_SCALAR(epicsUInt16);
+        case INTD_INT:
+        case INTD_LONG:     INTD_VEC_SUM_SCALAR(epicsInt32);
+        case INTD_UINT:
+        case INTD_ULONG:    INTD_VEC_SUM_SCALAR(epicsUInt32);
+        default:            return 0.0;
+    }
+}
+
+/**
+ * Index of the first element of the array equal to value, pno if not found
+ */
+unsigned int INTD_API_vecFind(INTD_enum_dataType dataType, const void *data, unsigned int pno, double value)
+{
+    unsigned int i;
+
+    if(!data) return pno;
+
+    switch(dataType) {
+        case INTD_DOUBLE:   return INTD_func_vecKernels() -> findDouble((const double *)data, pno, value);
+        case INTD_FLOAT:    return INTD_func_vecKernels() -> findFloat ((const float  *)data, pno, (float)value);
+        case INTD_CHAR:     INTD_VEC_FIND_SCALAR(epicsInt8);
+        case INTD_UCHAR:    INTD_VEC_FIND_SCALAR(epicsUInt8);
+        case INTD_SHORT:    INTD_VEC_FIND_SCALAR(epicsInt16);
+        case INTD_USHORT:   INTD_VEC_FIND_SCALAR(epicsUInt16);
+        case INTD_INT:
+        case INTD_LONG:     INTD_VEC_FIND_SCALAR(epicsInt32);
+        case INTD_UINT:
+        case INTD_ULONG:    INTD_VEC_FIND_SCALAR(epicsUInt32);
+        default:            return pno;
+    }
+}
+
+/**
+ * Convert an array between the data types, same result as the C cast of each element (float to integer is
+ *   truncated, the integers keep the low bits)
+ * Input:
+ *   dstType, dst   : Type and buffer of the result
+ *   srcType, src   : Type and buffer of the source, must not overlap with dst
+ *   pno            : Number of elements
+ * Return:
+ *   0              : Successful
+ *  -1              : Failed (e.g. INTD_OLDSTRING)
+ */
+int INTD_API_vecConvert(INTD_enum_dataType dstType, void *dst, INTD_enum_dataType srcType, const void *src, unsigned int pno)
+{
+    if(!dst || !src) return -1;
+    if(pno == 0)     return 0;
+
+    return INTD_func_vecConvertWith(INTD_func_vecKernels() -> cvt, dstType, dst, srcType, src, pno);
+}
+
+/**
+ * Compare the vector conversions of each instruction set supported by the CPU with the plain C loops for
+ *   the waveform sizes of the application. The results must be bit-identical
+ * Input:
+ *   pno            : Number of elements
+ *   loops          : Number of conversions timed per type pair
+ */
+void INTD_API_vecBenchmark(unsigned int pno, unsigned int loops)
+{
+    static const struct {
+        INTD_enum_dataType dstType, srcType;
+        const char *name;
+    } pairs[] = {
+        {INTD_DOUBLE, INTD_CHAR,   "char   -> double"},
+        {INTD_DOUBLE, INTD_UCHAR,  "uchar  -> double"},
+        {INTD_DOUBLE, INTD_SHORT,  "short  -> double"},
+        {INTD_DOUBLE, INTD_USHORT, "ushort -> double"},
+        {INTD_DOUBLE, INTD_LONG,   "long   -> double"},
+        {INTD_DOUBLE, INTD_ULONG,  "ulong  -> double"},
+        {INTD_DOUBLE, INTD_FLOAT,  "float  -> double"},
+        {INTD_FLOAT,  INTD_CHAR,   "char   -> float"},
+        {INTD_FLOAT,  INTD_SHORT,  "short  -> float"},
+        {INTD_FLOAT,  INTD_USHORT, "ushort -> float"},
+        {INTD_FLOAT,  INTD_LONG,   "long   -> float"},
+        {INTD_FLOAT,  INTD_ULONG,  "ulong  -> float"},
+        {INTD_FLOAT,  INTD_DOUBLE, "double -> float"},
+        {INTD_LONG,   INTD_DOUBLE, "double -> long"},
+        {INTD_LONG,   INTD_FLOAT,  "float  -> long"},
+        {INTD_LONG,   INTD_SHORT,  "short  -> long"},
+        {INTD_LONG,   INTD_UCHAR,  "uchar  -> long"},
+        {INTD_ULONG,  INTD_DOUBLE, "double -> ulong"},
+        {INTD_ULONG,  INTD_FLOAT,  "float  -> ulong"},
+        {INTD_SHORT,  INTD_DOUBLE, "double -> short"},
+        {INTD_SHORT,  INTD_FLOAT,  "float  -> short"},
+        {INTD_SHORT,  INTD_LONG,   "long   -> short"},
+        {INTD_USHORT, INTD_DOUBLE, "double -> ushort"},
+        {INTD_SHORT,  INTD_CHAR,   "char   -> short"},
+        {INTD_CHAR,   INTD_DOUBLE, "double -> char"},
+        {INTD_UCHAR,  INTD_FLOAT,  "float  -> uchar"},
+        {INTD_CHAR,   INTD_LONG,   "long   -> char"},
+        {INTD_UCHAR,  INTD_SHORT,  "short  -> uchar"}
+    };
+
+    /* the instruction sets to compare, the ones not supported by the CPU are skipped */
+    struct {
+        const char *name;
+        const INTD_VEC_CVT_TABLE *cvt;
+    } isas[3];
+
+    unsigned int i, j, k, n, isaNum = 0;
+    int match;
+    double val, timeScalar, timeVec;
+    void *src, *dstScalar, *dstVec;
+    epicsTimeStamp start, end;
+
+#if defined(INTD_SIMD_SSE2)
+    isas[isaNum].name = "SSE2";    isas[isaNum].cvt = &INTD_gvar_cvtSse2;   isaNum ++;
+#endif
+#if defined(INTD_SIMD_DISPATCH)
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2"))    {isas[isaNum].name = "AVX2";    isas[isaNum].cvt = &INTD_gvar_cvtAvx2;   isaNum ++;}
+    if(__builtin_cpu_supports("avx512f")) {isas[isaNum].name = "AVX-512"; isas[isaNum].cvt = &INTD_gvar_cvtAvx512; isaNum ++;}
+#endif
+
+    if(pno == 0)   pno   = 4096;
+    if(loops == 0) loops = 1000;
+
+    src       = malloc((size_t)pno * sizeof(epicsFloat64));
+    dstScalar = malloc((size_t)pno * sizeof(epicsFloat64));
+    dstVec    = malloc((size_t)pno * sizeof(epicsFloat64));
+
+    if(!src || !dstScalar || !dstVec) {
+        printf("INTD_API_vecBenchmark: Failed to allocate memory\n");
+        free(src); free(dstScalar); free(dstVec);
+        return;
+    }
+
+    printf("INTD vector conversions (selected %s), %u points, %u loops, time in us:\n", INTD_func_vecKernels() -> cvtIsa, pno, loops);
+
+    for(i = 0; i < sizeof(pairs) / sizeof(pairs[0]); i ++) {
+        /* values beyond the range of the 8/16-bit results to check the wrap around, some in [2^31, 2^32) for ulong */
+        for(j = 0; j < pno; j ++) {
+            val = (double)((int)(j * 7919u % 200003u) - 100001) * 0.75;
+            switch(pairs[i].srcType) {
+                case INTD_CHAR:     ((epicsInt8    *)src)[j] = (epicsInt8)(j * 37u);                  break;
+                case INTD_UCHAR:    ((epicsUInt8   *)src)[j] = (epicsUInt8)(j * 37u);                 break;
+                case INTD_SHORT:    ((epicsInt16   *)src)[j] = (epicsInt16)(j * 7919u);               break;
+                case INTD_USHORT:   ((epicsUInt16  *)src)[j] = (epicsUInt16)(j * 7919u);              break;
+                case INTD_LONG:     ((epicsInt32   *)src)[j] = (epicsInt32)(val * 3.0);               break;
+                case INTD_ULONG:    ((epicsUInt32  *)src)[j] = (epicsUInt32)(j * 2654435761u);        break;
+                case INTD_FLOAT:    ((epicsFloat32 *)src)[j] = (epicsFloat32)(j % 5 ? val : val * 20000.0 + 2147483648.0); break;
+                default:            ((epicsFloat64 *)src)[j] = j % 5 ? val : val * 20000.0 + 2147483648.0;                 break;
+            }
+        }
+
+        /* the first run checks the results and warms up the caches for both */
+        memset(dstScalar, 0, (size_t)pno * sizeof(epicsFloat64));
+        INTD_func_vecConvertScalar(pairs[i].dstType, dstScalar, pairs[i].srcType, src, pno);
+
+        /* both timed into the same buffer, the distance to the source changes the timing (4k aliasing) */
+        epicsTimeGetCurrent(&start);
+        for(k = 0; k < loops; k ++)
+            INTD_func_vecConvertScalar(pairs[i].dstType, dstVec, pairs[i].srcType, src, pno);
+        epicsTimeGetCurrent(&end);
+        timeScalar = epicsTimeDiffInSeconds(&end, &start);
+
+        printf("    %s: loop %8.3f", pairs[i].name, timeScalar * 1e6 / loops);
+
+        for(n = 0; n < isaNum; n ++) {
+            memset(dstVec, 0, (size_t)pno * sizeof(epicsFloat64));
+            INTD_func_vecConvertWith(isas[n].cvt, pairs[i].dstType, dstVec, pairs[i].srcType, src, pno);
+            match = memcmp(dstScalar, dstVec, (size_t)pno * sizeof(epicsFloat64)) == 0;
+
+            epicsTimeGetCurrent(&start);
+            for(k = 0; k < loops; k ++)
+                INTD_func_vecConvertWith(isas[n].cvt, pairs[i].dstType, dstVec, pairs[i].srcType, src, pno);
+            epicsTimeGetCurrent(&end);
+            timeVec = epicsTimeDiffInSeconds(&end, &start);
+
+            printf(", %s %8.3f (x%5.2f)%s", isas[n].name, timeVec * 1e6 / loops,
+                   timeVec > 0.0 ? timeScalar / timeVec : 0.0, match ? "" : " MISMATCH");
+        }
+
+        printf("\n");
+    }
+
+    free(src);
+    free(dstScalar);
+    free(dstVec);
+}
@@ -0,0 +1,195 @@
+/***************************************************************************
+ *  Copyright (c) 2023 by Paul Scherrer Institute, Switzerland
+ *  All rights reserved.
+ *  Authors: Zheqiao Geng
+ ***************************************************************************/
+/***************************************************************************
+ * InternalData_wfStats.c
+ *
+ * Statistics derived from the waveform nodes. A waveform node declares the
+ * statistics it needs (min, max, mean, RMS, peak position), which are
+ * created as AI nodes on the same scan as the waveform. They are computed
+ * with the vector kernels of InternalData_simd.c when the producer
+ * publishes the waveform, so the modules do not need to loop over the
+ * data in the jobs.
+ ***************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <epicsMutex.h>
+#include <epicsTime.h>
+
+#include "InternalData.h"
+
+/*======================================
+ * Global variables
+ *======================================*/
+typedef struct INTD_struc_wfStats_tag {
+    unsigned int        mask;                                       /* statistics selected, INTD_WFSTAT_xxx */
+    double              val[INTD_WFSTAT_NUM];                       /* data of the AI nodes */
+    INTD_struc_node    *statNodes[INTD_WFSTAT_NUM];                 /* the AI nodes, NULL if not selected */
+    unsigned long       updateCnt;                                  /* number of computations */
+    double              timeSum, timeMax;                           /* computation time (s) */
+} INTD_struc_wfStats;
+
+static const char *INTD_gvar_wfStatNames[INTD_WFSTAT_NUM] = {"MIN", "MAX", "MEAN", "RMS", "PEAK"};
+
+/*======================================
+ * Public Routines
+ *======================================*/
+/**
+ * Declare the statistics of a waveform node. For each selected statistic an AI node named
+ *   <data name>-<MIN|MAX|MEAN|RMS|PEAK> is created in the same module and sub-module, with the
+ *   same scan type and IOSCANPVT as the waveform. Must be called before the records are generated
+ * Input:
+ *   dataNode       : Waveform node (INTD_WFI or INTD_WFO)
+ *   statMask       : OR of INTD_WFSTAT_MIN, INTD_WFSTAT_MAX, INTD_WFSTAT_MEAN, INTD_WFSTAT_RMS, INTD_WFSTAT_PEAK
+ * Return:
+ *   0              : Successful
+ *  -1              : Failed
+ */
+int INTD_API_addWfStats(INTD_struc_node *dataNode, unsigned int statMask)
+{
+    unsigned int i;
+    char dataName[256];
+    char descStr[41];
+    INTD_struc_wfStats *stats;
+
+    if(!dataNode || (dataNode -> recordType != INTD_WFI && dataNode -> recordType != INTD_WFO) ||
+       dataNode -> dataType == INTD_OLDSTRING) {
+        printf("INTD_API_addWfStats: Statistics only for numeric waveform nodes\n");
+        return -1;
+    }
+
+    if(dataNode -> wfStats) {
+        printf("INTD_API_addWfStats: Statistics of %s.%s already declared\n", dataNode -> moduleName, dataNode -> dataName);
+        return -1;
+    }
+
+    stats = (INTD_struc_wfStats *)calloc(1, sizeof(INTD_struc_wfStats));
+    if(!stats) {
+        printf("INTD_API_addWfStats: Failed to allocate memory for %s.%s\n", dataNode -> moduleName, dataNode -> dataName);
+        return -1;
+    }
+
+    stats -> mask = statMask & INTD_WFSTAT_ALL;
+
+    for(i = 0; i < INTD_WFSTAT_NUM; i ++) {
+        if(!(stats -> mask & (1u << i))) continue;
+
+        /* keep the sub-module part, the '|' is converted to '-' by INTD_API_createDataNode */
+        if(dataNode -> subModuleName[0])
+            sprintf(dataName, "%s|%s-%s", dataNode -> subModuleName + 1, dataNode -> recName, INTD_gvar_wfStatNames[i]);
+        else
+            sprintf(dataName, "%s-%s", dataNode -> recName, INTD_gvar_wfStatNames[i]);
+
+        stats -> statNodes[i] = INTD_API_createDataNode(dataNode -> moduleName, dataName,
+                                    "", i == INTD_WFSTAT_PEAK_IDX ? "" : dataNode -> unitStr,
+                                    (void *)&stats -> val[i], dataNode -> privateData, 1, dataNode -> ioIntScan,
+                                    INTD_DOUBLE, NULL, NULL, dataNode -> mutexId, NULL,
+                                    INTD_AI, dataNode -> scanType);
+
+        if(!stats -> statNodes[i]) {
+            printf("INTD_API_addWfStats: Failed to create the node %s.%s\n", dataNode -> moduleName, dataName);
+            continue;
+        }
+
+        snprintf(descStr, sizeof(descStr), "%s of %s", INTD_gvar_wfStatNames[i], dataNode -> recName);
+        INTD_API_setDescription(stats -> statNodes[i], descStr);
+        INTD_API_setPrecision(stats -> statNodes[i], i == INTD_WFSTAT_PEAK_IDX ? 0 : dataNode -> prec);
+        if(dataNode -> scanType == INTD_EVENT)
+            INTD_API_setScanEvent(stats -> statNodes[i], dataNode -> scanEvent);
+    }
+
+    dataNode -> wfStats = stats;
+    return 0;
+}
+
+/**
+ * Compute the statistics of the waveform node. Called by INTD_API_publishNode (LocalPV::publish), or by the
+ *   producer directly if it requests the scans itself. The values are updated under the mutex of the node
+ * Input:
+ *   dataNode       : Waveform node
+ *   pno            : Number of the valid points, 0 for the points written by the last put of the node (all points
+ *                    if it wrote all or the buffer was written in place)
+ */
+int INTD_API_updateWfStats(INTD_struc_node *dataNode, unsigned int pno)
+{
+    unsigned int seq, pos = 0, var_pno;
+    double minVal, maxVal, sum, sumSq;
+    double val[INTD_WFSTAT_NUM];
+    double elapsed;
+    epicsTimeStamp start, end;
+    INTD_struc_wfStats *stats;
+
+    if(!dataNode || !(stats = dataNode -> wfStats)) return -1;
+
+    epicsTimeGetCurrent(&start);
+
+    do {
+        seq = INTD_API_readBegin(dataNode);
+
+        if(!pno) var_pno = dataNode -> validPno ? dataNode -> validPno : dataNode -> pno;
+        else     var_pno = pno < dataNode -> pno ? pno : dataNode -> pno;
+
+        INTD_API_vecStats(dataNode -> dataType, INTD_API_readBuffer(dataNode), var_pno, &minVal, &maxVal, &sum, &sumSq);
+
+        if(stats -> mask & INTD_WFSTAT_PEAK)
+            pos = INTD_API_vecFind(dataNode -> dataType, INTD_API_readBuffer(dataNode), var_pno, maxVal);
+    } while(INTD_API_readRetry(dataNode, seq));
+
+    val[INTD_WFSTAT_MIN_IDX]  = minVal;
+    val[INTD_WFSTAT_MAX_IDX]  = maxVal;
+    val[INTD_WFSTAT_MEAN_IDX] = sum / var_pno;
+    val[INTD_WFSTAT_RMS_IDX]  = sqrt(sumSq / var_pno);
+    val[INTD_WFSTAT_PEAK_IDX] = (double)pos;
+
+    if(dataNode -> mutexId) epicsMutexMustLock(dataNode -> mutexId);
+    memcpy(stats -> val, val, sizeof(val));
+    if(dataNode -> mutexId) epicsMutexUnlock(dataNode -> mutexId);
+
+    epicsTimeGetCurrent(&end);
+    elapsed = epicsTimeDiffInSeconds(&end, &start);
+
+    stats -> updateCnt ++;
+    stats -> timeSum += elapsed;
+    if(elapsed > stats -> timeMax) stats -> timeMax = elapsed;
+
+    return 0;
+}
+
+/**
+ * Get the last computed statistics (array of INTD_WFSTAT_NUM values, index INTD_WFSTAT_xxx_IDX)
+ */
+int INTD_API_getWfStats(INTD_struc_node *dataNode, double *val)
+{
+    if(!dataNode || !dataNode -> wfStats || !val) return -1;
+
+    if(dataNode -> mutexId) epicsMutexMustLock(dataNode -> mutexId);
+    memcpy(val, dataNode -> wfStats -> val, sizeof(dataNode -> wfStats -> val));
+    if(dataNode -> mutexId) epicsMutexUnlock(dataNode -> mutexId);
+
+    return 0;
+}
+
+/**
+ * Print the waveform nodes with statistics and the computation time
+ */
+void INTD_API_wfStatsReport(const char *moduleName)
+{
+    INTD_struc_node *dataNode;
+    INTD_struc_wfStats *stats;
+
+    printf("INTD waveform statistics (%s kernels):\n", INTD_API_vecIsa());
+
+    for(dataNode = INTD_API_firstNode(); dataNode; dataNode = INTD_API_nextNode(dataNode)) {
+        if(!(stats = dataNode -> wfStats)) continue;
+        if(moduleName && moduleName[0] && strcmp(moduleName, "MOD_ALL") != 0 && strcmp(moduleName, dataNode -> moduleName) != 0) continue;
+
+        printf("    %s.%s (%u points): mask 0x%02x, updates %lu, time %.3f/%.3f ms (avg/max)\n",
+                dataNode -> moduleName, dataNode -> dataName, dataNode -> pno, stats -> mask, stats -> updateCnt,
+                stats -> updateCnt ? stats -> timeSum * 1e3 / stats -> updateCnt : 0.0, stats -> timeMax * 1e3);
+    }
+}
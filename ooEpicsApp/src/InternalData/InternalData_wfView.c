@@ -0,0 +1,293 @@
+/***************************************************************************
+ *  Copyright (c) 2023 by Paul Scherrer Institute, Switzerland
+ *  All rights reserved.
+ *  Authors: Zheqiao Geng
+ ***************************************************************************/
+/***************************************************************************
+ * InternalData_wfView.c
+ *
+ * Decimated views of large waveform nodes. A view is a waveform node of its
+ * own (a WFI record) with a few thousand points, computed from the source
+ * waveform by stride, mean or min/max envelope decimation when the source
+ * is published. Operator GUIs can subscribe to a view and only read the
+ * full array when needed.
+ *
+ * Point i of a view with m bins covers the source points
+ * [i * n / m, (i + 1) * n / m). A partial update of the source only
+ * recomputes the bins that overlap the changed range.
+ ***************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <epicsMutex.h>
+#include <epicsTime.h>
+
+#include "InternalData.h"
+
+/*======================================
+ * Global variables
+ *======================================*/
+typedef struct INTD_struc_wfView_tag {
+    struct INTD_struc_wfView_tag *next;                             /* next view of the same source */
+    INTD_struc_node    *viewNode;                                   /* the waveform node of the view */
+    INTD_enum_wfViewType viewType;
+    unsigned int        bins;                                       /* number of bins, 2 points per bin for the envelope */
+    void               *scratch;                                    /* computed outside of the lock of the view */
+    unsigned long       updateCnt;                                  /* number of updates */
+    unsigned long       binCnt;                                     /* number of bins computed */
+    double              timeSum, timeMax;                           /* update time (s) */
+} INTD_struc_wfView;
+
+static const char *INTD_gvar_wfViewNames[] = {"stride", "mean", "min/max"};
+
+/*======================================
+ * Private Routines
+ *======================================*/
+/**
+ * First source point of a bin
+ */
+static unsigned int INTD_func_viewBinStart(unsigned int bin, unsigned int bins, unsigned int pno)
+{
+    return (unsigned int)(((unsigned long long)bin * pno) / bins);
+}
+
+/**
+ * Bin containing a source point
+ */
+static unsigned int INTD_func_viewBinOf(unsigned int pos, unsigned int bins, unsigned int pno)
+{
+    unsigned int bin = (unsigned int)((((unsigned long long)pos + 1) * bins + pno - 1) / pno) - 1;
+    return bin < bins ? bin : bins - 1;
+}
+
+/**
+ * Store a value to the element idx of a buffer
+ */
+static void INTD_func_viewStore(INTD_enum_dataType dataType, void *buf, unsigned int idx, double value)
+{
+    switch(dataType) {
+        case INTD_CHAR:     ((epicsInt8    *)buf)[idx] = (epicsInt8)value;    break;
+        case INTD_UCHAR:    ((epicsUInt8   *)buf)[idx] = (epicsUInt8)value;   break;
+        case INTD_SHORT:    ((epicsInt16   *)buf)[idx] = (epicsInt16)value;   break;
+        case INTD_USHORT:   ((epicsUInt16  *)buf)[idx] = (epicsUInt16)value;  break;
+        case INTD_INT:
+        case INTD_LONG:     ((epicsInt32   *)buf)[idx] = (epicsInt32)value;   break;
+        case INTD_UINT:
+        case INTD_ULONG:    ((epicsUInt32  *)buf)[idx] = (epicsUInt32)value;  break;
+        case INTD_FLOAT:    ((epicsFloat32 *)buf)[idx] = (epicsFloat32)value; break;
+        case INTD_DOUBLE:   ((epicsFloat64 *)buf)[idx] = value;               break;
+        default: break;
+    }
+}
+
+/**
+ * Compute the bins [binFirst, binLast] of a view from the source data into the scratch buffer
+ */
+static void INTD_func_viewCompute(INTD_struc_wfView *view, INTD_struc_node *dataNode, const void *src, unsigned int binFirst, unsigned int binLast)
+{
+    unsigned int bin, start, end;
+    unsigned int srcSize = INTD_API_getDataSize(dataNode -> dataType);
+    INTD_enum_dataType viewDataType = view -> viewNode -> dataType;
+    double minVal, maxVal;
+
+    for(bin = binFirst; bin <= binLast; bin ++) {
+        start = INTD_func_viewBinStart(bin,     view -> bins, dataNode -> pno);
+        end   = INTD_func_viewBinStart(bin + 1, view -> bins, dataNode -> pno);
+
+        switch(view -> viewType) {
+            case INTD_VIEW_STRIDE:
+                memcpy((char *)view -> scratch + (size_t)bin * srcSize, (const char *)src + (size_t)start * srcSize, srcSize);
+                break;
+
+            case INTD_VIEW_MEAN:
+                INTD_func_viewStore(viewDataType, view -> scratch, bin,
+                        INTD_API_vecSum(dataNode -> dataType, (const char *)src + (size_t)start * srcSize, end - start) / (end - start));
+                break;
+
+            case INTD_VIEW_MINMAX:
+                INTD_API_vecMinMax(dataNode -> dataType, (const char *)src + (size_t)start * srcSize, end - start, &minVal, &maxVal);
+                INTD_func_viewStore(viewDataType, view -> scratch, 2 * bin,     minVal);
+                INTD_func_viewStore(viewDataType, view -> scratch, 2 * bin + 1, maxVal);
+                break;
+
+            default: break;
+        }
+    }
+}
+
+/*======================================
+ * Public Routines
+ *======================================*/
+/**
+ * Attach a decimated view to a waveform node. The view is a new INTD_WFI node named <data name>-<suffix>
+ *   in the same module and sub-module, with the scan type, IOSCANPVT and mutex of the source. Must be
+ *   called before the records are generated
+ * Input:
+ *   dataNode       : Source waveform node
+ *   suffix         : Suffix of the data name of the view (e.g. "V2K")
+ *   viewType       : INTD_VIEW_STRIDE, INTD_VIEW_MEAN or INTD_VIEW_MINMAX
+ *   points         : Number of points of the view, the envelope has points / 2 bins with min and max
+ * Return:
+ *   The node of the view, NULL if failed
+ */
+INTD_struc_node *INTD_API_addWfView(INTD_struc_node *dataNode, const char *suffix, INTD_enum_wfViewType viewType, unsigned int points)
+{
+    unsigned int bins, viewPno;
+    char dataName[256];
+    char descStr[41];
+    INTD_enum_dataType viewDataType;
+    INTD_struc_wfView *view;
+    void *buf;
+
+    if(!dataNode || !suffix || !suffix[0] ||
+       (dataNode -> recordType != INTD_WFI && dataNode -> recordType != INTD_WFO) || dataNode -> dataType == INTD_OLDSTRING) {
+        printf("INTD_API_addWfView: Views only for numeric waveform nodes\n");
+        return NULL;
+    }
+
+    /* number of bins, not more than the points of the source */
+    bins = viewType == INTD_VIEW_MINMAX ? points / 2 : points;
+    if(bins > dataNode -> pno) bins = dataNode -> pno;
+
+    if(bins == 0 || viewType < INTD_VIEW_STRIDE || viewType > INTD_VIEW_MINMAX) {
+        printf("INTD_API_addWfView: Illegal view of %s.%s\n", dataNode -> moduleName, dataNode -> dataName);
+        return NULL;
+    }
+
+    viewPno      = viewType == INTD_VIEW_MINMAX ? 2 * bins : bins;
+    viewDataType = dataNode -> dataType;
+    if(viewType == INTD_VIEW_MEAN && viewDataType != INTD_FLOAT) viewDataType = INTD_DOUBLE;
+
+    view = (INTD_struc_wfView *)calloc(1, sizeof(INTD_struc_wfView));
+    buf  = calloc(viewPno, INTD_API_getDataSize(viewDataType));
+
+    if(view) view -> scratch = calloc(viewPno, INTD_API_getDataSize(viewDataType));
+
+    if(!view || !buf || !view -> scratch) {
+        printf("INTD_API_addWfView: Failed to allocate memory for the view of %s.%s\n", dataNode -> moduleName, dataNode -> dataName);
+        if(view) free(view -> scratch);
+        free(view);
+        free(buf);
+        return NULL;
+    }
+
+    /* keep the sub-module part, the '|' is converted to '-' by INTD_API_createDataNode */
+    if(dataNode -> subModuleName[0])
+        sprintf(dataName, "%s|%s-%s", dataNode -> subModuleName + 1, dataNode -> recName, suffix);
+    else
+        sprintf(dataName, "%s-%s", dataNode -> recName, suffix);
+
+    view -> viewNode = INTD_API_createDataNode(dataNode -> moduleName, dataName, "", dataNode -> unitStr,
+                            buf, dataNode -> privateData, viewPno, dataNode -> ioIntScan,
+                            viewDataType, NULL, NULL, dataNode -> mutexId, NULL,
+                            INTD_WFI, dataNode -> scanType);
+
+    if(!view -> viewNode) {
+        printf("INTD_API_addWfView: Failed to create the node %s.%s\n", dataNode -> moduleName, dataName);
+        free(view -> scratch);
+        free(view);
+        free(buf);
+        return NULL;
+    }
+
+    view -> viewType = viewType;
+    view -> bins     = bins;
+
+    snprintf(descStr, sizeof(descStr), "%s view of %s", INTD_gvar_wfViewNames[viewType], dataNode -> recName);
+    INTD_API_setDescription(view -> viewNode, descStr);
+    if(dataNode -> scanType == INTD_EVENT)
+        INTD_API_setScanEvent(view -> viewNode, dataNode -> scanEvent);
+
+    /* append to keep the order of creation */
+    if(!dataNode -> wfViews) {
+        dataNode -> wfViews = view;
+    } else {
+        INTD_struc_wfView *last = dataNode -> wfViews;
+        while(last -> next) last = last -> next;
+        last -> next = view;
+    }
+
+    return view -> viewNode;
+}
+
+/**
+ * Update the views of a waveform node after the source points [first, last] changed. Only the bins
+ *   overlapping the range are recomputed
+ */
+int INTD_API_updateWfViewsRange(INTD_struc_node *dataNode, unsigned int first, unsigned int last)
+{
+    unsigned int seq, binFirst, binLast, pointFirst, pointNum, viewSize;
+    double elapsed;
+    epicsTimeStamp start, end;
+    INTD_struc_wfView *view;
+
+    if(!dataNode || !dataNode -> wfViews || first > last || first >= dataNode -> pno) return -1;
+    if(last >= dataNode -> pno) last = dataNode -> pno - 1;
+
+    for(view = dataNode -> wfViews; view; view = view -> next) {
+        epicsTimeGetCurrent(&start);
+
+        binFirst = INTD_func_viewBinOf(first, view -> bins, dataNode -> pno);
+        binLast  = INTD_func_viewBinOf(last,  view -> bins, dataNode -> pno);
+
+        do {
+            seq = INTD_API_readBegin(dataNode);
+            INTD_func_viewCompute(view, dataNode, INTD_API_readBuffer(dataNode), binFirst, binLast);
+        } while(INTD_API_readRetry(dataNode, seq));
+
+        /* copy the computed points to the view */
+        viewSize   = INTD_API_getDataSize(view -> viewNode -> dataType);
+        pointFirst = view -> viewType == INTD_VIEW_MINMAX ? 2 * binFirst : binFirst;
+        pointNum   = (binLast - binFirst + 1) * (view -> viewType == INTD_VIEW_MINMAX ? 2 : 1);
+
+        INTD_API_writeBegin(view -> viewNode);
+        memcpy((char *)INTD_API_writeBuffer(view -> viewNode) + (size_t)pointFirst * viewSize,
+               (char *)view -> scratch + (size_t)pointFirst * viewSize, (size_t)pointNum * viewSize);
+        INTD_API_markDirty(view -> viewNode, pointFirst, pointNum);
+        INTD_API_writeEnd(view -> viewNode);
+
+        epicsTimeGetCurrent(&end);
+        elapsed = epicsTimeDiffInSeconds(&end, &start);
+
+        view -> updateCnt ++;
+        view -> binCnt   += binLast - binFirst + 1;
+        view -> timeSum  += elapsed;
+        if(elapsed > view -> timeMax) view -> timeMax = elapsed;
+    }
+
+    return 0;
+}
+
+/**
+ * Update all points of the views of a waveform node. Called by INTD_API_publishNode (LocalPV::publish),
+ *   or by the producer directly if it requests the scans itself
+ */
+int INTD_API_updateWfViews(INTD_struc_node *dataNode)
+{
+    if(!dataNode) return -1;
+
+    return INTD_API_updateWfViewsRange(dataNode, 0, dataNode -> pno - 1);
+}
+
+/**
+ * Print the views and the update time
+ */
+void INTD_API_wfViewReport(const char *moduleName)
+{
+    INTD_struc_node *dataNode;
+    INTD_struc_wfView *view;
+
+    printf("INTD waveform views (%s kernels):\n", INTD_API_vecIsa());
+
+    for(dataNode = INTD_API_firstNode(); dataNode; dataNode = INTD_API_nextNode(dataNode)) {
+        if(!dataNode -> wfViews) continue;
+        if(moduleName && moduleName[0] && strcmp(moduleName, "MOD_ALL") != 0 && strcmp(moduleName, dataNode -> moduleName) != 0) continue;
+
+        for(view = dataNode -> wfViews; view; view = view -> next)
+            printf("    %s.%s (%u points) -> %s: %s, %u bins, updates %lu, bins computed %lu, time %.3f/%.3f ms (avg/max)\n",
+                    dataNode -> moduleName, dataNode -> dataName, dataNode -> pno, view -> viewNode -> dataName,
+                    INTD_gvar_wfViewNames[view -> viewType], view -> bins, view -> updateCnt, view -> binCnt,
+                    view -> updateCnt ? view -> timeSum * 1e3 / view -> updateCnt : 0.0, view -> timeMax * 1e3);
+    }
+}
@@ -13,19 +13,18 @@
 void INTD_RECORD_AO(const char *datName, const char *subModName, const char *recName, const char *scanMethod, const char *unitStr, const char *descStr, unsigned int precVal, const char *aliasStr, const char *asgStr, char *outStr)
 {
     int al;
-    char precStr[3];    
+    char precStr[16];    
     char als[128] = "";
 
     if(!recName || !scanMethod || !outStr) return;
 
-    sprintf(precStr, "%d", precVal);
+    snprintf(precStr, sizeof(precStr), "%u", precVal);
 
     if(strlen(aliasStr) > 0)    al = 1;
     else                        al = 0;
 
     if(al) {
-        strcpy(als, "$(name_space)$(module_name)-");
-        strcat(als, aliasStr);
+        snprintf(als, sizeof(als), "$(name_space)$(module_name)-%s", aliasStr);
     }    
 
     strcpy(outStr, "record(ao, $(name_space)");
@@ -61,19 +60,18 @@ void INTD_RECORD_AO(const char *datName, const char *subModName, const char *rec
 void INTD_RECORD_AI(const char *datName, const char *subModName, const char *recName, const char *scanMethod, const char *unitStr, const char *descStr, unsigned int precVal, const char *aliasStr, const char *asgStr, char *outStr)
 {
     int al;
-    char precStr[3];    
+    char precStr[16];    
     char als[128] = "";
 
     if(!recName || !scanMethod || !outStr) return;
 
-    sprintf(precStr, "%d", precVal);
+    snprintf(precStr, sizeof(precStr), "%u", precVal);
 
     if(strlen(aliasStr) > 0)    al = 1;
     else                        al = 0;
 
     if(al) {
-        strcpy(als, "$(name_space)$(module_name)-");
-        strcat(als, aliasStr);
+        snprintf(als, sizeof(als), "$(name_space)$(module_name)-%s", aliasStr);
     }    
 
     strcpy(outStr, "record(ai, $(name_space)");
@@ -121,8 +119,7 @@ void INTD_RECORD_BO(const char *datName, const char *subModName, const char *rec
     else                        al = 0;
 
     if(al) {
-        strcpy(als, "$(name_space)$(module_name)-");
-        strcat(als, aliasStr);
+        snprintf(als, sizeof(als), "$(name_space)$(module_name)-%s", aliasStr);
     }    
 
 	/* get the strings for bo */
@@ -130,8 +127,8 @@ void INTD_RECORD_BO(const char *datName, const char *subModName, const char *rec
     ped = strchr(supStr, '\0');
 
 	if(pfh && ped) {
-	    strncpy(strOne,  supStr,  pfh - supStr);
-    	strncpy(strZero, pfh + 1, ped - pfh - 1);
+	    snprintf(strOne,  sizeof(strOne),  "%.*s", (int)(pfh - supStr), supStr);
+    	snprintf(strZero, sizeof(strZero), "%.*s", (int)(ped - pfh - 1), pfh + 1);
 	}
 
 	/* the string for record */
@@ -180,8 +177,7 @@ void INTD_RECORD_BI(const char *datName, const char *subModName, const char *rec
     else                        al = 0;
 
     if(al) {
-        strcpy(als, "$(name_space)$(module_name)-");
-        strcat(als, aliasStr);
+        snprintf(als, sizeof(als), "$(name_space)$(module_name)-%s", aliasStr);
     }    
 
 	/* get the strings for bi */
@@ -189,8 +185,8 @@ void INTD_RECORD_BI(const char *datName, const char *subModName, const char *rec
     ped = strchr(supStr, '\0');
 
 	if(pfh && ped) {
-	    strncpy(strOne,  supStr,  pfh - supStr);
-    	strncpy(strZero, pfh + 1, ped - pfh - 1);
+	    snprintf(strOne,  sizeof(strOne),  "%.*s", (int)(pfh - supStr), supStr);
+    	snprintf(strZero, sizeof(strZero), "%.*s", (int)(ped - pfh - 1), pfh + 1);
 	}
 
 	/* the string for record */
@@ -235,8 +231,7 @@ void INTD_RECORD_LO(const char *datName, const char *subModName, const char *rec
     else                        al = 0;
 
     if(al) {
-        strcpy(als, "$(name_space)$(module_name)-");
-        strcat(als, aliasStr);
+        snprintf(als, sizeof(als), "$(name_space)$(module_name)-%s", aliasStr);
     }    
 
     strcpy(outStr, "record(longout, $(name_space)");
@@ -278,8 +273,7 @@ void INTD_RECORD_LI(const char *datName, const char *subModName, const char *rec
     else                        al = 0;
 
     if(al) {
-        strcpy(als, "$(name_space)$(module_name)-");
-        strcat(als, aliasStr);
+        snprintf(als, sizeof(als), "$(name_space)$(module_name)-%s", aliasStr);
     }    
 
     strcpy(outStr, "record(longin, $(name_space)");
@@ -326,20 +320,19 @@ void INTD_RECORD_MBBO(const char *datName, const char *subModName, const char *r
     else                        al = 0;
 
     if(al) {
-        strcpy(als, "$(name_space)$(module_name)-");
-        strcat(als, aliasStr);
+        snprintf(als, sizeof(als), "$(name_space)$(module_name)-%s", aliasStr);
     }    
 
 	/* get the strings for mbbo */
-	strcpy(subSupStr, supStr);
+	snprintf(subSupStr, sizeof(subSupStr), "%s", supStr);
 
 	for(i = 0; i < 16; i ++) {
     	pfh = strchr(subSupStr, ';');
 		if(pfh) {
-			strncpy(strSel[i], subSupStr, pfh - subSupStr);
-    		strcpy(subSupStr, pfh + 1);
+			snprintf(strSel[i], sizeof(strSel[i]), "%.*s", (int)(pfh - subSupStr), subSupStr);
+    		memmove(subSupStr, pfh + 1, strlen(pfh + 1) + 1);
 		} else {
-			strcpy(strSel[i], subSupStr);
+			snprintf(strSel[i], sizeof(strSel[i]), "%s", subSupStr);
 			break;
 		}
 	}
@@ -419,20 +412,19 @@ void INTD_RECORD_MBBI(const char *datName, const char *subModName, const char *r
     else                        al = 0;
 
     if(al) {
-        strcpy(als, "$(name_space)$(module_name)-");
-        strcat(als, aliasStr);
+        snprintf(als, sizeof(als), "$(name_space)$(module_name)-%s", aliasStr);
     }    
 
 	/* get the strings for mbbi */
-	strcpy(subSupStr, supStr);
+	snprintf(subSupStr, sizeof(subSupStr), "%s", supStr);
 
 	for(i = 0; i < 16; i ++) {
     	pfh = strchr(subSupStr, ';');
 		if(pfh) {
-			strncpy(strSel[i], subSupStr, pfh - subSupStr);
-    		strcpy(subSupStr, pfh + 1);
+			snprintf(strSel[i], sizeof(strSel[i]), "%.*s", (int)(pfh - subSupStr), subSupStr);
+    		memmove(subSupStr, pfh + 1, strlen(pfh + 1) + 1);
 		} else {
-			strcpy(strSel[i], subSupStr);
+			snprintf(strSel[i], sizeof(strSel[i]), "%s", subSupStr);
 			break;
 		}
 	}
@@ -507,8 +499,7 @@ void INTD_RECORD_WFO(const char *datName, const char *subModName, const char *re
     else                        al = 0;
 
     if(al) {
-        strcpy(als, "$(name_space)$(module_name)-");
-        strcat(als, aliasStr);
+        snprintf(als, sizeof(als), "$(name_space)$(module_name)-%s", aliasStr);
     }    
 
     strcpy(outStr, "record(waveform, $(name_space)");
@@ -554,8 +545,7 @@ void INTD_RECORD_WFI(const char *datName, const char *subModName, const char *re
     else                        al = 0;
 
     if(al) {
-        strcpy(als, "$(name_space)$(module_name)-");
-        strcat(als, aliasStr);
+        snprintf(als, sizeof(als), "$(name_space)$(module_name)-%s", aliasStr);
     }    
 
     strcpy(outStr, "record(waveform, $(name_space)");
@@ -590,6 +580,98 @@ void INTD_RECORD_WFI(const char *datName, const char *subModName, const char *re
     strcat(outStr, "\")\n}");    
 }
 
+void INTD_RECORD_AAO(const char *datName, const char *subModName, const char *recName, const char *scanMethod, const char *pno, const char *dataType, const char *unitStr, const char *descStr, const char *aliasStr, const char *asgStr, char *outStr)
+{
+    int al;
+    char als[128] = "";
+	
+    if(!recName || !scanMethod || !pno || !dataType || !outStr) return;
+
+    if(strlen(aliasStr) > 0)    al = 1;
+    else                        al = 0;
+
+    if(al) {
+        snprintf(als, sizeof(als), "$(name_space)$(module_name)-%s", aliasStr);
+    }    
+
+    strcpy(outStr, "record(aao, $(name_space)");
+    strcat(outStr, "$(module_name)");
+    strcat(outStr, subModName);
+    strcat(outStr, ":");
+    strcat(outStr, recName);
+    strcat(outStr, ") {\n");        
+
+    if(al) {
+        strcat(outStr, "        alias(");
+        strcat(outStr, als);
+        strcat(outStr, ")\n");
+    }
+
+    strcat(outStr,      "        field(DESC, \"");
+    strcat(outStr, descStr);
+    strcat(outStr, "\")\n        field(SCAN, \"");
+    strcat(outStr, scanMethod);
+    strcat(outStr, "\")\n        field(ASG, \"");
+    strcat(outStr, asgStr);
+    strcat(outStr, "\")\n        field(EGU, \"");
+    strcat(outStr, unitStr);
+    strcat(outStr, "\")\n        field(NELM, \"");
+    strcat(outStr, pno);
+    strcat(outStr, "\")\n        field(DTYP, \"InternalData\")\n        field(FTVL, \"");
+    strcat(outStr, dataType);
+    strcat(outStr, "\")\n        field(OUT, \"@");
+    strcat(outStr, "$(module_name)");
+    strcat(outStr, ".");
+    strcat(outStr, datName);
+    strcat(outStr, "\")\n}");    
+}
+
+void INTD_RECORD_AAI(const char *datName, const char *subModName, const char *recName, const char *scanMethod, const char *pno, const char *dataType, const char *unitStr, const char *descStr, const char *aliasStr, const char *asgStr, char *outStr)
+{
+    int al;
+    char als[128] = "";
+	
+    if(!recName || !scanMethod || !pno || !dataType || !outStr) return;
+
+    if(strlen(aliasStr) > 0)    al = 1;
+    else                        al = 0;
+
+    if(al) {
+        snprintf(als, sizeof(als), "$(name_space)$(module_name)-%s", aliasStr);
+    }    
+
+    strcpy(outStr, "record(aai, $(name_space)");
+    strcat(outStr, "$(module_name)");
+    strcat(outStr, subModName);
+    strcat(outStr, ":");
+    strcat(outStr, recName);
+    strcat(outStr, ") {\n");        
+
+    if(al) {
+        strcat(outStr, "        alias(");
+        strcat(outStr, als);
+        strcat(outStr, ")\n");
+    }
+
+    strcat(outStr,      "        field(DESC, \"");
+    strcat(outStr, descStr);
+    strcat(outStr, "\")\n        field(SCAN, \"");
+    strcat(outStr, scanMethod);
+    strcat(outStr, "\")\n        field(ASG, \"");
+    strcat(outStr, asgStr);
+    strcat(outStr, "\")\n        field(EGU, \"");
+    strcat(outStr, unitStr);
+    strcat(outStr, "\")\n        field(NELM, \"");
+    strcat(outStr, pno);
+    strcat(outStr, "\")\n        field(DTYP, \"InternalData\")\n        field(FTVL, \"");
+    strcat(outStr, dataType);
+    strcat(outStr, "\")\n        field(INP, \"@");
+    strcat(outStr, "$(module_name)");
+    strcat(outStr, ".");
+    strcat(outStr, datName);
+    strcat(outStr, "\")\n}");    
+}
+
 void INTD_RECORD_SO(const char *datName, const char *subModName, const char *recName, const char *scanMethod, const char *descStr, const char *aliasStr, const char *asgStr, char *outStr)
 {
     int al;
@@ -601,8 +683,7 @@ void INTD_RECORD_SO(const char *datName, const char *subModName, const char *rec
     else                        al = 0;
 
     if(al) {
-        strcpy(als, "$(name_space)$(module_name)-");
-        strcat(als, aliasStr);
+        snprintf(als, sizeof(als), "$(name_space)$(module_name)-%s", aliasStr);
     }    
 
     strcpy(outStr, "record(stringout, $(name_space)");
@@ -642,8 +723,7 @@ void INTD_RECORD_SI(const char *datName, const char *subModName, const char *rec
     else                        al = 0;
 
     if(al) {
-        strcpy(als, "$(name_space)$(module_name)-");
-        strcat(als, aliasStr);
+        snprintf(als, sizeof(als), "$(name_space)$(module_name)-%s", aliasStr);
     }    
 
     strcpy(outStr, "record(stringin, $(name_space)");
@@ -672,3 +752,86 @@ void INTD_RECORD_SI(const char *datName, const char *subModName, const char *rec
     strcat(outStr, "\")\n}");     
 }
 
+void INTD_RECORD_LSO(const char *datName, const char *subModName, const char *recName, const char *scanMethod, const char *pno, const char *descStr, const char *aliasStr, const char *asgStr, char *outStr)
+{
+    int al;
+    char als[128] = "";
+	
+    if(!recName || !scanMethod || !pno || !outStr) return;
+
+    if(strlen(aliasStr) > 0)    al = 1;
+    else                        al = 0;
+
+    if(al) {
+        snprintf(als, sizeof(als), "$(name_space)$(module_name)-%s", aliasStr);
+    }    
+
+    strcpy(outStr, "record(lso, $(name_space)");
+    strcat(outStr, "$(module_name)");
+    strcat(outStr, subModName);
+    strcat(outStr, ":");
+    strcat(outStr, recName);
+    strcat(outStr, ") {\n");        
+
+    if(al) {
+        strcat(outStr, "        alias(");
+        strcat(outStr, als);
+        strcat(outStr, ")\n");
+    }
+
+    strcat(outStr,      "        field(DESC, \"");
+    strcat(outStr, descStr);
+    strcat(outStr, "\")\n        field(SCAN, \"");
+    strcat(outStr, scanMethod);
+    strcat(outStr, "\")\n        field(ASG, \"");
+    strcat(outStr, asgStr);
+    strcat(outStr, "\")\n        field(SIZV, \"");
+    strcat(outStr, pno);
+    strcat(outStr, "\")\n        field(DTYP, \"InternalData\")\n        field(OUT, \"@");
+    strcat(outStr, "$(module_name)");
+    strcat(outStr, ".");
+    strcat(outStr, datName);
+    strcat(outStr, "\")\n}");     
+}
+
+void INTD_RECORD_LSI(const char *datName, const char *subModName, const char *recName, const char *scanMethod, const char *pno, const char *descStr, const char *aliasStr, const char *asgStr, char *outStr)
+{
+    int al;
+    char als[128] = "";
+	
+    if(!recName || !scanMethod || !pno || !outStr) return;
+
+    if(strlen(aliasStr) > 0)    al = 1;
+    else                        al = 0;
+
+    if(al) {
+        snprintf(als, sizeof(als), "$(name_space)$(module_name)-%s", aliasStr);
+    }    
+
+    strcpy(outStr, "record(lsi, $(name_space)");
+    strcat(outStr, "$(module_name)");
+    strcat(outStr, subModName);
+    strcat(outStr, ":");
+    strcat(outStr, recName);
+    strcat(outStr, ") {\n");        
+
+    if(al) {
+        strcat(outStr, "        alias(");
+        strcat(outStr, als);
+        strcat(outStr, ")\n");
+    }
+
+    strcat(outStr,      "        field(DESC, \"");
+    strcat(outStr, descStr);
+    strcat(outStr, "\")\n        field(SCAN, \"");
+    strcat(outStr, scanMethod);
+    strcat(outStr, "\")\n        field(ASG, \"");
+    strcat(outStr, asgStr);
+    strcat(outStr, "\")\n        field(SIZV, \"");
+    strcat(outStr, pno);
+    strcat(outStr, "\")\n        field(DTYP, \"InternalData\")\n        field(INP, \"@");
+    strcat(outStr, "$(module_name)");
+    strcat(outStr, ".");
+    strcat(outStr, datName);
+    strcat(outStr, "\")\n}");     
+}
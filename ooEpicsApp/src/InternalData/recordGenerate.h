@@ -32,8 +32,12 @@ void INTD_RECORD_MBBO(const char *datName, const char *subModName, const char *r
 void INTD_RECORD_MBBI(const char *datName, const char *subModName, const char *recName, const char *scanMethod, const char *supStr,  const char *descStr, const char *aliasStr, const char *asgStr, char *outStr);
 void INTD_RECORD_WFO( const char *datName, const char *subModName, const char *recName, const char *scanMethod, const char *pno, const char *dataType, const char *unitStr, const char *descStr, const char *aliasStr, const char *asgStr, char *outStr);
 void INTD_RECORD_WFI( const char *datName, const char *subModName, const char *recName, const char *scanMethod, const char *pno, const char *dataType, const char *unitStr, const char *descStr, const char *aliasStr, const char *asgStr, char *outStr);
+void INTD_RECORD_AAO( const char *datName, const char *subModName, const char *recName, const char *scanMethod, const char *pno, const char *dataType, const char *unitStr, const char *descStr, const char *aliasStr, const char *asgStr, char *outStr);
+void INTD_RECORD_AAI( const char *datName, const char *subModName, const char *recName, const char *scanMethod, const char *pno, const char *dataType, const char *unitStr, const char *descStr, const char *aliasStr, const char *asgStr, char *outStr);
 void INTD_RECORD_SO(  const char *datName, const char *subModName, const char *recName, const char *scanMethod, const char *descStr, const char *aliasStr, const char *asgStr, char *outStr);
 void INTD_RECORD_SI(  const char *datName, const char *subModName, const char *recName, const char *scanMethod, const char *descStr, const char *aliasStr, const char *asgStr, char *outStr);
+void INTD_RECORD_LSO( const char *datName, const char *subModName, const char *recName, const char *scanMethod, const char *pno, const char *descStr, const char *aliasStr, const char *asgStr, char *outStr);
+void INTD_RECORD_LSI( const char *datName, const char *subModName, const char *recName, const char *scanMethod, const char *pno, const char *descStr, const char *aliasStr, const char *asgStr, char *outStr);
 
 #ifdef __cplusplus
 }
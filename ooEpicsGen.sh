@@ -88,7 +88,7 @@ echo ""
 echo "Generate in ./src example job class ..."
 sed "s/__MODULE_NAME__/$MODNAME/g" $OOEPICS_TEMPLATE_PATH/Job_Example.h  > $PATH_SRC/Job_Example.h
 sed "s/__MODULE_NAME__/$MODNAME/g" $OOEPICS_TEMPLATE_PATH/Job_Example.cc > $PATH_SRC/Job_Example.cc
-echo "Job_Example.h and Job_Example.cc generated"
+echo "Job_Example.h and Job_Example.cc generated, the local PVs are declared in the table Job_Example::var_pvTable"
 echo ""
 
 echo "Generate in ./src example service class ..."
@@ -30,6 +30,7 @@ Job_Example::Job_Example(const char *moduleName, const char *jobName) :
 
     // init the local PV I/O scan drivers and locks before initializting the local PVs
     var_lockParameters = EPICSLIB_func_mutexMustCreate();
+    var_lockResults    = EPICSLIB_func_mutexMustCreate();
     EPICSLIB_func_scanIoInit(&var_scanResultPVs);
 
     // init the local PVs
@@ -48,68 +49,58 @@ Job_Example::~Job_Example()
     if(var_lockParameters)
         EPICSLIB_func_mutexDestroy(var_lockParameters);
 
+    if(var_lockResults)
+        EPICSLIB_func_mutexDestroy(var_lockResults);
+
     // message
     cout << "INFO:Job_Example: Object " << jobName << " for module " << modName << " deleted." << endl;
 }
 
 //-----------------------------------------------
-// init the local PVs
+// table of the local PVs, all created by initLocalPVs in one pass. the fields are
+//      PV member, name, supplementary string (choices of MBBI/MBBO, maximum 16 strings
+//      separated by ';'), unit, number of points, callback, record type, scan type,
+//      I/O Intr scan member, mutex member, data type of the waveforms, scan event
 //-----------------------------------------------
-void Job_Example::initLocalPVs()
-{
-    string modn(modName);
-    string devn(jobName);
-    string funsel("Choice1;Choice2;Choice3;Choice4;Choice5;Choice6;Choice7;Choice8");           // maximum 16 strings for choices
-    string fundis("Dis1;Dis2;Dis3");                                                            // maximum 16 strings for displaying
-
-    // create the local PVs, the definition is as below
-    // void init( string                  moduleName, 
-    //            string                  devName, 
-    //            string                  valName,
-    //            string                  supStr,
-    //            string                  unitStr,
-    //            unsigned int            pointNum,
-    //            void                   *privatePtr,
-    //            INTD_CALLBACK           callback,
-    //            INTD_enum_recordType    recordType,
-    //            INTD_enum_scanType      scanType,
-    //            IOSCANPVT              *ioIntScan, 
-    //            epicsMutexId            mutexId, 
-    //            epicsEventId            eventId); 
-
-    // it is necessary for the waveform records to specify the data type
-    lpv_waveformoutExample.setWfDataType(INTD_DOUBLE);
-    lpv_xaxis.setWfDataType             (INTD_DOUBLE);
-    lpv_waveforminExample.setWfDataType (INTD_DOUBLE);
-
-    // initalize the local PVs
-    lpv_enableDebug.init        (modn, devn, "ENA-DEBUG",       "", "",                         1, (void *)this,         NULL, INTD_BO,  INTD_PASSIVE,             NULL, var_lockParameters, NULL);
-
-    lpv_boExample.init          (modn, devn, "EXAMPLE-BO",      "", "",                         1, (void *)this,         NULL, INTD_BO,  INTD_PASSIVE,             NULL, var_lockParameters, NULL);
-    lpv_mbboExample.init        (modn, devn, "EXAMPLE-MBBO",funsel, "",                         1, (void *)this,         NULL, INTD_MBBO,INTD_PASSIVE,             NULL, var_lockParameters, NULL);
-    lpv_longoutExample.init     (modn, devn, "EXAMPLE-LO",      "", "DEG",                      1, (void *)this,         NULL, INTD_LO,  INTD_PASSIVE,             NULL, var_lockParameters, NULL);
-    lpv_aoExample.init          (modn, devn, "EXAMPLE-AO",      "", "GeV",                      1, (void *)this,         NULL, INTD_AO,  INTD_PASSIVE,             NULL, var_lockParameters, NULL);
-
-    lpv_waveformoutExample.init (modn, devn, "EXAMPLE-WFO",     "", "DIG",      SRVEXAM_BUF_SIZE,  (void *)this,         NULL, INTD_WFO, INTD_PASSIVE,             NULL, var_lockParameters, NULL);
-    lpv_stringoutExample.init   (modn, devn, "EXAMPLE-SO",      "", "",      INTD_STR_RECORD_LEN,  (void *)this,         NULL, INTD_SO,  INTD_PASSIVE,             NULL, var_lockParameters, NULL);
-
-    lpv_biExample.init          (modn, devn, "EXAMPLE-BI",      "", "",                         1, (void *)this,         NULL, INTD_BI,  INTD_IOINT, &var_scanResultPVs,               NULL, NULL);
-    lpv_mbbiExample.init        (modn, devn, "EXAMPLE-MBBI",fundis, "",                         1, (void *)this,         NULL, INTD_MBBI,INTD_IOINT, &var_scanResultPVs,               NULL, NULL);
-    lpv_longinExample.init      (modn, devn, "EXAMPLE-LI",      "", "DEG",                      1, (void *)this,         NULL, INTD_LI,  INTD_IOINT, &var_scanResultPVs,               NULL, NULL);
-    lpv_aiExample.init          (modn, devn, "EXAMPLE-AI",      "", "GeV",                      1, (void *)this,         NULL, INTD_AI,  INTD_IOINT, &var_scanResultPVs,               NULL, NULL);
-    
-    lpv_xaxis.init              (modn, devn, "EXAMPLE-WFX",     "", "SEC",       SRVEXAM_BUF_SIZE, (void *)this,         NULL, INTD_WFI, INTD_IOINT, &var_scanResultPVs,               NULL, NULL);
-    lpv_waveforminExample.init  (modn, devn, "EXAMPLE-WFI",     "", "DIG",       SRVEXAM_BUF_SIZE, (void *)this,         NULL, INTD_WFI, INTD_IOINT, &var_scanResultPVs,               NULL, NULL);
-    lpv_stringinExample.init    (modn, devn, "EXAMPLE-SI",      "", "",       INTD_STR_RECORD_LEN, (void *)this,         NULL, INTD_SI,  INTD_IOINT, &var_scanResultPVs,               NULL, NULL);
+const OOEPICS::LPV_PVDesc<Job_Example> Job_Example::var_pvTable[] = {
+    {&Job_Example::lpv_enableDebug,        "ENA-DEBUG",    "",                                                                 "",                       1, NULL,         INTD_BO,   INTD_PASSIVE, NULL,                           &Job_Example::var_lockParameters},
+
+    {&Job_Example::lpv_boExample,          "EXAMPLE-BO",   "",                                                                 "",                       1, NULL,         INTD_BO,   INTD_PASSIVE, NULL,                           &Job_Example::var_lockParameters},
+    {&Job_Example::lpv_mbboExample,        "EXAMPLE-MBBO", "Choice1;Choice2;Choice3;Choice4;Choice5;Choice6;Choice7;Choice8",  "",                       1, NULL,         INTD_MBBO, INTD_PASSIVE, NULL,                           &Job_Example::var_lockParameters},
+    {&Job_Example::lpv_longoutExample,     "EXAMPLE-LO",   "",                                                                 "DEG",                    1, NULL,         INTD_LO,   INTD_PASSIVE, NULL,                           &Job_Example::var_lockParameters},
+    {&Job_Example::lpv_aoExample,          "EXAMPLE-AO",   "",                                                                 "GeV",                    1, NULL,         INTD_AO,   INTD_PASSIVE, NULL,                           &Job_Example::var_lockParameters},
+
+    {&Job_Example::lpv_waveformoutExample, "EXAMPLE-WFO",  "",                                                                 "DIG",     SRVEXAM_BUF_SIZE, NULL,         INTD_WFO,  INTD_PASSIVE, NULL,                           &Job_Example::var_lockParameters, INTD_DOUBLE},
+    {&Job_Example::lpv_stringoutExample,   "EXAMPLE-SO",   "",                                                                 "",     INTD_STR_RECORD_LEN, NULL,         INTD_SO,   INTD_PASSIVE, NULL,                           &Job_Example::var_lockParameters},
+
+    {&Job_Example::lpv_biExample,          "EXAMPLE-BI",   "",                                                                 "",                       1, NULL,         INTD_BI,   INTD_IOINT,   &Job_Example::var_scanResultPVs, &Job_Example::var_lockResults},
+    {&Job_Example::lpv_mbbiExample,        "EXAMPLE-MBBI", "Dis1;Dis2;Dis3",                                                   "",                       1, NULL,         INTD_MBBI, INTD_IOINT,   &Job_Example::var_scanResultPVs, &Job_Example::var_lockResults},
+    {&Job_Example::lpv_longinExample,      "EXAMPLE-LI",   "",                                                                 "DEG",                    1, NULL,         INTD_LI,   INTD_IOINT,   &Job_Example::var_scanResultPVs, &Job_Example::var_lockResults},
+    {&Job_Example::lpv_aiExample,          "EXAMPLE-AI",   "",                                                                 "GeV",                    1, NULL,         INTD_AI,   INTD_IOINT,   &Job_Example::var_scanResultPVs, &Job_Example::var_lockResults},
 
-    lpv_counter1S.init          (modn, devn, "CNT1S",           "", "",                         1, (void *)this, lpvRcb_cnt1S, INTD_AI,  INTD_1S,                  NULL,               NULL, NULL);
-    lpv_counter2S.init          (modn, devn, "CNT2S",           "", "",                         1, (void *)this, lpvRcb_cnt2S, INTD_AI,  INTD_2S,                  NULL,               NULL, NULL);
-    lpv_counter5S.init          (modn, devn, "CNT5S",           "", "",                         1, (void *)this, lpvRcb_cnt5S, INTD_AI,  INTD_5S,                  NULL,               NULL, NULL);
+    {&Job_Example::lpv_xaxis,              "EXAMPLE-WFX",  "",                                                                 "SEC",     SRVEXAM_BUF_SIZE, NULL,         INTD_WFI,  INTD_IOINT,   &Job_Example::var_scanResultPVs, &Job_Example::var_lockResults, INTD_DOUBLE},
+    {&Job_Example::lpv_waveforminExample,  "EXAMPLE-WFI",  "",                                                                 "DIG",     SRVEXAM_BUF_SIZE, NULL,         INTD_WFI,  INTD_IOINT,   &Job_Example::var_scanResultPVs, &Job_Example::var_lockResults, INTD_DOUBLE},
+    {&Job_Example::lpv_stringinExample,    "EXAMPLE-SI",   "",                                                                 "",     INTD_STR_RECORD_LEN, NULL,         INTD_SI,   INTD_IOINT,   &Job_Example::var_scanResultPVs, &Job_Example::var_lockResults},
 
-    lpv_timeStr.init            (modn, devn, "MON-TIME-STR",    "", "",       INTD_STR_RECORD_LEN, (void *)this,         NULL, INTD_SI,  INTD_IOINT, &var_scanResultPVs,               NULL, NULL);
-    lpv_msgStr.init             (modn, devn, "MON-MSG-STR",     "", "",       INTD_STR_RECORD_LEN, (void *)this,         NULL, INTD_SI,  INTD_IOINT, &var_scanResultPVs,               NULL, NULL);
+    {&Job_Example::lpv_counter1S,          "CNT1S",        "",                                                                 "",                       1, lpvRcb_cnt1S, INTD_AI,   INTD_1S,      NULL,                           NULL},
+    {&Job_Example::lpv_counter2S,          "CNT2S",        "",                                                                 "",                       1, lpvRcb_cnt2S, INTD_AI,   INTD_2S,      NULL,                           NULL},
+    {&Job_Example::lpv_counter5S,          "CNT5S",        "",                                                                 "",                       1, lpvRcb_cnt5S, INTD_AI,   INTD_5S,      NULL,                           NULL},
 
-    lpv_enableJob.init          (modn, devn, "MON-ENA-JOB",     "", "",                         1, (void *)this,         NULL, INTD_BI,  INTD_IOINT, &var_scanResultPVs,               NULL, NULL);
+    {&Job_Example::lpv_timeStr,            "MON-TIME-STR", "",                                                                 "",     INTD_STR_RECORD_LEN, NULL,         INTD_SI,   INTD_IOINT,   &Job_Example::var_scanResultPVs, NULL},
+    {&Job_Example::lpv_msgStr,             "MON-MSG-STR",  "",                                                                 "",     INTD_STR_RECORD_LEN, NULL,         INTD_SI,   INTD_IOINT,   &Job_Example::var_scanResultPVs, NULL},
+
+    {&Job_Example::lpv_enableJob,          "MON-ENA-JOB",  "",                                                                 "",                       1, NULL,         INTD_BI,   INTD_IOINT,   &Job_Example::var_scanResultPVs, NULL}
+};
+
+//-----------------------------------------------
+// init the local PVs
+//-----------------------------------------------
+void Job_Example::initLocalPVs()
+{
+    // create the local PVs of the table, the object is the private pointer of the callbacks.
+    // single PVs can still be created with LocalPV::init, see the definition in LocalPV.h
+    if(OOEPICS::LPV_initTable(this, string(modName), string(jobName), var_pvTable) != 0)
+        cout << "ERROR:Job_Example: Failed to create some local PVs of " << jobName << "!" << endl;
 
     // assign default values after the initialization
     lpv_enableJob.setValue(jobEnabled);
@@ -203,9 +194,9 @@ int Job_Example::execute(int flag)
                                                             SRVEXAM_BUF_SIZE);
 
             if(status == __MODULE_NAME___RPVACCESS_SUCCESS) {
-                lpv_longinExample.setValue      (longinExample);
-                lpv_aiExample.setValue          (aiExample);
-                lpv_waveforminExample.setValues (buf_wfi, SRVEXAM_BUF_SIZE);
+                grp_resultPVs.stage             (lpv_longinExample,     longinExample);
+                grp_resultPVs.stage             (lpv_aiExample,         aiExample);
+                grp_resultPVs.stageValues       (lpv_waveforminExample, buf_wfi, SRVEXAM_BUF_SIZE);
 
                 // display the data for debugging
                 cout << "Data pulling read with CA:" << endl;
@@ -230,10 +221,10 @@ int Job_Example::execute(int flag)
                                                             SRVEXAM_BUF_SIZE);
 
             if(status == __MODULE_NAME___RPVACCESS_SUCCESS) {
-                lpv_biExample.setValue          (biExample);
-                lpv_mbbiExample.setValue        (mbbiExample);
-                lpv_xaxis.setValues             (buf_wfx, SRVEXAM_BUF_SIZE);
-                lpv_stringinExample.setString   (stringinExample);
+                grp_resultPVs.stage             (lpv_biExample,         biExample);
+                grp_resultPVs.stage             (lpv_mbbiExample,       mbbiExample);
+                grp_resultPVs.stageValues       (lpv_xaxis,             buf_wfx, SRVEXAM_BUF_SIZE);
+                grp_resultPVs.stageString       (lpv_stringinExample,   stringinExample);
 
                 // display the data for debugging
                 cout << "Data monitoring read with CA:" << endl;
@@ -272,10 +263,13 @@ int Job_Example::execute(int flag)
 }
 
 //-----------------------------------------------
-// update the local PVs for results
+// update the local PVs for results, the staged results are written
+// together before the scan
 //-----------------------------------------------
 void Job_Example::updateResultPVs() 
 {
+    grp_resultPVs.commit(false);
+
     if(var_scanResultPVs)
         EPICSLIB_func_scanIoRequest(var_scanResultPVs);
 }
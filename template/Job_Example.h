@@ -18,6 +18,8 @@
 
 #include "Job.h"
 #include "LocalPV.h"
+#include "LocalPVGroup.h"
+#include "LocalPVTable.h"
 #include "ooEpicsMisc.h"
 #include "MessageLogs.h"
 #include "EPICSLib_wrapper.h"
@@ -79,7 +81,12 @@ private:
 
     // locks and I/O interrupt scanning driver for local PVs
     EPICSLIB_type_mutexId   var_lockParameters;     // parameter PVs are shared by multiple thread, the mutex to protect them
+    EPICSLIB_type_mutexId   var_lockResults;        // result PVs written by the commit group, the mutex serializes the commits with the readers
     EPICSLIB_type_ioScanPvt var_scanResultPVs;      // collect PVs that can be scanned by the job with "I/O Inter" scan method
+    OOEPICS::LocalPVGroup   grp_resultPVs;          // results staged by the job, written together by updateResultPVs
+
+    // table of the local PVs
+    static const OOEPICS::LPV_PVDesc<Job_Example> var_pvTable[];
 
     // private variables
     int var_valCnt1S;
@@ -102,14 +102,22 @@ void Module___MODULE_NAME__::initLocalPVs()
         strIdStream.str("");
         strIdStream << i;
         strId = strIdStream.str();
-        
-        lpv_msgLog[i].setWfDataType(INTD_CHAR);
+
+#ifdef BASE_3_15
+        if(i == 0) {
+            lpv_msgLog[i].init(modn, devn, "MON-MSG-LOG" + strId, "", "", MSGLOG_MAX_LEN, (void *)this, lpvRcb_getLogMsg, INTD_LSI, INTD_1S, NULL, NULL, NULL);
+        } else {
+            lpv_msgLog[i].init(modn, devn, "MON-MSG-LOG" + strId, "", "", MSGLOG_MAX_LEN, (void *)this,             NULL, INTD_LSI, INTD_1S, NULL, NULL, NULL);
+        }
+#else
+        lpv_msgLog[i].setWfDataType(INTD_CHAR);                                         // lsi records need base 3.15 or later
 
         if(i == 0) {
             lpv_msgLog[i].init(modn, devn, "MON-MSG-LOG" + strId, "", "", MSGLOG_MAX_LEN, (void *)this, lpvRcb_getLogMsg, INTD_WFI, INTD_1S, NULL, NULL, NULL);
         } else {
             lpv_msgLog[i].init(modn, devn, "MON-MSG-LOG" + strId, "", "", MSGLOG_MAX_LEN, (void *)this,             NULL, INTD_WFI, INTD_1S, NULL, NULL, NULL);
         }
+#endif
     }
   
     lpv_versionStr.init     (modn, devn, "VERSION",        "", "", INTD_STR_RECORD_LEN, (void *)this, NULL, INTD_SI, INTD_10S, NULL, NULL, NULL);
@@ -205,14 +213,19 @@ void Module___MODULE_NAME__::lpvWcb_cmdFSMExample(void *arg)
 void Module___MODULE_NAME__::lpvRcb_getLogMsg(void *arg)
 {
     int i;
-    epicsInt8 msgStr[MSGLOG_MAX_LEN];
+    char msgStr[MSGLOG_MAX_LEN];
 
     Module___MODULE_NAME__ *mod = (Module___MODULE_NAME__ *)arg; 
     if(!mod) return;
 
     for(i = 0; i < MSGLOG_MAX_NUM; i ++) {
-        mod -> var_msgLog.copyMessage((char *)msgStr, i); 
-        mod -> lpv_msgLog[i].setValues(msgStr, MSGLOG_MAX_LEN);
+        mod -> var_msgLog.copyMessage(msgStr, i); 
+        msgStr[MSGLOG_MAX_LEN - 1] = '\0';
+#ifdef BASE_3_15
+        mod -> lpv_msgLog[i].setString(msgStr);
+#else
+        mod -> lpv_msgLog[i].setValues((epicsInt8 *)msgStr, MSGLOG_MAX_LEN);
+#endif
     }
 }
 
@@ -79,7 +79,7 @@ private:
     OOEPICS::LocalPV  lpv_monRPVMappedNum;              // longin, display the total number of remote PVs with names mapped
     OOEPICS::LocalPV  lpv_monRPVConnectedNum;           // longin, display the total number of remote PVs with connections
 
-    OOEPICS::LocalPV  lpv_msgLog[MSGLOG_MAX_NUM];       // stringin[], display the run-time messages
+    OOEPICS::LocalPV  lpv_msgLog[MSGLOG_MAX_NUM];       // lsi[] (char waveform[] before base 3.15), display the run-time messages
 
     OOEPICS::LocalPV  lpv_versionStr;                   // stringin, display the version
     OOEPICS::LocalPV  lpv_compileDateStr;               // stringin, display the release (compile) date